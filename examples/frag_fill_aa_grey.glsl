@@ -0,0 +1,8 @@
+in mediump float frag_coverage;
+
+out mediump vec4 frag_color;
+
+void main()
+{
+    frag_color = vec4(0.5, 0.5, 0.5, TREEFACE_FILL_COVERAGE(frag_coverage));
+}
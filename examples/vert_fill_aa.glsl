@@ -0,0 +1,10 @@
+in highp vec2 position;
+in mediump float coverage;
+
+out mediump float frag_coverage;
+
+void main()
+{
+    gl_Position = matrix_model_view_project * vec4(position, 0.0, 1.0);
+    frag_coverage = coverage;
+}
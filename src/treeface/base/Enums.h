@@ -64,6 +64,13 @@ typedef enum
     FILL_EVEN_ODD,
 } FillRule;
 
+typedef enum
+{
+    DEPTH_SORT_NONE,        ///< only group draws by material and geometry
+    DEPTH_SORT_TRANSLUCENT, ///< draw translucent items strictly from back to front
+    DEPTH_SORT_ALL,         ///< also draw opaque items roughly from front to back inside each material
+} DepthSortPolicy;
+
 typedef enum
 {
     TEXTURE_IMAGE_SOLO_AS_RED,
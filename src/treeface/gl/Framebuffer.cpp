@@ -11,11 +11,12 @@ namespace treeface
 Framebuffer::Framebuffer()
 {
     glGenFramebuffers( 1, &m_handle );
-    glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_handle );
+    bind_draw();
 }
 
 Framebuffer::~Framebuffer()
 {
+    GLStateCache::current().framebuffer_deleted( m_handle );
     glDeleteFramebuffers( 1, &m_handle );
 }
 
@@ -2,6 +2,7 @@
 #define TREEFACE_FRAMEBUFFER_H
 
 #include "treeface/gl/Enums.h"
+#include "treeface/gl/GLStateCache.h"
 
 #include <treecore/ClassUtils.h>
 #include <treecore/RefCountObject.h>
@@ -21,11 +22,11 @@ public:
 
     virtual ~Framebuffer();
 
-    void bind_draw() const noexcept { glBindFramebuffer( GL_DRAW_FRAMEBUFFER, m_handle ); }
-    void bind_read() const noexcept { glBindFramebuffer( GL_READ_FRAMEBUFFER, m_handle ); }
+    void bind_draw() const noexcept { GLStateCache::current().bind_framebuffer( GL_DRAW_FRAMEBUFFER, m_handle ); }
+    void bind_read() const noexcept { GLStateCache::current().bind_framebuffer( GL_READ_FRAMEBUFFER, m_handle ); }
 
-    bool is_bound_to_draw() const noexcept { return m_handle == get_current_bound_draw(); }
-    bool is_bound_to_read() const noexcept { return m_handle == get_current_bound_read(); }
+    bool is_bound_to_draw() const noexcept { return m_handle == GLStateCache::current().get_draw_framebuffer(); }
+    bool is_bound_to_read() const noexcept { return m_handle == GLStateCache::current().get_read_framebuffer(); }
 
     void attach_2d_texture( GLFramebufferAttachment attach, Texture* texture ) const;
     void attach_cube_texture( GLFramebufferAttachment attach, Texture* texture, GLTextureCubeSide side ) const;
@@ -39,8 +40,8 @@ public:
 
     GLuint get_gl_handle() const noexcept { return m_handle; }
 
-    static void bind_draw_to_default() noexcept { glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 ); }
-    static void bind_read_to_default() noexcept { glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 ); }
+    static void bind_draw_to_default() noexcept { GLStateCache::current().bind_framebuffer( GL_DRAW_FRAMEBUFFER, 0 ); }
+    static void bind_read_to_default() noexcept { GLStateCache::current().bind_framebuffer( GL_READ_FRAMEBUFFER, 0 ); }
 
     static GLuint get_current_bound_draw() noexcept
     {
@@ -13,13 +13,16 @@ GLBuffer::GLBuffer( GLBufferType type, GLBufferUsage usage )
     glGenBuffers( 1, &m_buffer );
     if (!m_buffer)
         die( "failed to create buffer" );
-    glBindBuffer( m_type, m_buffer );
+    bind();
 }
 
 GLBuffer::~GLBuffer()
 {
     if (m_buffer)
+    {
+        GLStateCache::current().buffer_deleted( m_buffer );
         glDeleteBuffers( 1, &m_buffer );
+    }
 }
 
 GLuint GLBuffer::get_current_bound_buffer( GLBufferType type )
@@ -11,6 +11,7 @@
 #include "treeface/base/Enums.h"
 
 #include "treeface/gl/Enums.h"
+#include "treeface/gl/GLStateCache.h"
 
 namespace treeface
 {
@@ -35,17 +36,17 @@ public:
 
     virtual ~GLBuffer();
 
-    void bind()   const { glBindBuffer( m_type, m_buffer ); }
-    void unbind() const { glBindBuffer( m_type, 0 ); }
+    void bind()   const { GLStateCache::current().bind_buffer( m_type, m_buffer ); }
+    void unbind() const { GLStateCache::current().bind_buffer( m_type, 0 ); }
 
     bool is_bound() const
     {
-        return get_current_bound_buffer( m_type ) == m_buffer;
+        return GLStateCache::current().get_buffer( m_type ) == m_buffer;
     }
 
     void upload_data( const void* data, GLsizei num_byte )
     {
-        treecore_assert( get_current_bound_buffer( m_type ) == m_buffer );
+        treecore_assert( is_bound() );
         glBufferData( m_type, num_byte, data, m_usage );
     }
 
@@ -60,6 +61,38 @@ public:
         upload_data( data.getData(), GLsizei( data.getSize() ) );
     }
 
+    ///
+    /// \brief modify part of buffer content without reallocating storage
+    ///
+    void upload_sub_data( GLintptr offset, const void* data, GLsizeiptr num_byte )
+    {
+        treecore_assert( is_bound() );
+        glBufferSubData( m_type, offset, num_byte, data );
+    }
+
+    ///
+    /// \brief bind whole buffer to an indexed binding point
+    ///
+    /// Only valid for uniform buffer and transform feedback buffer.
+    ///
+    void bind_base( GLuint index ) const
+    {
+        glBindBufferBase( m_type, index, m_buffer );
+        GLStateCache::current().buffer_bound_indexed( m_type, m_buffer );
+    }
+
+    ///
+    /// \brief bind a range of buffer to an indexed binding point
+    ///
+    /// For uniform buffer, offset must be a multiple of
+    /// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+    ///
+    void bind_range( GLuint index, GLintptr offset, GLsizeiptr num_byte ) const
+    {
+        glBindBufferRange( m_type, index, m_buffer, offset, num_byte );
+        GLStateCache::current().buffer_bound_indexed( m_type, m_buffer );
+    }
+
     GLuint get_gl_handle() const noexcept { return m_buffer; }
 
     static GLuint get_current_bound_buffer( GLBufferType type );
@@ -0,0 +1,242 @@
+#include "treeface/gl/GLStateCache.h"
+
+#include "treeface/gl/Framebuffer.h"
+#include "treeface/gl/GLBuffer.h"
+#include "treeface/gl/Program.h"
+#include "treeface/gl/Texture.h"
+#include "treeface/gl/VertexArray.h"
+
+using namespace treecore;
+
+namespace treeface
+{
+
+inline int _buffer_target_index_( GLBufferType target ) noexcept
+{
+    switch (target)
+    {
+    case TFGL_BUFFER_VERTEX:   return 0;
+    case TFGL_BUFFER_INDEX:    return 1;
+    case TFGL_BUFFER_PACK:     return 2;
+    case TFGL_BUFFER_UNPACK:   return 3;
+    case TFGL_BUFFER_READ:     return 4;
+    case TFGL_BUFFER_WRITE:    return 5;
+    case TFGL_BUFFER_FEEDBACK: return 6;
+    case TFGL_BUFFER_UNIFORM:  return 7;
+    }
+    abort();
+}
+
+inline int _texture_target_index_( GLTextureType target ) noexcept
+{
+    switch (target)
+    {
+    case TFGL_TEXTURE_2D:       return 0;
+    case TFGL_TEXTURE_3D:       return 1;
+    case TFGL_TEXTURE_2D_ARRAY: return 2;
+    case TFGL_TEXTURE_CUBE:     return 3;
+    }
+    abort();
+}
+
+const GLuint GLStateCache::UNKNOWN;
+
+static GLStateCache  _default_cache_;
+static GLStateCache* _current_cache_ = nullptr;
+
+GLStateCache::GLStateCache()
+{
+    invalidate();
+}
+
+GLStateCache& GLStateCache::current() noexcept
+{
+    return _current_cache_ ? *_current_cache_ : _default_cache_;
+}
+
+void GLStateCache::set_current( GLStateCache* cache ) noexcept
+{
+    _current_cache_ = cache;
+}
+
+void GLStateCache::invalidate() noexcept
+{
+    m_program          = UNKNOWN;
+    m_vertex_array     = UNKNOWN;
+    m_active_unit      = UNKNOWN;
+    m_draw_framebuffer = UNKNOWN;
+    m_read_framebuffer = UNKNOWN;
+
+    for (int i = 0; i < TREEFACE_GL_STATE_NUM_BUFFER_TARGET; i++)
+        m_buffers[i] = UNKNOWN;
+
+    for (int i_unit = 0; i_unit < TREEFACE_GL_STATE_NUM_TEXTURE_UNIT; i_unit++)
+        for (int i_target = 0; i_target < TREEFACE_GL_STATE_NUM_TEXTURE_TARGET; i_target++)
+            m_textures[i_unit][i_target] = UNKNOWN;
+}
+
+void GLStateCache::use_program( GLuint program ) noexcept
+{
+    if ( check_and_set( m_program, program ) )
+        glUseProgram( program );
+}
+
+void GLStateCache::bind_vertex_array( GLuint array ) noexcept
+{
+    if ( check_and_set( m_vertex_array, array ) )
+    {
+        glBindVertexArray( array );
+
+        // index buffer binding is a part of vertex array state
+        m_buffers[_buffer_target_index_( TFGL_BUFFER_INDEX )] = UNKNOWN;
+    }
+}
+
+void GLStateCache::bind_buffer( GLBufferType target, GLuint buffer ) noexcept
+{
+    if ( check_and_set( m_buffers[_buffer_target_index_( target )], buffer ) )
+        glBindBuffer( target, buffer );
+}
+
+void GLStateCache::buffer_bound_indexed( GLBufferType target, GLuint buffer ) noexcept
+{
+    m_buffers[_buffer_target_index_( target )] = buffer;
+}
+
+void GLStateCache::active_texture( GLuint unit ) noexcept
+{
+    if ( check_and_set( m_active_unit, unit ) )
+        glActiveTexture( GL_TEXTURE0 + unit );
+}
+
+void GLStateCache::bind_texture( GLTextureType target, GLuint texture ) noexcept
+{
+    // units beyond cache capacity are not tracked
+    if (m_active_unit >= TREEFACE_GL_STATE_NUM_TEXTURE_UNIT)
+    {
+        m_stats.num_issued++;
+        glBindTexture( target, texture );
+        return;
+    }
+
+    if ( check_and_set( m_textures[m_active_unit][_texture_target_index_( target )], texture ) )
+        glBindTexture( target, texture );
+}
+
+void GLStateCache::bind_framebuffer( GLenum target, GLuint framebuffer ) noexcept
+{
+    switch (target)
+    {
+    case GL_DRAW_FRAMEBUFFER:
+        if ( check_and_set( m_draw_framebuffer, framebuffer ) )
+            glBindFramebuffer( target, framebuffer );
+        break;
+    case GL_READ_FRAMEBUFFER:
+        if ( check_and_set( m_read_framebuffer, framebuffer ) )
+            glBindFramebuffer( target, framebuffer );
+        break;
+    default:
+        if (m_draw_framebuffer == framebuffer && m_read_framebuffer == framebuffer)
+        {
+            m_stats.num_elided++;
+        }
+        else
+        {
+            m_stats.num_issued++;
+            m_draw_framebuffer = framebuffer;
+            m_read_framebuffer = framebuffer;
+            glBindFramebuffer( target, framebuffer );
+        }
+    }
+}
+
+GLuint GLStateCache::get_program() noexcept
+{
+    if (m_program == UNKNOWN)
+        m_program = Program::get_current_bound_program();
+    return m_program;
+}
+
+GLuint GLStateCache::get_vertex_array() noexcept
+{
+    if (m_vertex_array == UNKNOWN)
+        m_vertex_array = VertexArray::get_current_bound_vertex_array();
+    return m_vertex_array;
+}
+
+GLuint GLStateCache::get_buffer( GLBufferType target ) noexcept
+{
+    GLuint& cached = m_buffers[_buffer_target_index_( target )];
+    if (cached == UNKNOWN)
+        cached = GLBuffer::get_current_bound_buffer( target );
+    return cached;
+}
+
+GLuint GLStateCache::get_texture( GLTextureType target ) noexcept
+{
+    if (m_active_unit >= TREEFACE_GL_STATE_NUM_TEXTURE_UNIT)
+        return Texture::get_current_bound_texture( target );
+
+    GLuint& cached = m_textures[m_active_unit][_texture_target_index_( target )];
+    if (cached == UNKNOWN)
+        cached = Texture::get_current_bound_texture( target );
+    return cached;
+}
+
+GLuint GLStateCache::get_draw_framebuffer() noexcept
+{
+    if (m_draw_framebuffer == UNKNOWN)
+        m_draw_framebuffer = Framebuffer::get_current_bound_draw();
+    return m_draw_framebuffer;
+}
+
+GLuint GLStateCache::get_read_framebuffer() noexcept
+{
+    if (m_read_framebuffer == UNKNOWN)
+        m_read_framebuffer = Framebuffer::get_current_bound_read();
+    return m_read_framebuffer;
+}
+
+void GLStateCache::program_deleted( GLuint program ) noexcept
+{
+    if (m_program == program)
+        m_program = UNKNOWN;
+}
+
+void GLStateCache::vertex_array_deleted( GLuint array ) noexcept
+{
+    if (m_vertex_array == array)
+    {
+        m_vertex_array = UNKNOWN;
+        m_buffers[_buffer_target_index_( TFGL_BUFFER_INDEX )] = UNKNOWN;
+    }
+}
+
+void GLStateCache::buffer_deleted( GLuint buffer ) noexcept
+{
+    for (int i = 0; i < TREEFACE_GL_STATE_NUM_BUFFER_TARGET; i++)
+    {
+        if (m_buffers[i] == buffer)
+            m_buffers[i] = UNKNOWN;
+    }
+}
+
+void GLStateCache::texture_deleted( GLuint texture ) noexcept
+{
+    for (int i_unit = 0; i_unit < TREEFACE_GL_STATE_NUM_TEXTURE_UNIT; i_unit++)
+    {
+        for (int i_target = 0; i_target < TREEFACE_GL_STATE_NUM_TEXTURE_TARGET; i_target++)
+        {
+            if (m_textures[i_unit][i_target] == texture)
+                m_textures[i_unit][i_target] = UNKNOWN;
+        }
+    }
+}
+
+void GLStateCache::framebuffer_deleted( GLuint framebuffer ) noexcept
+{
+    if (m_draw_framebuffer == framebuffer) m_draw_framebuffer = UNKNOWN;
+    if (m_read_framebuffer == framebuffer) m_read_framebuffer = UNKNOWN;
+}
+
+} // namespace treeface
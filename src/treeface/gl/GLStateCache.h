@@ -0,0 +1,166 @@
+#ifndef TREEFACE_GL_STATE_CACHE_H
+#define TREEFACE_GL_STATE_CACHE_H
+
+#include "treeface/base/Common.h"
+#include "treeface/gl/Enums.h"
+
+#include <treecore/ClassUtils.h>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#define TREEFACE_GL_STATE_NUM_TEXTURE_UNIT   32
+#define TREEFACE_GL_STATE_NUM_TEXTURE_TARGET 4
+#define TREEFACE_GL_STATE_NUM_BUFFER_TARGET  8
+
+namespace treeface
+{
+
+///
+/// \brief shadow copy of OpenGL object bindings of one context
+///
+/// All binding methods of treeface GL objects go through this cache, and the
+/// driver is only called when binding actually changes. Bindings that are not
+/// known, such as at startup or after invalidate(), are always sent to driver
+/// and are fetched from driver when they are queried.
+///
+/// The cache only sees calls made by treeface. If other code modifies GL
+/// bindings, invalidate() must be called before using treeface objects again.
+/// If application uses multiple GL contexts, each context should have its own
+/// cache, and set_current() should be called together with context switch.
+///
+class GLStateCache
+{
+public:
+    ///
+    /// \brief number of binding calls since last reset_stats()
+    ///
+    /// SceneRenderer::render() resets stats of current cache when it begins,
+    /// so they count calls of the last frame.
+    ///
+    struct Stats
+    {
+        treecore::uint32 num_issued = 0; ///< calls that are sent to driver
+        treecore::uint32 num_elided = 0; ///< redundant calls that are skipped
+    };
+
+    static const GLuint UNKNOWN = GLuint( -1 );
+
+    GLStateCache();
+
+    TREECORE_DECLARE_NON_COPYABLE( GLStateCache );
+    TREECORE_DECLARE_NON_MOVABLE( GLStateCache );
+
+    ///
+    /// \brief get the cache of currently used GL context
+    ///
+    /// A default cache is used if set_current() is never called.
+    ///
+    static GLStateCache& current() noexcept;
+
+    ///
+    /// \brief use another cache, should be called after GL context switch
+    ///
+    /// \param cache  the cache to use, or nullptr to use the default one
+    ///
+    static void set_current( GLStateCache* cache ) noexcept;
+
+    ///
+    /// \brief forget all bindings
+    ///
+    void invalidate() noexcept;
+
+    void use_program( GLuint program ) noexcept;
+    void bind_vertex_array( GLuint array ) noexcept;
+    void bind_buffer( GLBufferType target, GLuint buffer ) noexcept;
+
+    ///
+    /// \brief record buffer binding changed by glBindBufferBase() or
+    ///        glBindBufferRange(), which also modifies generic binding
+    ///
+    void buffer_bound_indexed( GLBufferType target, GLuint buffer ) noexcept;
+
+    ///
+    /// \brief select active texture unit
+    ///
+    /// \param unit  zero-based unit index, not GL_TEXTUREi enum
+    ///
+    void active_texture( GLuint unit ) noexcept;
+
+    ///
+    /// \brief bind texture to active texture unit
+    ///
+    void bind_texture( GLTextureType target, GLuint texture ) noexcept;
+
+    ///
+    /// \brief bind texture to specified unit, and it becomes active unit
+    ///
+    void bind_texture( GLuint unit, GLTextureType target, GLuint texture ) noexcept
+    {
+        active_texture( unit );
+        bind_texture( target, texture );
+    }
+
+    ///
+    /// \param target  GL_FRAMEBUFFER, GL_DRAW_FRAMEBUFFER or GL_READ_FRAMEBUFFER
+    ///
+    void bind_framebuffer( GLenum target, GLuint framebuffer ) noexcept;
+
+    GLuint get_program() noexcept;
+    GLuint get_vertex_array() noexcept;
+    GLuint get_buffer( GLBufferType target ) noexcept;
+    GLuint get_texture( GLTextureType target ) noexcept;
+    GLuint get_draw_framebuffer() noexcept;
+    GLuint get_read_framebuffer() noexcept;
+
+    ///
+    /// \brief forget bindings of objects that are being deleted, as GL may
+    ///        reuse their names
+    ///
+    void program_deleted( GLuint program ) noexcept;
+    void vertex_array_deleted( GLuint array ) noexcept;
+    void buffer_deleted( GLuint buffer ) noexcept;
+    void texture_deleted( GLuint texture ) noexcept;
+    void framebuffer_deleted( GLuint framebuffer ) noexcept;
+
+    const Stats& get_stats() const noexcept
+    {
+        return m_stats;
+    }
+
+    ///
+    /// \brief clear counters, typically called at the beginning of each frame
+    ///
+    void reset_stats() noexcept
+    {
+        m_stats = Stats();
+    }
+
+protected:
+    bool check_and_set( GLuint& cached, GLuint value ) noexcept
+    {
+        if (cached == value)
+        {
+            m_stats.num_elided++;
+            return false;
+        }
+
+        cached = value;
+        m_stats.num_issued++;
+        return true;
+    }
+
+    GLuint m_program      = UNKNOWN;
+    GLuint m_vertex_array = UNKNOWN;
+    GLuint m_buffers[TREEFACE_GL_STATE_NUM_BUFFER_TARGET];
+    GLuint m_active_unit  = UNKNOWN;
+    GLuint m_textures[TREEFACE_GL_STATE_NUM_TEXTURE_UNIT][TREEFACE_GL_STATE_NUM_TEXTURE_TARGET];
+    GLuint m_draw_framebuffer = UNKNOWN;
+    GLuint m_read_framebuffer = UNKNOWN;
+
+    Stats m_stats;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_GL_STATE_CACHE_H
@@ -24,6 +24,9 @@ struct Program::Impl
     treecore::Array<TypedTemplateWithLocation> uni_infos;
     treecore::HashMap<Identifier, int32>       uni_idx_by_name; // name => index
     treecore::HashMap<GLint,  int32>           uni_idx_by_loc; // location => index
+
+    treecore::Array<UniformBlockInfo>    block_infos;
+    treecore::HashMap<Identifier, int32> block_idx_by_name; // name => index
 };
 
 Program::Program( const char* src_vert, const char* src_frag ): m_impl( new Impl() )
@@ -117,6 +120,34 @@ Program::Program( const char* src_vert, const char* src_frag ): m_impl( new Impl
         m_impl->attr_idx_by_name.set( Identifier( attr_name ), i_attr );
     }
 
+    // extract uniform blocks
+    int n_block = -1;
+    glGetProgramiv( m_program, GL_ACTIVE_UNIFORM_BLOCKS, &n_block );
+    if (n_block == -1)
+        die( "failed to get uniform block number from program %u", m_program );
+    TREECORE_DBG( "uniform block amount: " + String( n_block ) );
+
+    for (int i_block = 0; i_block < n_block; i_block++)
+    {
+        char    block_name[256];
+        GLsizei block_name_len = -1;
+        glGetActiveUniformBlockName( m_program, i_block, 256, &block_name_len, block_name );
+
+        if (block_name_len == -1)
+            die( "failed to get name for uniform block %d", i_block );
+
+        if (block_name_len >= 255)
+            die( "uniform block %d name is too long", i_block );
+
+        GLint block_size = -1;
+        glGetActiveUniformBlockiv( m_program, i_block, GL_UNIFORM_BLOCK_DATA_SIZE, &block_size );
+
+        TREECORE_DBG( "  uniform block " + String( i_block ) + " " + String( block_name ) + ": size " + String( block_size ) );
+
+        m_impl->block_infos.add( UniformBlockInfo( Identifier( block_name ), GLuint( i_block ), block_size ) );
+        m_impl->block_idx_by_name.set( Identifier( block_name ), i_block );
+    }
+
     // extract program uniforms
     int n_uni = -1;
     glGetProgramiv( m_program, GL_ACTIVE_UNIFORMS, &n_uni );
@@ -140,6 +171,27 @@ Program::Program( const char* src_vert, const char* src_frag ): m_impl( new Impl
         if (uni_name_len >= 255)
             die( "uniform %d name is too long", i_uni );
 
+        // uniforms in block have no location, store their layout in block
+        GLuint uni_index = GLuint( i_uni );
+        GLint  i_block   = -1;
+        glGetActiveUniformsiv( m_program, 1, &uni_index, GL_UNIFORM_BLOCK_INDEX, &i_block );
+
+        if (i_block != -1)
+        {
+            GLint offset        = -1;
+            GLint array_stride  = 0;
+            GLint matrix_stride = 0;
+            glGetActiveUniformsiv( m_program, 1, &uni_index, GL_UNIFORM_OFFSET,        &offset );
+            glGetActiveUniformsiv( m_program, 1, &uni_index, GL_UNIFORM_ARRAY_STRIDE,  &array_stride );
+            glGetActiveUniformsiv( m_program, 1, &uni_index, GL_UNIFORM_MATRIX_STRIDE, &matrix_stride );
+
+            TREECORE_DBG( "  uniform " + String( i_uni ) + " " + String( uni_name ) + " in block " + String( i_block ) + " at offset " + String( offset ) + ": type " + toString( GLType( uni_type ) ) + ", size " + String( uni_size ) );
+
+            m_impl->block_infos[i_block].members.add( UniformBlockMember( Identifier( uni_name ), uni_size, GLType( uni_type ),
+                                                                          offset, array_stride, matrix_stride ) );
+            continue;
+        }
+
         // get uniform location by name
         GLint uni_loc = glGetUniformLocation( m_program, uni_name );
         if (uni_loc == -1)
@@ -148,16 +200,20 @@ Program::Program( const char* src_vert, const char* src_frag ): m_impl( new Impl
         TREECORE_DBG( "  uniform " + String( i_uni ) + " " + String( uni_name ) + " at " + String( uni_loc ) + ": type " + toString( GLType( uni_type ) ) + ", size " + String( uni_size ) );
 
         // store uniform info
+        int32 i_info = m_impl->uni_infos.size();
         m_impl->uni_infos.add( { Identifier( uni_name ), uni_size, GLType( uni_type ), uni_loc } );
-        m_impl->uni_idx_by_name.set( Identifier( uni_name ), i_uni );
-        m_impl->uni_idx_by_loc.set( uni_loc, i_uni );
+        m_impl->uni_idx_by_name.set( Identifier( uni_name ), i_info );
+        m_impl->uni_idx_by_loc.set( uni_loc, i_info );
     }
 }
 
 Program::~Program()
 {
     if (m_program)
+    {
+        GLStateCache::current().program_deleted( m_program );
         glDeleteProgram( m_program );
+    }
 
     if (m_shader_vert)
         glDeleteShader( m_shader_vert );
@@ -474,4 +530,29 @@ GLint Program::get_uniform_location( const treecore::Identifier& name ) const no
         return -1;
 }
 
+int Program::get_num_uniform_blocks() const noexcept
+{
+    return m_impl->block_infos.size();
+}
+
+int Program::get_uniform_block_index( const treecore::Identifier& name ) const noexcept
+{
+    treecore::HashMap<Identifier, int32>::ConstIterator it( m_impl->block_idx_by_name );
+    if ( m_impl->block_idx_by_name.select( name, it ) )
+        return it.value();
+    else
+        return -1;
+}
+
+const UniformBlockInfo& Program::get_uniform_block( int i_block ) const noexcept
+{
+    return m_impl->block_infos[i_block];
+}
+
+void Program::set_uniform_block_binding( int i_block, GLuint binding ) noexcept
+{
+    treecore_assert( 0 <= i_block && i_block < m_impl->block_infos.size() );
+    glUniformBlockBinding( m_program, m_impl->block_infos[i_block].index, binding );
+}
+
 } // namespace treeface
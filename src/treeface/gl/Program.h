@@ -3,6 +3,8 @@
 
 #include "treeface/base/Common.h"
 
+#include "treeface/gl/GLStateCache.h"
+
 #include "treeface/math/Vec2.h"
 #include "treeface/math/Vec3.h"
 #include "treeface/math/Vec4.h"
@@ -11,6 +13,7 @@
 #include "treeface/math/Mat4.h"
 
 #include "treeface/misc/TypedTemplateWithLocation.h"
+#include "treeface/misc/UniformBlockInfo.h"
 
 #include <treecore/Array.h>
 #include <treecore/HashMap.h>
@@ -36,6 +39,9 @@ struct VertexArray;
  * The metadata of all vertex attributes and uniforms will be enumerated during
  * build time, and can be accessed by get_attribute_index(),
  * get_attribute_info(), get_uniform_index(), get_uniform_info() methods.
+ * Uniforms inside of uniform blocks don't have location, and they are stored
+ * in block metadata which can be accessed by get_uniform_block_index() and
+ * get_uniform_block().
  *
  * The geometry shader is not included, as OpenGL ES do not support it.
  *
@@ -79,14 +85,14 @@ public:
     ///
     /// \brief bind program
     ///
-    void bind() noexcept { glUseProgram( m_program ); }
+    void bind() noexcept { GLStateCache::current().use_program( m_program ); }
 
     ///
     /// \brief unbind program
     ///
-    static void unbind() { glUseProgram( 0 ); }
+    static void unbind() { GLStateCache::current().use_program( 0 ); }
 
-    bool is_bound() const noexcept { return get_current_bound_program() == m_program; }
+    bool is_bound() const noexcept { return GLStateCache::current().get_program() == m_program; }
 
     void set_uniform( GLint uni_loc, GLint value ) const noexcept;
     void set_uniform( GLint uni_loc, GLuint value ) const noexcept;
@@ -170,6 +176,33 @@ public:
     ///
     GLint get_uniform_location( const treecore::Identifier& name ) const noexcept;
 
+    int get_num_uniform_blocks() const noexcept;
+
+    ///
+    /// \brief get uniform block index by block name
+    ///
+    /// \param name  uniform block name, not the instance name
+    /// \return uniform block index, or -1 if no such block
+    ///
+    int get_uniform_block_index( const treecore::Identifier& name ) const noexcept;
+
+    ///
+    /// \brief get uniform block info by index, including size and layout of
+    ///        block members
+    ///
+    const UniformBlockInfo& get_uniform_block( int i_block ) const noexcept;
+
+    ///
+    /// \brief associate uniform block with an indexed uniform buffer binding
+    ///        point
+    ///
+    /// Block contents are then read from the buffer bound by
+    /// GLBuffer::bind_base() or GLBuffer::bind_range() on the same binding
+    /// point. The association is a state of program object, so it doesn't need
+    /// program binding.
+    ///
+    void set_uniform_block_binding( int i_block, GLuint binding ) noexcept;
+
     GLuint get_gl_handle() const noexcept { return m_program; }
 
     static GLuint get_current_bound_program() noexcept
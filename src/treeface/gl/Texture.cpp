@@ -82,7 +82,7 @@ inline void _check_error_unbind_( GLTextureType type, const String& msg )
     GLenum err = glGetError();
     if (err != GL_NO_ERROR)
     {
-        glBindTexture( type, 0 );
+        GLStateCache::current().bind_texture( type, 0 );
         switch (err)
         {
         case GL_INVALID_ENUM:      throw GLInvalidEnum( "invalid enum while " + msg );
@@ -98,7 +98,7 @@ Texture::Texture(  TextureCompatibleImageRef image, treecore::uint32 num_gen_mip
     : m_type( TFGL_TEXTURE_2D )
     , m_texture( _gen_texture_() )
 {
-    glBindTexture( m_type, m_texture );
+    bind();
 
     glTexParameteri( m_type, GL_TEXTURE_BASE_LEVEL, 0 );
     glTexParameteri( m_type, GL_TEXTURE_MAX_LEVEL,  num_gen_mipmap );
@@ -112,7 +112,7 @@ Texture::Texture(  TextureCompatibleImageRef image, treecore::uint32 num_gen_mip
         _check_error_unbind_( m_type, "generating 2D texture mipmaps" );
     }
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 Texture::Texture( GLsizei width, GLsizei height, GLsizei levels, GLInternalImageFormat internal_fmt )
@@ -120,19 +120,19 @@ Texture::Texture( GLsizei width, GLsizei height, GLsizei levels, GLInternalImage
     , m_type( TFGL_TEXTURE_2D )
     , m_immutable( true )
 {
-    glBindTexture( m_type, m_texture );
+    bind();
 
     glTexStorage2D( m_type, levels, internal_fmt, width, height );
     _check_error_unbind_( m_type, "creating immutable 2D texture" );
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 Texture::Texture( treecore::ArrayRef<TextureCompatibleImageRef> images )
     : m_texture( _gen_texture_() )
     , m_type( TFGL_TEXTURE_2D )
 {
-    glBindTexture( m_type, m_texture );
+    bind();
 
     glTexParameteri( m_type, GL_TEXTURE_BASE_LEVEL, 0 );
     glTexParameteri( m_type, GL_TEXTURE_MAX_LEVEL,  images.size() - 1 );
@@ -143,14 +143,14 @@ Texture::Texture( treecore::ArrayRef<TextureCompatibleImageRef> images )
         _check_error_unbind_( m_type, "assigning 2D texture data for mipmap level " + String( level ) );
     }
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 Texture::Texture( TextureCompatibleImageArrayRef images, uint32 num_gen_mipmap )
     : m_texture( _gen_texture_() )
     , m_type( TFGL_TEXTURE_2D_ARRAY )
 {
-    glBindTexture( m_type, m_texture );
+    bind();
 
     glTexParameteri( m_type, GL_TEXTURE_BASE_LEVEL, 0 );
     glTexParameteri( m_type, GL_TEXTURE_MAX_LEVEL,  num_gen_mipmap );
@@ -164,7 +164,7 @@ Texture::Texture( TextureCompatibleImageArrayRef images, uint32 num_gen_mipmap )
         _check_error_unbind_( m_type, "generating 2D texture array mipmaps" );
     }
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 Texture::Texture( TextureCompatibleImageRef img_x_plus, TextureCompatibleImageRef img_x_minus,
@@ -174,7 +174,7 @@ Texture::Texture( TextureCompatibleImageRef img_x_plus, TextureCompatibleImageRe
     : m_texture( _gen_texture_() )
     , m_type( TFGL_TEXTURE_CUBE )
 {
-    glBindTexture( m_type, m_texture );
+    bind();
 
     glTexParameteri( m_type, GL_TEXTURE_BASE_LEVEL, 0 );
     glTexParameteri( m_type, GL_TEXTURE_MAX_LEVEL,  num_gen_mipmap );
@@ -203,14 +203,14 @@ Texture::Texture( TextureCompatibleImageRef img_x_plus, TextureCompatibleImageRe
         _check_error_unbind_( m_type, "generating 2D texture array mipmaps" );
     }
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 Texture::Texture( TextureCompatibleVoxelBlockRef voxel, uint32 num_gen_mipmap )
     : m_texture( _gen_texture_() )
     , m_type( TFGL_TEXTURE_3D )
 {
-    glBindTexture( m_type, m_texture );
+    bind();
 
     glTexParameteri( m_type, GL_TEXTURE_BASE_LEVEL, 0 );
     glTexParameteri( m_type, GL_TEXTURE_MAX_LEVEL,  num_gen_mipmap );
@@ -224,7 +224,7 @@ Texture::Texture( TextureCompatibleVoxelBlockRef voxel, uint32 num_gen_mipmap )
         _check_error_unbind_( m_type, "generating 3D texture mipmaps" );
     }
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 #define KEY_NAME          "name"
@@ -281,7 +281,7 @@ Texture::Texture( const treecore::var& tex_node )
     //
     if ( !fromString( tex_kv[KEY_TYPE], m_type ) )
         throw ConfigParseError( "failed to parse type from " + tex_kv[KEY_TYPE].toString() );
-    glBindTexture( m_type, m_texture );
+    bind();
 
     //
     // load properties
@@ -475,13 +475,16 @@ Texture::Texture( const treecore::var& tex_node )
 
     set_min_filter( min_filter );
 
-    glBindTexture( m_type, 0 );
+    unbind();
 }
 
 Texture::~Texture()
 {
     if (m_texture)
+    {
+        GLStateCache::current().texture_deleted( m_texture );
         glDeleteTextures( 1, &m_texture );
+    }
 }
 
 GLuint Texture::get_current_bound_texture( GLTextureType type ) noexcept
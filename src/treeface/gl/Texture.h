@@ -3,6 +3,7 @@
 
 #include "treeface/base/Common.h"
 #include "treeface/gl/Enums.h"
+#include "treeface/gl/GLStateCache.h"
 #include "treeface/gl/ImageRef.h"
 
 #include <treecore/ArrayRef.h>
@@ -205,14 +206,14 @@ public:
         glTexParameteri( m_type, GL_TEXTURE_MAG_FILTER, value );
     }
 
-    void bind() noexcept { glBindTexture( m_type, m_texture ); }
+    void bind() noexcept { GLStateCache::current().bind_texture( m_type, m_texture ); }
 
     /**
      * @brief bind zero
      */
-    void unbind() noexcept { glBindTexture( m_type, 0 ); }
+    void unbind() noexcept { GLStateCache::current().bind_texture( m_type, 0 ); }
 
-    bool is_bound() const noexcept { return get_current_bound_texture( m_type ) == m_texture; }
+    bool is_bound() const noexcept { return GLStateCache::current().get_texture( m_type ) == m_texture; }
 
     GLuint get_gl_handle() const noexcept { return m_texture; }
 
@@ -17,7 +17,7 @@ using namespace treecore;
 
 namespace treeface {
 
-void _build_one_( const TypedTemplateWithOffset& host_attr, GLsizei stride, Program* program )
+void _build_one_( const TypedTemplateWithOffset& host_attr, GLsizei stride, Program* program, GLuint divisor = 0 )
 {
     int prog_attr_idx = program->get_attribute_index( host_attr.name );
     if (prog_attr_idx < 0)
@@ -36,6 +36,8 @@ void _build_one_( const TypedTemplateWithOffset& host_attr, GLsizei stride, Prog
                            stride,
                            reinterpret_cast<void*>(host_attr.offset) );
 
+    if (divisor != 0)
+        glVertexAttribDivisor( prog_attr.location, divisor );
 }
 
 VertexArray::VertexArray( GLBuffer* buffer_vtx,
@@ -67,8 +69,30 @@ VertexArray::VertexArray( GLBuffer* buffer_vtx,
     buffer_idx->unbind();
 }
 
+void VertexArray::add_instance_attributes( GLBuffer* instance_buffer,
+                                           const VertexTemplate& instance_info,
+                                           Program* program )
+{
+    treecore_assert( m_buf_instance == nullptr );
+    m_buf_instance = instance_buffer;
+
+    bind();
+    instance_buffer->bind();
+
+    TREECORE_DBG( "connect instance buffer with program" );
+    GLsizei stride = (GLsizei) instance_info.vertex_size();
+    for (int i = 0; i < instance_info.n_attribs(); i++)
+    {
+        _build_one_( instance_info.get_attrib( i ), stride, program, 1 );
+    }
+
+    unbind();
+    instance_buffer->unbind();
+}
+
 VertexArray::~VertexArray()
 {
+    GLStateCache::current().vertex_array_deleted( m_array );
     glDeleteVertexArrays( 1, &m_array );
 }
 
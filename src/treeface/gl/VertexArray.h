@@ -4,6 +4,7 @@
 #include "treeface/base/Common.h"
 
 #include "treeface/gl/GLBuffer.h"
+#include "treeface/gl/GLStateCache.h"
 #include "treeface/gl/VertexTemplate.h"
 
 #include <treecore/ArrayRef.h>
@@ -78,7 +79,7 @@ public:
      */
     void bind() const noexcept
     {
-        glBindVertexArray( m_array );
+        GLStateCache::current().bind_vertex_array( m_array );
     }
 
     /**
@@ -86,16 +87,47 @@ public:
      */
     static void unbind() noexcept
     {
-        glBindVertexArray( 0 );
+        GLStateCache::current().bind_vertex_array( 0 );
     }
 
-    bool is_bound() const noexcept { return get_current_bound_vertex_array() == m_array; }
+    bool is_bound() const noexcept { return GLStateCache::current().get_vertex_array() == m_array; }
 
-    void draw( GLPrimitive primitive, GLsizei num_idx ) noexcept
+    ///
+    /// \brief connect per-instance attributes to this vertex array
+    ///
+    /// Attributes are fetched from the buffer once per instance. Attributes
+    /// that the program don't have are ignored.
+    ///
+    /// \param instance_buffer  buffer that stores per-instance data
+    /// \param instance_info    metadata for per-instance data composition
+    /// \param program          instance attribute will be fetched from this
+    ///                         program
+    ///
+    void add_instance_attributes( GLBuffer* instance_buffer,
+                                  const VertexTemplate& instance_info,
+                                  Program* program );
+
+    ///
+    /// \brief draw elements using bound index buffer
+    ///
+    /// \param index_type  type of values in index buffer, either
+    ///                    TFGL_TYPE_UNSIGNED_SHORT or TFGL_TYPE_UNSIGNED_INT
+    ///
+    void draw( GLPrimitive primitive, GLsizei num_idx, GLType index_type = TFGL_TYPE_UNSIGNED_SHORT ) noexcept
+    {
+        treecore_assert( is_bound() );
+        treecore_assert( num_idx >= 0 );
+        treecore_assert( index_type == TFGL_TYPE_UNSIGNED_SHORT || index_type == TFGL_TYPE_UNSIGNED_INT );
+        glDrawElements( primitive, num_idx, index_type, nullptr );
+    }
+
+    void draw_instanced( GLPrimitive primitive, GLsizei num_idx, GLsizei num_instance, GLType index_type = TFGL_TYPE_UNSIGNED_SHORT ) noexcept
     {
         treecore_assert( is_bound() );
         treecore_assert( num_idx >= 0 );
-        glDrawElements( primitive, num_idx, GLTypeEnumHelper<IndexType>::value, nullptr );
+        treecore_assert( num_instance >= 0 );
+        treecore_assert( index_type == TFGL_TYPE_UNSIGNED_SHORT || index_type == TFGL_TYPE_UNSIGNED_INT );
+        glDrawElementsInstanced( primitive, num_idx, index_type, nullptr, num_instance );
     }
 
     GLuint get_gl_handle() const noexcept { return m_array; }
@@ -103,6 +135,7 @@ public:
     const VertexTemplate& get_vertex_template() noexcept { return m_vtx_info; }
     GLBuffer*             get_vertex_buffer()   noexcept { return m_buf_vtx; }
     GLBuffer*             get_index_buffer()    noexcept { return m_buf_idx; }
+    GLBuffer*             get_instance_buffer() noexcept { return m_buf_instance; }
     Program*              get_program()         noexcept { return m_program; }
 
     static GLuint get_current_bound_vertex_array();
@@ -114,6 +147,7 @@ protected:
     const VertexTemplate m_vtx_info;
     treecore::RefCountHolder<GLBuffer> m_buf_vtx;
     treecore::RefCountHolder<GLBuffer> m_buf_idx;
+    treecore::RefCountHolder<GLBuffer> m_buf_instance;
     treecore::RefCountHolder<Program>  m_program;
 };
 
@@ -10,19 +10,25 @@
 namespace treeface
 {
 
-struct HalfEdge
+///
+/// \brief half edge whose vertex and edge indices are stored in IdxT
+///
+template<typename IdxT>
+struct HalfEdgeT
 {
-    IndexType idx_vertex;
-    IndexType idx_prev_edge;
-    IndexType idx_next_edge;
-    IndexType idx_peer_edge;
-
-    const Vec2f&    get_vertex( const Geometry::HostVertexCache& store ) const { return store.get<Vec2f>( idx_vertex ); }
-    const HalfEdge& get_prev( const treecore::Array<HalfEdge>& store ) const   { return store[idx_prev_edge]; }
-    const HalfEdge& get_next( const treecore::Array<HalfEdge>& store ) const   { return store[idx_next_edge]; }
-    const HalfEdge& get_peer( const treecore::Array<HalfEdge>& store ) const   { return store[idx_peer_edge]; }
+    IdxT idx_vertex;
+    IdxT idx_prev_edge;
+    IdxT idx_next_edge;
+    IdxT idx_peer_edge;
+
+    const Vec2f&     get_vertex( const Geometry::HostVertexCache& store ) const { return store.get<Vec2f>( idx_vertex ); }
+    const HalfEdgeT& get_prev( const treecore::Array<HalfEdgeT>& store ) const  { return store[idx_prev_edge]; }
+    const HalfEdgeT& get_next( const treecore::Array<HalfEdgeT>& store ) const  { return store[idx_next_edge]; }
+    const HalfEdgeT& get_peer( const treecore::Array<HalfEdgeT>& store ) const  { return store[idx_peer_edge]; }
 };
 
+typedef HalfEdgeT<IndexType> HalfEdge;
+
 } // namespace treeface
 
 #endif // TREEFACE_HALF_EDGE_H
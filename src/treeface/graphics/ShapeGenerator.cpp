@@ -26,6 +26,17 @@ void ShapeGenerator::clear()
     m_guts->subpaths.clear();
 }
 
+float ShapeGenerator::get_tolerance() const noexcept
+{
+    return m_guts->tolerance;
+}
+
+void ShapeGenerator::set_tolerance( float value ) noexcept
+{
+    treecore_assert( value > 0.0f );
+    m_guts->tolerance = value;
+}
+
 void ShapeGenerator::close_path()
 {
     if (m_guts->subpaths.size() < 2)
@@ -44,14 +55,32 @@ void ShapeGenerator::fill_simple( Geometry* geom )
 
 void ShapeGenerator::fill_simple_preserve( Geometry* geom ) const
 {
-    Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
-    Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+    TessellateScratch scratch;
+    m_guts->fill_geometry( geom, scratch );
+}
 
-    m_guts->triangulate( geom->get_host_vertex_cache(), geom->get_host_index_cache(),
-                         skeleton_min, skeleton_max );
+void ShapeGenerator::fill_simple_aa( float fringe_width, Geometry* geom )
+{
+    fill_simple_aa_preserve( fringe_width, geom );
+    clear();
+}
 
-    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
-    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+void ShapeGenerator::fill_simple_aa_preserve( float fringe_width, Geometry* geom ) const
+{
+    TessellateScratch scratch;
+    m_guts->fill_aa_geometry( fringe_width, geom, scratch );
+}
+
+void ShapeGenerator::fill_complicated( FillRule rule, Geometry* geom )
+{
+    fill_complicated_preserve( rule, geom );
+    clear();
+}
+
+void ShapeGenerator::fill_complicated_preserve( FillRule rule, Geometry* geom ) const
+{
+    TessellateScratch scratch;
+    m_guts->fill_complicated_geometry( rule, geom, scratch );
 }
 
 void ShapeGenerator::stroke_complicated( const StrokeStyle& style, Geometry* geom )
@@ -62,18 +91,8 @@ void ShapeGenerator::stroke_complicated( const StrokeStyle& style, Geometry* geo
 
 void ShapeGenerator::stroke_complicated_preserve( const StrokeStyle& style, Geometry* geom ) const
 {
-    Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
-    Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
-
-    for (const SubPath& path : m_guts->subpaths)
-    {
-        path.stroke_complex( geom->get_host_vertex_cache(), geom->get_host_index_cache(), skeleton_min, skeleton_max, style );
-    }
-
-    // set geometric properties to uniform slots
-    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_LINE_WIDTH,   UniversalValue( float(style.width) ) );
-    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
-    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+    TessellateScratch scratch;
+    m_guts->stroke_geometry( style, geom, scratch );
 }
 
 void ShapeGenerator::line_to( const Vec2f& position )
@@ -173,6 +192,11 @@ Geometry* ShapeGenerator::create_fill_geometry()
     return new Geometry( VERTEX_TEMPLATE_FILL(), TFGL_PRIMITIVE_TRIANGLES, TFGL_BUFFER_DYNAMIC_DRAW );
 }
 
+Geometry* ShapeGenerator::create_fill_aa_geometry()
+{
+    return new Geometry( VERTEX_TEMPLATE_FILL_AA(), TFGL_PRIMITIVE_TRIANGLES, TFGL_BUFFER_DYNAMIC_DRAW );
+}
+
 struct StrokeTemplateHelper: public treecore::RefCountObject, public treecore::RefCountSingleton<StrokeTemplateHelper>
 {
     StrokeTemplateHelper()
@@ -202,6 +226,20 @@ struct FillTemplateHelper: public treecore::RefCountObject, public treecore::Ref
     VertexTemplate value;
 };
 
+struct FillAATemplateHelper: public treecore::RefCountObject, public treecore::RefCountSingleton<FillAATemplateHelper>
+{
+    FillAATemplateHelper()
+    {
+        value.add_attrib( TypedTemplate( "position", 2, TFGL_TYPE_FLOAT ), false, 8 );
+        value.add_attrib( TypedTemplate( "coverage", 1, TFGL_TYPE_FLOAT ), false, 4 );
+        treecore_assert( sizeof(FillAAVertex) == value.vertex_size() );
+    }
+
+    virtual ~FillAATemplateHelper() = default;
+
+    VertexTemplate value;
+};
+
 const VertexTemplate& ShapeGenerator::VERTEX_TEMPLATE_STROKE()
 {
     return StrokeTemplateHelper::getInstance()->value;
@@ -212,4 +250,9 @@ const VertexTemplate& ShapeGenerator::VERTEX_TEMPLATE_FILL()
     return FillTemplateHelper::getInstance()->value;
 }
 
+const VertexTemplate& ShapeGenerator::VERTEX_TEMPLATE_FILL_AA()
+{
+    return FillAATemplateHelper::getInstance()->value;
+}
+
 } // namespace treeface
@@ -11,29 +11,64 @@
 
 class TestFramework;
 
+#define SHAPE_GENERATOR_DEFAULT_TOLERANCE 0.25f
+
 namespace treeface
 {
 
 class Geometry;
+class TessellationCache;
+class Tessellator;
 class VertexTemplate;
 
+///
+/// \brief build paths and convert them into triangles
+///
+/// Each ShapeGenerator holds its own path, so independent instances can be
+/// created and used in different threads. The shared instance from
+/// getInstance() should only be used by one thread. Use Tessellator to
+/// convert many paths at once.
+///
 class ShapeGenerator: public treecore::RefCountObject, public treecore::RefCountSingleton<ShapeGenerator>
 {
     friend class ::TestFramework;
+    friend class TessellationCache;
+    friend class Tessellator;
     friend class treecore::RefCountSingleton<ShapeGenerator>;
 
 public:
     TREECORE_DECLARE_NON_COPYABLE( ShapeGenerator );
     TREECORE_DECLARE_NON_MOVABLE( ShapeGenerator );
 
+    ShapeGenerator();
+    virtual ~ShapeGenerator();
+
     void clear();
 
     void close_path();
 
+    ///
+    /// \brief maximum distance between curves and the line segments they are
+    ///        converted to
+    ///
+    /// Tolerance is measured in path coordinate. To get a certain precision
+    /// on screen, divide the desired pixel distance by the scale from path
+    /// coordinate to pixels. Small tolerance gives smoother curves but more
+    /// vertices. Default is SHAPE_GENERATOR_DEFAULT_TOLERANCE.
+    ///
+    float get_tolerance() const noexcept;
+
+    ///
+    /// \brief set tolerance used by later fill and stroke
+    /// \see get_tolerance()
+    ///
+    void set_tolerance( float value ) noexcept;
+
     ///
     /// \brief do simple fill without edge crossing test
     ///
-    /// If shape has self-intersections, fill result could be not correct
+    /// If shape has self-intersections, fill result could be not correct.
+    /// Use fill_complicated() for these shapes.
     ///
     /// \return
     /// \return a new Geometry object containing triangulated result
@@ -45,6 +80,46 @@ public:
     /// \see fill_simple(float)
     void fill_simple_preserve( Geometry* geom ) const;
 
+    ///
+    /// \brief do simple fill, with anti-aliased edges that don't need MSAA
+    ///
+    /// A fringe is added outside of outline, whose "coverage" attribute fades
+    /// from 1 to 0. Shape looks about half fringe width larger than
+    /// fill_simple(). Geometry must be created by create_fill_aa_geometry(),
+    /// and drawn by a vector graphics material with "anti_alias" enabled.
+    ///
+    /// \param fringe_width  width of fringe in path coordinate. To get one
+    ///                      pixel wide fringe, use one divided by the scale
+    ///                      from path coordinate to pixels.
+    /// \param geom          vertices and indices are appended to host cache
+    ///                      of it
+    ///
+    void fill_simple_aa( float fringe_width, Geometry* geom );
+
+    ///
+    /// \brief do anti-aliased simple fill without clearing current path state
+    /// \see fill_simple_aa()
+    ///
+    void fill_simple_aa_preserve( float fringe_width, Geometry* geom ) const;
+
+    ///
+    /// \brief fill shape whose edges may cross each other
+    ///
+    /// Crossing points are added as new vertices, and the area inside by fill
+    /// rule is triangulated. Subpaths are filled together, so overlapped
+    /// subpaths and holes are decided by their winding numbers.
+    ///
+    /// \param rule  how winding number decides inside
+    /// \param geom  vertices and indices are appended to host cache of it
+    ///
+    void fill_complicated( FillRule rule, Geometry* geom );
+
+    ///
+    /// \brief fill by fill rule without clearing current path state
+    /// \see fill_complicated()
+    ///
+    void fill_complicated_preserve( FillRule rule, Geometry* geom ) const;
+
     void stroke_complicated( const StrokeStyle& style, Geometry* geom );
 
     void stroke_complicated_preserve( const StrokeStyle& style, Geometry* geom ) const;
@@ -64,14 +139,13 @@ public:
     static Geometry* create_simple_stroke_geometry();
     static Geometry* create_complicated_stroke_geometry();
     static Geometry* create_fill_geometry();
+    static Geometry* create_fill_aa_geometry();
 
     static const VertexTemplate& VERTEX_TEMPLATE_STROKE();
     static const VertexTemplate& VERTEX_TEMPLATE_FILL();
+    static const VertexTemplate& VERTEX_TEMPLATE_FILL_AA();
 
 private:
-    ShapeGenerator();
-    virtual ~ShapeGenerator();
-
     struct Guts;
     Guts* m_guts;
 };
@@ -0,0 +1,250 @@
+#include "treeface/graphics/StrokeStream.h"
+
+#include "treeface/graphics/VectorGraphicsMaterial.h"
+#include "treeface/graphics/guts/LineStroker.h"
+#include "treeface/graphics/guts/Utils.h"
+#include "treeface/misc/UniversalValue.h"
+#include "treeface/scene/Geometry.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace treecore;
+
+namespace treeface
+{
+
+struct StrokeStream::Guts
+{
+    Guts( Geometry* geom, const StrokeStyle& style )
+        : geom( geom )
+        , style( style )
+        , stroker( style )
+        , preview( style )
+    {}
+
+    void end_stroke( LineStroker& target );
+    void flush( LineStroker& target, bool stroke_done );
+    void drop_preview();
+
+    int32 get_num_index() const noexcept
+    {
+        return geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT
+               ? geom->get_host_index_cache_32().size()
+               : geom->get_host_index_cache().size();
+    }
+
+    void note_modified( int32 vtx_begin, int32 idx_begin ) noexcept
+    {
+        modified_vtx = std::min( modified_vtx, vtx_begin );
+        modified_idx = std::min( modified_idx, idx_begin );
+    }
+
+    Geometry*   geom;
+    StrokeStyle style;
+    LineStroker stroker;
+    LineStroker preview; // copy of stroker that is ended at current point
+
+    bool  in_path   = false;
+    bool  closed    = false;
+    int   num_point = 0;
+    Vec2f first;
+    Vec2f last;
+    Vec2f v_begin;
+    Vec2f v_prev;
+
+    Vec2f skeleton_min = Vec2f( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skeleton_max = Vec2f( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+
+    // where preview is appended in geometry, negative if there's no preview
+    int32 preview_vtx = -1;
+    int32 preview_idx = -1;
+
+    // first vertex and index modified since last take_modified_begin()
+    int32 modified_vtx = std::numeric_limits<int32>::max();
+    int32 modified_idx = std::numeric_limits<int32>::max();
+};
+
+void StrokeStream::Guts::end_stroke( LineStroker& target )
+{
+    if (closed)
+    {
+        if (last != first)
+        {
+            target.extend_stroke( v_prev, last, first, true );
+            target.close_stroke_end( last, first, v_begin );
+        }
+        else
+        {
+            Vec2f p_prev_calc = first - v_prev * (target.style.half_width * 4);
+            target.close_stroke_end( p_prev_calc, first, v_begin );
+        }
+    }
+    else
+    {
+        target.cap_end( last, v_prev );
+    }
+}
+
+void StrokeStream::Guts::flush( LineStroker& target, bool stroke_done )
+{
+    drop_preview();
+
+    Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+    int32  num_vtx_old = vertices.size();
+    int32  num_idx_old = get_num_index();
+    GLType type_old    = geom->get_index_type();
+
+    // number of result vertices is not more than outline vertices
+    geom->fit_index_type( vertices.size() + target.get_num_result_vertex() );
+
+    if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+    {
+        if (stroke_done)
+            target.triangulate_rest( vertices, geom->get_host_index_cache_32(), closed );
+        else
+            target.triangulate_final( vertices, geom->get_host_index_cache_32(), closed );
+    }
+    else
+    {
+        if (stroke_done)
+            target.triangulate_rest( vertices, geom->get_host_index_cache(), closed );
+        else
+            target.triangulate_final( vertices, geom->get_host_index_cache(), closed );
+    }
+
+    // all indices are converted if index type is changed
+    note_modified( num_vtx_old, geom->get_index_type() == type_old ? num_idx_old : 0 );
+
+    // so that appended part can be drawn before path ends
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_LINE_WIDTH,   UniversalValue( float(style.width) ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+}
+
+void StrokeStream::Guts::drop_preview()
+{
+    if (preview_vtx < 0)
+        return;
+
+    Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+    treecore_assert( vertices.size() >= preview_vtx );
+    vertices.resize( preview_vtx );
+
+    if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+        geom->get_host_index_cache_32().resize( preview_idx );
+    else
+        geom->get_host_index_cache().resize( preview_idx );
+
+    note_modified( preview_vtx, preview_idx );
+    preview_vtx = -1;
+    preview_idx = -1;
+}
+
+StrokeStream::StrokeStream( Geometry* geom, const StrokeStyle& style ): m_guts( new Guts( geom, style ) )
+{}
+
+StrokeStream::~StrokeStream()
+{
+    if (m_guts)
+        delete m_guts;
+}
+
+void StrokeStream::begin_path( const Vec2f& position, bool closed )
+{
+    end_path();
+
+    m_guts->stroker.reset( m_guts->style );
+    m_guts->in_path   = true;
+    m_guts->closed    = closed;
+    m_guts->num_point = 1;
+    m_guts->first     = position;
+    m_guts->last      = position;
+}
+
+void StrokeStream::line_to( const Vec2f& position )
+{
+    if (!m_guts->in_path)
+    {
+        begin_path( position );
+        return;
+    }
+
+    if (position == m_guts->last)
+        return;
+
+    LineStroker& stroker = m_guts->stroker;
+
+    // first segment, render cap
+    if (m_guts->num_point == 1)
+    {
+        m_guts->v_begin = position - m_guts->first;
+        m_guts->v_begin.normalize();
+        m_guts->v_prev = m_guts->v_begin;
+
+        if (m_guts->closed)
+            stroker.close_stroke_begin( m_guts->first, m_guts->v_begin );
+        else
+            stroker.cap_begin( m_guts->first, m_guts->v_begin );
+
+        update_bound( m_guts->first, m_guts->skeleton_min, m_guts->skeleton_max );
+    }
+
+    m_guts->v_prev = stroker.extend_stroke( m_guts->v_prev, m_guts->last, position, true );
+    update_bound( position, m_guts->skeleton_min, m_guts->skeleton_max );
+
+    m_guts->last = position;
+    m_guts->num_point++;
+
+    if (stroker.get_num_final_vertex() >= STROKE_STREAM_CHUNK)
+        m_guts->flush( stroker, false );
+}
+
+void StrokeStream::end_path()
+{
+    if (!m_guts->in_path)
+        return;
+
+    m_guts->in_path = false;
+
+    // a single point has no direction to be stroked
+    if (m_guts->num_point < 2)
+        return;
+
+    m_guts->end_stroke( m_guts->stroker );
+    m_guts->flush( m_guts->stroker, true );
+}
+
+void StrokeStream::update_preview()
+{
+    m_guts->drop_preview();
+
+    if (!m_guts->in_path || m_guts->num_point < 2)
+        return;
+
+    // only recent joints are kept in stroker, so copying it is cheap
+    m_guts->preview = m_guts->stroker;
+    m_guts->end_stroke( m_guts->preview );
+
+    int32 preview_vtx = m_guts->geom->get_host_vertex_cache().size();
+    int32 preview_idx = m_guts->get_num_index();
+    m_guts->flush( m_guts->preview, true );
+    m_guts->preview_vtx = preview_vtx;
+    m_guts->preview_idx = preview_idx;
+}
+
+void StrokeStream::take_modified_begin( int32& vtx_begin, int32& idx_begin ) noexcept
+{
+    vtx_begin = std::min( m_guts->modified_vtx, m_guts->geom->get_host_vertex_cache().size() );
+    idx_begin = std::min( m_guts->modified_idx, m_guts->get_num_index() );
+
+    m_guts->modified_vtx = std::numeric_limits<int32>::max();
+    m_guts->modified_idx = std::numeric_limits<int32>::max();
+}
+
+int StrokeStream::get_num_pending_vertex() const noexcept
+{
+    return m_guts->in_path ? m_guts->stroker.get_num_result_vertex() : 0;
+}
+
+} // namespace treeface
@@ -0,0 +1,101 @@
+#ifndef TREEFACE_STROKE_STREAM_H
+#define TREEFACE_STROKE_STREAM_H
+
+#include "treeface/graphics/Utils.h"
+#include "treeface/math/Vec2.h"
+
+#include <treecore/ClassUtils.h>
+#include <treecore/IntTypes.h>
+
+namespace treeface
+{
+
+class Geometry;
+
+///
+/// \brief stroke very long polylines point by point
+///
+/// Unlike ShapeGenerator, the whole outline is not kept until stroke ends.
+/// Triangles are appended to host cache of geometry in chunks as soon as
+/// outline vertices on both sides won't be changed by later points, so only
+/// a bounded window of recent joints is kept in memory.
+///
+/// Result is the same as ShapeGenerator::stroke_complicated() on the same
+/// polyline, except that trip attribute is the distance from path begin
+/// instead of being normalized by total length, and that leading vertices of
+/// closed path are appended after all others. Dash pattern of style is not
+/// supported, and lines are always solid.
+///
+/// Geometry should use stroke vertex template. Only host side data is
+/// modified, so caller should upload data after appending points. As
+/// triangles may be appended by any point, geometry must be inside
+/// Geometry::host_draw_begin() while points are added.
+///
+/// For paths that grow by a few points per frame, call update_preview() to
+/// show the whole current path, and pass take_modified_begin() to
+/// Geometry::host_draw_end_tail(), so that only the tail is re-tessellated
+/// and uploaded. Geometry should be dynamic in this case, as preview is
+/// removed from host side data on further changes.
+///
+class StrokeStream
+{
+public:
+    StrokeStream( Geometry* geom, const StrokeStyle& style );
+
+    TREECORE_DECLARE_NON_COPYABLE( StrokeStream );
+    TREECORE_DECLARE_NON_MOVABLE( StrokeStream );
+
+    ~StrokeStream();
+
+    ///
+    /// \brief start a new polyline, current polyline is ended
+    ///
+    /// \param closed  whether last point will be joined back to first point,
+    ///                which must be known before streaming
+    ///
+    void begin_path( const Vec2f& position, bool closed = false );
+
+    ///
+    /// \brief extend current polyline, a new open polyline is started if
+    ///        there is no current one
+    ///
+    void line_to( const Vec2f& position );
+
+    ///
+    /// \brief add end cap or close current polyline, and append all its
+    ///        remaining triangles
+    ///
+    void end_path();
+
+    ///
+    /// \brief number of outline vertices kept in memory, which are not
+    ///        appended to geometry yet
+    ///
+    int get_num_pending_vertex() const noexcept;
+
+    ///
+    /// \brief append triangles of current polyline as if it ends at current
+    ///        point
+    ///
+    /// Only vertices that are not appended yet, which are the last joints
+    /// and the end cap, are tessellated. They are removed from geometry
+    /// before anything else is appended, or on next call of this function.
+    ///
+    void update_preview();
+
+    ///
+    /// \brief get first vertex and index that are modified since last call
+    ///
+    /// Vertices and indices before them are not touched by this stream since
+    /// last call.
+    ///
+    void take_modified_begin( treecore::int32& vtx_begin, treecore::int32& idx_begin ) noexcept;
+
+private:
+    struct Guts;
+    Guts* m_guts = nullptr;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_STROKE_STREAM_H
@@ -0,0 +1,362 @@
+#include "treeface/graphics/TessellationCache.h"
+
+#include "treeface/graphics/VectorGraphicsMaterial.h"
+#include "treeface/graphics/guts/ShapeGenerator_guts.h"
+#include "treeface/misc/UniversalValue.h"
+#include "treeface/scene/Geometry.h"
+
+#include <treecore/HashMap.h>
+
+#include <cstring>
+
+using namespace treecore;
+
+namespace treeface
+{
+
+struct _KeyHasher_
+{
+    int generateHash( uint64 key, int limit ) const noexcept
+    {
+        return int( key % uint64( limit ) );
+    }
+};
+
+///
+/// \brief one cached result, also a node of LRU list
+///
+struct TessellationCacheEntry
+{
+    TessellationCacheEntry( int32 vertex_size ): vertices( vertex_size ) {}
+
+    uint64        hash;
+    Array<uint32> key;
+
+    Geometry::HostVertexCache vertices;
+    GLType           index_type;
+    Array<IndexType> indices_16;
+    Array<uint32>    indices_32;
+    UniversalValue   skeleton_min;
+    UniversalValue   skeleton_max;
+
+    size_t num_byte = 0;
+
+    TessellationCacheEntry* lru_prev = nullptr;
+    TessellationCacheEntry* lru_next = nullptr;
+};
+
+typedef HashMap<uint64, TessellationCacheEntry*, _KeyHasher_> EntryMap;
+
+inline void _key_add_( Array<uint32>& key, float value )
+{
+    uint32 bits;
+    memcpy( &bits, &value, sizeof(bits) );
+    key.add( bits );
+}
+
+inline void _key_add_( Array<uint32>& key, const Vec2f& value )
+{
+    _key_add_( key, value.x );
+    _key_add_( key, value.y );
+}
+
+///
+/// \brief serialize everything that affects tessellation result
+///
+/// Only meaningful fields of each glyph are used, as unused part of glyph
+/// union is not initialized.
+///
+/// \param style  nullptr for fill
+///
+static void _build_key_( const Array<SubPath>& subpaths, float tolerance, const StrokeStyle* style, Array<uint32>& key )
+{
+    key.clearQuick();
+    key.add( uint32( style != nullptr ) );
+    _key_add_( key, tolerance );
+
+    if (style != nullptr)
+    {
+        key.add( uint32( style->cap ) );
+        key.add( uint32( style->join ) );
+        _key_add_( key, style->miter_cutoff );
+        _key_add_( key, style->width );
+
+        // dash pattern is only added when used, so keys of solid strokes
+        // don't depend on its unused fields
+        int num_dash = style->dash != nullptr ? style->num_dash : 0;
+        key.add( uint32( num_dash ) );
+        if (num_dash > 0)
+        {
+            for (int i = 0; i < num_dash; i++)
+                _key_add_( key, style->dash[i] );
+            _key_add_( key, style->dash_offset );
+        }
+    }
+
+    key.add( uint32( subpaths.size() ) );
+
+    for (const SubPath& subpath : subpaths)
+    {
+        key.add( uint32( subpath.closed ) );
+        key.add( uint32( subpath.glyphs.size() ) );
+
+        for (const PathGlyph& glyph : subpath.glyphs)
+        {
+            key.add( uint32( glyph.type ) );
+            _key_add_( key, glyph.end );
+
+            switch (glyph.type)
+            {
+            case GLYPH_TYPE_ARC:
+                _key_add_( key, glyph.arc.center_x );
+                _key_add_( key, glyph.arc.center_y );
+                _key_add_( key, glyph.arc.angle );
+                key.add( uint32( glyph.arc.is_cclw ) );
+                break;
+            case GLYPH_TYPE_BESSEL3:
+                _key_add_( key, glyph.bessel3.ctrl_x );
+                _key_add_( key, glyph.bessel3.ctrl_y );
+                break;
+            case GLYPH_TYPE_BESSEL4:
+                _key_add_( key, glyph.bessel4.ctrl1_x );
+                _key_add_( key, glyph.bessel4.ctrl1_y );
+                _key_add_( key, glyph.bessel4.ctrl2_x );
+                _key_add_( key, glyph.bessel4.ctrl2_y );
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+// 64-bit FNV-1a
+static uint64 _hash_key_( const Array<uint32>& key )
+{
+    uint64 result = 14695981039346656037ULL;
+    for (uint32 word : key)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            result ^= (word >> (i * 8) ) & 0xff;
+            result *= 1099511628211ULL;
+        }
+    }
+    return result;
+}
+
+struct TessellationCache::Guts
+{
+    size_t byte_budget = 0;
+    size_t num_byte    = 0;
+    int64  num_hit     = 0;
+    int64  num_miss    = 0;
+
+    EntryMap entries;
+
+    // most recently used at head
+    TessellationCacheEntry* lru_head = nullptr;
+    TessellationCacheEntry* lru_tail = nullptr;
+
+    TessellateScratch scratch;
+    Array<uint32>     key;
+
+    ~Guts()
+    {
+        clear();
+    }
+
+    void lru_unlink( TessellationCacheEntry* entry ) noexcept
+    {
+        if (entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+        else lru_head = entry->lru_next;
+
+        if (entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+        else lru_tail = entry->lru_prev;
+
+        entry->lru_prev = nullptr;
+        entry->lru_next = nullptr;
+    }
+
+    void lru_push_head( TessellationCacheEntry* entry ) noexcept
+    {
+        entry->lru_prev = nullptr;
+        entry->lru_next = lru_head;
+        if (lru_head) lru_head->lru_prev = entry;
+        else lru_tail = entry;
+        lru_head = entry;
+    }
+
+    void remove( TessellationCacheEntry* entry )
+    {
+        lru_unlink( entry );
+        entries.remove( entry->hash );
+        num_byte -= entry->num_byte;
+        delete entry;
+    }
+
+    void shrink_to( size_t budget )
+    {
+        while (num_byte > budget && lru_tail != nullptr)
+            remove( lru_tail );
+    }
+
+    void clear()
+    {
+        while (lru_tail != nullptr)
+            remove( lru_tail );
+        treecore_assert( num_byte == 0 );
+    }
+};
+
+void TessellationCache::run( const ShapeGenerator& path, const StrokeStyle* style, Geometry* geom )
+{
+    Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+    treecore_assert( vertices.size() == 0 );
+
+    Array<uint32>& key = m_guts->key;
+    _build_key_( path.m_guts->subpaths, path.m_guts->tolerance, style, key );
+    uint64 hash = _hash_key_( key );
+
+    //
+    // copy stored result on hit
+    //
+    {
+        EntryMap::Iterator it( m_guts->entries );
+        if ( m_guts->entries.select( hash, it ) && it.value()->key == key )
+        {
+            TessellationCacheEntry* entry = it.value();
+            m_guts->num_hit++;
+
+            vertices = entry->vertices;
+            geom->set_index_type( entry->index_type );
+            if (entry->index_type == TFGL_TYPE_UNSIGNED_INT)
+                geom->get_host_index_cache_32() = entry->indices_32;
+            else
+                geom->get_host_index_cache() = entry->indices_16;
+            geom->mark_dirty();
+
+            if (style != nullptr)
+                geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_LINE_WIDTH, UniversalValue( float(style->width) ) );
+            geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, entry->skeleton_min );
+            geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, entry->skeleton_max );
+
+            m_guts->lru_unlink( entry );
+            m_guts->lru_push_head( entry );
+            return;
+        }
+    }
+
+    //
+    // do tessellation, and store its result
+    //
+    m_guts->num_miss++;
+
+    if (style != nullptr)
+        path.m_guts->stroke_geometry( *style, geom, m_guts->scratch );
+    else
+        path.m_guts->fill_geometry( geom, m_guts->scratch );
+
+    TessellationCacheEntry* entry = new TessellationCacheEntry( vertices.block_size() );
+    entry->hash       = hash;
+    entry->key        = key;
+    entry->vertices   = vertices;
+    entry->index_type = geom->get_index_type();
+    if (entry->index_type == TFGL_TYPE_UNSIGNED_INT)
+        entry->indices_32 = geom->get_host_index_cache_32();
+    else
+        entry->indices_16 = geom->get_host_index_cache();
+    geom->get_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, entry->skeleton_min );
+    geom->get_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, entry->skeleton_max );
+
+    entry->num_byte = sizeof(TessellationCacheEntry)
+                      + size_t( key.size() ) * sizeof(uint32)
+                      + size_t( vertices.num_byte() )
+                      + size_t( entry->indices_16.size() ) * sizeof(IndexType)
+                      + size_t( entry->indices_32.size() ) * sizeof(uint32);
+
+    // result that can never fit is not stored
+    if (entry->num_byte > m_guts->byte_budget)
+    {
+        delete entry;
+        return;
+    }
+
+    // same hash with different content, drop the old one
+    {
+        EntryMap::Iterator it( m_guts->entries );
+        if ( m_guts->entries.select( hash, it ) )
+            m_guts->remove( it.value() );
+    }
+
+    m_guts->shrink_to( m_guts->byte_budget - entry->num_byte );
+
+    m_guts->entries.set( hash, entry );
+    m_guts->lru_push_head( entry );
+    m_guts->num_byte += entry->num_byte;
+}
+
+TessellationCache::TessellationCache( size_t byte_budget ): m_guts( new Guts() )
+{
+    m_guts->byte_budget = byte_budget;
+}
+
+TessellationCache::~TessellationCache()
+{
+    if (m_guts)
+        delete m_guts;
+}
+
+void TessellationCache::fill_simple( const ShapeGenerator& path, Geometry* geom )
+{
+    run( path, nullptr, geom );
+}
+
+void TessellationCache::stroke_complicated( const ShapeGenerator& path, const StrokeStyle& style, Geometry* geom )
+{
+    run( path, &style, geom );
+}
+
+void TessellationCache::clear()
+{
+    m_guts->clear();
+}
+
+size_t TessellationCache::get_byte_budget() const noexcept
+{
+    return m_guts->byte_budget;
+}
+
+void TessellationCache::set_byte_budget( size_t value )
+{
+    m_guts->byte_budget = value;
+    m_guts->shrink_to( value );
+}
+
+size_t TessellationCache::get_num_byte() const noexcept
+{
+    return m_guts->num_byte;
+}
+
+int32 TessellationCache::get_num_entry() const noexcept
+{
+    return m_guts->entries.size();
+}
+
+int64 TessellationCache::get_num_hit() const noexcept
+{
+    return m_guts->num_hit;
+}
+
+int64 TessellationCache::get_num_miss() const noexcept
+{
+    return m_guts->num_miss;
+}
+
+void TessellationCache::reset_counters() noexcept
+{
+    m_guts->num_hit  = 0;
+    m_guts->num_miss = 0;
+}
+
+} // namespace treeface
@@ -0,0 +1,89 @@
+#ifndef TREEFACE_TESSELLATION_CACHE_H
+#define TREEFACE_TESSELLATION_CACHE_H
+
+#include "treeface/graphics/Utils.h"
+
+#include <treecore/ClassUtils.h>
+#include <treecore/IntTypes.h>
+
+#define TESSELLATION_CACHE_DEFAULT_BUDGET (16 * 1024 * 1024)
+
+namespace treeface
+{
+
+class Geometry;
+class ShapeGenerator;
+
+///
+/// \brief keep fill and stroke results of paths, so that same path with same
+///        style is not tessellated again
+///
+/// Results are looked up by path content, tolerance and stroke style. On hit,
+/// stored vertices, indices and skeleton bounds are copied into target
+/// geometry. Least recently used results are dropped when total size of
+/// results goes beyond byte budget.
+///
+/// Target geometry should have empty host caches, as is required by
+/// ShapeGenerator, and its host caches are written directly, so it must be
+/// inside host_draw_begin() and host_draw_end(). The cache is not thread
+/// safe.
+///
+class TessellationCache
+{
+public:
+    TessellationCache( size_t byte_budget = TESSELLATION_CACHE_DEFAULT_BUDGET );
+
+    TREECORE_DECLARE_NON_COPYABLE( TessellationCache );
+    TREECORE_DECLARE_NON_MOVABLE( TessellationCache );
+
+    ~TessellationCache();
+
+    ///
+    /// \brief same as ShapeGenerator::fill_simple_preserve(), using cached
+    ///        result if possible
+    ///
+    void fill_simple( const ShapeGenerator& path, Geometry* geom );
+
+    ///
+    /// \brief same as ShapeGenerator::stroke_complicated_preserve(), using
+    ///        cached result if possible
+    ///
+    void stroke_complicated( const ShapeGenerator& path, const StrokeStyle& style, Geometry* geom );
+
+    ///
+    /// \brief drop all results, counters are not changed
+    ///
+    void clear();
+
+    size_t get_byte_budget() const noexcept;
+
+    ///
+    /// \brief change byte budget, and drop results beyond it
+    ///
+    void set_byte_budget( size_t value );
+
+    ///
+    /// \brief approximate memory used by all stored results
+    ///
+    size_t get_num_byte() const noexcept;
+
+    treecore::int32 get_num_entry() const noexcept;
+
+    treecore::int64 get_num_hit() const noexcept;
+    treecore::int64 get_num_miss() const noexcept;
+
+    void reset_counters() noexcept;
+
+private:
+    ///
+    /// \param style  nullptr for fill
+    ///
+    void run( const ShapeGenerator& path, const StrokeStyle* style, Geometry* geom );
+
+    struct Guts;
+    Guts* m_guts = nullptr;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_TESSELLATION_CACHE_H
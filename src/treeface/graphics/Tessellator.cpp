@@ -0,0 +1,62 @@
+#include "treeface/graphics/Tessellator.h"
+
+#include "treeface/graphics/guts/ShapeGenerator_guts.h"
+#include "treeface/misc/WorkerPool.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace treecore;
+
+namespace treeface
+{
+
+struct Tessellator::Guts
+{
+    WorkerPool* pool = nullptr;
+
+    // one for each thread of pool
+    std::vector<TessellateScratch> scratches;
+};
+
+Tessellator::Tessellator( WorkerPool* pool ): m_guts( new Guts() )
+{
+    m_guts->pool = pool;
+    m_guts->scratches.resize( pool ? pool->get_num_threads() : 1 );
+}
+
+Tessellator::~Tessellator()
+{
+    if (m_guts)
+        delete m_guts;
+}
+
+void Tessellator::run( const Job* jobs, int num_jobs )
+{
+    // one task for each scratch, and each task takes jobs one by one until
+    // all jobs are taken, so that scratches are never shared
+    int num_tasks = int( m_guts->scratches.size() );
+    if (num_tasks > num_jobs)
+        num_tasks = num_jobs;
+
+    std::atomic<int> next_job( 0 );
+
+    parallel_for( m_guts->pool, num_tasks, [&]( int i_task ) {
+        TessellateScratch& scratch = m_guts->scratches[i_task];
+
+        for (;;)
+        {
+            int i_job = next_job.fetch_add( 1 );
+            if (i_job >= num_jobs)
+                break;
+
+            const Job& job = jobs[i_job];
+            if (job.is_stroke)
+                job.path->m_guts->stroke_geometry( job.style, job.geom, scratch );
+            else
+                job.path->m_guts->fill_geometry( job.geom, scratch );
+        }
+    } );
+}
+
+} // namespace treeface
@@ -0,0 +1,63 @@
+#ifndef TREEFACE_TESSELLATOR_H
+#define TREEFACE_TESSELLATOR_H
+
+#include "treeface/graphics/Utils.h"
+
+#include <treecore/ClassUtils.h>
+
+namespace treeface
+{
+
+class Geometry;
+class ShapeGenerator;
+class WorkerPool;
+
+///
+/// \brief convert many paths into geometries in one call
+///
+/// Jobs are shared among threads of a worker pool. Each thread keeps its own
+/// intermediate storage, which is reused by all jobs it takes, and is kept
+/// for later runs.
+///
+/// Only host side data of geometries are modified, so geometries don't need
+/// a GL context in worker threads. Geometries should be different for each
+/// job, and should not be drawn while tessellating.
+///
+class Tessellator
+{
+public:
+    struct Job
+    {
+        const ShapeGenerator* path;
+        Geometry*             geom;
+        bool                  is_stroke; ///< do fill_simple if false, stroke_complicated if true
+        StrokeStyle           style;     ///< only used by stroke
+    };
+
+    ///
+    /// \param pool  worker pool, or nullptr to run in calling thread
+    ///
+    Tessellator( WorkerPool* pool = nullptr );
+
+    TREECORE_DECLARE_NON_COPYABLE( Tessellator );
+    TREECORE_DECLARE_NON_MOVABLE( Tessellator );
+
+    ~Tessellator();
+
+    ///
+    /// \brief run all jobs and wait until they are finished
+    ///
+    /// Result of each job is the same as calling fill_simple_preserve() or
+    /// stroke_complicated_preserve() on its path. Like those calls, geometry
+    /// of every job must be inside host_draw_begin() and host_draw_end().
+    ///
+    void run( const Job* jobs, int num_jobs );
+
+private:
+    struct Guts;
+    Guts* m_guts = nullptr;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_TESSELLATOR_H
@@ -15,12 +15,36 @@ struct StrokeVertex
     float side;
 };
 
+///
+/// \brief vertex of anti-aliased fill
+///
+/// Vertices on outline and inside have coverage of 1. Fringe vertices out of
+/// outline have coverage of 0, so that interpolated coverage fades out the
+/// edge.
+///
+struct FillAAVertex
+{
+    Vec2f position;
+    float coverage;
+};
+
 struct StrokeStyle
 {
     LineCap  cap;
     LineJoin join;
     float    miter_cutoff;
     float    width;
+
+    ///
+    /// \brief lengths of alternating dashes and gaps, beginning with a dash
+    ///
+    /// If number of lengths is odd, they are repeated once to make it even.
+    /// Line is solid if this is nullptr, or if all lengths are zero. Lengths
+    /// are not copied, so they must be kept valid while stroking.
+    ///
+    const float* dash;
+    int          num_dash;
+    float        dash_offset; ///< distance into dash pattern where each subpath begins
 };
 
 inline bool vec_are_cclw( const Vec2f& v1, const Vec2f& v2, const Vec2f& v3 )
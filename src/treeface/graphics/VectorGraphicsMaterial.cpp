@@ -19,11 +19,22 @@ VectorGraphicsMaterial::~VectorGraphicsMaterial() {}
 
 treecore::String VectorGraphicsMaterial::get_shader_source_addition() const noexcept
 {
-    return SceneGraphMaterial::get_shader_source_addition() + String(
+    String result = SceneGraphMaterial::get_shader_source_addition() + String(
         "uniform highp float " UNI_NAME_LINE_WIDTH ";\n"
         "uniform highp vec2 " UNI_NAME_SKLT_MIN ";\n"
         "uniform highp vec2 " UNI_NAME_SKLT_MAX ";\n"
         "\n" );
+
+    // helpers are macros rather than functions, as fwidth() is not available
+    // in vertex shader that shares same addition
+    if (m_anti_alias)
+        result += String(
+            "#define TREEFACE_ANTI_ALIAS 1\n"
+            "#define TREEFACE_FILL_COVERAGE(coverage) clamp((coverage), 0.0, 1.0)\n"
+            "#define TREEFACE_STROKE_COVERAGE(side) clamp(0.5 + min((side), 1.0 - (side)) / max(fwidth(side), 1.0e-5), 0.0, 1.0)\n"
+            "\n" );
+
+    return result;
 }
 
 } // namespace treeface
@@ -8,6 +8,8 @@ namespace treeface
 
 class VectorGraphicsMaterial: public SceneGraphMaterial
 {
+    friend class MaterialManager;
+
 public:
     static const treecore::Identifier UNIFORM_LINE_WIDTH;
     static const treecore::Identifier UNIFORM_SKELETON_MIN;
@@ -16,8 +18,32 @@ public:
     VectorGraphicsMaterial();
     virtual ~VectorGraphicsMaterial();
 
+    ///
+    /// \brief whether shaders are built with anti-alias helpers
+    ///
+    /// If true, TREEFACE_ANTI_ALIAS is defined in shader source, along with
+    /// these macros that give coverage to be multiplied to output alpha:
+    ///
+    /// - TREEFACE_FILL_COVERAGE(coverage): for "coverage" attribute of
+    ///   ShapeGenerator::VERTEX_TEMPLATE_FILL_AA() that is passed to
+    ///   fragment shader.
+    /// - TREEFACE_STROKE_COVERAGE(side): for "side" attribute of
+    ///   ShapeGenerator::VERTEX_TEMPLATE_STROKE() that is passed to fragment
+    ///   shader. Edges are faded by screen-space derivative of side, which is
+    ///   exact along straight parts, and approximate at caps and joins.
+    ///
+    /// Both can only be used in fragment shader. Material should also be
+    /// translucent, so that faded edges are blended.
+    ///
+    bool uses_anti_alias() const noexcept
+    {
+        return m_anti_alias;
+    }
+
 protected:
     treecore::String get_shader_source_addition() const noexcept override;
+
+    bool m_anti_alias = false;
 };
 
 } // namespace treeface
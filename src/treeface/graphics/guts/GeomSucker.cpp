@@ -17,8 +17,7 @@ using namespace treecore;
 namespace treeface
 {
 
-GeomSucker::GeomSucker( const HalfEdgeNetwork& network, const treecore::String& title )
-    : network( network )
+void GeomSucker::init( const treecore::String& title )
 {
     // get X and Y boundary
     float x_min = std::numeric_limits<float>::max();
@@ -26,9 +25,9 @@ GeomSucker::GeomSucker( const HalfEdgeNetwork& network, const treecore::String&
     float x_max = std::numeric_limits<float>::min();
     float y_max = std::numeric_limits<float>::min();
 
-    for (int i = 0; i < network.vertices.size(); i++)
+    for (int i = 0; i < vertices.size(); i++)
     {
-        const Vec2f& vtx = network.vertices.get<Vec2f>( i );
+        const Vec2f& vtx = vertices.get<Vec2f>( i );
         if (x_min > vtx.x) x_min = vtx.x;
         if (y_min > vtx.y) y_min = vtx.y;
         if (x_max < vtx.x) x_max = vtx.x;
@@ -82,10 +81,10 @@ GeomSucker::GeomSucker( const HalfEdgeNetwork& network, const treecore::String&
         cairo_set_line_width( context, line_w );
 
         Array<bool> rendered;
-        rendered.resize( network.edges.size() );
-        for (int i = 0; i < network.edges.size(); i++) rendered[i] = false;
+        rendered.resize( edges.size() );
+        for (int i = 0; i < edges.size(); i++) rendered[i] = false;
 
-        for (int i_begin = 0; i_begin < network.edges.size(); i_begin++)
+        for (int i_begin = 0; i_begin < edges.size(); i_begin++)
         {
             if (rendered[i_begin]) continue;
 
@@ -93,9 +92,9 @@ GeomSucker::GeomSucker( const HalfEdgeNetwork& network, const treecore::String&
 
             for (int i_edge = i_begin;; )
             {
-                const HalfEdge& edge = network.edges[i_edge];
+                const HalfEdgeT<uint32>& edge = edges[i_edge];
 
-                const Vec2f& vtx = edge.get_vertex( network.vertices );
+                const Vec2f& vtx = edge.get_vertex( vertices );
                 cairo_line_to( context, vtx.x, -vtx.y );
                 rendered[i_edge] = true;
 
@@ -128,9 +127,9 @@ GeomSucker::~GeomSucker()
         cairo_surface_destroy( surface );
 }
 
-void GeomSucker::draw_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_vtx( uint32 vtx_idx ) const
 {
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     draw_vtx( vtx );
 }
 
@@ -170,7 +169,7 @@ void GeomSucker::draw_vector( const Vec2f& start, const Vec2f& end ) const
     cairo_restore( context );
 }
 
-void GeomSucker::draw_roled_vtx( IndexType vtx_idx, VertexRole role ) const
+void GeomSucker::draw_roled_vtx( uint32 vtx_idx, VertexRole role ) const
 {
     switch (role)
     {
@@ -184,9 +183,9 @@ void GeomSucker::draw_roled_vtx( IndexType vtx_idx, VertexRole role ) const
     }
 }
 
-void GeomSucker::draw_merge_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_merge_vtx( uint32 vtx_idx ) const
 {
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     Vec2f        p1  = vtx - Vec2f( 0.0f, line_w * 2 );
     Vec2f        p2  = vtx + Vec2f( line_w * 2, line_w * 2 );
     Vec2f        p3  = vtx + Vec2f( -line_w * 2, line_w * 2 );
@@ -197,9 +196,9 @@ void GeomSucker::draw_merge_vtx( IndexType vtx_idx ) const
     cairo_fill( context );
 }
 
-void GeomSucker::draw_split_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_split_vtx( uint32 vtx_idx ) const
 {
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     Vec2f        p1  = vtx + Vec2f( 0.0f, line_w * 2 );
     Vec2f        p2  = vtx + Vec2f( line_w * 2, -line_w * 2 );
     Vec2f        p3  = vtx + Vec2f( -line_w * 2, -line_w * 2 );
@@ -210,9 +209,9 @@ void GeomSucker::draw_split_vtx( IndexType vtx_idx ) const
     cairo_fill( context );
 }
 
-void GeomSucker::draw_start_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_start_vtx( uint32 vtx_idx ) const
 {
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     Vec2f        p1  = vtx + Vec2f( line_w * 1.5, line_w * 1.5 );
     Vec2f        p2  = vtx + Vec2f( -line_w * 1.5, line_w * 1.5 );
     Vec2f        p3  = vtx + Vec2f( -line_w * 1.5, -line_w * 1.5 );
@@ -226,9 +225,9 @@ void GeomSucker::draw_start_vtx( IndexType vtx_idx ) const
     cairo_stroke( context );
 }
 
-void GeomSucker::draw_end_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_end_vtx( uint32 vtx_idx ) const
 {
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     Vec2f        p1  = vtx + Vec2f( line_w * 1.5, line_w * 1.5 );
     Vec2f        p2  = vtx + Vec2f( -line_w * 1.5, line_w * 1.5 );
     Vec2f        p3  = vtx + Vec2f( -line_w * 1.5, -line_w * 1.5 );
@@ -241,35 +240,35 @@ void GeomSucker::draw_end_vtx( IndexType vtx_idx ) const
     cairo_fill( context );
 }
 
-void GeomSucker::draw_regular_left_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_regular_left_vtx( uint32 vtx_idx ) const
 {
     draw_vtx( vtx_idx );
 
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     cairo_new_path( context );
     cairo_move_to( context, vtx.x - line_w * 2, -vtx.y - line_w * 5 );
     cairo_line_to( context, vtx.x - line_w * 2, -vtx.y + line_w * 5 );
     cairo_stroke( context );
 }
 
-void GeomSucker::draw_regular_right_vtx( IndexType vtx_idx ) const
+void GeomSucker::draw_regular_right_vtx( uint32 vtx_idx ) const
 {
     draw_vtx( vtx_idx );
 
-    const Vec2f& vtx = network.vertices.get<Vec2f>( vtx_idx );
+    const Vec2f& vtx = vertices.get<Vec2f>( vtx_idx );
     cairo_new_path( context );
     cairo_move_to( context, vtx.x + line_w * 2, -vtx.y - line_w * 5 );
     cairo_line_to( context, vtx.x + line_w * 2, -vtx.y + line_w * 5 );
     cairo_stroke( context );
 }
 
-void GeomSucker::draw_edge( const IndexType i_edge, float offset_rate ) const
+void GeomSucker::draw_edge( const uint32 i_edge, float offset_rate ) const
 {
-    const HalfEdge& edge    = network.edges[i_edge];
-    const Vec2f&    p_start = edge.get_vertex( network.vertices );
-    const Vec2f&    p_end   = edge.get_next( network.edges ).get_vertex( network.vertices );
-    const Vec2f&    p_prev  = edge.get_prev( network.edges ).get_vertex( network.vertices );
-    const Vec2f&    p_next  = edge.get_next( network.edges ).get_next( network.edges ).get_vertex( network.vertices );
+    const HalfEdgeT<uint32>& edge    = edges[i_edge];
+    const Vec2f&             p_start = edge.get_vertex( vertices );
+    const Vec2f&             p_end   = edge.get_next( edges ).get_vertex( vertices );
+    const Vec2f&             p_prev  = edge.get_prev( edges ).get_vertex( vertices );
+    const Vec2f&             p_next  = edge.get_next( edges ).get_next( edges ).get_vertex( vertices );
 
     Vec2f v_prev = p_start - p_prev;
     Vec2f v_curr = p_end - p_start;
@@ -313,22 +312,11 @@ void GeomSucker::draw_edge( const IndexType i_edge, float offset_rate ) const
     draw_vtx( edge.idx_vertex );
 }
 
-void GeomSucker::draw_edge_stack( const treecore::Array<IndexType>& edges ) const
+void GeomSucker::draw_trig_by_edge( uint32 i_edge1, uint32 i_edge2, uint32 i_edge3 ) const
 {
-    cairo_save( context );
-    cairo_set_source_rgba( context, SUCKER_BLACK, 0.3 );
-    for (IndexType edge_i : edges)
-    {
-        draw_edge( edge_i );
-    }
-    cairo_restore( context );
-}
-
-void GeomSucker::draw_trig_by_edge( IndexType i_edge1, IndexType i_edge2, IndexType i_edge3 ) const
-{
-    const Vec2f& p1 = network.get_edge_vertex( i_edge1 );
-    const Vec2f& p2 = network.get_edge_vertex( i_edge2 );
-    const Vec2f& p3 = network.get_edge_vertex( i_edge3 );
+    const Vec2f& p1 = edges[i_edge1].get_vertex( vertices );
+    const Vec2f& p2 = edges[i_edge2].get_vertex( vertices );
+    const Vec2f& p3 = edges[i_edge3].get_vertex( vertices );
 
     cairo_new_path( context );
     cairo_move_to( context, p1.x, -p1.y );
@@ -337,7 +325,7 @@ void GeomSucker::draw_trig_by_edge( IndexType i_edge1, IndexType i_edge2, IndexT
     cairo_fill( context );
 }
 
-void GeomSucker::draw_helper( IndexType i_edge, IndexType i_helper ) const
+void GeomSucker::draw_helper( uint32 i_edge, uint32 i_helper ) const
 {
     cairo_save( context );
 
@@ -349,7 +337,7 @@ void GeomSucker::draw_helper( IndexType i_edge, IndexType i_helper ) const
     cairo_restore( context );
 }
 
-void GeomSucker::draw_helper_change( IndexType i_edge, IndexType i_helper_old, IndexType i_helper_new ) const
+void GeomSucker::draw_helper_change( uint32 i_edge, uint32 i_helper_old, uint32 i_helper_new ) const
 {
     cairo_save( context );
 
@@ -371,9 +359,9 @@ void GeomSucker::text( const treecore::String& text, const Vec2f& position ) con
     cairo_show_text( context, text.toRawUTF8() );
 }
 
-void GeomSucker::text( const treecore::String& text, IndexType i_vtx ) const
+void GeomSucker::text( const treecore::String& text, uint32 i_vtx ) const
 {
-    this->text( text, network.vertices.get<Vec2f>( i_vtx ) );
+    this->text( text, vertices.get<Vec2f>( i_vtx ) );
 }
 
 OutlineSucker::OutlineSucker( const HalfOutline&      outline,
@@ -10,6 +10,7 @@
 
 #    include "treeface/gl/TypeUtils.h"
 #    include "treeface/math/Vec2.h"
+#    include "treeface/graphics/HalfEdge.h"
 #    include "treeface/graphics/guts/Enums.h"
 
 #    define SUCKER_RED      1.0f, 0.0f, 0.0f
@@ -25,15 +26,33 @@
 namespace treeface
 {
 
-struct HalfEdgeNetwork;
+template<typename IdxT>
+struct HalfEdgeNetworkT;
 struct HalfOutline;
 
 struct GeomSucker
 {
-    GeomSucker( const HalfEdgeNetwork&  network,
-                const treecore::String& title = treecore::String::empty );
+    // edges are copied with 32-bit index, so that networks of any index type
+    // can be drawn
+    template<typename IdxT>
+    GeomSucker( const HalfEdgeNetworkT<IdxT>& network,
+                const treecore::String&       title = treecore::String::empty )
+        : vertices( network.vertices )
+    {
+        edges.resize( network.edges.size() );
+        for (int i = 0; i < edges.size(); i++)
+        {
+            const HalfEdgeT<IdxT>& edge = network.edges[i];
+            edges[i] = { edge.idx_vertex, edge.idx_prev_edge, edge.idx_next_edge, edge.idx_peer_edge };
+        }
+
+        init( title );
+    }
+
     ~GeomSucker();
 
+    void init( const treecore::String& title );
+
     void rgba( float r, float g, float b, float a ) {
         cairo_set_source_rgba( context, r, g, b, a );
     }
@@ -41,30 +60,41 @@ struct GeomSucker
         cairo_set_source_rgb( context, r, g, b );
     }
 
-    void draw_vtx( IndexType vtx_idx ) const;
+    void draw_vtx( treecore::uint32 vtx_idx ) const;
     void draw_vtx( const Vec2f& vtx ) const;
 
     void draw_vector( const Vec2f& start, const Vec2f& end ) const;
 
-    void draw_roled_vtx( IndexType vtx_idx, VertexRole role ) const;
-    void draw_merge_vtx( IndexType vtx_idx ) const;
-    void draw_split_vtx( IndexType vtx_idx ) const;
-    void draw_start_vtx( IndexType vtx_idx ) const;
-    void draw_end_vtx( IndexType vtx_idx ) const;
-    void draw_regular_left_vtx( IndexType vtx_idx ) const;
-    void draw_regular_right_vtx( IndexType vtx_idx ) const;
+    void draw_roled_vtx( treecore::uint32 vtx_idx, VertexRole role ) const;
+    void draw_merge_vtx( treecore::uint32 vtx_idx ) const;
+    void draw_split_vtx( treecore::uint32 vtx_idx ) const;
+    void draw_start_vtx( treecore::uint32 vtx_idx ) const;
+    void draw_end_vtx( treecore::uint32 vtx_idx ) const;
+    void draw_regular_left_vtx( treecore::uint32 vtx_idx ) const;
+    void draw_regular_right_vtx( treecore::uint32 vtx_idx ) const;
+
+    void draw_edge( const treecore::uint32 i_edge, float offset_rate = 1.0f ) const;
+
+    template<typename IdxT>
+    void draw_edge_stack( const treecore::Array<IdxT>& edge_stack ) const
+    {
+        cairo_save( context );
+        cairo_set_source_rgba( context, SUCKER_BLACK, 0.3 );
+        for (IdxT i_edge : edge_stack)
+            draw_edge( i_edge );
+        cairo_restore( context );
+    }
 
-    void draw_edge( const IndexType i_edge, float offset_rate = 1.0f ) const;
-    void draw_edge_stack( const treecore::Array<IndexType>& edges ) const;
-    void draw_trig_by_edge( IndexType i_edge1, IndexType i_edge2, IndexType i_edge3 ) const;
+    void draw_trig_by_edge( treecore::uint32 i_edge1, treecore::uint32 i_edge2, treecore::uint32 i_edge3 ) const;
 
-    void draw_helper( IndexType i_edge, IndexType i_helper ) const;
-    void draw_helper_change( IndexType i_edge, IndexType i_helper_old, IndexType i_helper_new ) const;
+    void draw_helper( treecore::uint32 i_edge, treecore::uint32 i_helper ) const;
+    void draw_helper_change( treecore::uint32 i_edge, treecore::uint32 i_helper_old, treecore::uint32 i_helper_new ) const;
 
     void text( const treecore::String& content, const Vec2f& position ) const;
-    void text( const treecore::String& content, IndexType i_vtx ) const;
+    void text( const treecore::String& content, treecore::uint32 i_vtx ) const;
 
-    const HalfEdgeNetwork& network;
+    const Geometry::HostVertexCache&              vertices;
+    treecore::Array<HalfEdgeT<treecore::uint32> > edges;
 
     float width  = std::numeric_limits<float>::signaling_NaN();
     float height = std::numeric_limits<float>::signaling_NaN();
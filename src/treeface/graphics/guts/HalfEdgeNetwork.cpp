@@ -3,96 +3,112 @@
 #include "treeface/graphics/Utils.h"
 #include "treeface/graphics/guts/Utils.h"
 
+#include "treeface/misc/RadixSort.h"
+#include "treeface/misc/ScratchArena.h"
+
 using namespace treecore;
 
 namespace treeface
 {
 
-struct HalfEdgeIndexVerticalSorter
+///
+/// \brief edge with its sort keys extracted from vertex position and role
+///
+template<typename IdxT>
+struct EdgeOrderItem
 {
-    HalfEdgeIndexVerticalSorter( const Geometry::HostVertexCache&   vertices,
-                                 const treecore::Array<HalfEdge>&   edges,
-                                 const treecore::Array<VertexRole>& edge_roles )
-        : vertices( vertices )
-        , edges( edges )
-        , edge_roles( edge_roles )
-    {}
-
-    int compareElements( IndexType a, IndexType b ) const noexcept
-    {
-        const Vec2f& p1 = vertices.get<Vec2f>( edges[a].idx_vertex );
-        const Vec2f& p2 = vertices.get<Vec2f>( edges[b].idx_vertex );
+    uint64 pos_key;  ///< Y in high half and X in low half, both reversed
+    uint8  role_key; ///< reversed role
+    IdxT   i_edge;
+};
 
-        if (p1.y < p2.y)
-        {
-            return 1;
-        }
-        else if (p1.y == p2.y)
-        {
-            if      (p1.x <  p2.x) return 1;
-            else if (p1.x == p2.x)
-            {
-                VertexRole role1 = edge_roles[a];
-                VertexRole role2 = edge_roles[b];
-                if (role1 < role2)       return 1;
-                else if (role1 == role2) return 0;
-                else                     return -1;
-            }
-            else                   return -1;
-        }
-        else
-        {
-            return -1;
-        }
+template<typename IdxT>
+struct EdgeOrderPosKeyGetter
+{
+    uint64 operator ()( const EdgeOrderItem<IdxT>& item ) const noexcept
+    {
+        return item.pos_key;
     }
+};
 
-    const Geometry::HostVertexCache&   vertices;
-    const treecore::Array<HalfEdge>&   edges;
-    const treecore::Array<VertexRole>& edge_roles;
+///
+/// \brief node of sweep line status tree, which is indexed by edge index
+///
+template<typename IdxT>
+struct SweepTreeNode
+{
+    IdxT   left;
+    IdxT   right;
+    IdxT   parent;
+    uint32 priority;
 };
 
+///
+/// \brief edges that intersect with sweep line, together with their helpers
+///
+/// Edges are kept in a treap ordered from left to right. As edges in the
+/// store never cross each other, their order is unchanged when sweep line
+/// moves down, so edges are only compared on insert and search, using their
+/// X coordinate at current sweep line.
+///
+template<typename IdxT>
 struct HelpEdgeStore
 {
-    HelpEdgeStore( const HalfEdgeNetwork& network )
+    typedef HalfEdgeT<IdxT>        HalfEdge;
+    typedef HalfEdgeNetworkT<IdxT> HalfEdgeNetwork;
+    typedef SweepTreeNode<IdxT>    TreeNode;
+
+    HelpEdgeStore( const HalfEdgeNetwork& network, ScratchArena& arena )
         : network( network )
     {
         treecore_assert( network.vertices.size() == network.edges.size() );
-        edge_helper_edge_map.resize( network.edges.size() );
-        for (int i = 0; i < edge_helper_edge_map.size(); i++)
-            edge_helper_edge_map[i] = -1;
+        int num_edge = network.edges.size();
+
+        edge_helper_edge_map = arena.allocate<IdxT>( num_edge );
+        for (int i = 0; i < num_edge; i++)
+            edge_helper_edge_map[i] = HalfEdgeNetwork::INDEX_NONE;
+
+        tree_nodes = arena.allocate<TreeNode>( num_edge );
+        for (int i = 0; i < num_edge; i++)
+            tree_nodes[i] = { HalfEdgeNetwork::INDEX_NONE, HalfEdgeNetwork::INDEX_NONE, HalfEdgeNetwork::INDEX_NONE, sweep_tree_priority( uint32( i ) ) };
     }
 
-    void add( IndexType edge_idx )
+    void add( IdxT edge_idx )
     {
         SUCK_GEOM( GeomSucker sucker( network, "add edge to search store" );
+                   Array<IdxT> i_left_edges;
+                   collect_edges( i_left_edges );
                    sucker.rgba( SUCKER_BLACK, 0.5 );
-                   for (IndexType idx : i_left_edges)
+                   for (IdxT idx : i_left_edges)
                        sucker.draw_edge( idx );
                    sucker.rgba( SUCKER_GREEN, 0.7 );
                    sucker.draw_edge( edge_idx, 2.0f );
         );
 
-        i_left_edges.add( edge_idx );
+        tree_insert( edge_idx );
         edge_helper_edge_map[edge_idx] = edge_idx;
     }
 
-    void remove( IndexType edge_idx )
+    void remove( IdxT edge_idx )
     {
-        i_left_edges.removeFirstMatchingValue( edge_idx );
+        if ( tree_contains( edge_idx ) )
+            tree_remove( edge_idx );
 
         SUCK_GEOM( GeomSucker sucker( network, "remove edge from search store" );
+                   Array<IdxT> i_left_edges;
+                   collect_edges( i_left_edges );
                    sucker.rgba( SUCKER_BLACK, 0.5 );
-                   for (IndexType idx : i_left_edges)
+                   for (IdxT idx : i_left_edges)
                        sucker.draw_edge( idx );
                    sucker.rgba( SUCKER_RED,   0.7 );
                    sucker.draw_edge( edge_idx, 2.0f );
         )
     }
 
-    IndexType get_edge_helper_edge( IndexType edge_idx )
+    IdxT get_edge_helper_edge( IdxT edge_idx )
     {
-        IndexType helper_idx = edge_helper_edge_map[edge_idx];
-        treecore_assert( 0 <= helper_idx && helper_idx < network.edges.size() );
+        IdxT helper_idx = edge_helper_edge_map[edge_idx];
+        treecore_assert( helper_idx != HalfEdgeNetwork::INDEX_NONE && helper_idx < IdxT( network.edges.size() ) );
         return helper_idx;
     }
 
@@ -104,89 +120,265 @@ struct HelpEdgeStore
     /// \param position
     /// \return half edge index
     ///
-    IndexType find_nearest_left_edge( const Vec2f& position )
+    IdxT find_nearest_left_edge( const Vec2f& position )
     {
-        IndexType result     = std::numeric_limits<IndexType>::max();
-        float     min_x_dist = std::numeric_limits<float>::max();
+        IdxT  result     = std::numeric_limits<IdxT>::max();
+        float min_x_dist = std::numeric_limits<float>::max();
 
-        IndexType result_rev     = std::numeric_limits<IndexType>::max();
-        float     min_x_dist_rev = std::numeric_limits<float>::max();
+        IdxT  result_rev     = std::numeric_limits<IdxT>::max();
+        float min_x_dist_rev = std::numeric_limits<float>::max();
 
-        for (IndexType i_edge : i_left_edges)
+        // the nearest left edge is the last edge we turn right on, and the
+        // nearest right edge is the last edge we turn left on
+        for (IdxT i_edge = tree_root; i_edge != HalfEdgeNetwork::INDEX_NONE; )
         {
-            const HalfEdge& edge = network.edges[i_edge];
-            const Vec2f&    p1   = edge.get_vertex( network.vertices );
-            const Vec2f&    p2   = edge.get_next( network.edges ).get_vertex( network.vertices );
-
-            treecore_assert( p2.y <= p1.y );
+            bool  crossing      = false;
+            float cross_point_x = get_x_at( i_edge, position.y, crossing );
+            float x_dist        = position.x - cross_point_x;
 
-            if (p1.y < position.y || p2.y > position.y) continue;
-
-            Vec2f edge_v = p2 - p1;
-            if (edge_v.y == 0)
-                continue;
-
-            float slope_inv     = edge_v.x / edge_v.y;
-            float dy            = position.y - p1.y;
-            float dx            = dy * slope_inv;
-            float cross_point_x = p1.x + dx;
-
-            float x_dist = position.x - cross_point_x;
-
-            if (x_dist > 0)
+            if (crossing)
             {
-                if (x_dist < min_x_dist)
+                if (x_dist > 0)
                 {
-                    result     = i_edge;
-                    min_x_dist = x_dist;
+                    if (x_dist < min_x_dist)
+                    {
+                        result     = i_edge;
+                        min_x_dist = x_dist;
+                    }
                 }
-            }
-            else
-            {
-                x_dist *= -1;
-                if (x_dist < min_x_dist_rev)
+                else
                 {
-                    result_rev     = i_edge;
-                    min_x_dist_rev = x_dist;
+                    if (-x_dist < min_x_dist_rev)
+                    {
+                        result_rev     = i_edge;
+                        min_x_dist_rev = -x_dist;
+                    }
                 }
             }
+
+            i_edge = x_dist > 0 ? tree_nodes[i_edge].right : tree_nodes[i_edge].left;
         }
 
-        if ( result != std::numeric_limits<IndexType>::max() )
+        if ( result != std::numeric_limits<IdxT>::max() )
         {
             treecore_assert( min_x_dist != std::numeric_limits<float>::max() );
             return result;
         }
         else
         {
-            treecore_assert( result_rev != std::numeric_limits<IndexType>::max() );
+            treecore_assert( result_rev != std::numeric_limits<IdxT>::max() );
             treecore_assert( min_x_dist_rev != std::numeric_limits<float>::max() );
             return result_rev;
         }
     }
 
-    Array<IndexType>       edge_helper_edge_map; // edge idx => helper edge idx
-    Array<IndexType>       i_left_edges;
+    ///
+    /// \brief get X coordinate of edge at specified Y
+    ///
+    /// \param crossing  set to false if edge is horizontal or don't reach Y,
+    ///                  in which case the X of edge start is returned
+    ///
+    float get_x_at( IdxT i_edge, float y, bool& crossing ) const
+    {
+        const HalfEdge& edge = network.edges[i_edge];
+        const Vec2f&    p1   = edge.get_vertex( network.vertices );
+        const Vec2f&    p2   = edge.get_next( network.edges ).get_vertex( network.vertices );
+
+        treecore_assert( p2.y <= p1.y );
+
+        Vec2f edge_v = p2 - p1;
+        if (edge_v.y == 0)
+        {
+            crossing = false;
+            return p1.x;
+        }
+
+        crossing = !(p1.y < y || p2.y > y);
+
+        float slope_inv = edge_v.x / edge_v.y;
+        float dy        = y - p1.y;
+        float dx        = dy * slope_inv;
+        return p1.x + dx;
+    }
+
+    ///
+    /// \brief X movement of edge per unit of downward movement
+    ///
+    float get_down_slope( IdxT i_edge ) const
+    {
+        const HalfEdge& edge   = network.edges[i_edge];
+        Vec2f           edge_v = edge.get_next( network.edges ).get_vertex( network.vertices ) - edge.get_vertex( network.vertices );
+
+        if (edge_v.y == 0)
+            return edge_v.x > 0 ? std::numeric_limits<float>::infinity() : -std::numeric_limits<float>::infinity();
+
+        return edge_v.x / -edge_v.y;
+    }
+
+    ///
+    /// \brief whether new edge goes on the left of an edge in store
+    ///
+    bool is_left_of( IdxT i_edge_new, IdxT i_edge_store ) const
+    {
+        const Vec2f& start = network.get_edge_vertex( i_edge_new );
+
+        bool  crossing = false;
+        float x_store  = get_x_at( i_edge_store, start.y, crossing );
+
+        if (start.x != x_store)
+            return start.x < x_store;
+
+        // edges meet at sweep line, then the one goes more left is on left
+        return get_down_slope( i_edge_new ) < get_down_slope( i_edge_store );
+    }
+
+    bool tree_contains( IdxT i_edge ) const noexcept
+    {
+        return i_edge == tree_root || tree_nodes[i_edge].parent != HalfEdgeNetwork::INDEX_NONE;
+    }
+
+    ///
+    /// \brief move node above its parent while keeping in-order sequence
+    ///
+    void tree_rotate_up( IdxT i_node )
+    {
+        TreeNode& node     = tree_nodes[i_node];
+        IdxT      i_parent = node.parent;
+        TreeNode& parent   = tree_nodes[i_parent];
+        IdxT      i_grand  = parent.parent;
+
+        if (parent.left == i_node)
+        {
+            parent.left = node.right;
+            if (node.right != HalfEdgeNetwork::INDEX_NONE)
+                tree_nodes[node.right].parent = i_parent;
+            node.right = i_parent;
+        }
+        else
+        {
+            parent.right = node.left;
+            if (node.left != HalfEdgeNetwork::INDEX_NONE)
+                tree_nodes[node.left].parent = i_parent;
+            node.left = i_parent;
+        }
+
+        parent.parent = i_node;
+        node.parent   = i_grand;
+
+        if (i_grand == HalfEdgeNetwork::INDEX_NONE)
+            tree_root = i_node;
+        else if (tree_nodes[i_grand].left == i_parent)
+            tree_nodes[i_grand].left = i_node;
+        else
+            tree_nodes[i_grand].right = i_node;
+    }
+
+    void tree_insert( IdxT i_edge )
+    {
+        treecore_assert( !tree_contains( i_edge ) );
+
+        IdxT i_parent = HalfEdgeNetwork::INDEX_NONE;
+        bool      go_left  = false;
+
+        for (IdxT i_curr = tree_root; i_curr != HalfEdgeNetwork::INDEX_NONE; )
+        {
+            i_parent = i_curr;
+            go_left  = is_left_of( i_edge, i_curr );
+            i_curr   = go_left ? tree_nodes[i_curr].left : tree_nodes[i_curr].right;
+        }
+
+        TreeNode& node = tree_nodes[i_edge];
+        node.left   = HalfEdgeNetwork::INDEX_NONE;
+        node.right  = HalfEdgeNetwork::INDEX_NONE;
+        node.parent = i_parent;
+
+        if (i_parent == HalfEdgeNetwork::INDEX_NONE)
+            tree_root = i_edge;
+        else if (go_left)
+            tree_nodes[i_parent].left = i_edge;
+        else
+            tree_nodes[i_parent].right = i_edge;
+
+        // restore heap order of priorities
+        while (node.parent != HalfEdgeNetwork::INDEX_NONE && tree_nodes[node.parent].priority < node.priority)
+            tree_rotate_up( i_edge );
+    }
+
+    void tree_remove( IdxT i_edge )
+    {
+        TreeNode& node = tree_nodes[i_edge];
+
+        // rotate node down until it is a leaf
+        while (node.left != HalfEdgeNetwork::INDEX_NONE || node.right != HalfEdgeNetwork::INDEX_NONE)
+        {
+            IdxT i_child;
+            if (node.left == HalfEdgeNetwork::INDEX_NONE)
+                i_child = node.right;
+            else if (node.right == HalfEdgeNetwork::INDEX_NONE)
+                i_child = node.left;
+            else
+                i_child = tree_nodes[node.left].priority > tree_nodes[node.right].priority ? node.left : node.right;
+
+            tree_rotate_up( i_child );
+        }
+
+        if (node.parent == HalfEdgeNetwork::INDEX_NONE)
+            tree_root = HalfEdgeNetwork::INDEX_NONE;
+        else if (tree_nodes[node.parent].left == i_edge)
+            tree_nodes[node.parent].left = HalfEdgeNetwork::INDEX_NONE;
+        else
+            tree_nodes[node.parent].right = HalfEdgeNetwork::INDEX_NONE;
+
+        node.parent = HalfEdgeNetwork::INDEX_NONE;
+    }
+
+    ///
+    /// \brief get all edges in store from left to right
+    ///
+    void collect_edges( Array<IdxT>& result ) const
+    {
+        Array<IdxT> stack;
+        IdxT i_curr = tree_root;
+
+        while (i_curr != HalfEdgeNetwork::INDEX_NONE || stack.size() > 0)
+        {
+            while (i_curr != HalfEdgeNetwork::INDEX_NONE)
+            {
+                stack.add( i_curr );
+                i_curr = tree_nodes[i_curr].left;
+            }
+
+            i_curr = stack.getLast();
+            stack.removeLast();
+            result.add( i_curr );
+            i_curr = tree_nodes[i_curr].right;
+        }
+    }
+
+    IdxT*                  edge_helper_edge_map = nullptr; // edge idx => helper edge idx, in arena
+    TreeNode*              tree_nodes = nullptr;           // edge idx => tree node, in arena
+    IdxT                   tree_root = HalfEdgeNetwork::INDEX_NONE;
     const HalfEdgeNetwork& network;
 };
 
-void HalfEdgeNetwork::build_half_edges( const treecore::Array<IndexType>& subpath_begin, bool is_cclw )
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::build_half_edges( const treecore::Array<IdxT>& subpath_begin, bool is_cclw )
 {
     for (int i_subpath = 0; i_subpath < subpath_begin.size(); i_subpath++)
     {
 
-        IndexType i_vtx_begin = subpath_begin[i_subpath];
-        IndexType i_vtx_end   = i_subpath == subpath_begin.size() - 1
+        IdxT i_vtx_begin = subpath_begin[i_subpath];
+        IdxT i_vtx_end   = i_subpath == subpath_begin.size() - 1
                                 ? vertices.size()
                                 : subpath_begin[i_subpath + 1];
 
-        IndexType i_vtx_last = i_vtx_end - 1;
+        IdxT i_vtx_last = i_vtx_end - 1;
 
-        for (IndexType i_vtx = i_vtx_begin; i_vtx != i_vtx_end; i_vtx++)
+        for (IdxT i_vtx = i_vtx_begin; i_vtx != i_vtx_end; i_vtx++)
         {
             treecore_assert( i_vtx == edges.size() );
-            IndexType i_edge_prev;
-            IndexType i_edge_next;
+            IdxT i_edge_prev;
+            IdxT i_edge_next;
 
             if (is_cclw)
             {
@@ -207,23 +399,24 @@ void HalfEdgeNetwork::build_half_edges( const treecore::Array<IndexType>& subpat
                               : i_vtx - 1;
             }
 
-            edges.add( HalfEdge{ i_vtx, i_edge_prev, i_edge_next, std::numeric_limits<IndexType>::max() } );
+            edges.add( HalfEdge{ i_vtx, i_edge_prev, i_edge_next, std::numeric_limits<IdxT>::max() } );
         }
     }
 }
 
-void HalfEdgeNetwork::connect( IndexType i_edge1, IndexType i_edge2 )
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::connect( IdxT i_edge1, IdxT i_edge2 )
 {
     // pre-calculate the index of newly added half edges
-    IndexType i_edge_1_2 = edges.size();
-    IndexType i_edge_2_1 = i_edge_1_2 + 1;
+    IdxT i_edge_1_2 = edges.size();
+    IdxT i_edge_2_1 = i_edge_1_2 + 1;
 
     HalfEdge& edge1        = edges[i_edge1];
-    IndexType i_edge1_prev = edge1.idx_prev_edge;
+    IdxT      i_edge1_prev = edge1.idx_prev_edge;
     HalfEdge& edge1_prev   = edges[i_edge1_prev];
 
     HalfEdge& edge2        = edges[i_edge2];
-    IndexType i_edge2_prev = edge2.idx_prev_edge;
+    IdxT      i_edge2_prev = edge2.idx_prev_edge;
     HalfEdge& edge2_prev   = edges[i_edge2_prev];
 
     SUCK_GEOM_BLK(
@@ -268,12 +461,13 @@ void HalfEdgeNetwork::connect( IndexType i_edge1, IndexType i_edge2 )
     )
 }
 
-IndexType HalfEdgeNetwork::get_next_edge_diff_vtx( const IndexType i_edge_search_base ) const
+template<typename IdxT>
+IdxT HalfEdgeNetworkT<IdxT>::get_next_edge_diff_vtx( const IdxT i_edge_search_base ) const
 {
     const HalfEdge& edge_from = edges[i_edge_search_base];
     const Vec2f&    vtx_from  = edge_from.get_vertex( vertices );
 
-    for (IndexType i_edge = edge_from.idx_next_edge; i_edge != i_edge_search_base; )
+    for (IdxT i_edge = edge_from.idx_next_edge; i_edge != i_edge_search_base; )
     {
         const HalfEdge& edge = edges[i_edge];
         const Vec2f&    vtx  = edge.get_vertex( vertices );
@@ -287,15 +481,16 @@ IndexType HalfEdgeNetwork::get_next_edge_diff_vtx( const IndexType i_edge_search
     }
 
     treecore_assert_false;
-    return std::numeric_limits<IndexType>::max();
+    return std::numeric_limits<IdxT>::max();
 }
 
-IndexType HalfEdgeNetwork::get_prev_edge_diff_vtx( const IndexType i_edge_search_base ) const
+template<typename IdxT>
+IdxT HalfEdgeNetworkT<IdxT>::get_prev_edge_diff_vtx( const IdxT i_edge_search_base ) const
 {
     const HalfEdge& edge_from = edges[i_edge_search_base];
     const Vec2f&    vtx_from  = edge_from.get_vertex( vertices );
 
-    for (IndexType i_edge = edge_from.idx_prev_edge; i_edge != i_edge_search_base; )
+    for (IdxT i_edge = edge_from.idx_prev_edge; i_edge != i_edge_search_base; )
     {
         const HalfEdge& edge = edges[i_edge];
         const Vec2f&    vtx  = edge.get_vertex( vertices );
@@ -308,10 +503,11 @@ IndexType HalfEdgeNetwork::get_prev_edge_diff_vtx( const IndexType i_edge_search
     }
 
     treecore_assert_false;
-    return std::numeric_limits<IndexType>::max();
+    return std::numeric_limits<IdxT>::max();
 }
 
-bool HalfEdgeNetwork::fan_is_facing( const Vec2f& vec_ref, IndexType i_edge ) const
+template<typename IdxT>
+bool HalfEdgeNetworkT<IdxT>::fan_is_facing( const Vec2f& vec_ref, IdxT i_edge ) const
 {
     const Vec2f& vtx_fan_base = edges[i_edge].get_vertex( vertices );
     const Vec2f& vtx_next     = edges[get_next_edge_diff_vtx( i_edge )].get_vertex( vertices );
@@ -323,27 +519,74 @@ bool HalfEdgeNetwork::fan_is_facing( const Vec2f& vec_ref, IndexType i_edge ) co
     return vec_are_cclw( v_next, vec_ref, v_prev );
 }
 
-void HalfEdgeNetwork::get_edge_vertical_order( const treecore::Array<VertexRole>& roles, treecore::Array<IndexType>& result ) const
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::get_edge_vertical_order( const treecore::Array<VertexRole>& roles, treecore::Array<IdxT>& result ) const
 {
     treecore_assert( roles.size() == edges.size() );
+    result.resize( edges.size() );
+    get_edge_vertical_order( roles.getRawDataPointer(), result.getRawDataPointer() );
+}
 
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::get_edge_vertical_order( const VertexRole* roles, IdxT* result ) const
+{
     int num_edge = edges.size();
-    result.resize( num_edge );
+    if (num_edge == 0)
+        return;
+
+    // edges are ordered by decreasing Y, then decreasing X, then decreasing
+    // role, so all keys are reversed
+    ScratchArena&        arena  = ScratchArena::get_thread_arena();
+    ScratchScope         scope( arena );
+    EdgeOrderItem<IdxT>* items  = arena.allocate<EdgeOrderItem<IdxT> >( num_edge );
+    EdgeOrderItem<IdxT>* buffer = arena.allocate<EdgeOrderItem<IdxT> >( num_edge );
 
     for (int i = 0; i < num_edge; i++)
-        result[i] = IndexType( i );
+    {
+        const Vec2f& vtx = vertices.get<Vec2f>( edges[i].idx_vertex );
 
-    HalfEdgeIndexVerticalSorter sorter( vertices, edges, roles );
-    result.sort( sorter );
+        uint32 y_key = ~float_to_radix_key( vtx.y );
+        uint32 x_key = ~float_to_radix_key( vtx.x );
+        items[i] = { (uint64( y_key ) << 32) | uint64( x_key ), uint8( 0xff - roles[i] ), IdxT( i ) };
+    }
+
+    radix_sort( items, buffer, size_t( num_edge ), EdgeOrderPosKeyGetter<IdxT>() );
+
+    // edges on same position are rare and few, so they are ordered by role
+    // with insertion sort
+    for (int i = 1; i < num_edge; i++)
+    {
+        if (items[i].pos_key != items[i - 1].pos_key || items[i].role_key >= items[i - 1].role_key)
+            continue;
+
+        EdgeOrderItem<IdxT> item = items[i];
+        int i_dst = i;
+        while (i_dst > 0 && items[i_dst - 1].pos_key == item.pos_key && items[i_dst - 1].role_key > item.role_key)
+        {
+            items[i_dst] = items[i_dst - 1];
+            i_dst--;
+        }
+        items[i_dst] = item;
+    }
+
+    for (int i = 0; i < num_edge; i++)
+        result[i] = items[i].i_edge;
 }
 
-void HalfEdgeNetwork::get_edge_role( treecore::Array<VertexRole>& result_roles ) const
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::get_edge_role( treecore::Array<VertexRole>& result_roles ) const
 {
     result_roles.resize( edges.size() );
+    get_edge_role( result_roles.getRawDataPointer() );
+}
+
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::get_edge_role( VertexRole* result_roles ) const
+{
     for (int i_edge = 0; i_edge < edges.size(); i_edge++)
     {
-        IndexType i_prev = get_prev_edge_diff_vtx( i_edge );
-        IndexType i_next = get_next_edge_diff_vtx( i_edge );
+        IdxT i_prev = get_prev_edge_diff_vtx( i_edge );
+        IdxT i_next = get_next_edge_diff_vtx( i_edge );
 
         const Vec2f& vtx_curr = edges[i_edge].get_vertex( vertices );
         const Vec2f& vtx_prev = edges[i_prev].get_vertex( vertices );
@@ -382,7 +625,8 @@ void HalfEdgeNetwork::get_edge_role( treecore::Array<VertexRole>& result_roles )
     }
 }
 
-void HalfEdgeNetwork::iter_edge_to_facing_fan( const IndexType i_edge_ref, IndexType& i_edge_iter ) const
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::iter_edge_to_facing_fan( const IdxT i_edge_ref, IdxT& i_edge_iter ) const
 {
     const Vec2f& vtx_fan_base = edges[i_edge_iter].get_vertex( vertices );
 
@@ -394,8 +638,8 @@ void HalfEdgeNetwork::iter_edge_to_facing_fan( const IndexType i_edge_ref, Index
         Vec2f vtx_ref_use = edges[i_edge_ref].get_vertex( vertices );
         if (vtx_ref_use == vtx_fan_base)
         {
-            IndexType i_edge_ref_next = get_next_edge_diff_vtx( i_edge_ref );
-            IndexType i_edge_ref_prev = get_prev_edge_diff_vtx( i_edge_ref );
+            IdxT i_edge_ref_next = get_next_edge_diff_vtx( i_edge_ref );
+            IdxT i_edge_ref_prev = get_prev_edge_diff_vtx( i_edge_ref );
             vtx_ref_use  = edges[i_edge_ref_next].get_vertex( vertices ) + edges[i_edge_ref_prev].get_vertex( vertices );
             vtx_ref_use /= 2;
         }
@@ -419,8 +663,8 @@ void HalfEdgeNetwork::iter_edge_to_facing_fan( const IndexType i_edge_ref, Index
     }
 
     // search forward
-    for (IndexType i_edge_search = edge_begin.get_next( edges ).idx_peer_edge;
-         i_edge_search != std::numeric_limits<IndexType>::max() && i_edge_search != i_edge_iter;
+    for (IdxT i_edge_search = edge_begin.get_next( edges ).idx_peer_edge;
+         i_edge_search != std::numeric_limits<IdxT>::max() && i_edge_search != i_edge_iter;
          i_edge_search = edges[i_edge_search].get_next( edges ).idx_peer_edge)
     {
         if ( fan_is_facing( v_ref, i_edge_search ) )
@@ -444,8 +688,8 @@ void HalfEdgeNetwork::iter_edge_to_facing_fan( const IndexType i_edge_ref, Index
     }
 
     // search revert
-    for (IndexType i_edge_search = edge_begin.get_prev( edges ).idx_peer_edge;
-         i_edge_search != std::numeric_limits<IndexType>::max() && i_edge_search != i_edge_iter;
+    for (IdxT i_edge_search = edge_begin.get_prev( edges ).idx_peer_edge;
+         i_edge_search != std::numeric_limits<IdxT>::max() && i_edge_search != i_edge_iter;
          i_edge_search = edges[i_edge_search].get_prev( edges ).idx_peer_edge)
     {
         if ( fan_is_facing( v_ref, i_edge_search ) )
@@ -481,7 +725,8 @@ void HalfEdgeNetwork::iter_edge_to_facing_fan( const IndexType i_edge_ref, Index
 ///
 /// \return number of polygons
 ///
-int16 HalfEdgeNetwork::mark_polygons( Array<int16>& edge_polygon_map ) const
+template<typename IdxT>
+int32 HalfEdgeNetworkT<IdxT>::mark_polygons( Array<int32>& edge_polygon_map ) const
 {
     int num_edge = edges.size();
 
@@ -491,14 +736,14 @@ int16 HalfEdgeNetwork::mark_polygons( Array<int16>& edge_polygon_map ) const
         edge_polygon_map[i] = -1;
 
     // traverse all edges
-    int16 num_polygon = 0;
-    for (IndexType i_edge_first = 0; i_edge_first < edges.size(); i_edge_first++)
+    int32 num_polygon = 0;
+    for (IdxT i_edge_first = 0; i_edge_first < edges.size(); i_edge_first++)
     {
         // skip processed edge
         if (edge_polygon_map[i_edge_first] >= 0) continue;
 
         // mark all edges of this polygon
-        for (IndexType i_edge = i_edge_first;; )
+        for (IdxT i_edge = i_edge_first;; )
         {
             // mark polygon index
             treecore_assert( edge_polygon_map[i_edge] == -1 );
@@ -516,29 +761,32 @@ int16 HalfEdgeNetwork::mark_polygons( Array<int16>& edge_polygon_map ) const
     return num_polygon;
 }
 
-void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  edge_indices_by_y,
-                                                     const Array<int16>&      edge_polygon_map,
-                                                     int16 num_polygon,
-                                                     const Array<VertexRole>& edge_roles,
-                                                     Array<IndexType>&        result_indices,
-                                                     Vec2f& result_skeleton_min,
-                                                     Vec2f& result_skeleton_max ) const
+template<typename IdxT>
+template<typename ResultIdxT>
+void HalfEdgeNetworkT<IdxT>::triangulate_monotone_polygons( const Array<IdxT>&       edge_indices_by_y,
+                                                            const Array<int32>&      edge_polygon_map,
+                                                            int32 num_polygon,
+                                                            const Array<VertexRole>& edge_roles,
+                                                            Array<ResultIdxT>&       result_indices,
+                                                            Vec2f& result_skeleton_min,
+                                                            Vec2f& result_skeleton_max ) const
 {
     SUCK_GEOM_BLK( GeomSucker sucker( *this, "input for triangulation" ); );
 
-    Array<IndexType> edge_stack;
+    Array<IdxT> edge_stack;
+    Array<IdxT> popped_edges;
 
-    for (int16 i_polygon = 0; i_polygon < num_polygon; i_polygon++)
+    for (int32 i_polygon = 0; i_polygon < num_polygon; i_polygon++)
     {
         int count = 0;
 
-        IndexType i_edge_first = std::numeric_limits<IndexType>::max();
-        IndexType i_edge_prev  = std::numeric_limits<IndexType>::max();
+        IdxT i_edge_first = std::numeric_limits<IdxT>::max();
+        IdxT i_edge_prev  = std::numeric_limits<IdxT>::max();
 
         //
         // traverse by decreasing Y coord
         //
-        for (IndexType i_edge : edge_indices_by_y)
+        for (IdxT i_edge : edge_indices_by_y)
         {
             if (edge_polygon_map[i_edge] != i_polygon) continue;
 
@@ -594,11 +842,11 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
                         //PSEUDOCODE Insert into D a diagonal from u(j) to each popped vertex, except the last one.
                         for (int i_stack = 1; i_stack < edge_stack.size(); i_stack++)
                         {
-                            IndexType i_curr = edge_stack[i_stack];
-                            IndexType i_prev = edge_stack[i_stack - 1];
-                            result_indices.add( edge.idx_vertex );
-                            result_indices.add( edges[i_curr].idx_vertex );
-                            result_indices.add( edges[i_prev].idx_vertex );
+                            IdxT i_curr = edge_stack[i_stack];
+                            IdxT i_prev = edge_stack[i_stack - 1];
+                            result_indices.add( ResultIdxT( edge.idx_vertex ) );
+                            result_indices.add( ResultIdxT( edges[i_curr].idx_vertex ) );
+                            result_indices.add( ResultIdxT( edges[i_prev].idx_vertex ) );
                             SUCK_GEOM_BLK(
                                 GeomSucker sucker( *this, "do triangulation" );
                                 sucker.draw_edge_stack( edge_stack );
@@ -629,7 +877,7 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
                         )
 
                         treecore_assert( edge_stack.size() > 1 );
-                        Array<IndexType> popped_edges;
+                        popped_edges.clearQuick();
 
                         //PSEUDOCODE Pop one vertex from S.
                         popped_edges.add( edge_stack.getLast() );
@@ -647,10 +895,10 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
                         //PSEUDOCODE Pop the other vertices from S as long as the diagonals from u(j) to them are inside P.
                         while (edge_stack.size() > 0)
                         {
-                            const IndexType i_edge_stack_top = edge_stack.getLast();
-                            const Vec2f&    vtx_stack_top    = edges[i_edge_stack_top].get_vertex( vertices );
-                            const IndexType i_edge_popped    = popped_edges.getLast();
-                            const Vec2f&    vtx_popped       = edges[i_edge_popped].get_vertex( vertices );
+                            const IdxT   i_edge_stack_top = edge_stack.getLast();
+                            const Vec2f& vtx_stack_top    = edges[i_edge_stack_top].get_vertex( vertices );
+                            const IdxT   i_edge_popped    = popped_edges.getLast();
+                            const Vec2f& vtx_popped       = edges[i_edge_popped].get_vertex( vertices );
 
                             bool diag_is_inside;
                             if (edge_roles[i_edge] == VTX_ROLE_LEFT)
@@ -694,12 +942,12 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
                         for (int i = 1; i < popped_edges.size(); i++)
                         {
                             // the last one continues with edge stack top
-                            IndexType i_edge1 = popped_edges[i];
-                            IndexType i_edge2 = popped_edges[i - 1];
+                            IdxT i_edge1 = popped_edges[i];
+                            IdxT i_edge2 = popped_edges[i - 1];
 
-                            result_indices.add( edge.idx_vertex );
-                            result_indices.add( edges[i_edge1].idx_vertex );
-                            result_indices.add( edges[i_edge2].idx_vertex );
+                            result_indices.add( ResultIdxT( edge.idx_vertex ) );
+                            result_indices.add( ResultIdxT( edges[i_edge1].idx_vertex ) );
+                            result_indices.add( ResultIdxT( edges[i_edge2].idx_vertex ) );
 
                             SUCK_GEOM_BLK(
                                 GeomSucker sucker( *this, "do triangulation" );
@@ -711,7 +959,7 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
 
                         //PSEUDOCODE Push the last vertex that has been popped back onto S.
                         //PSEUDOCODE Push u(j) onto S.
-                        IndexType i_popped_last = popped_edges.getLast();
+                        IdxT i_popped_last = popped_edges.getLast();
 
                         SUCK_GEOM_BLK(
                             GeomSucker sucker( *this );
@@ -747,11 +995,11 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
 
                     for (int i = 1; i < edge_stack.size(); i++)
                     {
-                        IndexType i_prev = edge_stack[i - 1];
-                        IndexType i_curr = edge_stack[i];
-                        result_indices.add( edge.idx_vertex );
-                        result_indices.add( edges[i_prev].idx_vertex );
-                        result_indices.add( edges[i_curr].idx_vertex );
+                        IdxT i_prev = edge_stack[i - 1];
+                        IdxT i_curr = edge_stack[i];
+                        result_indices.add( ResultIdxT( edge.idx_vertex ) );
+                        result_indices.add( ResultIdxT( edges[i_prev].idx_vertex ) );
+                        result_indices.add( ResultIdxT( edges[i_curr].idx_vertex ) );
 
                         SUCK_GEOM_BLK(
                             GeomSucker sucker( *this, "do triangulation" );
@@ -771,28 +1019,35 @@ void HalfEdgeNetwork::triangulate_monotone_polygons( const Array<IndexType>&  ed
     }   // polygon cycle
 }
 
-void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_network ) const
+template<typename IdxT>
+void HalfEdgeNetworkT<IdxT>::partition_polygon_monotone( HalfEdgeNetworkT& result_network ) const
 {
     treecore_assert( &vertices == &result_network.vertices );
-    result_network.edges = edges;
+    result_network.edges.clearQuick();
+    result_network.edges.addArray( edges );
 
     int num_edge_orig = edges.size();
 
     SUCK_GEOM_BLK( GeomSucker( *this ); );
 
+    // temporary arrays are only used in this function
+    ScratchArena& arena = ScratchArena::get_thread_arena();
+    ScratchScope  scope( arena );
+
     // determine edge role
-    Array<VertexRole> vtx_roles;
+    VertexRole* vtx_roles = arena.allocate<VertexRole>( num_edge_orig );
     get_edge_role( vtx_roles );
 
     // sort by vertical position
-    Array<IndexType> edge_idx_by_y;
+    IdxT* edge_idx_by_y = arena.allocate<IdxT>( num_edge_orig );
     get_edge_vertical_order( vtx_roles, edge_idx_by_y );
 
     // process all edges by decreasing Y corrd
-    HelpEdgeStore helper_store( *this );
+    HelpEdgeStore<IdxT> helper_store( *this, arena );
 
-    for (IndexType i_edge_curr : edge_idx_by_y)
+    for (int i_order = 0; i_order < num_edge_orig; i_order++)
     {
+        IdxT i_edge_curr = edge_idx_by_y[i_order];
         const HalfEdge& edge_curr = edges[i_edge_curr];
         const Vec2f&    vtx_curr  = edge_curr.get_vertex( vertices );
         const Vec2f&    vtx_prev  = edge_curr.get_prev( edges ).get_vertex( vertices );
@@ -825,8 +1080,8 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
 
             //PSEUDOCODE if helper(e(i-1)) is a merge vertex
             //PSEUDOCODE     then Insert the diagonal connecting v(i) to helper( e(i-1) ) in D
-            IndexType i_edge_of_prev_edge_helper = helper_store.get_edge_helper_edge( edge_curr.idx_prev_edge );
-            IndexType i_prev_edge_helper = result_network.edges[i_edge_of_prev_edge_helper].idx_vertex;
+            IdxT i_edge_of_prev_edge_helper = helper_store.get_edge_helper_edge( edge_curr.idx_prev_edge );
+            IdxT i_prev_edge_helper = result_network.edges[i_edge_of_prev_edge_helper].idx_vertex;
 
             SUCK_GEOM_BLK(
                 GeomSucker sucker( result_network, "helper of prev" );
@@ -854,8 +1109,8 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
 
             //PSEUDOCODE if helper(e(i-1)) is a merge vertex
             //PSEUDOCODE     then Insert the diagonal connecting v(i) to helper(e(i-1)) in D.
-            IndexType i_edge_of_prev_edge_helper = helper_store.get_edge_helper_edge( edge_curr.idx_prev_edge );
-            IndexType i_prev_edge_helper = result_network.edges[i_edge_of_prev_edge_helper].idx_vertex;
+            IdxT i_edge_of_prev_edge_helper = helper_store.get_edge_helper_edge( edge_curr.idx_prev_edge );
+            IdxT i_prev_edge_helper = result_network.edges[i_edge_of_prev_edge_helper].idx_vertex;
 
             SUCK_GEOM_BLK(
                 GeomSucker sucker( result_network, "prev edge and helper" );
@@ -885,9 +1140,9 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
             )
 
             //PSEUDOCODE Search in T to find the edge e(j) directly left of v(i) .
-            IndexType i_left_edge = helper_store.find_nearest_left_edge( vtx_curr );
-            IndexType i_edge_of_left_edge_helper = helper_store.get_edge_helper_edge( i_left_edge );
-            IndexType i_left_edge_helper = edges[i_edge_of_left_edge_helper].idx_vertex;
+            IdxT i_left_edge = helper_store.find_nearest_left_edge( vtx_curr );
+            IdxT i_edge_of_left_edge_helper = helper_store.get_edge_helper_edge( i_left_edge );
+            IdxT i_left_edge_helper = edges[i_edge_of_left_edge_helper].idx_vertex;
             SUCK_GEOM_BLK(
                 GeomSucker sucker( result_network, "left edge and helper" );
                 sucker.draw_helper( i_left_edge, i_left_edge_helper );
@@ -919,9 +1174,9 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
             )
 
             //PSEUDOCODE Search in T to find the edge e(j) directly left of v(i)
-            IndexType i_left_edge = helper_store.find_nearest_left_edge( vtx_curr );
-            IndexType i_edge_of_left_edge_helper = helper_store.get_edge_helper_edge( i_left_edge );
-            IndexType i_left_edge_helper = edges[i_edge_of_left_edge_helper].idx_vertex;
+            IdxT i_left_edge = helper_store.find_nearest_left_edge( vtx_curr );
+            IdxT i_edge_of_left_edge_helper = helper_store.get_edge_helper_edge( i_left_edge );
+            IdxT i_left_edge_helper = edges[i_edge_of_left_edge_helper].idx_vertex;
 
             SUCK_GEOM_BLK(
                 GeomSucker sucker( result_network, "left edge and helper" );
@@ -955,8 +1210,8 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
 
             //PSEUDOCODE if helper(e(i-1)) is a merge vertex
             //PSEUDOCODE     then Insert the diagonal connecting v(i) to helper(e(i-1)) in D.
-            IndexType i_edge_of_prev_edge_helper = helper_store.get_edge_helper_edge( edge_curr.idx_prev_edge );
-            IndexType i_prev_edge_helper = edges[i_edge_of_prev_edge_helper].idx_vertex;
+            IdxT i_edge_of_prev_edge_helper = helper_store.get_edge_helper_edge( edge_curr.idx_prev_edge );
+            IdxT i_prev_edge_helper = edges[i_edge_of_prev_edge_helper].idx_vertex;
 
             SUCK_GEOM_BLK(
                 GeomSucker sucker( result_network, "prev edge and helper" );
@@ -973,9 +1228,9 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
             helper_store.remove( edge_curr.idx_prev_edge );
 
             //PSEUDOCODE Search in T to find the edge e(j) directly left of v(i).
-            IndexType i_left_edge = helper_store.find_nearest_left_edge( vtx_curr );
-            IndexType i_edge_of_left_edge_helper = helper_store.get_edge_helper_edge( i_left_edge );
-            IndexType i_left_edge_helper = edges[i_edge_of_left_edge_helper].idx_vertex;
+            IdxT i_left_edge = helper_store.find_nearest_left_edge( vtx_curr );
+            IdxT i_edge_of_left_edge_helper = helper_store.get_edge_helper_edge( i_left_edge );
+            IdxT i_left_edge_helper = edges[i_edge_of_left_edge_helper].idx_vertex;
 
             SUCK_GEOM_BLK(
                 GeomSucker sucker( result_network, "left edge and helper" );
@@ -1006,4 +1261,15 @@ void HalfEdgeNetwork::partition_polygon_monotone( HalfEdgeNetwork& result_networ
     }
 }
 
+template<typename IdxT>
+constexpr IdxT HalfEdgeNetworkT<IdxT>::INDEX_NONE;
+
+template struct HalfEdgeNetworkT<uint16>;
+template struct HalfEdgeNetworkT<uint32>;
+
+template void HalfEdgeNetworkT<uint16>::triangulate_monotone_polygons<uint16>( const Array<uint16>&, const Array<int32>&, int32, const Array<VertexRole>&, Array<uint16>&, Vec2f&, Vec2f& ) const;
+template void HalfEdgeNetworkT<uint16>::triangulate_monotone_polygons<uint32>( const Array<uint16>&, const Array<int32>&, int32, const Array<VertexRole>&, Array<uint32>&, Vec2f&, Vec2f& ) const;
+template void HalfEdgeNetworkT<uint32>::triangulate_monotone_polygons<uint16>( const Array<uint32>&, const Array<int32>&, int32, const Array<VertexRole>&, Array<uint16>&, Vec2f&, Vec2f& ) const;
+template void HalfEdgeNetworkT<uint32>::triangulate_monotone_polygons<uint32>( const Array<uint32>&, const Array<int32>&, int32, const Array<VertexRole>&, Array<uint32>&, Vec2f&, Vec2f& ) const;
+
 } // namespace treeface
@@ -10,42 +10,69 @@
 
 #include <treecore/Array.h>
 
+#include <limits>
+
 namespace treeface
 {
 
-struct HalfEdgeNetwork
+///
+/// \brief half edges of polygons, whose vertex and edge indices are stored
+///        in IdxT
+///
+/// Instantiated for 16-bit and 32-bit indices. The 32-bit one is for shapes
+/// whose vertices or edges are beyond range of 16-bit index.
+///
+template<typename IdxT>
+struct HalfEdgeNetworkT
 {
-    explicit HalfEdgeNetwork( const Geometry::HostVertexCache& vertices ): vertices( vertices ) {}
+    typedef HalfEdgeT<IdxT> HalfEdge;
+
+    ///
+    /// \brief index that refers to no edge
+    ///
+    static constexpr IdxT INDEX_NONE = std::numeric_limits<IdxT>::max();
+
+    explicit HalfEdgeNetworkT( const Geometry::HostVertexCache& vertices ): vertices( vertices ) {}
 
-    void build_half_edges( const treecore::Array<IndexType>& subpath_begin, bool is_cclw );
+    void build_half_edges( const treecore::Array<IdxT>& subpath_begin, bool is_cclw );
 
-    void connect( IndexType i_edge1, IndexType i_edge2 );
+    void connect( IdxT i_edge1, IdxT i_edge2 );
 
-    bool fan_is_facing( const Vec2f& vec_ref, IndexType i_edge ) const;
+    bool fan_is_facing( const Vec2f& vec_ref, IdxT i_edge ) const;
 
-    void get_edge_vertical_order( const treecore::Array<VertexRole>& roles, treecore::Array<IndexType>& result ) const;
+    void get_edge_vertical_order( const treecore::Array<VertexRole>& roles, treecore::Array<IdxT>& result ) const;
+    void get_edge_vertical_order( const VertexRole* roles, IdxT* result ) const;
 
     void get_edge_role( treecore::Array<VertexRole>& result_roles ) const;
+    void get_edge_role( VertexRole* result_roles ) const;
 
-    IndexType get_next_edge_diff_vtx( const IndexType i_edge_search_base ) const;
-    IndexType get_prev_edge_diff_vtx( const IndexType i_edge_search_base ) const;
+    IdxT get_next_edge_diff_vtx( const IdxT i_edge_search_base ) const;
+    IdxT get_prev_edge_diff_vtx( const IdxT i_edge_search_base ) const;
 
-    void iter_edge_to_facing_fan( const IndexType i_edge_ref, IndexType& i_edge_search ) const;
+    void iter_edge_to_facing_fan( const IdxT i_edge_ref, IdxT& i_edge_search ) const;
 
-    void partition_polygon_monotone( HalfEdgeNetwork& result_network ) const;
+    void partition_polygon_monotone( HalfEdgeNetworkT& result_network ) const;
 
-    const Vec2f& get_edge_vertex( IndexType i_edge ) const noexcept
+    const Vec2f& get_edge_vertex( IdxT i_edge ) const noexcept
     {
         return vertices.get<Vec2f>( edges[i_edge].idx_vertex );
     }
 
-    treecore::int16 mark_polygons( treecore::Array<treecore::int16>& edge_polygon_map ) const;
-
-    void triangulate_monotone_polygons( const treecore::Array<IndexType>&       edge_indices_by_y,
-                                        const treecore::Array<treecore::int16>& edge_polygon_map,
-                                        treecore::int16 num_polygon,
+    treecore::int32 mark_polygons( treecore::Array<treecore::int32>& edge_polygon_map ) const;
+
+    ///
+    /// \brief triangulate monotone polygons into vertex indices
+    ///
+    /// Result index type can differ from half edge index type, as half edges
+    /// can be much more than vertices. Instantiated for 16-bit and 32-bit
+    /// result indices.
+    ///
+    template<typename ResultIdxT>
+    void triangulate_monotone_polygons( const treecore::Array<IdxT>&            edge_indices_by_y,
+                                        const treecore::Array<treecore::int32>& edge_polygon_map,
+                                        treecore::int32 num_polygon,
                                         const treecore::Array<VertexRole>&      edge_roles,
-                                        treecore::Array<IndexType>&             result_indices,
+                                        treecore::Array<ResultIdxT>&            result_indices,
                                         Vec2f& result_skeleton_min,
                                         Vec2f& result_skeleton_max ) const;
 
@@ -53,6 +80,11 @@ struct HalfEdgeNetwork
     treecore::Array<HalfEdge>        edges;
 };
 
+extern template struct HalfEdgeNetworkT<treecore::uint16>;
+extern template struct HalfEdgeNetworkT<treecore::uint32>;
+
+typedef HalfEdgeNetworkT<IndexType> HalfEdgeNetwork;
+
 } // namespace treeface
 
 #endif // TREEFACE_HALF_EDGE_NETWORK_H
@@ -3,6 +3,8 @@
 #include "treeface/math/Constants.h"
 #include "treeface/math/Mat2.h"
 
+#include <algorithm>
+
 using namespace treecore;
 
 namespace treeface
@@ -11,24 +13,23 @@ namespace treeface
 int HalfOutline::find_cross_from_head( const Vec2f& p1, const Vec2f& p2, Vec2f& p_cross, int step_limit ) const
 {
     treecore_assert( outline.size() > 1 );
-    treecore_assert( outline.size() == outline_bounds.size() + 1 );
+    treecore_assert( outline.size() == segments.size() + 1 );
 
-    SUCK_GEOM_BLK( OutlineSucker sucker( *this, "find cross from tail" );
+    SUCK_GEOM_BLK( OutlineSucker sucker( *this, "find cross from head" );
                    sucker.draw_vtx( p1 );
                    sucker.draw_vtx( p2 );
     );
 
-    const BBox2f bound_input( p1, p2 );
+    const OutlineSegments::Query query( p1, p2 );
+    const int i_end = std::min( segments.size(), step_limit );
 
-    for (int i = 0; i < outline.size() && i < step_limit; i++)
+    for (int i_pack = 0; i_pack * 4 < i_end; i_pack++)
     {
+        int lanes = segments.test_pack( i_pack, query );
 
-        if (bound_input ^ outline_bounds[i])
+        for (int i = i_pack * 4; lanes != 0 && i < i_end; i++, lanes >>= 1)
         {
-            const Vec2f& p3 = outline[i];
-            const Vec2f& p4 = outline[i + 1];
-
-            if ( cross_test_inc( p1, p2, p3, p4, p_cross ) )
+            if ( (lanes & 1) && cross_test_inc( p1, p2, outline[i], outline[i + 1], p_cross ) )
             {
                 SUCK_GEOM_BLK( OutlineSucker sucker( *this, "got cross" );
                                sucker.draw_vtx( p1 );
@@ -41,25 +42,6 @@ int HalfOutline::find_cross_from_head( const Vec2f& p1, const Vec2f& p2, Vec2f&
                 )
                 return i;
             }
-
-            SUCK_GEOM_BLK( OutlineSucker sucker( *this, "not cross" );
-                           sucker.draw_vtx( p1 );
-                           sucker.draw_vtx( p2 );
-                           sucker.rgb( SUCKER_RED );
-                           sucker.draw_vtx( i );
-                           sucker.draw_vtx( i + 1 );
-                           sucker.draw_vtx( p_cross );
-            )
-        }
-        else
-        {
-            SUCK_GEOM_BLK( OutlineSucker sucker( *this, "not cross by bbox" );
-                           sucker.draw_vtx( p1 );
-                           sucker.draw_vtx( p2 );
-                           sucker.rgb( SUCKER_RED );
-                           sucker.draw_vtx( i );
-                           sucker.draw_vtx( i + 1 );
-            )
         }
     }
 
@@ -75,25 +57,32 @@ int HalfOutline::find_cross_from_head( const Vec2f& p1, const Vec2f& p2, Vec2f&
 int HalfOutline::find_cross_from_tail( const Vec2f& p1, const Vec2f& p2, Vec2f& p_cross, int step_limit ) const
 {
     treecore_assert( outline.size() > 1 );
-    treecore_assert( outline.size() == outline_bounds.size() + 1 );
+    treecore_assert( outline.size() == segments.size() + 1 );
 
     SUCK_GEOM_BLK( OutlineSucker sucker( *this, "find cross from tail" );
                    sucker.draw_vtx( p1 );
                    sucker.draw_vtx( p2 );
     );
 
-    const BBox2f bound_input( p1, p2 );
+    const OutlineSegments::Query query( p1, p2 );
 
-    for (int i = outline.size() - 2; i >= 0; i--)
+    // segments before last final vertex can't be cut
+    const int i_min = std::max( num_final > 0 ? num_final - 1 : 0, outline.size() - step_limit );
+    const int i_max = segments.size() - 1;
+
+    for (int i_pack = i_max / 4; i_pack >= 0 && i_pack * 4 + 3 >= i_min; i_pack--)
     {
-        if (outline.size() - i > step_limit) break;
+        int lanes = segments.test_pack( i_pack, query );
 
-        if (bound_input ^ outline_bounds[i])
+        for (int lane = 3; lanes != 0 && lane >= 0; lane--)
         {
-            const Vec2f& p3 = outline[i];
-            const Vec2f& p4 = outline[i + 1];
+            const int i = i_pack * 4 + lane;
+            if ( !( lanes & (1 << lane) ) || i > i_max || i < i_min )
+                continue;
+
+            lanes &= ~(1 << lane);
 
-            if ( cross_test_inc( p1, p2, p3, p4, p_cross ) )
+            if ( cross_test_inc( p1, p2, outline[i], outline[i + 1], p_cross ) )
             {
                 SUCK_GEOM_BLK( OutlineSucker sucker( *this, "got cross" );
                                sucker.draw_vtx( p1 );
@@ -106,25 +95,6 @@ int HalfOutline::find_cross_from_tail( const Vec2f& p1, const Vec2f& p2, Vec2f&
                 )
                 return i;
             }
-
-            SUCK_GEOM_BLK( OutlineSucker sucker( *this, "not cross" );
-                           sucker.draw_vtx( p1 );
-                           sucker.draw_vtx( p2 );
-                           sucker.rgb( SUCKER_RED );
-                           sucker.draw_vtx( i );
-                           sucker.draw_vtx( i + 1 );
-                           sucker.draw_vtx( p_cross );
-            )
-        }
-        else
-        {
-            SUCK_GEOM_BLK( OutlineSucker sucker( *this, "not cross by bbox" );
-                           sucker.draw_vtx( p1 );
-                           sucker.draw_vtx( p2 );
-                           sucker.rgb( SUCKER_RED );
-                           sucker.draw_vtx( i );
-                           sucker.draw_vtx( i + 1 );
-            )
         }
     }
 
@@ -268,7 +238,7 @@ void HalfOutline::process_inner( const HalfOutline&         outer_peer,
         treecore_assert( outline.size() > 0 );
         treecore_assert( outer_peer.size() > 0 );
 
-        if ( cross_test_inc( outline.getFirst(), outer_peer.outline.getFirst(), p1, p2, p_cross ) )
+        if ( cross_test_inc( head, outer_peer.head, p1, p2, p_cross ) )
         {
             add( p_cross, id1 );
             add( p2,      id2 );
@@ -298,10 +268,7 @@ void HalfOutline::process_inner( const HalfOutline&         outer_peer,
 
 void HalfOutline::accum_trip( treecore::Array<float>& results ) const
 {
-    results.add( 0.0f );
-
-    for (int i = 1; i < outline.size(); i++)
-        results.add( (outline[i] - outline[i - 1]).length() + results[i - 1] );
+    treeface::accum_trip( outline, results );
 }
 
 } // namespace treeface
@@ -3,6 +3,7 @@
 
 #include "treeface/graphics/BBox2.h"
 #include "treeface/math/Vec2.h"
+#include "treeface/graphics/guts/OutlineSegments.h"
 #include "treeface/graphics/guts/Utils.h"
 
 #include "treeface/graphics/guts/GeomSucker.h"
@@ -19,7 +20,7 @@ struct HalfOutline
     void add( const Vec2f& vtx, JointID id )
     {
         treecore_assert( outline.size() == joint_ids.size() );
-        treecore_assert( ( outline.size() == 0 ) || ( outline.size() == outline_bounds.size() + 1 ) );
+        treecore_assert( ( outline.size() == 0 ) || ( outline.size() == segments.size() + 1 ) );
 
         SUCK_GEOM_BLK(
             OutlineSucker sucker( *this, "add vertex" );
@@ -28,19 +29,66 @@ struct HalfOutline
         )
 
         if ( outline.size() )
-            outline_bounds.add( {outline.getLast(), vtx} );
+            segments.add( outline.getLast(), vtx );
+        else
+            head = vtx;
         outline.add( vtx );
         joint_ids.add( id );
     }
 
+    ///
+    /// \brief remove all vertices but keep allocated storage
+    ///
+    void clear() noexcept
+    {
+        outline.clearQuick();
+        segments.clear();
+        joint_ids.clearQuick();
+        sunken    = false;
+        num_head  = 0;
+        num_final = 0;
+    }
+
     void resize( int size )
     {
         treecore_assert( size > 0 );
         outline.resize( size );
-        outline_bounds.resize( size - 1 );
+        segments.resize( size - 1 );
         joint_ids.resize( size );
     }
 
+    ///
+    /// \brief remove vertices in the middle or at beginning of outline
+    ///
+    /// Used when closed stroke cuts its head, and by streamed stroke to drop
+    /// vertices that are already triangulated.
+    ///
+    void remove_range( int i_begin, int num )
+    {
+        treecore_assert( 0 <= i_begin && i_begin + num < outline.size() );
+        outline.removeRange( i_begin, num );
+        joint_ids.removeRange( i_begin, num );
+
+        // segments are shifted across SIMD lanes, so they are rebuilt from
+        // the one that now crosses the gap
+        int i_seg_begin = i_begin > 0 ? i_begin - 1 : 0;
+        segments.resize( outline.size() - 1 );
+        for (int i = i_seg_begin; i < segments.size(); i++)
+            segments.set( i, outline[i], outline[i + 1] );
+    }
+
+    ///
+    /// \brief move an existing vertex, segments on both sides are updated
+    ///
+    void set_vertex( int i, const Vec2f& vtx ) noexcept
+    {
+        outline.getReference( i ) = vtx;
+        if (i > 0)
+            segments.set( i - 1, outline[i - 1], vtx );
+        if (i < segments.size())
+            segments.set( i, vtx, outline[i + 1] );
+    }
+
     void salvage( const Vec2f& p1, const Vec2f& r_prev, JointID id )
     {
         if (sunken)
@@ -81,7 +129,7 @@ struct HalfOutline
     int size() const noexcept
     {
         treecore_assert( outline.size() == joint_ids.size() );
-        treecore_assert( outline.size() == outline_bounds.size() + 1 );
+        treecore_assert( outline.size() == segments.size() + 1 );
         return outline.size();
     }
 
@@ -113,10 +161,20 @@ struct HalfOutline
     void accum_trip( treecore::Array<float>& results ) const;
 
     treecore::Array<Vec2f>   outline;
-    treecore::Array<BBox2f>  outline_bounds;
+    OutlineSegments          segments; ///< bounds and end points of segments between outline vertices
     treecore::Array<JointID> joint_ids;
     float side; // 1 for left, -1 for right
     bool  sunken = false;
+
+    Vec2f head; ///< first vertex ever added, which is kept when it is removed by streamed stroke
+
+    // streamed stroke keeps leading vertices of closed stroke, as they are
+    // modified when stroke is closed
+    int num_head = 0;
+
+    // leading vertices that are already triangulated by streamed stroke,
+    // inner crossing is not searched into them
+    int num_final = 0;
 };
 
 } // namespace treeface
@@ -364,15 +364,12 @@ void LineStroker::close_stroke_end( const Vec2f& skeleton_last, const Vec2f& ske
                                        sucker.draw_vtx( i );
                     );
 
-                    part_inner->outline.removeRange( 0, i_head );
-                    part_inner->joint_ids.removeRange( 0, i_head );
-                    part_inner->outline_bounds.removeRange( 0, i_head );
+                    remove_head( *part_inner, i_head );
 
                     SUCK_GEOM_BLK( OutlineSucker sucker( *part_inner, "after shift" ); );
                 }
 
-                part_inner->outline[0]        = head_cross;
-                part_inner->outline_bounds[0] = BBox2f( part_inner->outline[0], part_inner->outline[1] );
+                part_inner->set_vertex( 0, head_cross );
 
                 SUCK_GEOM_BLK( OutlineSucker sucker( *part_inner, "inner head modified" );
                                sucker.rgb( SUCKER_BLUE );
@@ -387,8 +384,7 @@ void LineStroker::close_stroke_end( const Vec2f& skeleton_last, const Vec2f& ske
                 );
 
                 int last_i = part_inner->size() - 1;
-                part_inner->outline[last_i] = head_cross;
-                part_inner->outline_bounds.getLast() = BBox2f( part_inner->outline[last_i], part_inner->outline[last_i - 1] );
+                part_inner->set_vertex( last_i, head_cross );
 
                 SUCK_GEOM_BLK( OutlineSucker sucker( *part_inner, "inner part closed" );
                                sucker.draw_outline( *part_outer );
@@ -429,12 +425,13 @@ void LineStroker::close_stroke_end( const Vec2f& skeleton_last, const Vec2f& ske
     stroke_done = true;
 }
 
-inline bool _should_advance_( const Array<JointID>& ids_self, const Array<JointID>& ids_peer, int i_self, int i_peer )
+inline bool _should_advance_( const Array<JointID>& ids_self, const Array<JointID>& ids_peer,
+                             int i_self, int i_peer, int i_self_end, int i_peer_end )
 {
-    if (i_self == ids_self.size() - 1)
+    if (i_self == i_self_end)
         return false;
 
-    if (i_peer == ids_peer.size() - 1)
+    if (i_peer == i_peer_end)
         return true;
 
     // now both side have next thing
@@ -455,51 +452,66 @@ inline bool _should_advance_( const Array<JointID>& ids_self, const Array<JointI
     }
 }
 
-void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treecore::Array<IndexType>& result_indices, bool path_is_closed ) const
+inline float _trip_between_( const HalfOutline& part, int i_begin, int i_end )
 {
-    treecore_assert( stroke_done );
-
-    SUCK_GEOM_BLK( OutlineSucker sucker( part_left, "begin triangulate" );
-                   sucker.draw_outline( part_right );
-    )
-
-    Array<float> trip_left;
-    Array<float> trip_right;
-    part_left.accum_trip( trip_left );
-    part_right.accum_trip( trip_right );
-
-    treecore_assert( trip_left.size() == part_left.size() );
-    treecore_assert( trip_right.size() == part_right.size() );
+    float trip = 0.0f;
+    for (int i = i_begin + 1; i <= i_end; i++)
+        trip = (part.outline[i] - part.outline[i - 1]).length() + trip;
+    return trip;
+}
 
-    // initial state
-    int i_left_prev  = 0;
-    int i_right_prev = 0;
+// last outline vertex that won't be modified by further extension, whose next
+// vertex is also final, as tangent is calculated from both neighbors
+inline int _final_end_( const HalfOutline& part )
+{
+    return part.size() - STROKE_STREAM_WINDOW - 1;
+}
 
-    const IndexType idx_left_begin = result_vertices.size();
-    result_vertices.add( StrokeVertex{ part_left.outline[0],
-                                       part_left.get_tangent_unorm( 0, path_is_closed ),
-                                       trip_left[0] / trip_left.getLast(),
+void LineStroker::zip_begin( Geometry::HostVertexCache& result_vertices, ZipCursor& cursor, bool path_is_closed ) const
+{
+    cursor.idx_left = result_vertices.size();
+    result_vertices.add( StrokeVertex{ part_left.outline[cursor.i_left],
+                                       part_left.get_tangent_unorm( cursor.i_left, path_is_closed ),
+                                       cursor.trip_left / cursor.trip_left_total,
                                        0.0f } );
-    const IndexType idx_right_begin = result_vertices.size();
-    result_vertices.add( StrokeVertex{ part_right.outline[0],
-                                       part_right.get_tangent_unorm( 0, path_is_closed ),
-                                       trip_right[0] / trip_right.getLast(),
+    cursor.idx_right = result_vertices.size();
+    result_vertices.add( StrokeVertex{ part_right.outline[cursor.i_right],
+                                       part_right.get_tangent_unorm( cursor.i_right, path_is_closed ),
+                                       cursor.trip_right / cursor.trip_right_total,
                                        1.0f } );
+}
 
-    IndexType idx_left_prev  = idx_left_begin;
-    IndexType idx_right_prev = idx_right_begin;
+template<typename IdxT>
+void LineStroker::zip( Geometry::HostVertexCache& result_vertices,
+                       treecore::Array<IdxT>&     result_indices,
+                       ZipCursor&                 cursor,
+                       int i_left_end,
+                       int i_right_end,
+                       bool                       stop_at_any_end,
+                       const ZipCursor*           end_cursor,
+                       bool                       path_is_closed ) const
+{
+    int   i_left_prev     = cursor.i_left;
+    int   i_right_prev    = cursor.i_right;
+    IdxT  idx_left_prev   = IdxT( cursor.idx_left );
+    IdxT  idx_right_prev  = IdxT( cursor.idx_right );
+    float trip_left_prev  = cursor.trip_left;
+    float trip_right_prev = cursor.trip_right;
 
     // move on two sides
-    for (;; )
+    while (i_left_prev != i_left_end || i_right_prev != i_right_end)
     {
+        if ( stop_at_any_end && (i_left_prev >= i_left_end || i_right_prev >= i_right_end) )
+            break;
+
         int i_left  = i_left_prev;
         int i_right = i_right_prev;
 
-        IndexType idx_left  = idx_left_prev;
-        IndexType idx_right = idx_right_prev;
+        IdxT idx_left  = idx_left_prev;
+        IdxT idx_right = idx_right_prev;
 
-        bool left_move_on  = _should_advance_( part_left.joint_ids, part_right.joint_ids, i_left_prev, i_right_prev );
-        bool right_move_on = _should_advance_( part_right.joint_ids, part_left.joint_ids, i_right_prev, i_left_prev );
+        bool left_move_on  = _should_advance_( part_left.joint_ids, part_right.joint_ids, i_left_prev, i_right_prev, i_left_end, i_right_end );
+        bool right_move_on = _should_advance_( part_right.joint_ids, part_left.joint_ids, i_right_prev, i_left_prev, i_right_end, i_left_end );
 
         treecore_assert( left_move_on || right_move_on );
 
@@ -507,11 +519,20 @@ void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treec
         if (left_move_on)
         {
             i_left++;
-            idx_left = result_vertices.size();
-            result_vertices.add( StrokeVertex{ part_left.outline[i_left],
-                                               part_left.get_tangent_unorm( i_left, path_is_closed ),
-                                               trip_left[i_left] / trip_left.getLast(),
-                                               0.0f } );
+            trip_left_prev = (part_left.outline[i_left] - part_left.outline[i_left - 1]).length() + trip_left_prev;
+
+            if (end_cursor != nullptr && i_left == i_left_end)
+            {
+                idx_left = IdxT( end_cursor->idx_left );
+            }
+            else
+            {
+                idx_left = result_vertices.size();
+                result_vertices.add( StrokeVertex{ part_left.outline[i_left],
+                                                   part_left.get_tangent_unorm( i_left, path_is_closed ),
+                                                   trip_left_prev / cursor.trip_left_total,
+                                                   0.0f } );
+            }
 
             SUCK_GEOM_BLK( OutlineSucker sucker( part_left, "left move on" );
                            sucker.rgba( SUCKER_GREEN, 0.5f );
@@ -524,11 +545,20 @@ void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treec
         if (right_move_on)
         {
             i_right++;
-            idx_right = result_vertices.size();
-            result_vertices.add( StrokeVertex{ part_right.outline[i_right],
-                                               part_right.get_tangent_unorm( i_right, path_is_closed ),
-                                               trip_right[i_right] / trip_right.getLast(),
-                                               1.0f } );
+            trip_right_prev = (part_right.outline[i_right] - part_right.outline[i_right - 1]).length() + trip_right_prev;
+
+            if (end_cursor != nullptr && i_right == i_right_end)
+            {
+                idx_right = IdxT( end_cursor->idx_right );
+            }
+            else
+            {
+                idx_right = result_vertices.size();
+                result_vertices.add( StrokeVertex{ part_right.outline[i_right],
+                                                   part_right.get_tangent_unorm( i_right, path_is_closed ),
+                                                   trip_right_prev / cursor.trip_right_total,
+                                                   1.0f } );
+            }
 
             SUCK_GEOM_BLK( OutlineSucker sucker( part_right, "right move on" );
                            sucker.rgba( SUCKER_GREEN, 0.5f );
@@ -541,7 +571,7 @@ void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treec
         // generate triangle
         if (left_move_on)
         {
-            treecore_assert( idx_left_prev < idx_left );
+            treecore_assert( idx_left_prev != idx_left );
             result_indices.add( idx_left_prev );
             result_indices.add( idx_right_prev );
             result_indices.add( idx_left );
@@ -556,7 +586,7 @@ void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treec
 
             if (right_move_on)
             {
-                treecore_assert( idx_right_prev < idx_right );
+                treecore_assert( idx_right_prev != idx_right );
                 result_indices.add( idx_right_prev );
                 result_indices.add( idx_right );
                 result_indices.add( idx_left );
@@ -574,7 +604,7 @@ void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treec
         {
             if (right_move_on)
             {
-                treecore_assert( idx_right_prev < idx_right );
+                treecore_assert( idx_right_prev != idx_right );
                 result_indices.add( idx_left_prev );
                 result_indices.add( idx_right_prev );
                 result_indices.add( idx_right );
@@ -597,11 +627,186 @@ void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treec
         i_right_prev   = i_right;
         idx_left_prev  = idx_left;
         idx_right_prev = idx_right;
+    }
 
-        if (i_left  == part_left.size() - 1 &&
-            i_right == part_right.size() - 1)
-            break;
+    cursor.i_left     = i_left_prev;
+    cursor.i_right    = i_right_prev;
+    cursor.idx_left   = idx_left_prev;
+    cursor.idx_right  = idx_right_prev;
+    cursor.trip_left  = trip_left_prev;
+    cursor.trip_right = trip_right_prev;
+}
+
+template<typename IdxT>
+void LineStroker::triangulate( Geometry::HostVertexCache& result_vertices, treecore::Array<IdxT>& result_indices, bool path_is_closed ) const
+{
+    treecore_assert( stroke_done );
+    treecore_assert( result_vertices.size() + get_num_result_vertex() - 1 <= std::numeric_limits<IdxT>::max() );
+
+    SUCK_GEOM_BLK( OutlineSucker sucker( part_left, "begin triangulate" );
+                   sucker.draw_outline( part_right );
+    )
+
+    ZipCursor cursor{ 0, 0, 0, 0, 0.0f, 0.0f,
+                      _trip_between_( part_left, 0, part_left.size() - 1 ),
+                      _trip_between_( part_right, 0, part_right.size() - 1 ) };
+
+    zip_begin( result_vertices, cursor, path_is_closed );
+    zip( result_vertices, result_indices, cursor, part_left.size() - 1, part_right.size() - 1, false, nullptr, path_is_closed );
+}
+
+int LineStroker::get_num_final_vertex() const noexcept
+{
+    if (stroke_done)
+        return 0;
+
+    int num_left  = _final_end_( part_left ) + 1 - part_left.num_final;
+    int num_right = _final_end_( part_right ) + 1 - part_right.num_final;
+    return std::max( num_left, 0 ) + std::max( num_right, 0 );
+}
+
+bool LineStroker::stream_begin( int i_left_end, int i_right_end, bool path_is_closed ) noexcept
+{
+    if (i_left_end < 0 || i_right_end < 0)
+        return false;
+
+    ZipCursor cursor{ 0, 0, 0, 0, 0.0f, 0.0f, 1.0f, 1.0f };
+
+    // Leading vertices of closed stroke could be cut when it is closed, so
+    // streaming begins after them, at where zipping from head would reach.
+    // They are triangulated after stroke is closed.
+    if (path_is_closed)
+    {
+        while (cursor.i_left <= TAIL_FIND_LIMIT || cursor.i_right <= TAIL_FIND_LIMIT)
+        {
+            if (cursor.i_left == i_left_end || cursor.i_right == i_right_end)
+                return false;
+
+            bool left_move_on  = _should_advance_( part_left.joint_ids, part_right.joint_ids, cursor.i_left, cursor.i_right, i_left_end, i_right_end );
+            bool right_move_on = _should_advance_( part_right.joint_ids, part_left.joint_ids, cursor.i_right, cursor.i_left, i_right_end, i_left_end );
+
+            if (left_move_on)
+            {
+                cursor.i_left++;
+                cursor.trip_left = (part_left.outline[cursor.i_left] - part_left.outline[cursor.i_left - 1]).length() + cursor.trip_left;
+            }
+
+            if (right_move_on)
+            {
+                cursor.i_right++;
+                cursor.trip_right = (part_right.outline[cursor.i_right] - part_right.outline[cursor.i_right - 1]).length() + cursor.trip_right;
+            }
+        }
+
+        part_left.num_head  = cursor.i_left + 1;
+        part_right.num_head = cursor.i_right + 1;
     }
+
+    stream_cursor = cursor;
+    stream_begun  = true;
+    return true;
 }
 
+void LineStroker::stream_drop_triangulated() noexcept
+{
+    // last triangulated vertex is kept, as next triangles are built from it
+    int num_left = stream_cursor.i_left - part_left.num_head;
+    if (num_left > 0)
+    {
+        part_left.remove_range( part_left.num_head, num_left );
+        stream_cursor.i_left -= num_left;
+    }
+
+    int num_right = stream_cursor.i_right - part_right.num_head;
+    if (num_right > 0)
+    {
+        part_right.remove_range( part_right.num_head, num_right );
+        stream_cursor.i_right -= num_right;
+    }
+
+    part_left.num_final  = stream_cursor.i_left + 1;
+    part_right.num_final = stream_cursor.i_right + 1;
+}
+
+void LineStroker::remove_head( HalfOutline& part, int num ) noexcept
+{
+    part.remove_range( 0, num );
+
+    if (stream_begun)
+    {
+        if (&part == &part_left)
+        {
+            stream_cursor.i_left   -= num;
+            stream_head_end.i_left -= num;
+        }
+        else
+        {
+            stream_cursor.i_right   -= num;
+            stream_head_end.i_right -= num;
+        }
+
+        part.num_head  -= num;
+        part.num_final -= num;
+    }
+}
+
+template<typename IdxT>
+void LineStroker::triangulate_final( Geometry::HostVertexCache& result_vertices, treecore::Array<IdxT>& result_indices, bool path_is_closed )
+{
+    treecore_assert( !stroke_done );
+    treecore_assert( result_vertices.size() + get_num_result_vertex() - 1 <= std::numeric_limits<IdxT>::max() );
+
+    const int i_left_end  = _final_end_( part_left );
+    const int i_right_end = _final_end_( part_right );
+
+    if (!stream_begun)
+    {
+        if ( !stream_begin( i_left_end, i_right_end, path_is_closed ) )
+            return;
+
+        zip_begin( result_vertices, stream_cursor, path_is_closed );
+        stream_head_end = stream_cursor;
+    }
+
+    zip( result_vertices, result_indices, stream_cursor, i_left_end, i_right_end, true, nullptr, path_is_closed );
+    stream_drop_triangulated();
+}
+
+template<typename IdxT>
+void LineStroker::triangulate_rest( Geometry::HostVertexCache& result_vertices, treecore::Array<IdxT>& result_indices, bool path_is_closed )
+{
+    treecore_assert( stroke_done );
+    treecore_assert( result_vertices.size() + get_num_result_vertex() - 1 <= std::numeric_limits<IdxT>::max() );
+
+    if (!stream_begun)
+    {
+        stream_cursor = ZipCursor{ 0, 0, 0, 0, 0.0f, 0.0f, 1.0f, 1.0f };
+        zip_begin( result_vertices, stream_cursor, path_is_closed );
+    }
+
+    zip( result_vertices, result_indices, stream_cursor, part_left.size() - 1, part_right.size() - 1, false, nullptr, path_is_closed );
+
+    // leading vertices of closed stroke, which is joined to where streaming
+    // began
+    if (stream_begun && path_is_closed)
+    {
+        ZipCursor head{ 0, 0, 0, 0,
+                        stream_head_end.trip_left - _trip_between_( part_left, 0, stream_head_end.i_left ),
+                        stream_head_end.trip_right - _trip_between_( part_right, 0, stream_head_end.i_right ),
+                        1.0f, 1.0f };
+
+        zip_begin( result_vertices, head, path_is_closed );
+        zip( result_vertices, result_indices, head, stream_head_end.i_left, stream_head_end.i_right, false, &stream_head_end, path_is_closed );
+    }
+
+    stream_begun = false;
+}
+
+template void LineStroker::triangulate<uint16>( Geometry::HostVertexCache&, Array<uint16>&, bool ) const;
+template void LineStroker::triangulate<uint32>( Geometry::HostVertexCache&, Array<uint32>&, bool ) const;
+template void LineStroker::triangulate_final<uint16>( Geometry::HostVertexCache&, Array<uint16>&, bool );
+template void LineStroker::triangulate_final<uint32>( Geometry::HostVertexCache&, Array<uint32>&, bool );
+template void LineStroker::triangulate_rest<uint16>( Geometry::HostVertexCache&, Array<uint16>&, bool );
+template void LineStroker::triangulate_rest<uint32>( Geometry::HostVertexCache&, Array<uint32>&, bool );
+
 } // namespace treeface
@@ -17,11 +17,23 @@ namespace treeface
 struct LineStroker
 {
     LineStroker( const StrokeStyle& pub_style )
-        : style(InternalStrokeStyle{ pub_style.cap, pub_style.join, std::cos(pub_style.miter_cutoff), pub_style.width / 2 })
-        , part_left( 1.0f )
+        : part_left( 1.0f )
         , part_right( -1.0f )
+        , style( _internal_style_( pub_style ) )
     {}
 
+    ///
+    /// \brief start a new stroke, reusing storage of previous one
+    ///
+    void reset( const StrokeStyle& pub_style ) noexcept
+    {
+        part_left.clear();
+        part_right.clear();
+        stroke_done  = false;
+        stream_begun = false;
+        style        = _internal_style_( pub_style );
+    }
+
     void cap_begin( const Vec2f& skeleton, const Vec2f& direction );
     void close_stroke_begin( const Vec2f& skeleton, const Vec2f& direction );
 
@@ -30,12 +42,104 @@ struct LineStroker
     void cap_end( const Vec2f& skeleton, const Vec2f& direction );
     void close_stroke_end( const Vec2f& skeleton_last, const Vec2f& skeleton_first, const Vec2f& v_begin );
 
-    void triangulate( Geometry::HostVertexCache& result_vertices, treecore::Array<IndexType>& result_indices, bool path_is_closed ) const;
+    ///
+    /// \brief number of vertices that triangulate() will add
+    ///
+    int get_num_result_vertex() const noexcept
+    {
+        return part_left.size() + part_right.size();
+    }
+
+    ///
+    /// \brief generate stroke triangles from both sides of outline
+    ///
+    /// Instantiated for 16-bit and 32-bit indices. Caller should ensure
+    /// vertices can be addressed by IdxT.
+    ///
+    template<typename IdxT>
+    void triangulate( Geometry::HostVertexCache& result_vertices, treecore::Array<IdxT>& result_indices, bool path_is_closed ) const;
+
+    ///
+    /// \brief number of outline vertices that won't be modified by further
+    ///        extension, and are not triangulated yet
+    ///
+    int get_num_final_vertex() const noexcept;
+
+    ///
+    /// \brief triangulate final part of an unfinished stroke, and drop it
+    ///        from outline
+    ///
+    /// Outline vertices within STROKE_STREAM_WINDOW from tail could still be
+    /// cut by inner side of later joints, and are kept. Leading vertices of
+    /// closed stroke are also kept until stroke is closed.
+    ///
+    /// Unlike triangulate(), trip of streamed vertices is the distance from
+    /// stroke begin, as total length is not known yet.
+    ///
+    template<typename IdxT>
+    void triangulate_final( Geometry::HostVertexCache& result_vertices, treecore::Array<IdxT>& result_indices, bool path_is_closed );
+
+    ///
+    /// \brief triangulate all remaining vertices of a finished streamed
+    ///        stroke
+    /// \see triangulate_final()
+    ///
+    template<typename IdxT>
+    void triangulate_rest( Geometry::HostVertexCache& result_vertices, treecore::Array<IdxT>& result_indices, bool path_is_closed );
 
     HalfOutline part_left;
     HalfOutline part_right;
     bool        stroke_done = false;
     InternalStrokeStyle style;
+
+private:
+    ///
+    /// \brief last triangulated vertex on both sides
+    ///
+    struct ZipCursor
+    {
+        int              i_left;
+        int              i_right;
+        treecore::uint32 idx_left;  ///< index in result vertices
+        treecore::uint32 idx_right;
+        float            trip_left;
+        float            trip_right;
+        float            trip_left_total; ///< trip is divided by this
+        float            trip_right_total;
+    };
+
+    void zip_begin( Geometry::HostVertexCache& result_vertices, ZipCursor& cursor, bool path_is_closed ) const;
+
+    ///
+    /// \brief triangulate between cursor and end vertices of both sides
+    ///
+    /// \param stop_at_any_end  stop when any side reaches end, used when
+    ///                         vertices after end are not known yet
+    /// \param end_cursor       if not null, end vertices are already added
+    ///                         by this cursor
+    ///
+    template<typename IdxT>
+    void zip( Geometry::HostVertexCache& result_vertices,
+              treecore::Array<IdxT>&     result_indices,
+              ZipCursor&                 cursor,
+              int i_left_end,
+              int i_right_end,
+              bool                       stop_at_any_end,
+              const ZipCursor*           end_cursor,
+              bool                       path_is_closed ) const;
+
+    bool stream_begin( int i_left_end, int i_right_end, bool path_is_closed ) noexcept;
+    void stream_drop_triangulated() noexcept;
+    void remove_head( HalfOutline& part, int num ) noexcept;
+
+    bool      stream_begun = false;
+    ZipCursor stream_cursor;
+    ZipCursor stream_head_end; // where leading vertices of closed stroke are joined
+
+    static InternalStrokeStyle _internal_style_( const StrokeStyle& pub_style ) noexcept
+    {
+        return InternalStrokeStyle{ pub_style.cap, pub_style.join, std::cos( pub_style.miter_cutoff ), pub_style.width / 2 };
+    }
 };
 
 } // namespace treeface
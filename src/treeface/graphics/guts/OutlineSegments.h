@@ -0,0 +1,192 @@
+#ifndef TREEFACE_OUTLINE_SEGMENTS_H
+#define TREEFACE_OUTLINE_SEGMENTS_H
+
+#include "treeface/math/Vec2.h"
+
+#include <treecore/AlignedMalloc.h>
+#include <treecore/Array.h>
+#include <treecore/FloatUtils.h>
+#include <treecore/IntTypes.h>
+#include <treecore/SimdObject.h>
+
+#include <cmath>
+
+namespace treeface
+{
+
+///
+/// \brief segments of half outline stored in SoA layout, so that one query
+///        segment is tested against four of them at once
+///
+/// Segment i goes from outline vertex i to i + 1, and is stored at lane
+/// i % 4 of pack i / 4.
+///
+struct OutlineSegments
+{
+    typedef treecore::SimdObject<float, 4>           DataType;
+    typedef treecore::SimdObject<treecore::int32, 4> MaskType;
+
+    struct Pack
+    {
+        TREECORE_ALIGNED_ALLOCATOR( Pack );
+
+        DataType x_min;
+        DataType x_max;
+        DataType y_min;
+        DataType y_max;
+        DataType x1; ///< start point
+        DataType y1;
+        DataType x2; ///< end point
+        DataType y2;
+    };
+
+    ///
+    /// \brief query segment broadcasted to all lanes
+    ///
+    struct Query
+    {
+        Query( const Vec2f& p1, const Vec2f& p2 )
+            : x1( p1.x ), y1( p1.y ), x2( p2.x ), y2( p2.y )
+            , vx( p2.x - p1.x ), vy( p2.y - p1.y )
+            , x_min( std::fmin( p1.x, p2.x ) ), x_max( std::fmax( p1.x, p2.x ) )
+            , y_min( std::fmin( p1.y, p2.y ) ), y_max( std::fmax( p1.y, p2.y ) )
+        {}
+
+        DataType x1;
+        DataType y1;
+        DataType x2;
+        DataType y2;
+        DataType vx;
+        DataType vy;
+        DataType x_min;
+        DataType x_max;
+        DataType y_min;
+        DataType y_max;
+    };
+
+    int size() const noexcept
+    {
+        return num_segment;
+    }
+
+    int num_pack() const noexcept
+    {
+        return (num_segment + 3) / 4;
+    }
+
+    void clear() noexcept
+    {
+        packs.clearQuick();
+        num_segment = 0;
+    }
+
+    ///
+    /// \brief keep first num segments, storage of dropped lanes is not
+    ///        cleared
+    ///
+    void resize( int num ) noexcept
+    {
+        treecore_assert( 0 <= num && num <= num_segment );
+        num_segment = num;
+        packs.resize( num_pack() );
+    }
+
+    void add( const Vec2f& p1, const Vec2f& p2 )
+    {
+        if (num_segment % 4 == 0)
+            packs.add( Pack() );
+        num_segment++;
+        set( num_segment - 1, p1, p2 );
+    }
+
+    void set( int i, const Vec2f& p1, const Vec2f& p2 ) noexcept
+    {
+        treecore_assert( 0 <= i && i < num_segment );
+        Pack& pack = packs.getReference( i / 4 );
+
+        switch (i % 4)
+        {
+        case 0: _set_lane_<0>( pack, p1, p2 ); break;
+        case 1: _set_lane_<1>( pack, p1, p2 ); break;
+        case 2: _set_lane_<2>( pack, p1, p2 ); break;
+        case 3: _set_lane_<3>( pack, p1, p2 ); break;
+        }
+    }
+
+    ///
+    /// \brief test query segment against all four segments of a pack
+    ///
+    /// A lane is accepted if bounding boxes overlap, and if the segments
+    /// straddle each other or are parallel. This is a superset of what
+    /// cross_test_inc() accepts, as straddle test is done by same arithmetic,
+    /// while parallel and zero-length segments are left to cross_test_inc().
+    ///
+    /// \return bit k is set if segment at lane k may cross query segment
+    ///
+    int test_pack( int i_pack, const Query& query ) const noexcept
+    {
+        const Pack& pack = packs.getReference( i_pack );
+
+        // sign bit is set if any of them is negative, most packs are far
+        // from query segment and are rejected here
+        DataType box_out = (pack.x_max - query.x_min) | (query.x_max - pack.x_min) |
+                           (pack.y_max - query.y_min) | (query.y_max - pack.y_min);
+        if ( _all_negative_( box_out ) )
+            return 0;
+
+        // same as rule_34_on_12 and rule_12_on_34 in cross_test_inc()
+        const DataType zero( 0.0f );
+        DataType vx34 = pack.x2 - pack.x1;
+        DataType vy34 = pack.y2 - pack.y1;
+        DataType rule_34_on_12 = ( (pack.x1 - query.x1) * query.vy - (pack.y1 - query.y1) * query.vx ) *
+                                 ( (pack.x2 - query.x1) * query.vy - (pack.y2 - query.y1) * query.vx );
+        DataType rule_12_on_34 = ( (query.x1 - pack.x1) * vy34 - (query.y1 - pack.y1) * vx34 ) *
+                                 ( (query.x2 - pack.x1) * vy34 - (query.y2 - pack.y1) * vx34 );
+        DataType denom = query.vx * vy34 - query.vy * vx34;
+
+        // subtracted from zero, so that both +0 and -0 become +0
+        DataType straddle_out = (zero - rule_34_on_12) | (zero - rule_12_on_34);
+        DataType parallel_out = zero - denom * denom;
+
+        return _positive_lanes_( box_out ) & _positive_lanes_( straddle_out & parallel_out );
+    }
+
+    treecore::Array<Pack, 16> packs;
+    int num_segment = 0;
+
+private:
+    // sign bits are turned into +1 or -1 and summed, which avoids extracting
+    // lanes one by one
+    static bool _all_negative_( const DataType& value ) noexcept
+    {
+        const MaskType sign_mask( treecore::float_sign_mask<float>::value );
+        const MaskType one_bits( 0x3f800000 );
+        return ( (value & sign_mask) ^ one_bits ).sum() == -4.0f;
+    }
+
+    // bit k is set if sign bit of lane k is clear
+    static int _positive_lanes_( const DataType& value ) noexcept
+    {
+        return (std::signbit( value.template get<0>() ) ? 0 : 1) |
+               (std::signbit( value.template get<1>() ) ? 0 : 2) |
+               (std::signbit( value.template get<2>() ) ? 0 : 4) |
+               (std::signbit( value.template get<3>() ) ? 0 : 8);
+    }
+
+    template<int LANE>
+    static void _set_lane_( Pack& pack, const Vec2f& p1, const Vec2f& p2 ) noexcept
+    {
+        pack.x_min.template set<LANE>( std::fmin( p1.x, p2.x ) );
+        pack.x_max.template set<LANE>( std::fmax( p1.x, p2.x ) );
+        pack.y_min.template set<LANE>( std::fmin( p1.y, p2.y ) );
+        pack.y_max.template set<LANE>( std::fmax( p1.y, p2.y ) );
+        pack.x1.template set<LANE>( p1.x );
+        pack.y1.template set<LANE>( p1.y );
+        pack.x2.template set<LANE>( p2.x );
+        pack.y2.template set<LANE>( p2.y );
+    }
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_OUTLINE_SEGMENTS_H
@@ -3,12 +3,21 @@
 #include "treeface/math/Constants.h"
 #include "treeface/math/Mat2.h"
 
+#include <treecore/SimdObject.h>
+
+// upper limit of segments on one curve, which also limits error accumulated
+// by forward differencing
+#define MAX_NUM_CURVE_SEGMENT 1024
+
+using namespace treecore;
+
 namespace treeface
 {
 
-void PathGlyph::segment_arc( const Vec2f& prev_end, Geometry::HostVertexCache& result_vertices ) const
+void PathGlyph::segment_arc( const Vec2f& prev_end, float tolerance, Geometry::HostVertexCache& result_vertices ) const
 {
     treecore_assert( type == GLYPH_TYPE_ARC );
+    treecore_assert( tolerance > 0.0f );
 
     // roll to 0-360 degree
     float angle_use = arc.angle;
@@ -16,8 +25,18 @@ void PathGlyph::segment_arc( const Vec2f& prev_end, Geometry::HostVertexCache& r
     while (angle_use > 2.0f * PI) angle_use -= 2.0f * PI;
 
     // determine step
-    int num_step = std::round( angle_use / PI * 32 );
-    if (num_step < 5 && angle_use > 0.0f) num_step = 5;
+    // the distance from chord middle to arc is r * (1 - cos(step / 2))
+    Vec2f v      = prev_end - Vec2f( arc.center_x, arc.center_y );
+    float radius = v.length();
+
+    int num_step = 1;
+    if (radius > tolerance)
+    {
+        float step_max = 2.0f * std::acos( 1.0f - tolerance / radius );
+        num_step = int( std::ceil( angle_use / step_max ) );
+        if (num_step < 1) num_step = 1;
+        if (num_step > MAX_NUM_CURVE_SEGMENT) num_step = MAX_NUM_CURVE_SEGMENT;
+    }
     float step = angle_use / num_step;
 
     // rotate from end point
@@ -26,9 +45,7 @@ void PathGlyph::segment_arc( const Vec2f& prev_end, Geometry::HostVertexCache& r
     else             rot.set_rotate( -step );
 
     // generate points
-    Vec2f v = prev_end - Vec2f( arc.center_x, arc.center_y );
-
-    for (int i = 1; i < num_step; i--)
+    for (int i = 1; i < num_step; i++)
     {
         v = rot * v;
         result_vertices.add( Vec2f( arc.center_x, arc.center_y ) + v );
@@ -37,77 +54,95 @@ void PathGlyph::segment_arc( const Vec2f& prev_end, Geometry::HostVertexCache& r
     result_vertices.add( end );
 }
 
-#define INTERPO( _a_, _frac_, _b_ ) _a_ * (1.0f - _frac_) + _b_ * _frac_
-
-inline Vec2f _bessel3_interpo_( const Vec2f& p1, const Vec2f& p2, const Vec2f& p3, float frac )
+int PathGlyph::get_num_bessel_segment( const Vec2f& prev_end, float tolerance ) const noexcept
 {
-    Vec2f tmp1 = INTERPO( p1, frac, p2 );
-    Vec2f tmp2 = INTERPO( p2, frac, p3 );
-    return INTERPO( tmp1, frac, tmp2 );
-}
+    treecore_assert( type == GLYPH_TYPE_BESSEL3 || type == GLYPH_TYPE_BESSEL4 );
+    treecore_assert( tolerance > 0.0f );
 
-inline Vec2f _bessel4_interpo_( const Vec2f& p1, const Vec2f& p2, const Vec2f& p3, const Vec2f& p4, float frac )
-{
-    Vec2f tmp_a1 = INTERPO( p1, frac, p2 );
-    Vec2f tmp_a2 = INTERPO( p2, frac, p3 );
-    Vec2f tmp_a3 = INTERPO( p3, frac, p4 );
+    // Wang's formula: a curve of degree n segmented into
+    // sqrt( n * (n-1) * M / (8 * tolerance) ) lines has error within
+    // tolerance, where M is the maximum length of second differences of
+    // control points
+    float deg_factor;
+    float diff2_max;
 
-    Vec2f tmp_b1 = INTERPO( tmp_a1, frac, tmp_a2 );
-    Vec2f tmp_b2 = INTERPO( tmp_a2, frac, tmp_a3 );
+    if (type == GLYPH_TYPE_BESSEL3)
+    {
+        Vec2f ctrl( bessel3.ctrl_x, bessel3.ctrl_y );
+        deg_factor = 2.0f / 8.0f;
+        diff2_max  = (prev_end - ctrl * 2.0f + end).length2();
+    }
+    else
+    {
+        Vec2f ctrl1( bessel4.ctrl1_x, bessel4.ctrl1_y );
+        Vec2f ctrl2( bessel4.ctrl2_x, bessel4.ctrl2_y );
+        deg_factor = 6.0f / 8.0f;
+        diff2_max  = std::max( (prev_end - ctrl1 * 2.0f + ctrl2).length2(),
+                               (ctrl1 - ctrl2 * 2.0f + end).length2() );
+    }
+
+    float num = std::ceil( std::sqrt( deg_factor * std::sqrt( diff2_max ) / tolerance ) );
 
-    Vec2f result = INTERPO( tmp_b1, frac, tmp_b2 );
-    return result;
+    if (num < 1.0f) return 1;
+    if (num > float( MAX_NUM_CURVE_SEGMENT )) return MAX_NUM_CURVE_SEGMENT;
+    return int( num );
 }
 
-void PathGlyph::segment_bessel( const Vec2f& prev_end, Geometry::HostVertexCache& result_vertices ) const
+void PathGlyph::segment_bessel( const Vec2f& prev_end, float tolerance, Geometry::HostVertexCache& result_vertices ) const
 {
-    treecore_assert( type == GLYPH_TYPE_BESSEL4 );
+    const int num_seg = get_num_bessel_segment( prev_end, tolerance );
 
-    float step     = 1.0f / 32;
-    Vec2f vtx_prev = prev_end;
+    // polynomial coefficients: P(t) = a * t^3 + b * t^2 + c * t + prev_end
+    Vec2f a;
+    Vec2f b;
+    Vec2f c;
 
-    float frac_prev = 0.0f;
-    float frac_curr = step;
+    if (type == GLYPH_TYPE_BESSEL3)
+    {
+        Vec2f ctrl( bessel3.ctrl_x, bessel3.ctrl_y );
+        a = Vec2f( 0.0f, 0.0f );
+        b = prev_end - ctrl * 2.0f + end;
+        c = (ctrl - prev_end) * 2.0f;
+    }
+    else
+    {
+        Vec2f ctrl1( bessel4.ctrl1_x, bessel4.ctrl1_y );
+        Vec2f ctrl2( bessel4.ctrl2_x, bessel4.ctrl2_y );
+        a = end - prev_end + (ctrl1 - ctrl2) * 3.0f;
+        b = (prev_end - ctrl1 * 2.0f + ctrl2) * 3.0f;
+        c = (ctrl1 - prev_end) * 3.0f;
+    }
 
-    for (; frac_curr < 1.0f; )
+    // differences of all orders at t = 0
+    const float h1 = 1.0f / num_seg;
+    const float h2 = h1 * h1;
+    const float h3 = h2 * h1;
+
+    Vec2f diff1 = a * h3 + b * h2 + c * h1;
+    Vec2f diff2 = a * (6.0f * h3) + b * (2.0f * h2);
+    Vec2f diff3 = a * (6.0f * h3);
+
+    // position and first three differences are packed in pairs, so that each
+    // step only takes three SIMD additions
+    SimdObject<float, 4> pos_diff1;
+    SimdObject<float, 4> diff1_diff2;
+    SimdObject<float, 4> diff2_diff3;
+    SimdObject<float, 4> diff3_zero;
+    pos_diff1.set_all( prev_end.x, prev_end.y, diff1.x, diff1.y );
+    diff1_diff2.set_all( diff1.x, diff1.y, diff2.x, diff2.y );
+    diff2_diff3.set_all( diff2.x, diff2.y, diff3.x, diff3.y );
+    diff3_zero.set_all( diff3.x, diff3.y, 0.0f, 0.0f );
+
+    for (int i = 1; i < num_seg; i++)
     {
-        Vec2f vtx_curr;
-
-        for (;; )
-        {
-            float frac_delta     = frac_curr - frac_prev;
-            float frac_estimator = frac_prev + frac_delta / 2;
-
-            Vec2f vtx_estimator =
-                type == GLYPH_TYPE_BESSEL3
-                ? _bessel3_interpo_( prev_end, Vec2f( bessel3.ctrl_x, bessel3.ctrl_y ), end, frac_estimator )
-                : _bessel4_interpo_( prev_end, Vec2f( bessel4.ctrl1_x, bessel4.ctrl1_y ), Vec2f( bessel4.ctrl2_x, bessel4.ctrl2_y ), end, frac_estimator );
-            vtx_curr =
-                type == GLYPH_TYPE_BESSEL3
-                ? _bessel3_interpo_( prev_end, Vec2f( bessel3.ctrl_x, bessel3.ctrl_y ), end, frac_curr )
-                : _bessel4_interpo_( prev_end, Vec2f( bessel4.ctrl1_x, bessel4.ctrl1_y ), Vec2f( bessel4.ctrl2_x, bessel4.ctrl2_y ), end, frac_curr );
-
-            treecore_assert( vtx_prev != vtx_estimator );
-            treecore_assert( vtx_estimator != vtx_curr );
-            treecore_assert( vtx_curr != vtx_prev );
-
-            Vec2f v1 = vtx_curr - vtx_estimator;
-            Vec2f v2 = vtx_estimator - vtx_prev;
-
-            float cosine = v1 * v2 / std::sqrt( v1.length2() * v2.length2() );
-            if (cosine > 0.6f) break;
-
-            frac_curr = frac_prev + frac_delta * 0.67f;
-        }
-
-        result_vertices.add( vtx_curr );
-        vtx_prev   = vtx_curr;
-        frac_prev  = frac_curr;
-        frac_curr += step;
+        pos_diff1   += diff1_diff2;
+        diff1_diff2 += diff2_diff3;
+        diff2_diff3 += diff3_zero;
+        result_vertices.add( Vec2f( pos_diff1.get<0>(), pos_diff1.get<1>() ) );
     }
 
-    if (result_vertices.get_last<Vec2f>() != end)
-        result_vertices.add( end );
+    // use exact end point, avoid accumulated error
+    result_vertices.add( end );
 }
 
 } // namespace treeface
@@ -58,21 +58,42 @@ struct PathGlyph
         , bessel4( PathGlyphBessel4 { ctrl1.x, ctrl1.y, ctrl2.x, ctrl2.y } )
     {}
 
-    void segment( const Vec2f& prev_end, Geometry::HostVertexCache& result_vertices ) const
+    ///
+    /// \brief convert glyph into line segments
+    ///
+    /// Start point is not included, while end point is always included.
+    ///
+    /// \param prev_end   end point of previous glyph, which is start of this
+    ///                   glyph
+    /// \param tolerance  maximum distance between curve and segmented result
+    ///
+    void segment( const Vec2f& prev_end, float tolerance, Geometry::HostVertexCache& result_vertices ) const
     {
         switch (type)
         {
-        case GLYPH_TYPE_ARC: segment_arc( prev_end, result_vertices ); break;
+        case GLYPH_TYPE_ARC: segment_arc( prev_end, tolerance, result_vertices ); break;
         case GLYPH_TYPE_BESSEL3:
-        case GLYPH_TYPE_BESSEL4: segment_bessel( prev_end, result_vertices ); break;
+        case GLYPH_TYPE_BESSEL4: segment_bessel( prev_end, tolerance, result_vertices ); break;
         case GLYPH_TYPE_LINE: result_vertices.add( end ); break;
         default: abort();
         }
     }
 
-    void segment_arc( const Vec2f& prev_end, Geometry::HostVertexCache& result_vertices ) const;
-
-    void segment_bessel( const Vec2f& prev_end, Geometry::HostVertexCache& result_vertices ) const;
+    void segment_arc( const Vec2f& prev_end, float tolerance, Geometry::HostVertexCache& result_vertices ) const;
+
+    ///
+    /// \brief segment quadratic or cubic bessel curve
+    ///
+    /// Number of segments is estimated using Wang's formula, so that the
+    /// distance between curve and segments won't exceed tolerance. Points
+    /// are then evaluated by forward differencing.
+    ///
+    void segment_bessel( const Vec2f& prev_end, float tolerance, Geometry::HostVertexCache& result_vertices ) const;
+
+    ///
+    /// \brief number of segments used by segment_bessel()
+    ///
+    int get_num_bessel_segment( const Vec2f& prev_end, float tolerance ) const noexcept;
 
     GlyphType type;
     Vec2f     end;
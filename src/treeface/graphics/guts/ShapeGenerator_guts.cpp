@@ -2,11 +2,16 @@
 
 #include <treecore/IntUtils.h>
 
+#include <cmath>
+
 #include "treeface/math/Constants.h"
 #include "treeface/math/Mat2.h"
+#include "treeface/graphics/VectorGraphicsMaterial.h"
 #include "treeface/graphics/guts/GeomSucker.h"
 #include "treeface/graphics/guts/HalfEdgeNetwork.h"
 #include "treeface/graphics/guts/Utils.h"
+#include "treeface/misc/ScratchArena.h"
+#include "treeface/misc/UniversalValue.h"
 
 using namespace treecore;
 
@@ -64,38 +69,62 @@ struct IntermVtxSorter
     const Array<Vec2f>&   vertices;
 };
 
+// half edges of monotone partition can be up to three times of vertices, so
+// 16-bit half edge network is only used below this
+#define MAX_NUM_VERTEX_NETWORK_16 (std::numeric_limits<uint16>::max() / 3)
+
+template<typename NetIdxT>
+NetworkScratchT<NetIdxT>& _network_scratch_( TessellateScratch& scratch );
+
+template<>
+NetworkScratchT<uint16>& _network_scratch_<uint16>( TessellateScratch& scratch )
+{
+    return scratch.network_16;
+}
+
+template<>
+NetworkScratchT<uint32>& _network_scratch_<uint32>( TessellateScratch& scratch )
+{
+    return scratch.network_32;
+}
+
 ///
 /// \brief do triangulate
-/// \param idx_list  a list of all indices
-/// \param vertices  vertex list that all index values should be valid in it
-/// \param indices   result triangle indices will be filled to here
+/// \param network         half edges of input polygons
+/// \param result_indices  result triangle indices will be filled to here
 ///
-void _triangulate_( const HalfEdgeNetwork& network,
-                    Array<IndexType>& result_indices,
+template<typename NetIdxT, typename IdxT>
+void _triangulate_( const HalfEdgeNetworkT<NetIdxT>& network,
+                    Array<IdxT>& result_indices,
                     Vec2f& result_skeleton_min,
-                    Vec2f& result_skeleton_max )
+                    Vec2f& result_skeleton_max,
+                    TessellateScratch& scratch )
 {
-    HalfEdgeNetwork network_monotone( network.vertices );
+    NetworkScratchT<NetIdxT>& net_scratch = _network_scratch_<NetIdxT>( scratch );
+
+    // borrow storage from scratch
+    HalfEdgeNetworkT<NetIdxT> network_monotone( network.vertices );
+    network_monotone.edges.swapWith( net_scratch.edges_monotone );
     network.partition_polygon_monotone( network_monotone );
 
-    Array<VertexRole> monotone_edge_roles;
+    Array<VertexRole>& monotone_edge_roles = scratch.edge_roles;
     network_monotone.get_edge_role( monotone_edge_roles );
 
-    Array<IndexType> edge_monotone_by_y;
+    Array<NetIdxT>& edge_monotone_by_y = net_scratch.edges_by_y;
     network_monotone.get_edge_vertical_order( monotone_edge_roles, edge_monotone_by_y );
 
-    Array<int16> edge_polygon_map;
-    int16        num_polygon = network_monotone.mark_polygons( edge_polygon_map );
+    Array<int32>& edge_polygon_map = scratch.edge_polygon_map;
+    int32         num_polygon      = network_monotone.mark_polygons( edge_polygon_map );
 
     SUCK_GEOM(
         for (int i_poly = 0; i_poly < num_polygon; i_poly++)
         {
             GeomSucker sucker( network_monotone, "monotone polygon #" + String( i_poly ) );
             int idx = 0;
-            for (IndexType i_edge = 0; i_edge < network_monotone.edges.size(); i_edge++)
+            for (NetIdxT i_edge = 0; i_edge < network_monotone.edges.size(); i_edge++)
             {
                 if (edge_polygon_map[i_edge] != i_poly) continue;
-                IndexType i_vtx = network_monotone.edges[i_edge].idx_vertex;
+                NetIdxT i_vtx = network_monotone.edges[i_edge].idx_vertex;
                 sucker.rgba( SUCKER_BLACK, 0.4 );
                 sucker.draw_edge( i_edge );
                 sucker.rgb( SUCKER_BLACK );
@@ -112,21 +141,46 @@ void _triangulate_( const HalfEdgeNetwork& network,
                                                     result_indices,
                                                     result_skeleton_min,
                                                     result_skeleton_max );
+
+    // give storage back
+    network_monotone.edges.swapWith( net_scratch.edges_monotone );
 }
 
-void ShapeGenerator::Guts::triangulate( Geometry::HostVertexCache& result_vertices,
-                                        treecore::Array<IndexType>& result_indices,
-                                        Vec2f& result_skeleton_min,
-                                        Vec2f& result_skeleton_max )
+template<typename NetIdxT, typename IdxT>
+void _build_network_and_triangulate_( const Geometry::HostVertexCache& vertices,
+                                      const Array<int32>& subpath_begin,
+                                      bool is_cclw,
+                                      Array<IdxT>& result_indices,
+                                      Vec2f& result_skeleton_min,
+                                      Vec2f& result_skeleton_max,
+                                      TessellateScratch& scratch )
+{
+    NetworkScratchT<NetIdxT>& net_scratch = _network_scratch_<NetIdxT>( scratch );
+
+    Array<NetIdxT>& subpath_begin_use = net_scratch.subpath_begin;
+    subpath_begin_use.clearQuick();
+    for (int32 i_begin : subpath_begin)
+        subpath_begin_use.add( NetIdxT( i_begin ) );
+
+    HalfEdgeNetworkT<NetIdxT> network( vertices );
+    network.edges.swapWith( net_scratch.edges );
+    network.edges.clearQuick();
+    network.build_half_edges( subpath_begin_use, is_cclw );
+
+    _triangulate_( network, result_indices, result_skeleton_min, result_skeleton_max, scratch );
+
+    network.edges.swapWith( net_scratch.edges );
+}
+
+void ShapeGenerator::Guts::segment( Geometry::HostVertexCache& result_vertices,
+                                    treecore::Array<int32>&    result_subpath_begin ) const
 {
     treecore_assert( result_vertices.block_size() == sizeof(Vec2f) );
 
     // do segment on all subpath
-    Array<IndexType> subpath_begin_indices;
     for (const SubPath& subpath : subpaths)
     {
-        IndexType idx_begin = IndexType( result_vertices.size() );
-        subpath_begin_indices.add( idx_begin );
+        result_subpath_begin.add( result_vertices.size() );
 
         treecore_assert( subpath.glyphs.size() > 1 );
 
@@ -142,30 +196,276 @@ void ShapeGenerator::Guts::triangulate( Geometry::HostVertexCache& result_vertic
             else
             {
                 const PathGlyph& prev_glyph = subpath.glyphs[i_glyph - 1];
-                glyph.segment(prev_glyph.end, result_vertices);
+                glyph.segment( prev_glyph.end, tolerance, result_vertices );
             }
         }
     }
 
-    treecore_assert( subpath_begin_indices.size() == subpaths.size() );
+    treecore_assert( result_subpath_begin.size() == subpaths.size() );
+}
 
-    // determine global clockwise
+int32 _subpath_end_( const Geometry::HostVertexCache& vertices, const Array<int32>& subpath_begin, int i_subpath )
+{
+    return i_subpath == subpath_begin.size() - 1
+           ? vertices.size()
+           : subpath_begin[i_subpath + 1];
+}
+
+// determine global clockwise
+double _global_clockwise_accum_( const Geometry::HostVertexCache& vertices, const Array<int32>& subpath_begin )
+{
     double clw_accum_global = 0.0;
-    for (int i_subpath = 0; i_subpath < subpaths.size(); i_subpath++)
+    for (int i_subpath = 0; i_subpath < subpath_begin.size(); i_subpath++)
+        clw_accum_global += clockwise_accum( vertices, subpath_begin[i_subpath], _subpath_end_( vertices, subpath_begin, i_subpath ) );
+    return clw_accum_global;
+}
+
+///
+/// \brief get outward normal of each edge of one polygon
+///
+/// Edge i goes from vertex i to i + 1. Zero-length edges take normal of the
+/// edge before them.
+///
+/// \return false if all edges are zero-length
+///
+bool _get_fringe_normals_( const Geometry::HostVertexCache& vertices, int32 i_begin, int32 i_end, bool is_cclw, Array<Vec2f>& normals )
+{
+    const int32 num = i_end - i_begin;
+    const float side = is_cclw ? -1.0f : 1.0f;
+
+    normals.clearQuick();
+    int32 i_valid = -1;
+    for (int32 i = 0; i < num; i++)
     {
-        IndexType i_begin = subpath_begin_indices[i_subpath];
-        IndexType i_end   = i_subpath == subpaths.size() - 1
-                            ? result_vertices.size()
-                            : subpath_begin_indices[i_subpath + 1];
-        clw_accum_global += clockwise_accum( result_vertices, i_begin, i_end );
+        const Vec2f& p1 = vertices.get<Vec2f>( i_begin + i );
+        const Vec2f& p2 = vertices.get<Vec2f>( i_begin + (i + 1) % num );
+        Vec2f v   = p2 - p1;
+        float len = v.length();
+
+        if (len > 0.0f)
+        {
+            normals.add( v.get_ortholog() * (side / len) );
+            i_valid = i;
+        }
+        else
+        {
+            normals.add( Vec2f( 0.0f, 0.0f ) );
+        }
     }
 
-    // generate half edges
-    HalfEdgeNetwork network( result_vertices );
-    network.build_half_edges( subpath_begin_indices, clw_accum_global < 0.0 );
+    if (i_valid < 0)
+        return false;
 
-    // do triangulation
-    _triangulate_( network, result_indices, result_skeleton_min, result_skeleton_max );
+    // start from a valid edge, so that all zero-length edges can find one
+    for (int32 step = 1; step < num; step++)
+    {
+        int32 i      = (i_valid + step) % num;
+        int32 i_prev = (i_valid + step - 1) % num;
+        if (normals[i].x == 0.0f && normals[i].y == 0.0f)
+            normals.getReference( i ) = normals[i_prev];
+    }
+
+    return true;
 }
 
+template<typename IdxT>
+void ShapeGenerator::Guts::fill( const Geometry::HostVertexCache& vertices,
+                                 const treecore::Array<int32>&    subpath_begin,
+                                 treecore::Array<IdxT>&           result_indices,
+                                 Vec2f& result_skeleton_min,
+                                 Vec2f& result_skeleton_max,
+                                 TessellateScratch&               scratch ) const
+{
+    treecore_assert( vertices.size() - 1 <= std::numeric_limits<IdxT>::max() );
+
+    double clw_accum_global = _global_clockwise_accum_( vertices, subpath_begin );
+
+    // generate half edges and do triangulation
+    if (vertices.size() <= MAX_NUM_VERTEX_NETWORK_16)
+        _build_network_and_triangulate_<uint16>( vertices, subpath_begin, clw_accum_global < 0.0, result_indices, result_skeleton_min, result_skeleton_max, scratch );
+    else
+        _build_network_and_triangulate_<uint32>( vertices, subpath_begin, clw_accum_global < 0.0, result_indices, result_skeleton_min, result_skeleton_max, scratch );
+}
+
+void ShapeGenerator::Guts::fill_geometry( Geometry* geom, TessellateScratch& scratch ) const
+{
+    // arena memory taken by any stage is released when this path is done
+    ScratchScope arena_scope( ScratchArena::get_thread_arena() );
+
+    Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+
+    Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+    scratch.subpath_begin.clearQuick();
+    segment( vertices, scratch.subpath_begin );
+
+    // small shapes keep using 16-bit index
+    geom->fit_index_type( vertices.size() );
+
+    if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+        fill( vertices, scratch.subpath_begin, geom->get_host_index_cache_32(), skeleton_min, skeleton_max, scratch );
+    else
+        fill( vertices, scratch.subpath_begin, geom->get_host_index_cache(), skeleton_min, skeleton_max, scratch );
+
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+}
+
+void ShapeGenerator::Guts::fill_aa( float fringe_width,
+                                    Geometry::HostVertexCache& result_vertices,
+                                    Array<uint32>&             result_indices,
+                                    Vec2f& result_skeleton_min,
+                                    Vec2f& result_skeleton_max,
+                                    TessellateScratch&         scratch ) const
+{
+    treecore_assert( result_vertices.block_size() == sizeof(FillAAVertex) );
+    treecore_assert( fringe_width > 0.0f );
+
+    Geometry::HostVertexCache& positions = scratch.fill_positions;
+    positions.clear_quick();
+    scratch.subpath_begin.clearQuick();
+    segment( positions, scratch.subpath_begin );
+
+    const int32  num_position = positions.size();
+    const uint32 idx_base     = uint32( result_vertices.size() );
+
+    // interior, whose indices are relative to segmented positions
+    const int32 i_index_begin = result_indices.size();
+    fill( positions, scratch.subpath_begin, result_indices, result_skeleton_min, result_skeleton_max, scratch );
+
+    for (int32 i = i_index_begin; i < result_indices.size(); i++)
+        result_indices.getReference( i ) += idx_base;
+
+    for (int32 i = 0; i < num_position; i++)
+        result_vertices.add( FillAAVertex{ positions.get<Vec2f>( i ), 1.0f } );
+
+    // fringe is on the side that fill() takes as outside, which is also the
+    // outside of holes
+    const bool    is_cclw        = _global_clockwise_accum_( positions, scratch.subpath_begin ) < 0.0;
+    const float   min_miter_len2 = 4.0f / float(FILL_FRINGE_MITER_LIMIT * FILL_FRINGE_MITER_LIMIT);
+    Array<Vec2f>& normals        = scratch.fringe_normals;
+
+    for (int i_subpath = 0; i_subpath < scratch.subpath_begin.size(); i_subpath++)
+    {
+        const int32 i_begin = scratch.subpath_begin[i_subpath];
+        const int32 i_end   = _subpath_end_( positions, scratch.subpath_begin, i_subpath );
+        const int32 num     = i_end - i_begin;
+
+        if ( !_get_fringe_normals_( positions, i_begin, i_end, is_cclw, normals ) )
+            continue;
+
+        const uint32 idx_inner = idx_base + uint32( i_begin );
+        const uint32 idx_outer = uint32( result_vertices.size() );
+
+        for (int32 i = 0; i < num; i++)
+        {
+            // miter of adjacent edges is 2 / |n1 + n2| times of fringe width,
+            // and is clamped at sharp corners
+            Vec2f miter      = normals[(i + num - 1) % num] + normals[i];
+            float miter_len2 = miter.length2();
+            if (miter_len2 >= min_miter_len2)
+                miter *= 2.0f * fringe_width / miter_len2;
+            else if (miter_len2 > 0.0f)
+                miter *= float(FILL_FRINGE_MITER_LIMIT) * fringe_width / std::sqrt( miter_len2 );
+
+            result_vertices.add( FillAAVertex{ positions.get<Vec2f>( i_begin + i ) + miter, 0.0f } );
+        }
+
+        // two triangles for each edge
+        for (int32 i = 0; i < num; i++)
+        {
+            const uint32 i_next = uint32( (i + 1) % num );
+            result_indices.add( idx_inner + uint32( i ) );
+            result_indices.add( idx_inner + i_next );
+            result_indices.add( idx_outer + i_next );
+
+            result_indices.add( idx_inner + uint32( i ) );
+            result_indices.add( idx_outer + i_next );
+            result_indices.add( idx_outer + uint32( i ) );
+        }
+    }
+}
+
+void ShapeGenerator::Guts::fill_aa_geometry( float fringe_width, Geometry* geom, TessellateScratch& scratch ) const
+{
+    ScratchScope arena_scope( ScratchArena::get_thread_arena() );
+
+    Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+
+    // fringe vertices are added after interior, so index type is decided
+    // after filling
+    Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+    scratch.fill_indices.clearQuick();
+    fill_aa( fringe_width, vertices, scratch.fill_indices, skeleton_min, skeleton_max, scratch );
+
+    geom->fit_index_type( vertices.size() );
+
+    if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+    {
+        geom->get_host_index_cache_32().addArray( scratch.fill_indices );
+    }
+    else
+    {
+        Array<uint16>& indices = geom->get_host_index_cache();
+        for (uint32 index : scratch.fill_indices)
+            indices.add( uint16( index ) );
+    }
+
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+}
+
+void ShapeGenerator::Guts::fill_complicated_geometry( FillRule rule, Geometry* geom, TessellateScratch& scratch ) const
+{
+    ScratchScope arena_scope( ScratchArena::get_thread_arena() );
+
+    Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+
+    Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+    scratch.subpath_begin.clearQuick();
+    segment( vertices, scratch.subpath_begin );
+
+    // crossing points are appended to vertices, so index type is decided
+    // after filling
+    scratch.fill_indices.clearQuick();
+    scratch.filler.fill( rule, vertices, scratch.subpath_begin, scratch.fill_indices, skeleton_min, skeleton_max );
+
+    geom->fit_index_type( vertices.size() );
+
+    if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+    {
+        geom->get_host_index_cache_32().addArray( scratch.fill_indices );
+    }
+    else
+    {
+        Array<uint16>& indices = geom->get_host_index_cache();
+        for (uint32 index : scratch.fill_indices)
+            indices.add( uint16( index ) );
+    }
+
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+}
+
+void ShapeGenerator::Guts::stroke_geometry( const StrokeStyle& style, Geometry* geom, TessellateScratch& scratch ) const
+{
+    ScratchScope arena_scope( ScratchArena::get_thread_arena() );
+
+    Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+
+    for (const SubPath& path : subpaths)
+        path.stroke_complex( geom, scratch.stroker, scratch.skeleton, style, tolerance, skeleton_min, skeleton_max );
+
+    // set geometric properties to uniform slots
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_LINE_WIDTH,   UniversalValue( float(style.width) ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MIN, UniversalValue( skeleton_min ) );
+    geom->set_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, UniversalValue( skeleton_max ) );
+}
+
+template void ShapeGenerator::Guts::fill<uint16>( const Geometry::HostVertexCache&, const Array<int32>&, Array<uint16>&, Vec2f&, Vec2f&, TessellateScratch& ) const;
+template void ShapeGenerator::Guts::fill<uint32>( const Geometry::HostVertexCache&, const Array<int32>&, Array<uint32>&, Vec2f&, Vec2f&, TessellateScratch& ) const;
+
 } // namespace treeface
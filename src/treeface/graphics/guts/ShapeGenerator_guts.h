@@ -6,8 +6,10 @@
 
 #include "treeface/gl/TypeUtils.h"
 #include "treeface/graphics/HalfEdge.h"
+#include "treeface/graphics/guts/LineStroker.h"
 #include "treeface/graphics/guts/PathGlyph.h"
 #include "treeface/graphics/guts/SubPath.h"
+#include "treeface/graphics/guts/SweepFiller.h"
 #include "treeface/graphics/BBox2.h"
 #include "treeface/math/Vec3.h"
 #include "treeface/scene/Geometry.h"
@@ -17,14 +19,135 @@
 namespace treeface
 {
 
+///
+/// \brief arrays used by triangulation with half edges of IdxT
+///
+template<typename IdxT>
+struct NetworkScratchT
+{
+    treecore::Array<IdxT>             subpath_begin;
+    treecore::Array<HalfEdgeT<IdxT> > edges;
+    treecore::Array<HalfEdgeT<IdxT> > edges_monotone;
+    treecore::Array<IdxT>             edges_by_y;
+};
+
+///
+/// \brief intermediate storage of fill and stroke
+///
+/// Reusing one scratch for many shapes avoids growing these arrays from
+/// empty for every shape. A scratch must not be used by multiple threads at
+/// the same time.
+///
+struct TessellateScratch
+{
+    TessellateScratch()
+        : fill_positions( sizeof(Vec2f) )
+        , stroker( StrokeStyle{ LINE_CAP_BUTT, LINE_JOIN_MITER, 0.0f, 1.0f } )
+    {}
+
+    treecore::Array<treecore::int32>  subpath_begin;
+    NetworkScratchT<treecore::uint16> network_16;
+    NetworkScratchT<treecore::uint32> network_32;
+    treecore::Array<VertexRole>       edge_roles;
+    treecore::Array<treecore::int32>  edge_polygon_map;
+    treecore::Array<treecore::uint32> fill_indices;
+    Geometry::HostVertexCache         fill_positions;
+    treecore::Array<Vec2f>            fringe_normals;
+    LineStroker    stroker;
+    StrokeSkeleton skeleton;
+    SweepFiller    filler;
+};
+
 struct ShapeGenerator::Guts
 {
     treecore::Array<SubPath> subpaths;
 
+    /// maximum distance between curves and their segments
+    float tolerance = SHAPE_GENERATOR_DEFAULT_TOLERANCE;
+
+    ///
+    /// \brief segment all subpaths into polygon vertices
+    ///
+    /// \param result_vertices        vertices are appended to here
+    /// \param result_subpath_begin   index of first vertex of each subpath
+    ///
+    void segment( Geometry::HostVertexCache&        result_vertices,
+                  treecore::Array<treecore::int32>& result_subpath_begin ) const;
+
+    ///
+    /// \brief triangulate polygons that are already segmented
+    ///
+    /// Instantiated for 16-bit and 32-bit result indices. Half edges of
+    /// intermediate steps use 32-bit index if there are too many vertices for
+    /// 16-bit, regardless of result index type.
+    ///
+    template<typename IdxT>
+    void fill( const Geometry::HostVertexCache&        vertices,
+               const treecore::Array<treecore::int32>& subpath_begin,
+               treecore::Array<IdxT>&                  result_indices,
+               Vec2f& result_skeleton_min,
+               Vec2f& result_skeleton_max,
+               TessellateScratch&                      scratch ) const;
+
+    ///
+    /// \brief fill all subpaths into host cache of geometry
+    ///
+    /// Only touches host side data of geometry, so different geometries can
+    /// be processed in different threads.
+    ///
+    void fill_geometry( Geometry* geom, TessellateScratch& scratch ) const;
+
+    ///
+    /// \brief fill all subpaths, and surround them with a fringe whose
+    ///        coverage fades from 1 on outline to 0 on outer side
+    ///
+    /// Interior is triangulated same as fill(). Each outline vertex gets a
+    /// fringe vertex that is fringe_width away from both adjacent edges,
+    /// which is limited by FILL_FRINGE_MITER_LIMIT at sharp corners.
+    ///
+    /// \param fringe_width     width of fringe in path coordinate
+    /// \param result_vertices  FillAAVertex are appended to here
+    /// \param result_indices   indices into result_vertices are appended to
+    ///                         here
+    ///
+    void fill_aa( float fringe_width,
+                  Geometry::HostVertexCache&         result_vertices,
+                  treecore::Array<treecore::uint32>& result_indices,
+                  Vec2f& result_skeleton_min,
+                  Vec2f& result_skeleton_max,
+                  TessellateScratch&                 scratch ) const;
+
+    ///
+    /// \brief fill with anti-alias fringe into host cache of geometry
+    /// \see fill_geometry()
+    ///
+    void fill_aa_geometry( float fringe_width, Geometry* geom, TessellateScratch& scratch ) const;
+
+    ///
+    /// \brief fill all subpaths by fill rule, resolving edge crossings
+    /// \see fill_geometry()
+    ///
+    void fill_complicated_geometry( FillRule rule, Geometry* geom, TessellateScratch& scratch ) const;
+
+    ///
+    /// \brief stroke all subpaths into host cache of geometry
+    /// \see fill_geometry()
+    ///
+    void stroke_geometry( const StrokeStyle& style, Geometry* geom, TessellateScratch& scratch ) const;
+
+    ///
+    /// \brief segment and triangulate all subpaths
+    ///
+    template<typename IdxT>
     void triangulate( Geometry::HostVertexCache& result_vertices,
-                      treecore::Array<IndexType>& result_indices,
+                      treecore::Array<IdxT>&     result_indices,
                       Vec2f& result_skeleton_min,
-                      Vec2f& result_skeleton_max );
+                      Vec2f& result_skeleton_max ) const
+    {
+        TessellateScratch scratch;
+        segment( result_vertices, scratch.subpath_begin );
+        fill( result_vertices, scratch.subpath_begin, result_indices, result_skeleton_min, result_skeleton_max, scratch );
+    }
 };
 
 } // namespace treeface
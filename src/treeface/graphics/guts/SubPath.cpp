@@ -2,21 +2,21 @@
 
 #include "treeface/graphics/guts/LineStroker.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace treecore;
 
 namespace treeface
 {
 
-void SubPath::stroke_complex( Geometry::HostVertexCache&  result_vertices,
-                              treecore::Array<IndexType>& result_indices,
-                              Vec2f& result_skeleton_min,
-                              Vec2f& result_skeleton_max,
-                              const StrokeStyle& style ) const
+void SubPath::build_stroke( LineStroker& stroker,
+                            float        tolerance,
+                            Vec2f& result_skeleton_min,
+                            Vec2f& result_skeleton_max ) const
 {
     treecore_assert( glyphs[0].type == GLYPH_TYPE_LINE );
 
-    LineStroker stroker( style );
-
     //
     // generate stroke outline
     //
@@ -24,13 +24,14 @@ void SubPath::stroke_complex( Geometry::HostVertexCache&  result_vertices,
     Vec2f v_prev;
 
     // glyph 0 is start vertex, so glyph 1 is the actual first glyph
+    Geometry::HostVertexCache curr_glyph_skeleton( sizeof(Vec2f) );
     for (int i_glyph = 1; i_glyph < glyphs.size(); i_glyph++)
     {
         const PathGlyph& glyph_prev = glyphs[i_glyph - 1];
         const PathGlyph& glyph      = glyphs[i_glyph];
 
-        Geometry::HostVertexCache curr_glyph_skeleton( sizeof(Vec2f) );
-        glyph.segment( glyph_prev.end, curr_glyph_skeleton );
+        curr_glyph_skeleton.clear_quick();
+        glyph.segment( glyph_prev.end, tolerance, curr_glyph_skeleton );
 
         treecore_assert( curr_glyph_skeleton.size() > 0 );
 
@@ -97,7 +98,7 @@ void SubPath::stroke_complex( Geometry::HostVertexCache&  result_vertices,
         }
         else
         {
-            Vec2f p_prev_calc = p_first - v_prev * (style.width * 2);
+            Vec2f p_prev_calc = p_first - v_prev * (stroker.style.half_width * 4);
             SUCK_GEOM_BLK( OutlineSucker sucker( stroker.part_left, "end overlap start, going to close stroke using calculated end" );
                            sucker.draw_outline( stroker.part_right );
                            sucker.draw_vtx( p_prev_calc );
@@ -111,11 +112,330 @@ void SubPath::stroke_complex( Geometry::HostVertexCache&  result_vertices,
     {
         stroker.cap_end( glyphs.getLast().end, v_prev );
     }
+}
+
+void SubPath::build_skeleton( float tolerance, StrokeSkeleton& result ) const
+{
+    treecore_assert( glyphs[0].type == GLYPH_TYPE_LINE );
+
+    result.points.add( glyphs[0].end );
+    result.is_joint.add( false );
+
+    Geometry::HostVertexCache curr_glyph_skeleton( sizeof(Vec2f) );
+    for (int i_glyph = 1; i_glyph < glyphs.size(); i_glyph++)
+    {
+        curr_glyph_skeleton.clear_quick();
+        glyphs[i_glyph].segment( glyphs[i_glyph - 1].end, tolerance, curr_glyph_skeleton );
+
+        // last point of previous glyph is where line join is drawn
+        result.is_joint.getReference( result.is_joint.size() - 1 ) = true;
+
+        for (int i = 0; i < curr_glyph_skeleton.size(); i++)
+        {
+            const Vec2f& p = curr_glyph_skeleton.get<Vec2f>( i );
+            if (p != result.points.getLast())
+            {
+                result.points.add( p );
+                result.is_joint.add( false );
+            }
+        }
+    }
+
+    // closing segment is joined at both ends
+    if (closed)
+    {
+        const Vec2f p_first = result.points.getFirst();
+        result.is_joint.getReference( result.is_joint.size() - 1 ) = true;
+
+        if (result.points.getLast() != p_first)
+        {
+            result.points.add( p_first );
+            result.is_joint.add( true );
+        }
+    }
+}
+
+// triangulate into geometry, which decides index type by itself
+struct GeometryStrokeTarget
+{
+    void triangulate( const LineStroker& stroker, bool closed )
+    {
+        Geometry::HostVertexCache& vertices = geom->get_host_vertex_cache();
+
+        // switch to 32-bit index when this stroke goes beyond 16-bit range
+        geom->fit_index_type( vertices.size() + stroker.get_num_result_vertex() );
+
+        if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+            stroker.triangulate( vertices, geom->get_host_index_cache_32(), closed );
+        else
+            stroker.triangulate( vertices, geom->get_host_index_cache(), closed );
+    }
+
+    Geometry* geom;
+};
+
+// triangulate into plain arrays, caller ensures index range
+template<typename IdxT>
+struct HostStrokeTarget
+{
+    void triangulate( const LineStroker& stroker, bool closed )
+    {
+        stroker.triangulate( vertices, indices, closed );
+    }
+
+    Geometry::HostVertexCache& vertices;
+    Array<IdxT>&               indices;
+};
+
+// odd number of dash lengths are repeated once
+inline int _num_dash_interval_( const StrokeStyle& style ) noexcept
+{
+    return style.num_dash % 2 == 0 ? style.num_dash : style.num_dash * 2;
+}
+
+inline float _dash_interval_( const StrokeStyle& style, int i ) noexcept
+{
+    treecore_assert( style.dash[i % style.num_dash] >= 0.0f );
+    return std::max( style.dash[i % style.num_dash], 0.0f );
+}
+
+///
+/// \brief get point on skeleton at trip
+///
+/// \param i_seg  segment to start searching from, only moves forward, so
+///               that walking through all dashes is linear
+///
+Vec2f _skeleton_point_at_( const StrokeSkeleton& skeleton, float trip, int& i_seg )
+{
+    const Array<float>& trips = skeleton.trip;
+    while (i_seg + 2 < trips.size() && trips[i_seg + 1] <= trip)
+        i_seg++;
+
+    const Vec2f& p1 = skeleton.points[i_seg];
+    const Vec2f& p2 = skeleton.points[i_seg + 1];
+    const float  seg_length = trips[i_seg + 1] - trips[i_seg];
+
+    if (trip <= trips[i_seg] || seg_length <= 0.0f) return p1;
+    if (trip >= trips[i_seg + 1]) return p2;
+    return p1 + (p2 - p1) * ( (trip - trips[i_seg]) / seg_length );
+}
+
+// stroke part of skeleton as an open stroke
+template<typename TargetT>
+void _stroke_dash_( LineStroker&          stroker,
+                    const StrokeSkeleton& skeleton,
+                    const StrokeStyle&    style,
+                    float                 trip_begin,
+                    float                 trip_end,
+                    int&                  i_seg,
+                    TargetT&              target )
+{
+    // zero-length dash is a dot, which has no area without cap
+    if (trip_end <= trip_begin && style.cap == LINE_CAP_BUTT)
+        return;
+
+    const Array<Vec2f>& points = skeleton.points;
+
+    Vec2f p_prev = _skeleton_point_at_( skeleton, trip_begin, i_seg );
+
+    int         i_seg_end = i_seg;
+    const Vec2f p_end     = _skeleton_point_at_( skeleton, trip_end, i_seg_end );
+
+    // cap follows first piece that is actually stroked, as interpolated ends
+    // of very short dash are not exactly on direction of skeleton segment
+    Vec2f p_next = p_end;
+    for (int i = i_seg + 1; i <= i_seg_end; i++)
+    {
+        if (points[i] != p_prev)
+        {
+            p_next = points[i];
+            break;
+        }
+    }
+
+    Vec2f v_prev = p_next != p_prev ? p_next - p_prev : points[i_seg + 1] - points[i_seg];
+    v_prev.normalize();
+
+    stroker.reset( style );
+    stroker.cap_begin( p_prev, v_prev );
+
+    bool use_line_join = true;
+    while (i_seg + 2 < points.size() && skeleton.trip[i_seg + 1] < trip_end)
+    {
+        const Vec2f& p = points[i_seg + 1];
+        if (p != p_prev)
+        {
+            v_prev = stroker.extend_stroke( v_prev, p_prev, p, use_line_join );
+            p_prev = p;
+        }
+        use_line_join = skeleton.is_joint[i_seg + 1];
+        i_seg++;
+    }
+
+    i_seg = i_seg_end;
+    if (p_end != p_prev)
+        v_prev = stroker.extend_stroke( v_prev, p_prev, p_end, use_line_join );
+
+    stroker.cap_end( p_end, v_prev );
+    target.triangulate( stroker, false );
+}
+
+template<typename TargetT>
+void _stroke_subpath_( const SubPath&     path,
+                       LineStroker&       stroker,
+                       StrokeSkeleton&    skeleton,
+                       const StrokeStyle& style,
+                       float              tolerance,
+                       Vec2f& result_skeleton_min,
+                       Vec2f& result_skeleton_max,
+                       TargetT&           target )
+{
+    const int num_interval = style.dash != nullptr && style.num_dash > 0 ? _num_dash_interval_( style ) : 0;
+
+    float period = 0.0f;
+    for (int i = 0; i < num_interval; i++)
+        period += _dash_interval_( style, i );
+
+    if ( !(period > 0.0f) )
+    {
+        stroker.reset( style );
+        path.build_stroke( stroker, tolerance, result_skeleton_min, result_skeleton_max );
+        target.triangulate( stroker, path.closed );
+        return;
+    }
 
     //
-    // triangulate stroke outline, which provides final result
+    // segment whole subpath once, and cut it by trip
     //
-    stroker.triangulate( result_vertices, result_indices, closed );
+    skeleton.clear();
+    path.build_skeleton( tolerance, skeleton );
+
+    for (const Vec2f& p : skeleton.points)
+        update_bound( p, result_skeleton_min, result_skeleton_max );
+
+    // a single point has no direction to be stroked
+    if (skeleton.points.size() < 2)
+        return;
+
+    accum_trip( skeleton.points, skeleton.trip );
+    const float total = skeleton.trip.getLast();
+
+    // locate where subpath begins in dash pattern
+    float phase = std::fmod( style.dash_offset, period );
+    if (phase < 0.0f) phase += period;
+
+    // zero-length dash at phase 0 is a dot at the beginning, which is kept
+    int i_interval = 0;
+    for (; i_interval < num_interval - 1; i_interval++)
+    {
+        const float length = _dash_interval_( style, i_interval );
+        if (phase < length || (phase == 0.0f && length == 0.0f))
+            break;
+        phase -= length;
+    }
+
+    float remain = std::max( _dash_interval_( style, i_interval ) - phase, 0.0f );
+
+    // dash at beginning of closed subpath is delayed, so that it can be
+    // joined with the dash that reaches end
+    bool  head_pending = false;
+    float head_end     = 0.0f;
+    bool  is_head      = path.closed && i_interval % 2 == 0;
+
+    // bounds the loop when intervals are too small to move trip forward
+    int64 num_interval_left = int64( double( total ) / double( period ) + 2.0 ) * num_interval;
+
+    int   i_seg = 0;
+    float trip  = 0.0f;
+    for (; num_interval_left > 0; num_interval_left--)
+    {
+        const bool  interval_done = trip + remain <= total;
+        const float trip_end      = interval_done ? trip + remain : total;
+
+        if (i_interval % 2 == 0)
+        {
+            if (is_head)
+            {
+                head_pending = true;
+                head_end     = trip_end;
+            }
+            else if (head_pending && !interval_done)
+            {
+                // append skeleton from beginning until end of head dash
+                const int num_point = skeleton.points.size();
+                for (int i = 1; i < num_point; i++)
+                {
+                    const Vec2f p       = skeleton.points[i];
+                    const bool  joint   = skeleton.is_joint[i];
+                    const float trip_pt = skeleton.trip[i];
+                    skeleton.points.add( p );
+                    skeleton.is_joint.add( joint );
+                    skeleton.trip.add( trip_pt + total );
+                    if (trip_pt >= head_end) break;
+                }
+
+                _stroke_dash_( stroker, skeleton, style, trip, total + head_end, i_seg, target );
+                head_pending = false;
+            }
+            else
+            {
+                _stroke_dash_( stroker, skeleton, style, trip, trip_end, i_seg, target );
+            }
+        }
+
+        is_head = false;
+
+        if (!interval_done) break;
+
+        trip       = trip_end;
+        i_interval = (i_interval + 1) % num_interval;
+        remain     = _dash_interval_( style, i_interval );
+    }
+
+    if (head_pending)
+    {
+        if (head_end >= total)
+        {
+            // dash covers whole subpath
+            stroker.reset( style );
+            path.build_stroke( stroker, tolerance, result_skeleton_min, result_skeleton_max );
+            target.triangulate( stroker, path.closed );
+        }
+        else
+        {
+            int i_seg_head = 0;
+            _stroke_dash_( stroker, skeleton, style, 0.0f, head_end, i_seg_head, target );
+        }
+    }
 }
 
+void SubPath::stroke_complex( Geometry*          geom,
+                              LineStroker&       stroker,
+                              StrokeSkeleton&    skeleton,
+                              const StrokeStyle& style,
+                              float              tolerance,
+                              Vec2f& result_skeleton_min,
+                              Vec2f& result_skeleton_max ) const
+{
+    GeometryStrokeTarget target{ geom };
+    _stroke_subpath_( *this, stroker, skeleton, style, tolerance, result_skeleton_min, result_skeleton_max, target );
+}
+
+template<typename IdxT>
+void SubPath::stroke_complex( Geometry::HostVertexCache& result_vertices,
+                              treecore::Array<IdxT>&     result_indices,
+                              Vec2f& result_skeleton_min,
+                              Vec2f& result_skeleton_max,
+                              const StrokeStyle& style,
+                              float tolerance ) const
+{
+    LineStroker    stroker( style );
+    StrokeSkeleton skeleton;
+    HostStrokeTarget<IdxT> target{ result_vertices, result_indices };
+    _stroke_subpath_( *this, stroker, skeleton, style, tolerance, result_skeleton_min, result_skeleton_max, target );
+}
+
+template void SubPath::stroke_complex<uint16>( Geometry::HostVertexCache&, Array<uint16>&, Vec2f&, Vec2f&, const StrokeStyle&, float ) const;
+template void SubPath::stroke_complex<uint32>( Geometry::HostVertexCache&, Array<uint32>&, Vec2f&, Vec2f&, const StrokeStyle&, float ) const;
+
 } // namespace treeface
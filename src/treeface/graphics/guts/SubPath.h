@@ -10,6 +10,25 @@
 namespace treeface
 {
 
+struct LineStroker;
+
+///
+/// \brief subpath segmented into polyline, with distance from its beginning
+///
+struct StrokeSkeleton
+{
+    void clear() noexcept
+    {
+        points.clearQuick();
+        trip.clearQuick();
+        is_joint.clearQuick();
+    }
+
+    treecore::Array<Vec2f> points;
+    treecore::Array<float> trip;
+    treecore::Array<bool>  is_joint; ///< line join is drawn at point between glyphs
+};
+
 struct SubPath
 {
     treecore::Array<PathGlyph> glyphs;
@@ -38,11 +57,57 @@ struct SubPath
                         Vec2f& result_skeleton_max,
                         treecore::Array<IndexType>& result_indices ) const;
 
-    void stroke_complex( Geometry::HostVertexCache&  result_vertices,
-                         treecore::Array<IndexType>& result_indices,
+    ///
+    /// \brief generate stroke outline of this subpath into stroker
+    ///
+    /// Vertices are not generated until stroker is triangulated, so caller
+    /// can choose index type by the number of result vertices.
+    ///
+    /// \param tolerance  maximum distance between curves and their segments
+    ///
+    void build_stroke( LineStroker& stroker,
+                       float        tolerance,
+                       Vec2f& result_skeleton_min,
+                       Vec2f& result_skeleton_max ) const;
+
+    ///
+    /// \brief segment all glyphs into a polyline
+    ///
+    /// Repeated points are skipped. Closed subpath ends at its first point.
+    ///
+    void build_skeleton( float tolerance, StrokeSkeleton& result ) const;
+
+    ///
+    /// \brief generate stroke outline and triangulate it into geometry
+    ///
+    /// If style has dash pattern, skeleton is cut by its trip, and each dash
+    /// is stroked as an open stroke with caps by reusing the same stroker.
+    /// Index type of geometry is widened when vertices go beyond 16-bit
+    /// range.
+    ///
+    /// \param skeleton  storage for segmented skeleton of dashed stroke
+    ///
+    void stroke_complex( Geometry*          geom,
+                         LineStroker&       stroker,
+                         StrokeSkeleton&    skeleton,
+                         const StrokeStyle& style,
+                         float              tolerance,
+                         Vec2f& result_skeleton_min,
+                         Vec2f& result_skeleton_max ) const;
+
+    ///
+    /// \brief generate stroke outline and triangulate it into plain arrays
+    ///
+    /// Instantiated for 16-bit and 32-bit indices. Caller should ensure
+    /// vertices can be addressed by IdxT.
+    ///
+    template<typename IdxT>
+    void stroke_complex( Geometry::HostVertexCache& result_vertices,
+                         treecore::Array<IdxT>&     result_indices,
                          Vec2f& result_skeleton_min,
                          Vec2f& result_skeleton_max,
-                         const StrokeStyle& style ) const;
+                         const StrokeStyle& style,
+                         float tolerance ) const;
 };
 
 } // namespace treeface
@@ -0,0 +1,885 @@
+#include "treeface/graphics/guts/SweepFiller.h"
+
+#include "treeface/graphics/Utils.h"
+#include "treeface/graphics/guts/Utils.h"
+#include "treeface/misc/RadixSort.h"
+#include "treeface/misc/ScratchArena.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace treecore;
+
+namespace treeface
+{
+
+#define SWEEP_NONE -1
+
+#define SPAN_SIDE_LEFT  0
+#define SPAN_SIDE_RIGHT 1
+
+// crossing found near or slightly beyond end points of edge is treated as on
+// the end point, which is caused by rounding
+#define SWEEP_CROSS_EPSILON 1.0e-9
+
+// points this close to a line, relative to coordinate size, are treated as on
+// it, so that crossing points slightly off by rounding are still on its edges
+#define SWEEP_SIDE_EPSILON 1.0e-12
+
+// number of edges checked beside found position, for edges that end at
+// current point but are put on wrong side of neighbors by rounding
+#define SWEEP_FIX_LIMIT 2
+
+typedef SweepFiller::Point Point;
+
+///
+/// \brief sort key of original vertex, which follows the order of is_below()
+///        from top to bottom
+///
+inline uint64 _point_key_( const Vec2f& p ) noexcept
+{
+    return (uint64( ~float_to_radix_key( p.y ) ) << 32) | uint64( ~float_to_radix_key( p.x ) );
+}
+
+///
+/// \brief whether point a is swept before point b
+///
+inline bool _is_above_( const Point& a, const Point& b ) noexcept
+{
+    return a.y > b.y || (a.y == b.y && a.x > b.x);
+}
+
+inline bool _is_same_( const Point& a, const Point& b ) noexcept
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+///
+/// \brief whether point p is swept during the sweep of an edge
+///
+inline bool _is_in_range_( const Point& p, const Point& upper, const Point& lower ) noexcept
+{
+    return !_is_above_( p, upper ) && !_is_above_( lower, p );
+}
+
+inline double _cross_( const Point& origin, const Point& p1, const Point& p2 ) noexcept
+{
+    return (p1.x - origin.x) * (p2.y - origin.y) - (p1.y - origin.y) * (p2.x - origin.x);
+}
+
+///
+/// \brief direction of p2 against p1 around origin
+///
+/// \return 1 for counter-clockwise, -1 for clockwise, 0 if they are in line
+///
+inline int _side_( const Point& origin, const Point& p1, const Point& p2 ) noexcept
+{
+    const double cross = _cross_( origin, p1, p2 );
+    const double bound = SWEEP_SIDE_EPSILON
+                         * (std::abs( p1.x - origin.x ) + std::abs( p1.y - origin.y ))
+                         * (std::abs( origin.x ) + std::abs( origin.y ) + std::abs( p2.x ) + std::abs( p2.y ));
+
+    if (cross > bound)
+        return 1;
+    else if (cross < -bound)
+        return -1;
+    else
+        return 0;
+}
+
+struct PointOrderItem
+{
+    uint64 key;
+    int32  i_point;
+};
+
+struct PointOrderKeyGetter
+{
+    uint64 operator ()( const PointOrderItem& item ) const noexcept
+    {
+        return item.key;
+    }
+};
+
+struct PendingEdgeOrder
+{
+    PendingEdgeOrder( const Array<Point>& points ): points( points ) {}
+
+    // std heap keeps the greatest one on top, so it is reversed to get the
+    // highest point
+    bool operator ()( const SweepFiller::Edge& a, const SweepFiller::Edge& b ) const noexcept
+    {
+        return _is_above_( points[b.upper], points[a.upper] );
+    }
+
+    const Array<Point>& points;
+};
+
+void SweepFiller::fill( FillRule                rule,
+                        Geometry::HostVertexCache& vertices,
+                        const Array<int32>&     subpath_begin,
+                        Array<uint32>&          result_indices,
+                        Vec2f& result_skeleton_min,
+                        Vec2f& result_skeleton_max )
+{
+    treecore_assert( vertices.block_size() == sizeof(Vec2f) );
+
+    num_crossing = 0;
+    if (subpath_begin.size() == 0)
+        return;
+
+    this->rule = rule;
+    index_base = uint32( subpath_begin[0] );
+    results    = &result_indices;
+
+    const int32 num_orig = vertices.size() - subpath_begin[0];
+
+    points.clearQuick();
+    for (int32 i = 0; i < num_orig; i++)
+    {
+        const Vec2f& p = vertices.get<Vec2f>( index_base + i );
+        points.add( Point{ p.x, p.y } );
+    }
+
+    pending.clearQuick();
+    nodes.clearQuick();
+    tree_root  = SWEEP_NONE;
+    list_first = SWEEP_NONE;
+    list_last  = SWEEP_NONE;
+
+    free_spans.clearQuick();
+    for (int32 i = spans.size() - 1; i >= 0; i--)
+        free_spans.add( i );
+
+    ScratchArena& arena = ScratchArena::get_thread_arena();
+    ScratchScope  scope( arena );
+
+    // neighbors of each vertex in its polygon
+    int32* point_prev = arena.allocate<int32>( num_orig );
+    int32* point_next = arena.allocate<int32>( num_orig );
+
+    for (int i_subpath = 0; i_subpath < subpath_begin.size(); i_subpath++)
+    {
+        int32 i_begin = subpath_begin[i_subpath] - int32( index_base );
+        int32 i_end   = i_subpath == subpath_begin.size() - 1
+                        ? num_orig
+                        : subpath_begin[i_subpath + 1] - int32( index_base );
+
+        for (int32 i = i_begin; i < i_end; i++)
+        {
+            point_prev[i] = i == i_begin   ? i_end - 1 : i - 1;
+            point_next[i] = i == i_end - 1 ? i_begin   : i + 1;
+        }
+    }
+
+    // original vertices ordered from top to bottom
+    PointOrderItem* order  = arena.allocate<PointOrderItem>( num_orig );
+    PointOrderItem* buffer = arena.allocate<PointOrderItem>( num_orig );
+    for (int32 i = 0; i < num_orig; i++)
+        order[i] = { _point_key_( vertices.get<Vec2f>( index_base + i ) ), i };
+
+    radix_sort( order, buffer, size_t( num_orig ), PointOrderKeyGetter() );
+
+    //
+    // sweep all vertices, including crossing points found on the way
+    //
+    PendingEdgeOrder pending_order( points );
+    int32 i_order = 0;
+
+    while (i_order < num_orig || pending.size() > 0)
+    {
+        int32 i_point;
+        if ( pending.size() > 0 && (i_order == num_orig || _is_above_( points[pending[0].upper], points[order[i_order].i_point] )) )
+            i_point = int32( pending[0].upper );
+        else
+            i_point = order[i_order].i_point;
+
+        const Point position = points[i_point];
+
+        // collect edges that start from here
+        event_edges.clearQuick();
+
+        for (; i_order < num_orig && _is_same_( points[order[i_order].i_point], position ); i_order++)
+        {
+            int32 i_curr = order[i_order].i_point;
+            int32 i_prev = point_prev[i_curr];
+            int32 i_next = point_next[i_curr];
+
+            if ( _is_above_( position, points[i_next] ) )
+                event_edges.add( Edge{ uint32( i_point ), uint32( i_next ), 1 } );
+
+            if ( _is_above_( position, points[i_prev] ) )
+                event_edges.add( Edge{ uint32( i_point ), uint32( i_prev ), -1 } );
+        }
+
+        while (pending.size() > 0 && _is_same_( points[pending[0].upper], position ))
+        {
+            Edge edge = pending[0];
+            std::pop_heap( pending.begin(), pending.end(), pending_order );
+            pending.removeLast();
+
+            edge.upper = uint32( i_point );
+            event_edges.add( edge );
+        }
+
+        update_bound( Vec2f( float( position.x ), float( position.y ) ), result_skeleton_min, result_skeleton_max );
+        process_event( i_point );
+    }
+
+    // crossing points are new vertices
+    for (int32 i = num_orig; i < points.size(); i++)
+        vertices.add( Vec2f( float( points[i].x ), float( points[i].y ) ) );
+
+    results = nullptr;
+}
+
+void SweepFiller::process_event( int32 i_point )
+{
+    const Point position = points[i_point];
+
+    //
+    // find edges that end at or go through current point, which are
+    // continuous on sweep line
+    //
+    int32 i_first = tree_lower_bound( position );
+    int32 i_left  = i_first == SWEEP_NONE ? list_last : nodes[i_first].prev;
+    int32 i_right = i_first;
+
+    event_nodes.clearQuick();
+    while (i_right != SWEEP_NONE && node_side( i_right, position ) == 0)
+    {
+        event_nodes.add( i_right );
+        i_right = nodes[i_right].next;
+    }
+
+    // edges that end here could be put on wrong side of its neighbors by
+    // rounding, they are taken together with edges between them
+    {
+        int32 i_probe = i_left;
+        for (int i = 0; i < SWEEP_FIX_LIMIT && i_probe != SWEEP_NONE; i++, i_probe = nodes[i_probe].prev)
+        {
+            if ( !_is_same_( points[nodes[i_probe].lower], position ) )
+                continue;
+
+            for (;; )
+            {
+                event_nodes.insert( 0, i_left );
+                bool done = i_left == i_probe;
+                i_left = nodes[i_left].prev;
+                if (done) break;
+            }
+
+            i = -1;
+        }
+
+        i_probe = i_right;
+        for (int i = 0; i < SWEEP_FIX_LIMIT && i_probe != SWEEP_NONE; i++, i_probe = nodes[i_probe].next)
+        {
+            if ( !_is_same_( points[nodes[i_probe].lower], position ) )
+                continue;
+
+            for (;; )
+            {
+                event_nodes.add( i_right );
+                bool done = i_right == i_probe;
+                i_right = nodes[i_right].next;
+                if (done) break;
+            }
+
+            i = -1;
+        }
+    }
+
+    // edges going through are split here
+    for (int32 i_node : event_nodes)
+    {
+        Node& node = nodes[i_node];
+        if ( _is_above_( position, points[node.lower] ) )
+            event_edges.add( Edge{ uint32( i_point ), node.lower, node.winding } );
+        node.lower = uint32( i_point );
+    }
+
+    sort_event_edges( position );
+
+    if (event_nodes.size() == 0 && event_edges.size() == 0)
+        return;
+
+    //
+    // update monotone pieces above current point
+    //
+    const SpanVertex vtx{ position, uint32( i_point ), SPAN_SIDE_LEFT };
+    int32 span_below_left  = SWEEP_NONE;
+    int32 span_below_right = SWEEP_NONE;
+
+    if (event_nodes.size() == 0)
+    {
+        // current point is inside the part between left and right edges
+        if (i_left != SWEEP_NONE && nodes[i_left].span != SWEEP_NONE)
+        {
+            int32 i_span       = nodes[i_left].span;
+            int32 i_span_merge = nodes[i_left].span_merge;
+
+            if (i_span_merge != SWEEP_NONE)
+            {
+                // connect merge vertex to current point
+                span_add( i_span, vtx, SPAN_SIDE_RIGHT );
+                span_add( i_span_merge, vtx, SPAN_SIDE_LEFT );
+                span_below_left  = i_span;
+                span_below_right = i_span_merge;
+            }
+            else
+            {
+                // split vertex, connect to latest vertex of the piece, which
+                // is always visible
+                SpanVertex helper = spans[i_span].stack.getLast();
+                int32      i_new  = span_create( helper );
+
+                if (helper.side == SPAN_SIDE_LEFT)
+                {
+                    span_add( i_span, vtx, SPAN_SIDE_LEFT );
+                    span_add( i_new,  vtx, SPAN_SIDE_RIGHT );
+                    span_below_left  = i_new;
+                    span_below_right = i_span;
+                }
+                else
+                {
+                    span_add( i_span, vtx, SPAN_SIDE_RIGHT );
+                    span_add( i_new,  vtx, SPAN_SIDE_LEFT );
+                    span_below_left  = i_span;
+                    span_below_right = i_new;
+                }
+            }
+        }
+    }
+    else
+    {
+        // current point is on right border of the part on left
+        if (i_left != SWEEP_NONE && nodes[i_left].span != SWEEP_NONE)
+        {
+            if (nodes[i_left].span_merge != SWEEP_NONE)
+                span_end( nodes[i_left].span_merge, vtx );
+
+            span_below_left = nodes[i_left].span;
+            span_add( span_below_left, vtx, SPAN_SIDE_RIGHT );
+        }
+
+        // parts between ending edges are finished
+        for (int i = 0; i < event_nodes.size() - 1; i++)
+        {
+            const Node& node = nodes[event_nodes[i]];
+            if (node.span != SWEEP_NONE)
+                span_end( node.span, vtx );
+            if (node.span_merge != SWEEP_NONE)
+                span_end( node.span_merge, vtx );
+        }
+
+        // current point is on left border of the part on right
+        const Node& last = nodes[event_nodes.getLast()];
+        if (last.span != SWEEP_NONE)
+        {
+            if (last.span_merge != SWEEP_NONE)
+            {
+                span_end( last.span, vtx );
+                span_below_right = last.span_merge;
+            }
+            else
+            {
+                span_below_right = last.span;
+            }
+
+            span_add( span_below_right, vtx, SPAN_SIDE_LEFT );
+        }
+
+        for (int32 i_node : event_nodes)
+            tree_remove( i_node );
+    }
+
+    //
+    // put new edges to sweep line, and start monotone pieces below current
+    // point
+    //
+    if (event_edges.size() == 0)
+    {
+        // parts on both sides are joined, current point is a merge vertex if
+        // both are inside
+        if (i_left != SWEEP_NONE)
+        {
+            Node& left = nodes[i_left];
+            left.span       = span_below_left;
+            left.span_merge = SWEEP_NONE;
+
+            if (span_below_left == SWEEP_NONE)
+            {
+                left.span = span_below_right;
+            }
+            else if (span_below_right != SWEEP_NONE)
+            {
+                left.span_merge = span_below_right;
+                left.vtx_merge  = uint32( i_point );
+            }
+        }
+        else
+        {
+            // should not happen, as left-most part is always outside
+            if (span_below_left != SWEEP_NONE)  span_end( span_below_left, vtx );
+            if (span_below_right != SWEEP_NONE) span_end( span_below_right, vtx );
+        }
+
+        check_crossing( i_left, i_right, i_point );
+    }
+    else
+    {
+        int32 winding = 0;
+
+        if (i_left != SWEEP_NONE)
+        {
+            Node& left = nodes[i_left];
+            left.span       = span_below_left;
+            left.span_merge = SWEEP_NONE;
+            winding         = left.winding_right;
+        }
+        else if (span_below_left != SWEEP_NONE)
+        {
+            span_end( span_below_left, vtx );
+        }
+
+        int32 i_first_new = SWEEP_NONE;
+        int32 i_prev      = i_left;
+        for (int i = 0; i < event_edges.size(); i++)
+        {
+            winding += event_edges[i].winding;
+
+            int32 i_node = tree_create( event_edges[i], winding );
+            tree_insert_after( i_prev, i_node );
+
+            int32 i_span = SWEEP_NONE;
+            if (i < event_edges.size() - 1)
+            {
+                if ( is_inside( winding ) )
+                    i_span = span_create( vtx );
+            }
+            else
+            {
+                // right-most part continues from above
+                if (is_inside( winding ) == (span_below_right != SWEEP_NONE) )
+                    i_span = span_below_right;
+                else if (span_below_right != SWEEP_NONE)
+                    span_end( span_below_right, vtx );
+                else
+                    i_span = span_create( vtx );
+            }
+
+            nodes[i_node].span = i_span;
+            if (i == 0) i_first_new = i_node;
+            i_prev = i_node;
+        }
+
+        check_crossing( i_left, i_first_new, i_point );
+        check_crossing( i_prev, i_right, i_point );
+    }
+}
+
+void SweepFiller::sort_event_edges( const Point& position )
+{
+    // there are usually two edges on one point, so insertion sort is enough
+    for (int i = 1; i < event_edges.size(); i++)
+    {
+        Edge  edge  = event_edges[i];
+        int   i_dst = i;
+        while ( i_dst > 0 && _cross_( position, points[edge.lower], points[event_edges[i_dst - 1].lower] ) > 0.0 )
+        {
+            event_edges[i_dst] = event_edges[i_dst - 1];
+            i_dst--;
+        }
+        event_edges[i_dst] = edge;
+    }
+
+    // edges going the same direction overlap, they are merged into one
+    for (int i = 1; i < event_edges.size(); )
+    {
+        Edge& prev = event_edges[i - 1];
+        Edge& curr = event_edges[i];
+
+        if (_cross_( position, points[prev.lower], points[curr.lower] ) != 0.0)
+        {
+            i++;
+            continue;
+        }
+
+        const Point& lower_prev = points[prev.lower];
+        const Point& lower_curr = points[curr.lower];
+
+        // the longer one is split at end of the shorter one
+        if ( _is_above_( lower_prev, lower_curr ) )
+        {
+            push_pending( Edge{ prev.lower, curr.lower, curr.winding } );
+        }
+        else if ( _is_above_( lower_curr, lower_prev ) )
+        {
+            push_pending( Edge{ curr.lower, prev.lower, prev.winding } );
+            prev.lower = curr.lower;
+        }
+
+        prev.winding += curr.winding;
+        event_edges.remove( i );
+    }
+
+    // edges with zero winding don't separate anything
+    for (int i = 0; i < event_edges.size(); )
+    {
+        if (event_edges[i].winding == 0)
+            event_edges.remove( i );
+        else
+            i++;
+    }
+}
+
+void SweepFiller::check_crossing( int32 i_left, int32 i_right, int32 i_curr )
+{
+    if (i_left == SWEEP_NONE || i_right == SWEEP_NONE)
+        return;
+
+    const Point position = points[i_curr];
+
+    const uint32 i_lower_a = nodes[i_left].lower;
+    const uint32 i_lower_b = nodes[i_right].lower;
+    const Point  upper_a   = points[nodes[i_left].upper];
+    const Point  lower_a   = points[i_lower_a];
+    const Point  upper_b   = points[nodes[i_right].upper];
+    const Point  lower_b   = points[i_lower_b];
+
+    if ( _is_same_( upper_a, upper_b ) || _is_same_( lower_a, lower_b ) ||
+         !_is_above_( position, lower_a ) || !_is_above_( position, lower_b ) )
+        return;
+
+    const double dir_ax = lower_a.x - upper_a.x;
+    const double dir_ay = lower_a.y - upper_a.y;
+    const double dir_bx = lower_b.x - upper_b.x;
+    const double dir_by = lower_b.y - upper_b.y;
+
+    const double denom = dir_ax * dir_by - dir_ay * dir_bx;
+    if (denom == 0.0)
+        return;
+
+    const double diff_x = upper_b.x - upper_a.x;
+    const double diff_y = upper_b.y - upper_a.y;
+
+    // crossing position on both edges, 0 at upper end and 1 at lower end
+    const double frac_a = (diff_x * dir_by - diff_y * dir_bx) / denom;
+    const double frac_b = (diff_x * dir_ay - diff_y * dir_ax) / denom;
+
+    if ( !(frac_a >= -SWEEP_CROSS_EPSILON && frac_a <= 1.0 + SWEEP_CROSS_EPSILON &&
+           frac_b >= -SWEEP_CROSS_EPSILON && frac_b <= 1.0 + SWEEP_CROSS_EPSILON) )
+        return;
+
+    Point cross{ upper_a.x + dir_ax * frac_a, upper_a.y + dir_ay * frac_a };
+
+    // keep crossing inside bound of both edges, otherwise rounding could
+    // move it off a horizontal or vertical edge
+    cross.x = std::max( cross.x, std::max( std::min( upper_a.x, lower_a.x ), std::min( upper_b.x, lower_b.x ) ) );
+    cross.x = std::min( cross.x, std::min( std::max( upper_a.x, lower_a.x ), std::max( upper_b.x, lower_b.x ) ) );
+    cross.y = std::max( cross.y, std::max( lower_a.y, lower_b.y ) );
+    cross.y = std::min( cross.y, std::min( upper_a.y, upper_b.y ) );
+
+    // crossing very close to end point is put on it, which is usually caused
+    // by rounding of crossing points found before
+    if (frac_a >= 1.0 - SWEEP_CROSS_EPSILON && _is_in_range_( lower_a, upper_b, lower_b ))
+        cross = lower_a;
+    else if (frac_b >= 1.0 - SWEEP_CROSS_EPSILON && _is_in_range_( lower_b, upper_a, lower_a ))
+        cross = lower_b;
+    else if (frac_a <= SWEEP_CROSS_EPSILON && _is_in_range_( upper_a, upper_b, lower_b ))
+        cross = upper_a;
+    else if (frac_b <= SWEEP_CROSS_EPSILON && _is_in_range_( upper_b, upper_a, lower_a ))
+        cross = upper_b;
+
+    // by rounding, crossing could be calculated above current point, which
+    // means the edges actually meet at current point, so they are split there
+    // and current point is swept once more
+    if ( !_is_above_( position, cross ) )
+    {
+        if ( !_is_same_( upper_a, position ) ) split_node( i_left, uint32( i_curr ) );
+        if ( !_is_same_( upper_b, position ) ) split_node( i_right, uint32( i_curr ) );
+        return;
+    }
+
+    // crossing should not go beyond end of edges
+    if ( !_is_above_( cross, lower_a ) || !_is_above_( cross, lower_b ) )
+        cross = _is_above_( lower_a, lower_b ) ? lower_a : lower_b;
+
+    uint32 i_cross;
+    if ( _is_same_( cross, lower_a ) )
+    {
+        i_cross = i_lower_a;
+    }
+    else if ( _is_same_( cross, lower_b ) )
+    {
+        i_cross = i_lower_b;
+    }
+    else
+    {
+        i_cross = uint32( points.size() );
+        points.add( cross );
+        num_crossing++;
+    }
+
+    if (i_cross != i_lower_a) split_node( i_left, i_cross );
+    if (i_cross != i_lower_b) split_node( i_right, i_cross );
+}
+
+void SweepFiller::split_node( int32 i_node, uint32 i_point )
+{
+    Node& node = nodes[i_node];
+    push_pending( Edge{ i_point, node.lower, node.winding } );
+    node.lower = i_point;
+}
+
+void SweepFiller::push_pending( const Edge& edge )
+{
+    pending.add( edge );
+    std::push_heap( pending.begin(), pending.end(), PendingEdgeOrder( points ) );
+}
+
+int SweepFiller::node_side( int32 i_node, const Point& position ) const noexcept
+{
+    const Node& node = nodes[i_node];
+    if ( !_is_above_( position, points[node.lower] ) )
+        return 0;
+
+    // edges are directed downwards, so counter-clockwise means on right
+    return _side_( points[node.upper], points[node.lower], position );
+}
+
+int32 SweepFiller::tree_lower_bound( const Point& position ) const noexcept
+{
+    int32 result = SWEEP_NONE;
+
+    for (int32 i_node = tree_root; i_node != SWEEP_NONE; )
+    {
+        if (node_side( i_node, position ) <= 0)
+        {
+            result = i_node;
+            i_node = nodes[i_node].left;
+        }
+        else
+        {
+            i_node = nodes[i_node].right;
+        }
+    }
+
+    return result;
+}
+
+int32 SweepFiller::tree_create( const Edge& edge, int32 winding_right )
+{
+    int32 i_node = nodes.size();
+    nodes.add( Node{ edge.upper, edge.lower, edge.winding, winding_right,
+                     SWEEP_NONE, SWEEP_NONE, SWEEP_NONE, sweep_tree_priority( uint32( i_node ) ),
+                     SWEEP_NONE, SWEEP_NONE,
+                     SWEEP_NONE, SWEEP_NONE, 0 } );
+    return i_node;
+}
+
+void SweepFiller::tree_rotate_up( int32 i_node ) noexcept
+{
+    Node& node     = nodes[i_node];
+    int32 i_parent = node.parent;
+    Node& parent   = nodes[i_parent];
+    int32 i_grand  = parent.parent;
+
+    if (parent.left == i_node)
+    {
+        parent.left = node.right;
+        if (node.right != SWEEP_NONE)
+            nodes[node.right].parent = i_parent;
+        node.right = i_parent;
+    }
+    else
+    {
+        parent.right = node.left;
+        if (node.left != SWEEP_NONE)
+            nodes[node.left].parent = i_parent;
+        node.left = i_parent;
+    }
+
+    parent.parent = i_node;
+    node.parent   = i_grand;
+
+    if (i_grand == SWEEP_NONE)
+        tree_root = i_node;
+    else if (nodes[i_grand].left == i_parent)
+        nodes[i_grand].left = i_node;
+    else
+        nodes[i_grand].right = i_node;
+}
+
+void SweepFiller::tree_insert_after( int32 i_prev, int32 i_node ) noexcept
+{
+    Node& node = nodes[i_node];
+
+    // link with neighbors
+    node.prev = i_prev;
+    node.next = i_prev == SWEEP_NONE ? list_first : nodes[i_prev].next;
+
+    if (node.prev == SWEEP_NONE) list_first = i_node;
+    else nodes[node.prev].next = i_node;
+
+    if (node.next == SWEEP_NONE) list_last = i_node;
+    else nodes[node.next].prev = i_node;
+
+    // in-order position right after previous node is its right child if it
+    // has no right subtree, otherwise it is the left child of next node,
+    // which is the left-most node of that subtree
+    if (i_prev != SWEEP_NONE && nodes[i_prev].right == SWEEP_NONE)
+    {
+        node.parent          = i_prev;
+        nodes[i_prev].right = i_node;
+    }
+    else if (node.next != SWEEP_NONE)
+    {
+        treecore_assert( nodes[node.next].left == SWEEP_NONE );
+        node.parent            = node.next;
+        nodes[node.next].left = i_node;
+    }
+    else
+    {
+        treecore_assert( tree_root == SWEEP_NONE );
+        node.parent = SWEEP_NONE;
+        tree_root   = i_node;
+    }
+
+    // restore heap order of priorities
+    while (node.parent != SWEEP_NONE && nodes[node.parent].priority < node.priority)
+        tree_rotate_up( i_node );
+}
+
+void SweepFiller::tree_remove( int32 i_node ) noexcept
+{
+    Node& node = nodes[i_node];
+
+    if (node.prev == SWEEP_NONE) list_first = node.next;
+    else nodes[node.prev].next = node.next;
+
+    if (node.next == SWEEP_NONE) list_last = node.prev;
+    else nodes[node.next].prev = node.prev;
+
+    // rotate node down until it is a leaf
+    while (node.left != SWEEP_NONE || node.right != SWEEP_NONE)
+    {
+        int32 i_child;
+        if (node.left == SWEEP_NONE)
+            i_child = node.right;
+        else if (node.right == SWEEP_NONE)
+            i_child = node.left;
+        else
+            i_child = nodes[node.left].priority > nodes[node.right].priority ? node.left : node.right;
+
+        tree_rotate_up( i_child );
+    }
+
+    if (node.parent == SWEEP_NONE)
+        tree_root = SWEEP_NONE;
+    else if (nodes[node.parent].left == i_node)
+        nodes[node.parent].left = SWEEP_NONE;
+    else
+        nodes[node.parent].right = SWEEP_NONE;
+
+    node.parent = SWEEP_NONE;
+    node.prev   = SWEEP_NONE;
+    node.next   = SWEEP_NONE;
+}
+
+int32 SweepFiller::span_create( const SpanVertex& top )
+{
+    int32 i_span;
+    if (free_spans.size() > 0)
+    {
+        i_span = free_spans.getLast();
+        free_spans.removeLast();
+    }
+    else
+    {
+        i_span = spans.size();
+        spans.add( Span() );
+    }
+
+    Array<SpanVertex>& stack = spans[i_span].stack;
+    stack.clearQuick();
+    stack.add( top );
+    return i_span;
+}
+
+void SweepFiller::span_add( int32 i_span, const SpanVertex& vtx_in, int32 side )
+{
+    Array<SpanVertex>& stack = spans[i_span].stack;
+    treecore_assert( stack.size() > 0 );
+
+    // a point could be swept more than once
+    if ( _is_same_( stack.getLast().position, vtx_in.position ) )
+        return;
+
+    SpanVertex vtx = vtx_in;
+    vtx.side = side;
+
+    if (stack.size() == 1 || stack.getLast().side != side)
+    {
+        // vertex on the other chain can see all vertices in stack
+        for (int i = 1; i < stack.size(); i++)
+            add_triangle( stack[i - 1], stack[i], vtx );
+
+        SpanVertex top = stack.getLast();
+        stack.clearQuick();
+        stack.add( top );
+        stack.add( vtx );
+    }
+    else
+    {
+        // vertex on the same chain cuts off convex corners
+        while (stack.size() > 1)
+        {
+            const SpanVertex& corner = stack.getLast();
+            const SpanVertex& before = stack[stack.size() - 2];
+
+            double cross = _cross_( before.position, corner.position, vtx.position );
+            if (side == SPAN_SIDE_LEFT ? cross <= 0.0 : cross >= 0.0)
+                break;
+
+            add_triangle( before, corner, vtx );
+            stack.removeLast();
+        }
+
+        stack.add( vtx );
+    }
+}
+
+void SweepFiller::span_end( int32 i_span, const SpanVertex& vtx )
+{
+    Array<SpanVertex>& stack = spans[i_span].stack;
+
+    for (int i = 1; i < stack.size(); i++)
+        add_triangle( stack[i - 1], stack[i], vtx );
+
+    stack.clearQuick();
+    free_spans.add( i_span );
+}
+
+void SweepFiller::add_triangle( const SpanVertex& a, const SpanVertex& b, const SpanVertex& c )
+{
+    double area = _cross_( a.position, b.position, c.position );
+    if (area == 0.0)
+        return;
+
+    // all triangles are counter-clockwise
+    results->add( index_base + a.index );
+    if (area > 0.0)
+    {
+        results->add( index_base + b.index );
+        results->add( index_base + c.index );
+    }
+    else
+    {
+        results->add( index_base + c.index );
+        results->add( index_base + b.index );
+    }
+}
+
+} // namespace treeface
@@ -0,0 +1,165 @@
+#ifndef TREEFACE_SWEEP_FILLER_H
+#define TREEFACE_SWEEP_FILLER_H
+
+#include "treeface/base/Enums.h"
+#include "treeface/math/Vec2.h"
+#include "treeface/scene/Geometry.h"
+
+#include <treecore/Array.h>
+#include <treecore/IntTypes.h>
+
+namespace treeface
+{
+
+///
+/// \brief fill polygons whose edges may cross each other, using fill rule
+///
+/// Polygons are swept from top to bottom. As in Bentley-Ottmann algorithm,
+/// edges that become neighbors on sweep line are tested for crossing, and
+/// are split at crossing point, so that each part of plane between edges has
+/// a definite winding number. Parts that are inside by fill rule are cut into
+/// monotone pieces, and each piece is triangulated as soon as its vertices
+/// are swept.
+///
+/// Edges on sweep line are kept in a treap, so n edges with k crossings are
+/// done in O((n+k) log n) time. Storage is kept between fills.
+///
+struct SweepFiller
+{
+    ///
+    /// \brief vertex position in double precision
+    ///
+    /// Crossing points often lie between two rows of float values, and are
+    /// kept in double precision so that they are swept in correct order.
+    ///
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    ///
+    /// \brief edge that is not reached by sweep line yet
+    ///
+    struct Edge
+    {
+        treecore::uint32 upper;
+        treecore::uint32 lower;
+        treecore::int32  winding; ///< +1 if polygon goes downwards on it, -1 if upwards
+    };
+
+    ///
+    /// \brief edge on sweep line, together with the part of plane on its
+    ///        right side
+    ///
+    struct Node
+    {
+        treecore::uint32 upper;
+        treecore::uint32 lower;
+        treecore::int32  winding;
+        treecore::int32  winding_right; ///< winding number of the part on right side
+
+        // treap ordered from left to right
+        treecore::int32  parent;
+        treecore::int32  left;
+        treecore::int32  right;
+        treecore::uint32 priority;
+
+        // neighbors on sweep line
+        treecore::int32 prev;
+        treecore::int32 next;
+
+        // monotone pieces of the part on right side, there are two pieces if
+        // the part has a merge vertex that is not connected yet
+        treecore::int32  span;
+        treecore::int32  span_merge;
+        treecore::uint32 vtx_merge;
+    };
+
+    struct SpanVertex
+    {
+        Point            position;
+        treecore::uint32 index;
+        treecore::int32  side;
+    };
+
+    ///
+    /// \brief monotone piece being triangulated
+    ///
+    /// Stack holds vertices whose triangles are not decided yet.
+    ///
+    struct Span
+    {
+        treecore::Array<SpanVertex> stack;
+    };
+
+    ///
+    /// \brief triangulate polygons
+    ///
+    /// \param rule                   how winding number decides inside
+    /// \param vertices               polygon vertices, crossing points are
+    ///                               appended to here
+    /// \param subpath_begin          index of first vertex of each polygon
+    /// \param result_indices         triangle indices are appended to here
+    ///
+    void fill( FillRule rule,
+               Geometry::HostVertexCache&               vertices,
+               const treecore::Array<treecore::int32>&  subpath_begin,
+               treecore::Array<treecore::uint32>&       result_indices,
+               Vec2f& result_skeleton_min,
+               Vec2f& result_skeleton_max );
+
+    /// number of crossing points added by last fill()
+    int num_crossing = 0;
+
+private:
+    void process_event( treecore::int32 i_point );
+
+    void sort_event_edges( const Point& position );
+
+    void check_crossing( treecore::int32 i_left, treecore::int32 i_right, treecore::int32 i_curr );
+
+    void split_node( treecore::int32 i_node, treecore::uint32 i_point );
+
+    void push_pending( const Edge& edge );
+
+    bool is_inside( treecore::int32 winding ) const noexcept
+    {
+        return rule == FILL_NON_ZERO ? winding != 0 : (winding & 1) != 0;
+    }
+
+    int  node_side( treecore::int32 i_node, const Point& position ) const noexcept;
+
+    treecore::int32 tree_lower_bound( const Point& position ) const noexcept;
+    treecore::int32 tree_create( const Edge& edge, treecore::int32 winding_right );
+    void tree_rotate_up( treecore::int32 i_node ) noexcept;
+    void tree_insert_after( treecore::int32 i_prev, treecore::int32 i_node ) noexcept;
+    void tree_remove( treecore::int32 i_node ) noexcept;
+
+    treecore::int32 span_create( const SpanVertex& top );
+    void span_add( treecore::int32 i_span, const SpanVertex& vtx, treecore::int32 side );
+    void span_end( treecore::int32 i_span, const SpanVertex& vtx );
+    void add_triangle( const SpanVertex& a, const SpanVertex& b, const SpanVertex& c );
+
+    FillRule rule = FILL_NON_ZERO;
+    treecore::uint32 index_base = 0;
+    treecore::Array<treecore::uint32>* results = nullptr;
+
+    treecore::Array<Point> points;
+
+    treecore::Array<Edge>            pending; // heap ordered by upper point
+    treecore::Array<Edge>            event_edges;
+    treecore::Array<treecore::int32> event_nodes;
+
+    treecore::Array<Node> nodes;
+    treecore::int32       tree_root  = -1;
+    treecore::int32       list_first = -1;
+    treecore::int32       list_last  = -1;
+
+    treecore::Array<Span>            spans;
+    treecore::Array<treecore::int32> free_spans;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_SWEEP_FILLER_H
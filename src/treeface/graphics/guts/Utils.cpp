@@ -5,7 +5,7 @@ using namespace treecore;
 namespace treeface
 {
 
-double clockwise_accum( const Geometry::HostVertexCache& vertices, IndexType i_begin, IndexType i_end ) noexcept
+double clockwise_accum( const Geometry::HostVertexCache& vertices, int i_begin, int i_end ) noexcept
 {
     treecore_assert( i_end - i_begin > 2 );
     treecore_assert( i_end <= vertices.size() );
@@ -28,4 +28,19 @@ double clockwise_accum( const Geometry::HostVertexCache& vertices, IndexType i_b
     return sum;
 }
 
+void accum_trip( const treecore::Array<Vec2f>& points, treecore::Array<float>& results )
+{
+    if (points.size() == 0)
+        return;
+
+    float trip = 0.0f;
+    results.add( trip );
+
+    for (int i = 1; i < points.size(); i++)
+    {
+        trip += (points[i] - points[i - 1]).length();
+        results.add( trip );
+    }
+}
+
 } // namespace treeface
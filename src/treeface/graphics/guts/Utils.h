@@ -11,10 +11,25 @@
 #define TAIL_FIND_LIMIT 32
 #define STROKE_ROUNDNESS 32
 
+// fringe vertex of anti-aliased fill is at most this many times of fringe
+// width away from outline, which limits spikes at sharp corners
+#define FILL_FRINGE_MITER_LIMIT 4
+
+// streamed stroke is triangulated when it has this many final outline
+// vertices, which bounds the outline kept in memory
+#define STROKE_STREAM_CHUNK 256
+
+// outline vertices near tail are not streamed out, as inner side of later
+// joints could cut them. One cut could make next search reach further than
+// TAIL_FIND_LIMIT, so a few times of it is kept.
+#define STROKE_STREAM_WINDOW (TAIL_FIND_LIMIT * 4)
+
 namespace treeface
 {
 
-typedef treecore::int16 JointID;
+// joints of one stroke can be more than range of 16-bit index, and joint ID
+// never leaves stroker, so it is not narrowed along with vertex index
+typedef treecore::int32 JointID;
 
 inline void update_bound( const Vec2f& p, Vec2f& result_min, Vec2f& result_max )
 {
@@ -24,6 +39,20 @@ inline void update_bound( const Vec2f& p, Vec2f& result_min, Vec2f& result_max )
     if (p.y > result_max.y) result_max.y = p.y;
 }
 
+///
+/// \brief fixed pseudo-random priority of treap node, so that results are
+///        reproducible
+///
+inline treecore::uint32 sweep_tree_priority( treecore::uint32 value ) noexcept
+{
+    value ^= value >> 16;
+    value *= 0x85ebca6b;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35;
+    value ^= value >> 16;
+    return value;
+}
+
 struct InternalStrokeStyle
 {
     LineCap  cap;
@@ -32,7 +61,12 @@ struct InternalStrokeStyle
     float    half_width;
 };
 
-double clockwise_accum( const Geometry::HostVertexCache& vertices, IndexType i_begin, IndexType i_end ) noexcept;
+double clockwise_accum( const Geometry::HostVertexCache& vertices, int i_begin, int i_end ) noexcept;
+
+///
+/// \brief append distance from first point to each point of a polyline
+///
+void accum_trip( const treecore::Array<Vec2f>& points, treecore::Array<float>& results );
 
 inline float calc_step( float total, float step_size, int min_num_step )
 {
@@ -0,0 +1,117 @@
+#ifndef TREEFACE_BBOX3_H
+#define TREEFACE_BBOX3_H
+
+#include "treeface/math/Mat4.h"
+
+#include <cmath>
+#include <limits>
+
+namespace treeface
+{
+
+///
+/// \brief axis-aligned bounding box in 3D space
+///
+/// Default constructed box is invalid, which has no point inside. Adding
+/// points or boxes to it makes it valid.
+///
+template<typename T>
+struct BBox3
+{
+    BBox3() = default;
+
+    BBox3( T x_min, T y_min, T z_min, T x_max, T y_max, T z_max ) noexcept
+        : x_min( x_min ), x_max( x_max )
+        , y_min( y_min ), y_max( y_max )
+        , z_min( z_min ), z_max( z_max )
+    {}
+
+    bool is_valid() const noexcept
+    {
+        return !std::isnan( x_min );
+    }
+
+    void add_point( T x, T y, T z ) noexcept
+    {
+        if ( !is_valid() )
+        {
+            x_min = x_max = x;
+            y_min = y_max = y;
+            z_min = z_max = z;
+            return;
+        }
+
+        if (x < x_min) x_min = x;
+        if (x > x_max) x_max = x;
+        if (y < y_min) y_min = y;
+        if (y > y_max) y_max = y;
+        if (z < z_min) z_min = z;
+        if (z > z_max) z_max = z;
+    }
+
+    void add_box( const BBox3& other ) noexcept
+    {
+        if ( !other.is_valid() )
+            return;
+
+        add_point( other.x_min, other.y_min, other.z_min );
+        add_point( other.x_max, other.y_max, other.z_max );
+    }
+
+    ///
+    /// \brief get the box that contains this box after transformation
+    ///
+    /// The result is calculated from the extent on each axis without
+    /// transforming eight corners, and is exact for affine transforms.
+    ///
+    BBox3 transformed( const Mat4<T>& mat ) const noexcept
+    {
+        if ( !is_valid() )
+            return BBox3();
+
+        T src_min[3] = { x_min, y_min, z_min };
+        T src_max[3] = { x_max, y_max, z_max };
+        T dst_min[3] = { mat.template get<0, 3>(), mat.template get<1, 3>(), mat.template get<2, 3>() };
+        T dst_max[3] = { dst_min[0], dst_min[1], dst_min[2] };
+
+        T m[3][3] = {
+            { mat.template get<0, 0>(), mat.template get<0, 1>(), mat.template get<0, 2>() },
+            { mat.template get<1, 0>(), mat.template get<1, 1>(), mat.template get<1, 2>() },
+            { mat.template get<2, 0>(), mat.template get<2, 1>(), mat.template get<2, 2>() },
+        };
+
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                T a = m[row][col] * src_min[col];
+                T b = m[row][col] * src_max[col];
+                if (a < b)
+                {
+                    dst_min[row] += a;
+                    dst_max[row] += b;
+                }
+                else
+                {
+                    dst_min[row] += b;
+                    dst_max[row] += a;
+                }
+            }
+        }
+
+        return BBox3( dst_min[0], dst_min[1], dst_min[2], dst_max[0], dst_max[1], dst_max[2] );
+    }
+
+    T x_min = std::numeric_limits<T>::quiet_NaN();
+    T x_max = std::numeric_limits<T>::quiet_NaN();
+    T y_min = std::numeric_limits<T>::quiet_NaN();
+    T y_max = std::numeric_limits<T>::quiet_NaN();
+    T z_min = std::numeric_limits<T>::quiet_NaN();
+    T z_max = std::numeric_limits<T>::quiet_NaN();
+};
+
+typedef BBox3<float> BBox3f;
+
+} // namespace treeface
+
+#endif // TREEFACE_BBOX3_H
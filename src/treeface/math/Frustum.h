@@ -0,0 +1,111 @@
+#ifndef TREEFACE_FRUSTUM_H
+#define TREEFACE_FRUSTUM_H
+
+#include "treeface/math/BBox3.h"
+#include "treeface/math/Mat4.h"
+
+namespace treeface
+{
+
+typedef enum
+{
+    FRUSTUM_OUTSIDE   = 0, ///< totally outside of frustum
+    FRUSTUM_INTERSECT = 1, ///< partially inside, or the test is inconclusive
+    FRUSTUM_INSIDE    = 2, ///< totally inside of frustum
+} FrustumTestResult;
+
+///
+/// \brief view frustum represented by six planes
+///
+/// Planes are extracted from a view-projection matrix, so that the frustum is
+/// in the space before that transformation. Plane normals point to inside.
+///
+template<typename T>
+struct Frustum
+{
+    Frustum() = default;
+
+    explicit Frustum( const Mat4<T>& view_proj ) noexcept
+    {
+        set( view_proj );
+    }
+
+    ///
+    /// \brief extract planes from view-projection matrix
+    ///
+    /// A point is inside if its clip-space coordinate satisfies
+    /// -w <= x, y, z <= w, which is the OpenGL convention.
+    ///
+    void set( const Mat4<T>& m ) noexcept
+    {
+        T rows[4][4];
+        _get_row_<0>( m, rows[0] );
+        _get_row_<1>( m, rows[1] );
+        _get_row_<2>( m, rows[2] );
+        _get_row_<3>( m, rows[3] );
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                planes[axis * 2][i]     = rows[3][i] + rows[axis][i];
+                planes[axis * 2 + 1][i] = rows[3][i] - rows[axis][i];
+            }
+        }
+    }
+
+    ///
+    /// \brief test box against frustum
+    ///
+    /// The test is conservative: box that is close to frustum corners may be
+    /// reported as intersecting while it's actually outside. Invalid box is
+    /// always reported as intersecting.
+    ///
+    FrustumTestResult test( const BBox3<T>& box ) const noexcept
+    {
+        if ( !box.is_valid() )
+            return FRUSTUM_INTERSECT;
+
+        FrustumTestResult result = FRUSTUM_INSIDE;
+
+        for (int i = 0; i < 6; i++)
+        {
+            const T* p = planes[i];
+
+            // the corner farthest along plane normal, and the nearest one
+            T far_dist  = p[3];
+            T near_dist = p[3];
+            far_dist  += p[0] * (p[0] >= 0 ? box.x_max : box.x_min);
+            near_dist += p[0] * (p[0] >= 0 ? box.x_min : box.x_max);
+            far_dist  += p[1] * (p[1] >= 0 ? box.y_max : box.y_min);
+            near_dist += p[1] * (p[1] >= 0 ? box.y_min : box.y_max);
+            far_dist  += p[2] * (p[2] >= 0 ? box.z_max : box.z_min);
+            near_dist += p[2] * (p[2] >= 0 ? box.z_min : box.z_max);
+
+            if (far_dist < 0)
+                return FRUSTUM_OUTSIDE;
+            if (near_dist < 0)
+                result = FRUSTUM_INTERSECT;
+        }
+
+        return result;
+    }
+
+    T planes[6][4]; ///< a, b, c, d of plane equation ax + by + cz + d = 0
+
+private:
+    template<int row>
+    static void _get_row_( const Mat4<T>& m, T* result ) noexcept
+    {
+        result[0] = m.template get<row, 0>();
+        result[1] = m.template get<row, 1>();
+        result[2] = m.template get<row, 2>();
+        result[3] = m.template get<row, 3>();
+    }
+};
+
+typedef Frustum<float> Frustumf;
+
+} // namespace treeface
+
+#endif // TREEFACE_FRUSTUM_H
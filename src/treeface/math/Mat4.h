@@ -250,6 +250,61 @@ struct Mat4
         return det4;
     }
 
+    /**
+     * @brief whether the last row is (0, 0, 0, 1)
+     */
+    bool is_affine() const noexcept
+    {
+        return get<3, 0>() == T(0) && get<3, 1>() == T(0) && get<3, 2>() == T(0) && get<3, 3>() == T(1);
+    }
+
+    /**
+     * @brief inverse this matrix, assuming it is affine
+     *
+     * Only the upper-left 3x3 part is inversed, and translation is solved
+     * from it, which is much cheaper than inverse(). The result is wrong if
+     * the matrix has projective components.
+     *
+     * @return the determinant before inverse
+     */
+    T inverse_affine() noexcept
+    {
+        const T a00 = get<0, 0>(), a01 = get<0, 1>(), a02 = get<0, 2>(), t0 = get<0, 3>();
+        const T a10 = get<1, 0>(), a11 = get<1, 1>(), a12 = get<1, 2>(), t1 = get<1, 3>();
+        const T a20 = get<2, 0>(), a21 = get<2, 1>(), a22 = get<2, 2>(), t2 = get<2, 3>();
+
+        const T c00 = a11 * a22 - a12 * a21;
+        const T c10 = a12 * a20 - a10 * a22;
+        const T c20 = a10 * a21 - a11 * a20;
+
+        const T det = a00 * c00 + a01 * c10 + a02 * c20;
+        if (det == T(0))
+            return det;
+
+        const T r = T(1) / det;
+
+        const T v00 = c00 * r;
+        const T v01 = (a02 * a21 - a01 * a22) * r;
+        const T v02 = (a01 * a12 - a02 * a11) * r;
+        const T v10 = c10 * r;
+        const T v11 = (a00 * a22 - a02 * a20) * r;
+        const T v12 = (a02 * a10 - a00 * a12) * r;
+        const T v20 = c20 * r;
+        const T v21 = (a01 * a20 - a00 * a21) * r;
+        const T v22 = (a00 * a11 - a01 * a10) * r;
+
+        const T v03 = -(v00 * t0 + v01 * t1 + v02 * t2);
+        const T v13 = -(v10 * t0 + v11 * t1 + v12 * t2);
+        const T v23 = -(v20 * t0 + v21 * t1 + v22 * t2);
+
+        data[0].set_all(v00, v10, v20, T(0));
+        data[1].set_all(v01, v11, v21, T(0));
+        data[2].set_all(v02, v12, v22, T(0));
+        data[3].set_all(v03, v13, v23, T(1));
+
+        return det;
+    }
+
     /**
      * @brief set first 3x3 elements to rotate matrix using specified quaternion. The 4th translation column is untouched.
      * @param value: quaternion representing the rotation
@@ -0,0 +1,113 @@
+#ifndef TREEFACE_RADIX_SORT_H
+#define TREEFACE_RADIX_SORT_H
+
+#include <treecore/Array.h>
+#include <treecore/IntTypes.h>
+
+#include <cstring>
+
+namespace treeface
+{
+
+///
+/// \brief stable LSD radix sort on unsigned 64-bit keys
+///
+/// Keys are processed by 8-bit digits from the lowest one. Histograms of all
+/// digits are built in one pass, and digits that are identical for all
+/// elements are skipped, so keys that only use a few bits are cheap.
+///
+/// \param data      elements to be sorted
+/// \param buffer    scratch space with at least size elements
+/// \param size      number of elements
+/// \param get_key   functor that returns the uint64 sort key of an element
+///
+template<typename T, typename KeyFunc>
+void radix_sort( T* data, T* buffer, size_t size, KeyFunc get_key )
+{
+    if (size < 2)
+        return;
+
+    size_t counts[8][256];
+    memset( counts, 0, sizeof(counts) );
+
+    for (size_t i = 0; i < size; i++)
+    {
+        treecore::uint64 key = get_key( data[i] );
+        for (int digit = 0; digit < 8; digit++)
+            counts[digit][(key >> (digit * 8) ) & 0xff]++;
+    }
+
+    treecore::uint64 first_key = get_key( data[0] );
+
+    T* src = data;
+    T* dst = buffer;
+
+    for (int digit = 0; digit < 8; digit++)
+    {
+        int shift = digit * 8;
+
+        // all elements have same value on this digit
+        if (counts[digit][(first_key >> shift) & 0xff] == size)
+            continue;
+
+        size_t offsets[256];
+        size_t accum = 0;
+        for (int i = 0; i < 256; i++)
+        {
+            offsets[i] = accum;
+            accum     += counts[digit][i];
+        }
+
+        for (size_t i = 0; i < size; i++)
+            dst[offsets[(get_key( src[i] ) >> shift) & 0xff]++] = src[i];
+
+        T* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != data)
+    {
+        for (size_t i = 0; i < size; i++)
+            data[i] = src[i];
+    }
+}
+
+///
+/// \brief map float to unsigned integer with the same order, so that floats
+///        can be used in radix sort keys
+///
+/// Negative zero is mapped to the same value as positive zero. NaN is not
+/// supported.
+///
+inline treecore::uint32 float_to_radix_key( float value ) noexcept
+{
+    value += 0.0f;
+
+    treecore::uint32 bits;
+    memcpy( &bits, &value, sizeof(bits) );
+
+    // negative values are reversed, positive values are moved above them
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+///
+/// \brief stable LSD radix sort on treecore::Array
+///
+/// \param data      elements to be sorted
+/// \param buffer    scratch array, will be resized to the size of data
+/// \param get_key   functor that returns the uint64 sort key of an element
+///
+template<typename T, typename KeyFunc>
+void radix_sort( treecore::Array<T>& data, treecore::Array<T>& buffer, KeyFunc get_key )
+{
+    if (data.size() < 2)
+        return;
+
+    buffer.resize( data.size() );
+    radix_sort( &data[0], &buffer[0], size_t( data.size() ), get_key );
+}
+
+} // namespace treeface
+
+#endif // TREEFACE_RADIX_SORT_H
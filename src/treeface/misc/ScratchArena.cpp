@@ -0,0 +1,98 @@
+#include "treeface/misc/ScratchArena.h"
+
+#include <treecore/DebugUtils.h>
+
+#include <cstdlib>
+#include <new>
+
+using namespace treecore;
+
+namespace treeface
+{
+
+ScratchArena::ScratchArena( size_t min_chunk_size ): m_min_chunk_size( min_chunk_size )
+{}
+
+ScratchArena::~ScratchArena()
+{
+    for (const Chunk& chunk : m_chunks)
+        free( chunk.data );
+}
+
+ScratchArena& ScratchArena::get_thread_arena()
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+void* ScratchArena::allocate_in_new_chunk( size_t num_byte )
+{
+    // space left in current chunk is skipped
+    int32 i_chunk = m_i_chunk < m_chunks.size() && m_offset > 0 ? m_i_chunk + 1 : m_i_chunk;
+
+    // chunks after current one are not used, drop those too small
+    while ( i_chunk < m_chunks.size() && m_chunks[i_chunk].size < num_byte )
+    {
+        free( m_chunks[i_chunk].data );
+        m_chunks.remove( i_chunk );
+    }
+
+    if ( i_chunk == m_chunks.size() )
+    {
+        // grow geometrically, so that number of chunks stays small
+        size_t size = m_min_chunk_size;
+        if ( m_chunks.size() > 0 && size < m_chunks.getLast().size * 2 )
+            size = m_chunks.getLast().size * 2;
+        if (size < num_byte)
+            size = num_byte;
+
+        uint8* data = static_cast<uint8*>( malloc( size ) );
+        if (data == nullptr)
+            throw std::bad_alloc();
+
+        m_chunks.add( Chunk{ data, size } );
+    }
+
+    m_i_chunk = i_chunk;
+    m_offset  = num_byte;
+    m_used   += num_byte;
+    if (m_peak < m_used) m_peak = m_used;
+
+    return m_chunks[i_chunk].data;
+}
+
+void ScratchArena::rewind( const Marker& marker ) noexcept
+{
+    treecore_assert( marker.used <= m_used );
+
+    m_i_chunk = marker.i_chunk;
+    m_offset  = marker.offset;
+    m_used    = marker.used;
+
+    // merge chunks when arena is empty, so that next time all memory is
+    // taken from one chunk
+    if (m_used == 0 && m_chunks.size() > 1)
+    {
+        size_t total = get_capacity();
+        for (const Chunk& chunk : m_chunks)
+            free( chunk.data );
+        m_chunks.clearQuick();
+
+        uint8* data = static_cast<uint8*>( malloc( total ) );
+        if (data != nullptr)
+            m_chunks.add( Chunk{ data, total } );
+
+        m_i_chunk = 0;
+        m_offset  = 0;
+    }
+}
+
+size_t ScratchArena::get_capacity() const noexcept
+{
+    size_t result = 0;
+    for (const Chunk& chunk : m_chunks)
+        result += chunk.size;
+    return result;
+}
+
+} // namespace treeface
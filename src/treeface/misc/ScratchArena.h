@@ -0,0 +1,169 @@
+#ifndef TREEFACE_SCRATCH_ARENA_H
+#define TREEFACE_SCRATCH_ARENA_H
+
+#include "treeface/base/Common.h"
+
+#include <treecore/Array.h>
+#include <treecore/ClassUtils.h>
+#include <treecore/IntTypes.h>
+
+#include <type_traits>
+
+// alignment of memory given by arena, which is also alignment of malloc
+#define SCRATCH_ARENA_ALIGN 16
+
+#define SCRATCH_ARENA_MIN_CHUNK (64 * 1024)
+
+namespace treeface
+{
+
+///
+/// \brief bump allocator for short-lived temporary arrays
+///
+/// Memory is taken from big chunks by moving an offset forward, and is
+/// released all at once by rewinding to an earlier position. When it is
+/// rewound to empty, all chunks are merged into one, so that repeated work of
+/// similar size won't touch heap any more.
+///
+/// Constructors and destructors are not called on arena memory, so it is
+/// only for trivial types. An arena is not thread safe; use
+/// get_thread_arena() to get the one of current thread.
+///
+class ScratchArena
+{
+public:
+    struct Marker
+    {
+        treecore::int32 i_chunk;
+        size_t          offset;
+        size_t          used;
+    };
+
+    ScratchArena( size_t min_chunk_size = SCRATCH_ARENA_MIN_CHUNK );
+
+    TREECORE_DECLARE_NON_COPYABLE( ScratchArena );
+    TREECORE_DECLARE_NON_MOVABLE( ScratchArena );
+
+    ~ScratchArena();
+
+    ///
+    /// \brief arena owned by current thread
+    ///
+    static ScratchArena& get_thread_arena();
+
+    void* allocate( size_t num_byte )
+    {
+        if ( m_i_chunk < m_chunks.size() )
+        {
+            const Chunk& chunk = m_chunks.getReference( m_i_chunk );
+            size_t       begin = (m_offset + SCRATCH_ARENA_ALIGN - 1) & ~size_t( SCRATCH_ARENA_ALIGN - 1 );
+
+            if (begin + num_byte <= chunk.size)
+            {
+                m_used  += begin + num_byte - m_offset;
+                m_offset = begin + num_byte;
+                if (m_peak < m_used) m_peak = m_used;
+                return chunk.data + begin;
+            }
+        }
+
+        return allocate_in_new_chunk( num_byte );
+    }
+
+    template<typename T>
+    T* allocate( size_t num_elem )
+    {
+        static_assert( std::is_trivially_destructible<T>::value, "arena memory is never destructed" );
+        static_assert( alignof(T) <= SCRATCH_ARENA_ALIGN, "arena memory is not aligned enough" );
+        return static_cast<T*>( allocate( sizeof(T) * num_elem ) );
+    }
+
+    Marker get_marker() const noexcept
+    {
+        return Marker{ m_i_chunk, m_offset, m_used };
+    }
+
+    ///
+    /// \brief release all memory allocated after marker was got
+    ///
+    void rewind( const Marker& marker ) noexcept;
+
+    ///
+    /// \brief release all memory
+    ///
+    void reset() noexcept
+    {
+        rewind( Marker{ 0, 0, 0 } );
+    }
+
+    ///
+    /// \brief number of bytes currently allocated, including alignment
+    ///        padding
+    ///
+    size_t get_num_used() const noexcept
+    {
+        return m_used;
+    }
+
+    ///
+    /// \brief maximum of get_num_used() since creation or last reset_peak()
+    ///
+    size_t get_peak() const noexcept
+    {
+        return m_peak;
+    }
+
+    void reset_peak() noexcept
+    {
+        m_peak = m_used;
+    }
+
+    ///
+    /// \brief total size of chunks held by arena
+    ///
+    size_t get_capacity() const noexcept;
+
+private:
+    struct Chunk
+    {
+        treecore::uint8* data;
+        size_t           size;
+    };
+
+    void* allocate_in_new_chunk( size_t num_byte );
+
+    treecore::Array<Chunk> m_chunks;
+    treecore::int32        m_i_chunk = 0;
+    size_t m_offset         = 0;
+    size_t m_used           = 0;
+    size_t m_peak           = 0;
+    size_t m_min_chunk_size = 0;
+};
+
+///
+/// \brief rewind arena on destruction to where it was on construction
+///
+class ScratchScope
+{
+public:
+    ScratchScope( ScratchArena& arena ) noexcept
+        : m_arena( arena )
+        , m_marker( arena.get_marker() )
+    {}
+
+    TREECORE_DECLARE_NON_COPYABLE( ScratchScope );
+    TREECORE_DECLARE_NON_MOVABLE( ScratchScope );
+
+    ~ScratchScope()
+    {
+        m_arena.rewind( m_marker );
+    }
+
+private:
+    ScratchArena&        m_arena;
+    ScratchArena::Marker m_marker;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_SCRATCH_ARENA_H
@@ -272,6 +272,33 @@ treecore::String toString<LineJoin>( LineJoin join )
     }
 }
 
+template<>
+bool fromString<DepthSortPolicy>( const String& str, DepthSortPolicy& result )
+{
+    String value_lc = str.toLowerCase();
+
+    if      (value_lc == "none")        result = DEPTH_SORT_NONE;
+    else if (value_lc == "translucent") result = DEPTH_SORT_TRANSLUCENT;
+    else if (value_lc == "all")         result = DEPTH_SORT_ALL;
+    else
+        return false;
+
+    return true;
+}
+
+template<>
+treecore::String toString<DepthSortPolicy>( DepthSortPolicy policy )
+{
+    switch (policy)
+    {
+    case DEPTH_SORT_NONE: return "none";
+    case DEPTH_SORT_TRANSLUCENT: return "translucent";
+    case DEPTH_SORT_ALL: return "all";
+    default:
+        throw std::invalid_argument( ( "invalid treeface depth sort policy enum: " + String( int(policy) ) ).toRawUTF8() );
+    }
+}
+
 template<>
 bool fromString<treeface::GLBufferType>( const treecore::String& string, treeface::GLBufferType& result )
 {
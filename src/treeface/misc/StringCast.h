@@ -22,6 +22,9 @@ bool fromString<treeface::LineCap>( const String& str, treeface::LineCap& result
 template<>
 bool fromString<treeface::LineJoin>( const String& str, treeface::LineJoin& result );
 
+template<>
+bool fromString<treeface::DepthSortPolicy>( const String& str, treeface::DepthSortPolicy& result );
+
 template<>
 bool fromString<FREE_IMAGE_FORMAT>( const treecore::String& string, FREE_IMAGE_FORMAT& result );
 
@@ -76,6 +79,9 @@ treecore::String toString<treeface::LineCap>( treeface::LineCap cap );
 template<>
 treecore::String toString<treeface::LineJoin>( treeface::LineJoin join );
 
+template<>
+treecore::String toString<treeface::DepthSortPolicy>( treeface::DepthSortPolicy policy );
+
 template<>
 treecore::String toString<FREE_IMAGE_FORMAT>( FREE_IMAGE_FORMAT arg );
 
@@ -0,0 +1,56 @@
+#ifndef TREEFACE_UNIFORM_BLOCK_INFO_H
+#define TREEFACE_UNIFORM_BLOCK_INFO_H
+
+#include "treeface/misc/TypedTemplate.h"
+
+#include <treecore/Array.h>
+
+namespace treeface
+{
+
+///
+/// \brief a uniform inside of a uniform block, with its layout in block
+///        storage
+///
+struct UniformBlockMember: public TypedTemplate
+{
+    UniformBlockMember( const treecore::Identifier& name, treecore::int32 n_elem, GLType type,
+                        GLint offset, GLint array_stride, GLint matrix_stride )
+        : TypedTemplate( name, n_elem, type )
+        , offset( offset )
+        , array_stride( array_stride )
+        , matrix_stride( matrix_stride )
+    {}
+
+    GLint offset;        ///< byte offset from block start
+    GLint array_stride;  ///< byte distance between array elements, 0 for non-array
+    GLint matrix_stride; ///< byte distance between matrix columns, 0 for non-matrix
+};
+
+struct UniformBlockInfo
+{
+    UniformBlockInfo( const treecore::Identifier& name, GLuint index, GLint data_size )
+        : name( name )
+        , index( index )
+        , data_size( data_size )
+    {}
+
+    int get_member_index( const treecore::Identifier& member_name ) const noexcept
+    {
+        for (int i = 0; i < members.size(); i++)
+        {
+            if (members[i].name == member_name)
+                return i;
+        }
+        return -1;
+    }
+
+    treecore::Identifier              name;
+    GLuint                            index;     ///< block index used by OpenGL
+    GLint                             data_size; ///< minimum buffer size for this block
+    treecore::Array<UniformBlockMember> members;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_UNIFORM_BLOCK_INFO_H
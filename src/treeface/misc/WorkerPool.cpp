@@ -0,0 +1,138 @@
+#include "treeface/misc/WorkerPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace treecore;
+
+namespace treeface
+{
+
+struct WorkerPool::Guts
+{
+    std::vector<std::thread> threads;
+
+    std::mutex              mutex;
+    std::condition_variable cond_start;
+    std::condition_variable cond_finish;
+
+    // current batch, written with mutex locked before workers are woken up
+    const std::function<void(int)>* task = nullptr;
+    int              num_tasks    = 0;
+    std::atomic<int> next_task{ 0 };
+    uint64           batch_serial = 0;
+    size_t           num_finished = 0;
+    bool             quit         = false;
+
+    void take_tasks( const std::function<void(int)>* batch_task, int batch_num_tasks )
+    {
+        for (;;)
+        {
+            int i_task = next_task.fetch_add( 1 );
+            if (i_task >= batch_num_tasks)
+                break;
+            (*batch_task)( i_task );
+        }
+    }
+
+    void worker_main()
+    {
+        uint64 last_serial = 0;
+
+        for (;;)
+        {
+            const std::function<void(int)>* batch_task = nullptr;
+            int batch_num_tasks = 0;
+
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                cond_start.wait( lock, [&] { return quit || batch_serial != last_serial; } );
+                if (quit)
+                    return;
+
+                last_serial     = batch_serial;
+                batch_task      = task;
+                batch_num_tasks = num_tasks;
+            }
+
+            take_tasks( batch_task, batch_num_tasks );
+
+            // every worker reports each batch, so that no worker is still
+            // looking at a batch when the next one starts
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                num_finished++;
+                if ( num_finished == threads.size() )
+                    cond_finish.notify_one();
+            }
+        }
+    }
+};
+
+WorkerPool::WorkerPool( int num_threads ): m_guts( new Guts() )
+{
+    if (num_threads <= 0)
+        num_threads = int( std::thread::hardware_concurrency() );
+    if (num_threads <= 0)
+        num_threads = 1;
+
+    // the calling thread is also a worker
+    for (int i = 1; i < num_threads; i++)
+        m_guts->threads.emplace_back( &Guts::worker_main, m_guts );
+}
+
+WorkerPool::~WorkerPool()
+{
+    if (m_guts)
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_guts->mutex );
+            m_guts->quit = true;
+        }
+        m_guts->cond_start.notify_all();
+
+        for (std::thread& thread : m_guts->threads)
+            thread.join();
+
+        delete m_guts;
+    }
+}
+
+int WorkerPool::get_num_threads() const noexcept
+{
+    return int( m_guts->threads.size() ) + 1;
+}
+
+void WorkerPool::run( int num_tasks, const std::function<void(int)>& task )
+{
+    if (num_tasks <= 0)
+        return;
+
+    if ( m_guts->threads.size() == 0 )
+    {
+        for (int i = 0; i < num_tasks; i++)
+            task( i );
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_guts->mutex );
+        m_guts->task         = &task;
+        m_guts->num_tasks    = num_tasks;
+        m_guts->next_task    = 0;
+        m_guts->num_finished = 0;
+        m_guts->batch_serial++;
+    }
+    m_guts->cond_start.notify_all();
+
+    m_guts->take_tasks( &task, num_tasks );
+
+    std::unique_lock<std::mutex> lock( m_guts->mutex );
+    m_guts->cond_finish.wait( lock, [&] { return m_guts->num_finished == m_guts->threads.size(); } );
+    m_guts->task = nullptr;
+}
+
+} // namespace treeface
@@ -0,0 +1,102 @@
+#ifndef TREEFACE_WORKER_POOL_H
+#define TREEFACE_WORKER_POOL_H
+
+#include "treeface/base/Common.h"
+
+#include <treecore/ClassUtils.h>
+
+#include <functional>
+
+namespace treeface
+{
+
+///
+/// \brief fixed set of threads that run fork-join batches of tasks
+///
+/// A batch is a number of tasks identified by index. The calling thread also
+/// takes tasks, and run() returns after all tasks of the batch are finished.
+/// Tasks are taken in ascending index order, one at a time, so that uneven
+/// tasks are balanced among threads.
+///
+/// Only one batch can run at a time, and run() must not be called from inside
+/// a task.
+///
+class WorkerPool
+{
+public:
+    ///
+    /// \param num_threads  number of threads that run tasks including the
+    ///                     calling thread, zero for number of CPU cores
+    ///
+    WorkerPool( int num_threads = 0 );
+
+    TREECORE_DECLARE_NON_COPYABLE( WorkerPool );
+    TREECORE_DECLARE_NON_MOVABLE( WorkerPool );
+
+    ~WorkerPool();
+
+    ///
+    /// \brief number of threads that run tasks, including the calling thread
+    ///
+    int get_num_threads() const noexcept;
+
+    ///
+    /// \brief run tasks and wait until they are all finished
+    ///
+    /// \param num_tasks  number of tasks
+    /// \param task       called with task index in range [0, num_tasks)
+    ///
+    void run( int num_tasks, const std::function<void(int)>& task );
+
+private:
+    struct Guts;
+    Guts* m_guts = nullptr;
+};
+
+///
+/// \brief run tasks with worker pool, or run them one by one in calling
+///        thread if pool is not provided
+///
+template<typename F>
+void parallel_for( WorkerPool* pool, int num_tasks, const F& task )
+{
+    if (pool == nullptr || num_tasks < 2)
+    {
+        for (int i = 0; i < num_tasks; i++)
+            task( i );
+    }
+    else
+    {
+        pool->run( num_tasks, task );
+    }
+}
+
+///
+/// \brief split range [0, num) into chunks and process chunks in parallel
+///
+/// \param min_chunk  chunks are not smaller than this, to keep scheduling
+///                   cost low compared to work
+/// \param func       called with [i_begin, i_end) of each chunk
+///
+template<typename F>
+void parallel_for_range( WorkerPool* pool, int num, int min_chunk, const F& func )
+{
+    int num_threads = pool ? pool->get_num_threads() : 1;
+
+    // a few chunks per thread for balancing
+    int chunk = (num + num_threads * 4 - 1) / (num_threads * 4);
+    if (chunk < min_chunk) chunk = min_chunk;
+    if (chunk < 1) chunk = 1;
+
+    int num_chunk = (num + chunk - 1) / chunk;
+
+    parallel_for( pool, num_chunk, [&]( int i_chunk ) {
+        int i_begin = i_chunk * chunk;
+        int i_end   = i_begin + chunk < num ? i_begin + chunk : num;
+        func( i_begin, i_end );
+    } );
+}
+
+} // namespace treeface
+
+#endif // TREEFACE_WORKER_POOL_H
@@ -0,0 +1,455 @@
+#include "treeface/scene/GLRenderBackend.h"
+
+#include "treeface/gl/GLBuffer.h"
+#include "treeface/gl/Program.h"
+#include "treeface/gl/VertexArray.h"
+
+#include "treeface/scene/Geometry.h"
+#include "treeface/scene/RenderCommand.h"
+#include "treeface/scene/SceneGraphMaterial.h"
+#include "treeface/scene/VisualObject.h"
+
+#include "treeface/scene/guts/Geometry_guts.h"
+#include "treeface/scene/guts/VisualObject_guts.h"
+#include "treeface/scene/guts/Utils.h"
+
+#include <treecore/HashMap.h>
+#include <treecore/RefCountHolder.h>
+#include <treecore/RefCountObject.h>
+
+#include <cstring>
+
+// std140 size of scene uniform blocks declared by SceneGraphMaterial
+#define FRAME_BLOCK_SIZE  (sizeof(Mat4f) * 2 + sizeof(Vec4f) * 3)
+#define OBJECT_BLOCK_SIZE (sizeof(Mat4f) * 3)
+
+// instance batches not used for this number of frames are released
+#define BATCH_EXPIRE_FRAMES 120
+
+using namespace treecore;
+
+namespace treeface {
+
+static_assert( sizeof(ItemMatrices) == OBJECT_BLOCK_SIZE, "item matrices should be copied as object uniform block" );
+
+struct InstanceBatchKey
+{
+    Geometry*           geom;
+    SceneGraphMaterial* mat;
+};
+
+bool operator ==( const InstanceBatchKey& a, const InstanceBatchKey& b )
+{
+    return a.geom == b.geom && a.mat == b.mat;
+}
+
+struct InstanceBatchKeyHasher
+{
+    int generateHash( const InstanceBatchKey& key, int limit ) const noexcept
+    {
+        pointer_sized_uint result = (pointer_sized_uint( key.geom ) >> 4) * 31 +
+                                    (pointer_sized_uint( key.mat ) >> 4);
+        return int( result % pointer_sized_uint( limit ) );
+    }
+};
+
+///
+/// \brief GL objects for drawing one geometry with instancing program of one
+///        material
+///
+/// Geometry and material are held, so that their addresses won't be reused
+/// while the batch is cached.
+///
+struct InstanceBatch: public RefCountObject
+{
+    RefCountHolder<Geometry>           geometry;
+    RefCountHolder<SceneGraphMaterial> material;
+    RefCountHolder<GLBuffer>           instance_buffer;
+    RefCountHolder<VertexArray>        vertex_array;
+
+    Array<float> uploaded; ///< instance data in buffer
+    int64 last_used = 0;
+
+    ///
+    /// \brief uniform location in instancing program, resolved on first use
+    ///
+    /// Resolved locations are dropped when the program is not the one they
+    /// were resolved from.
+    ///
+    GLint get_uniform_location( Program* prog, const Identifier& name )
+    {
+        if (prog != located_program)
+        {
+            uniform_locations.clear();
+            located_program = prog;
+        }
+
+        HashMap<Identifier, GLint>::Iterator it( uniform_locations );
+        if ( uniform_locations.select( name, it ) )
+            return it.value();
+
+        GLint location = prog->get_uniform_location( name );
+        uniform_locations.set( name, location );
+        return location;
+    }
+
+    Program* located_program = nullptr;
+    HashMap<Identifier, GLint> uniform_locations;
+};
+
+typedef HashMap<InstanceBatchKey, RefCountHolder<InstanceBatch>, InstanceBatchKeyHasher> InstanceBatchMap;
+
+///
+/// \brief find range of blocks that differ between two data of same size
+/// \return false if there's no difference
+///
+static bool _find_changed_blocks_( const uint8* prev, const uint8* curr, int num_block, size_t stride,
+                                   int& i_first, int& i_last )
+{
+    i_first = 0;
+    while ( i_first < num_block && memcmp( prev + stride * i_first, curr + stride * i_first, stride ) == 0 )
+        i_first++;
+
+    if (i_first == num_block)
+        return false;
+
+    i_last = num_block - 1;
+    while ( i_last > i_first && memcmp( prev + stride * i_last, curr + stride * i_last, stride ) == 0 )
+        i_last--;
+
+    return true;
+}
+
+struct GLRenderBackend::Impl
+{
+    ///
+    /// \brief get GL objects for instanced drawing, create them on first use
+    ///
+    InstanceBatch* get_instance_batch( Geometry* geom, SceneGraphMaterial* mat );
+
+    ///
+    /// \brief release instance batches that are not used recently
+    ///
+    void expire_instance_batches();
+
+    ///
+    /// \brief create uniform block buffers on first use
+    ///
+    void init_uniform_blocks();
+
+    ///
+    /// \brief upload frame uniform block and bind it for the whole frame
+    ///
+    void upload_frame_block( const RenderCommandList& commands );
+
+    ///
+    /// \brief upload per-object blocks of all items that are not instanced
+    ///
+    /// Blocks are written to one buffer in frame order, and are picked by
+    /// binding buffer range at draw time. If number of blocks is unchanged,
+    /// only the range that differs from previous frame is uploaded.
+    ///
+    void upload_object_blocks( const RenderCommandList& commands );
+
+    void draw_instanced( const RenderCommandList& commands, const RenderCommand& cmd, Program* prog );
+
+    InstanceBatchMap instance_batches;
+    Array<float>     instance_data;
+    int64 num_frames = 0;
+
+    // scene uniform blocks
+    RefCountHolder<GLBuffer> frame_block;
+    RefCountHolder<GLBuffer> object_block;
+    uint8        frame_block_data[FRAME_BLOCK_SIZE];
+    bool         frame_block_valid = false;
+    Array<uint8> block_data;
+    Array<uint8> prev_block_data;
+    GLsizeiptr   object_block_stride = 0;
+};
+
+InstanceBatch* GLRenderBackend::Impl::get_instance_batch( Geometry* geom, SceneGraphMaterial* mat )
+{
+    InstanceBatchKey key{ geom, mat };
+
+    InstanceBatchMap::Iterator it( instance_batches );
+    if ( instance_batches.select( key, it ) )
+        return it.value().get();
+
+    Program* prog = mat->get_instanced_program();
+    treecore_assert( prog != nullptr );
+
+    InstanceBatch* batch = new InstanceBatch();
+    batch->geometry        = geom;
+    batch->material        = mat;
+    batch->instance_buffer = new GLBuffer( TFGL_BUFFER_VERTEX, TFGL_BUFFER_STREAM_DRAW );
+    batch->vertex_array    = new VertexArray( geom->get_vertex_buffer(), geom->get_index_buffer(), geom->get_vertex_template(), prog );
+    batch->vertex_array->add_instance_attributes( batch->instance_buffer, SceneGraphMaterial::VERTEX_TEMPLATE_INSTANCE(), prog );
+
+    instance_batches.set( key, batch );
+    return batch;
+}
+
+void GLRenderBackend::Impl::expire_instance_batches()
+{
+    Array<InstanceBatchKey> expired;
+    for (InstanceBatchMap::Iterator it( instance_batches ); it.next(); )
+    {
+        if (it.value()->last_used + BATCH_EXPIRE_FRAMES < num_frames)
+            expired.add( it.key() );
+    }
+
+    for (const InstanceBatchKey& key : expired)
+        instance_batches.remove( key );
+}
+
+void GLRenderBackend::Impl::init_uniform_blocks()
+{
+    if (frame_block.get() != nullptr)
+        return;
+
+    frame_block  = new GLBuffer( TFGL_BUFFER_UNIFORM, TFGL_BUFFER_STREAM_DRAW );
+    object_block = new GLBuffer( TFGL_BUFFER_UNIFORM, TFGL_BUFFER_STREAM_DRAW );
+
+    // per-object blocks are bound by range, whose offset must be aligned
+    GLint align = 0;
+    glGetIntegerv( GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align );
+    if (align <= 0) align = 256;
+    object_block_stride = (GLsizeiptr( OBJECT_BLOCK_SIZE ) + align - 1) / align * align;
+}
+
+void GLRenderBackend::Impl::upload_frame_block( const RenderCommandList& commands )
+{
+    init_uniform_blocks();
+
+    uint8 data[FRAME_BLOCK_SIZE];
+    uint8* dst_light = data + sizeof(Mat4f) * 2;
+    memcpy( data,                          &commands.matrix_proj,   sizeof(Mat4f) );
+    memcpy( data + sizeof(Mat4f),          &commands.matrix_view,   sizeof(Mat4f) );
+    memcpy( dst_light,                     &commands.light_direct,  sizeof(Vec4f) );
+    memcpy( dst_light + sizeof(Vec4f),     &commands.light_color,   sizeof(Vec4f) );
+    memcpy( dst_light + sizeof(Vec4f) * 2, &commands.light_ambient, sizeof(Vec4f) );
+
+    if ( !frame_block_valid || memcmp( data, frame_block_data, FRAME_BLOCK_SIZE ) != 0 )
+    {
+        frame_block->bind();
+        frame_block->upload_data( data, GLsizei( FRAME_BLOCK_SIZE ) );
+        frame_block->unbind();
+
+        memcpy( frame_block_data, data, FRAME_BLOCK_SIZE );
+        frame_block_valid = true;
+    }
+
+    frame_block->bind_base( TREEFACE_UNIFORM_BINDING_SCENE_FRAME );
+}
+
+void GLRenderBackend::Impl::upload_object_blocks( const RenderCommandList& commands )
+{
+    init_uniform_blocks();
+
+    const int num_block = commands.object_blocks.size();
+    if (num_block == 0)
+        return;
+
+    block_data.resize( int( object_block_stride * num_block ) );
+    for (int i_block = 0; i_block < num_block; i_block++)
+    {
+        uint8* dst = &block_data[int( object_block_stride * i_block )];
+        memcpy( dst, &commands.matrices[commands.object_blocks[i_block]], OBJECT_BLOCK_SIZE );
+    }
+
+    object_block->bind();
+
+    if ( prev_block_data.size() == block_data.size() )
+    {
+        int i_first = 0;
+        int i_last  = 0;
+        if ( _find_changed_blocks_( &prev_block_data[0], &block_data[0], num_block, size_t( object_block_stride ), i_first, i_last ) )
+        {
+            GLintptr offset = object_block_stride * i_first;
+            object_block->upload_sub_data( offset, &block_data[int( offset )], object_block_stride * (i_last - i_first + 1) );
+        }
+    }
+    else
+    {
+        object_block->upload_data( &block_data[0], GLsizei( block_data.size() ) );
+    }
+
+    object_block->unbind();
+
+    block_data.swapWith( prev_block_data );
+}
+
+void GLRenderBackend::Impl::draw_instanced( const RenderCommandList& commands, const RenderCommand& cmd, Program* prog )
+{
+    VisualObject* run_head = cmd.vis_obj;
+    Geometry*     geom     = run_head->get_geometry();
+
+    // fill per-instance matrices
+    const int num_float_per_instance = sizeof(Mat4f) * 2 / sizeof(float);
+    instance_data.resize( cmd.arg1 * num_float_per_instance );
+
+    for (int i_inst = 0; i_inst < cmd.arg1; i_inst++)
+    {
+        const ItemMatrices& matrices = commands.matrices[cmd.arg0 + i_inst];
+
+        float* dst = &instance_data[i_inst * num_float_per_instance];
+        memcpy( dst,                              &matrices.model_view, sizeof(Mat4f) );
+        memcpy( dst + num_float_per_instance / 2, &matrices.normal,     sizeof(Mat4f) );
+    }
+
+    InstanceBatch* batch = get_instance_batch( geom, cmd.material );
+    batch->last_used = num_frames;
+
+    // instance data is often same as previous frame
+    if ( batch->uploaded.size() != instance_data.size() ||
+         memcmp( &batch->uploaded[0], &instance_data[0], sizeof(float) * size_t( instance_data.size() ) ) != 0 )
+    {
+        batch->instance_buffer->bind();
+        batch->instance_buffer->upload_data( &instance_data[0], GLsizei( instance_data.size() * sizeof(float) ) );
+        batch->instance_buffer->unbind();
+        batch->uploaded = instance_data;
+    }
+
+    batch->vertex_array->bind();
+
+    // geometry and visual object uniforms, whose locations are queried from
+    // instancing program, visual object ones win like collect_uniforms()
+    const UniformMap& obj_uniforms  = run_head->m_impl->uniforms;
+    const UniformMap& geom_uniforms = geom->m_impl->uniforms;
+
+    for (UniformMap::ConstIterator it( obj_uniforms ); it.next(); )
+        prog->set_uniform( batch->get_uniform_location( prog, it.key() ), it.value() );
+
+    for (UniformMap::ConstIterator it( geom_uniforms ); it.next(); )
+    {
+        if ( !obj_uniforms.contains( it.key() ) )
+            prog->set_uniform( batch->get_uniform_location( prog, it.key() ), it.value() );
+    }
+
+    treecore_assert( !geom->is_dirty() );
+    batch->vertex_array->draw_instanced( geom->get_primitive(), geom->get_num_index(), cmd.arg1, geom->get_index_type() );
+}
+
+GLRenderBackend::GLRenderBackend()
+    : m_impl( new Impl() )
+{}
+
+GLRenderBackend::~GLRenderBackend()
+{
+    if (m_impl)
+        delete m_impl;
+}
+
+void GLRenderBackend::upload_geometry( Geometry* geom )
+{
+    geom->get_vertex_buffer()->bind();
+    geom->get_index_buffer()->bind();
+    geom->upload_data();
+    geom->get_vertex_buffer()->unbind();
+    geom->get_index_buffer()->unbind();
+}
+
+void GLRenderBackend::execute( const RenderCommandList& commands )
+{
+    m_impl->num_frames++;
+
+    SceneGraphMaterial* mat  = nullptr;
+    Program*            prog = nullptr;
+
+    for (const RenderCommand& cmd : commands.commands)
+    {
+        switch (cmd.type)
+        {
+        case RENDER_COMMAND_FRAME_BLOCK:
+            m_impl->upload_frame_block( commands );
+            break;
+
+        case RENDER_COMMAND_OBJECT_BLOCKS:
+            m_impl->upload_object_blocks( commands );
+            break;
+
+        case RENDER_COMMAND_BIND_MATERIAL:
+            mat = cmd.material;
+            if (cmd.arg0)
+            {
+                prog = mat->get_instanced_program();
+                mat->bind_instanced();
+
+                // frame uniforms are already in uniform block
+                if ( !mat->uses_uniform_block() )
+                {
+                    prog->set_uniform( mat->m_inst_uni_proj,          commands.matrix_proj );
+                    prog->set_uniform( mat->m_inst_uni_light_direct,  commands.light_direct );
+                    prog->set_uniform( mat->m_inst_uni_light_color,   commands.light_color );
+                    prog->set_uniform( mat->m_inst_uni_light_ambient, commands.light_ambient );
+                }
+            }
+            else
+            {
+                prog = mat->get_program();
+                mat->bind();
+
+                if ( !mat->uses_uniform_block() )
+                {
+                    prog->set_uniform( mat->m_uni_proj,          commands.matrix_proj );
+                    prog->set_uniform( mat->m_uni_light_direct,  commands.light_direct );
+                    prog->set_uniform( mat->m_uni_light_color,   commands.light_color );
+                    prog->set_uniform( mat->m_uni_light_ambient, commands.light_ambient );
+                }
+            }
+            break;
+
+        case RENDER_COMMAND_BIND_OBJECT:
+        {
+            VisualObject::Impl* obj_impl = cmd.vis_obj->m_impl;
+            cmd.vis_obj->get_vertex_array()->bind();
+
+            // update geometry and visual obj's uniforms to current program
+            if (obj_impl->uniform_cache_dirty)
+                obj_impl->update_uniform_cache();
+
+            for (int i_uni = 0; i_uni < obj_impl->cached_uniforms.size(); i_uni++)
+            {
+                const UniformKV& kv = obj_impl->cached_uniforms[i_uni];
+                prog->set_uniform( kv.first, kv.second );
+            }
+            break;
+        }
+
+        case RENDER_COMMAND_OBJECT_BLOCK:
+            m_impl->object_block->bind_range( TREEFACE_UNIFORM_BINDING_SCENE_OBJECT,
+                                              m_impl->object_block_stride * cmd.arg0,
+                                              OBJECT_BLOCK_SIZE );
+            break;
+
+        case RENDER_COMMAND_OBJECT_MATRICES:
+        {
+            const ItemMatrices& matrices = commands.matrices[cmd.arg0];
+            prog->set_uniform( mat->m_uni_model_view,      matrices.model_view );
+            prog->set_uniform( mat->m_uni_model_view_proj, matrices.model_view_proj );
+            prog->set_uniform( mat->m_uni_norm,            matrices.normal );
+            break;
+        }
+
+        case RENDER_COMMAND_DRAW:
+            cmd.vis_obj->render();
+            break;
+
+        case RENDER_COMMAND_DRAW_INSTANCED:
+            m_impl->draw_instanced( commands, cmd, prog );
+            break;
+
+        case RENDER_COMMAND_FINISH:
+            VertexArray::unbind();
+            if (mat)
+                mat->unbind();
+            mat  = nullptr;
+            prog = nullptr;
+            break;
+        }
+    }
+
+    m_impl->expire_instance_batches();
+}
+
+} // namespace treeface
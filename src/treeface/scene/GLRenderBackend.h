@@ -0,0 +1,32 @@
+#ifndef TREEFACE_GL_RENDER_BACKEND_H
+#define TREEFACE_GL_RENDER_BACKEND_H
+
+#include "treeface/scene/RenderBackend.h"
+
+namespace treeface {
+
+/**
+ * @brief backend that draws with GL, used by SceneRenderer by default
+ *
+ * Data uploaded in previous frame is kept. Uniform blocks and instance data
+ * are compared with it, and only changed ranges are uploaded again, so that
+ * nearly identical frames cost few buffer uploads.
+ */
+class GLRenderBackend: public RenderBackend
+{
+public:
+    GLRenderBackend();
+    virtual ~GLRenderBackend();
+
+    void upload_geometry( Geometry* geom ) override;
+
+    void execute( const RenderCommandList& commands ) override;
+
+protected:
+    struct Impl;
+    Impl* m_impl = nullptr;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_GL_RENDER_BACKEND_H
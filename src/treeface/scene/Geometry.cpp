@@ -7,6 +7,8 @@
 #include "treeface/misc/PropertyValidator.h"
 #include "treeface/misc/StringCast.h"
 
+#include "treeface/scene/SceneNode.h"
+
 #include "treeface/scene/guts/Geometry_guts.h"
 
 #include <treecore/Array.h>
@@ -20,12 +22,14 @@
 #include <treecore/ScopedLock.h>
 #include <treecore/Variant.h>
 
+#include <algorithm>
+
 using namespace treecore;
 
 namespace treeface {
 
-Geometry::Geometry( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic )
-    : m_impl( new Guts( vtx_temp, primitive, is_dynamic ) )
+Geometry::Geometry( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic, GLType index_type )
+    : m_impl( new Guts( vtx_temp, primitive, is_dynamic, index_type ) )
 {}
 
 Geometry::~Geometry()
@@ -80,7 +84,13 @@ Geometry::Geometry( const treecore::var& geom_root_node )
             throw ConfigParseError( "failed to parse OpenGL primitive enum from: " + geom_root_kv[KEY_PRIM].toString() );
 
         // load vertex attribute template
-        m_impl = new Guts( VertexTemplate( geom_root_kv[KEY_ATTR] ), primitive, false );
+        // use 32-bit index only if vertices are too many for 16-bit
+        int    num_vtx    = geom_root_node[KEY_VTX].getArray()->size();
+        GLType index_type = num_vtx - 1 > std::numeric_limits<IndexType>::max()
+                            ? TFGL_TYPE_UNSIGNED_INT
+                            : TFGL_TYPE_UNSIGNED_SHORT;
+
+        m_impl = new Guts( VertexTemplate( geom_root_kv[KEY_ATTR] ), primitive, false, index_type );
     }
 
     //
@@ -129,9 +139,13 @@ Geometry::Geometry( const treecore::var& geom_root_node )
     for (int i_idx = 0; i_idx < idx_nodes->size(); i_idx++)
     {
         int idx = int( (*idx_nodes)[i_idx] );
-        if ( idx >= vtx_nodes->size() )
+        if ( idx < 0 || idx >= vtx_nodes->size() )
             throw ConfigParseError( "vertex amount is " + String( vtx_nodes->size() ) + ", but got index " + String( idx ) );
-        m_impl->host_data_idx.add( idx );
+
+        if (m_impl->index_type == TFGL_TYPE_UNSIGNED_INT)
+            m_impl->host_data_idx_32.add( uint32( idx ) );
+        else
+            m_impl->host_data_idx.add( IndexType( idx ) );
     }
 
     // mark data change
@@ -140,12 +154,82 @@ Geometry::Geometry( const treecore::var& geom_root_node )
 
 bool Geometry::is_dirty() const noexcept { return m_impl->dirty; }
 
-void Geometry::mark_dirty() noexcept { m_impl->dirty = true; }
+void Geometry::mark_dirty() noexcept
+{
+    m_impl->dirty = true;
+    m_impl->dirty_vtx_begin = 0;
+    m_impl->dirty_idx_begin = 0;
+}
+
+bool Geometry::get_dirty_range( DirtyRange& result ) const noexcept
+{
+    if (!m_impl->dirty)
+        return false;
+
+    const HostVertexCache& vertices = m_impl->host_data_vtx;
+    result.vertex_byte_begin = std::min( m_impl->dirty_vtx_begin, vertices.size() ) * vertices.block_size();
+    result.vertex_byte_end   = vertices.num_byte();
+
+    int32 num_idx   = 0;
+    int32 idx_bytes = 0;
+    if (m_impl->index_type == TFGL_TYPE_UNSIGNED_INT)
+    {
+        num_idx   = m_impl->host_data_idx_32.size();
+        idx_bytes = int32( sizeof(uint32) );
+    }
+    else
+    {
+        num_idx   = m_impl->host_data_idx.size();
+        idx_bytes = int32( sizeof(IndexType) );
+    }
+    result.index_byte_begin = std::min( m_impl->dirty_idx_begin, num_idx ) * idx_bytes;
+    result.index_byte_end   = num_idx * idx_bytes;
+
+    return true;
+}
 
 GLPrimitive Geometry::get_primitive() const noexcept { return m_impl->primitive; }
 
 int32 Geometry::get_num_index() const noexcept { return m_impl->num_idx; }
 
+GLType Geometry::get_index_type() const noexcept { return m_impl->index_type; }
+
+void Geometry::set_index_type( GLType index_type )
+{
+    treecore_assert( index_type == TFGL_TYPE_UNSIGNED_SHORT || index_type == TFGL_TYPE_UNSIGNED_INT );
+
+    if (index_type == m_impl->index_type)
+        return;
+
+    if (index_type == TFGL_TYPE_UNSIGNED_INT)
+    {
+        m_impl->host_data_idx_32.resize( m_impl->host_data_idx.size() );
+        for (int i = 0; i < m_impl->host_data_idx.size(); i++)
+            m_impl->host_data_idx_32[i] = m_impl->host_data_idx[i];
+        m_impl->host_data_idx.clear();
+    }
+    else
+    {
+        m_impl->host_data_idx.resize( m_impl->host_data_idx_32.size() );
+        for (int i = 0; i < m_impl->host_data_idx_32.size(); i++)
+        {
+            treecore_assert( m_impl->host_data_idx_32[i] <= std::numeric_limits<IndexType>::max() );
+            m_impl->host_data_idx[i] = IndexType( m_impl->host_data_idx_32[i] );
+        }
+        m_impl->host_data_idx_32.clear();
+    }
+
+    m_impl->index_type      = index_type;
+    m_impl->dirty           = true;
+    m_impl->dirty_idx_begin = 0;
+}
+
+void Geometry::fit_index_type( int32 num_vertex )
+{
+    if (m_impl->index_type == TFGL_TYPE_UNSIGNED_SHORT && num_vertex - 1 > std::numeric_limits<IndexType>::max())
+        set_index_type( TFGL_TYPE_UNSIGNED_INT );
+}
+
 const VertexTemplate& Geometry::get_vertex_template() const noexcept
 {
     return m_impl->vtx_temp;
@@ -214,10 +298,19 @@ void Geometry::add_vertex_by_ptr( const void* vtx_data )
     m_impl->host_data_vtx.add( vtx_data );
 }
 
-void Geometry::add_index( IndexType idx )
+void Geometry::add_index( uint32 idx )
 {
     m_impl->dirty = true;
 
+    if (m_impl->index_type == TFGL_TYPE_UNSIGNED_INT)
+    {
+        m_impl->host_data_idx_32.add( idx );
+    }
+    else
+    {
+        treecore_assert( idx <= std::numeric_limits<IndexType>::max() );
+        m_impl->host_data_idx.add( IndexType( idx ) );
+    }
 }
 
 Geometry::HostVertexCache& Geometry::get_host_vertex_cache() noexcept
@@ -229,13 +322,31 @@ Geometry::HostVertexCache& Geometry::get_host_vertex_cache() noexcept
 treecore::Array<IndexType>& Geometry::get_host_index_cache() noexcept
 {
     treecore_assert( m_impl->drawing );
+    treecore_assert( m_impl->index_type == TFGL_TYPE_UNSIGNED_SHORT );
     return m_impl->host_data_idx;
 }
 
+treecore::Array<uint32>& Geometry::get_host_index_cache_32() noexcept
+{
+    treecore_assert( m_impl->drawing );
+    treecore_assert( m_impl->index_type == TFGL_TYPE_UNSIGNED_INT );
+    return m_impl->host_data_idx_32;
+}
+
 void Geometry::host_draw_end()
 {
+    m_impl->drawing = false;
+    mark_dirty();
+}
+
+void Geometry::host_draw_end_tail( int32 vtx_begin, int32 idx_begin )
+{
+    treecore_assert( vtx_begin >= 0 && idx_begin >= 0 );
+
     m_impl->drawing = false;
     m_impl->dirty   = true;
+    m_impl->dirty_vtx_begin = std::min( m_impl->dirty_vtx_begin, vtx_begin );
+    m_impl->dirty_idx_begin = std::min( m_impl->dirty_idx_begin, idx_begin );
 }
 
 void Geometry::host_draw_end_no_change()
@@ -244,6 +355,26 @@ void Geometry::host_draw_end_no_change()
     m_impl->dirty   = false;
 }
 
-void Geometry::upload_data() { m_impl->upload_data(); }
+void Geometry::upload_data()
+{
+    m_impl->upload_data();
+
+    if (m_impl->bound_changed)
+    {
+        m_impl->bound_changed = false;
+
+        for (VisualObject::Impl* user = m_impl->user_head; user != nullptr; user = user->same_geom_next)
+        {
+            if ( SceneNode* node = user->host->get_node() )
+                node->invalidate_bounding_box();
+        }
+    }
+}
+
+bool Geometry::get_bounding_box( BBox3f& result ) const noexcept
+{
+    result = m_impl->bound;
+    return m_impl->bound_known;
+}
 
 } // namespace treeface
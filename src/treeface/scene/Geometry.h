@@ -10,6 +10,7 @@
 
 #include "treeface/base/Enums.h"
 #include "treeface/gl/Enums.h"
+#include "treeface/math/BBox3.h"
 #include "treeface/misc/SteakingArray.h"
 
 namespace treecore {
@@ -33,10 +34,24 @@ class Geometry: public treecore::RefCountObject
     friend class ::TestFramework;
     friend class VisualObject;
     friend class SceneRenderer;
+    friend class GLRenderBackend;
 
 public:
     typedef SteakingArray<16> HostVertexCache;
 
+    ///
+    /// \brief part of host-side data that is modified since last upload
+    ///
+    /// Ranges are in bytes, and always extend to the end of host data.
+    ///
+    struct DirtyRange
+    {
+        treecore::int32 vertex_byte_begin;
+        treecore::int32 vertex_byte_end;
+        treecore::int32 index_byte_begin;
+        treecore::int32 index_byte_end;
+    };
+
     class HostDrawScope
     {
     public:
@@ -54,12 +69,18 @@ public:
     /// \param primitive   type of geometric primitive.
     /// \param is_dynamic  if set to true, the host-side cache will be kept
     ///                    after data upload; otherwise it will be cleared.
+    /// \param index_type  type of vertex index, either
+    ///                    TFGL_TYPE_UNSIGNED_SHORT or TFGL_TYPE_UNSIGNED_INT.
     ///
-    Geometry( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic = false );
+    Geometry( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic = false,
+              GLType index_type = TFGL_TYPE_UNSIGNED_SHORT );
 
     ///
     /// \brief create geometry from config data
     ///
+    /// 32-bit index is used if there are more vertices than 16-bit index can
+    /// address.
+    ///
     /// \param geom_root_node  root node of config data
     ///
     Geometry( const treecore::var& geom_root_node );
@@ -72,9 +93,39 @@ public:
     bool is_dirty() const noexcept;
     void mark_dirty() noexcept;
 
+    ///
+    /// \brief get range of host-side data that will be uploaded
+    ///
+    /// \return false if data is not dirty
+    ///
+    bool get_dirty_range( DirtyRange& result ) const noexcept;
+
     GLPrimitive get_primitive() const noexcept;
     int32       get_num_index() const noexcept;
 
+    ///
+    /// \brief type of vertex index, either TFGL_TYPE_UNSIGNED_SHORT or
+    ///        TFGL_TYPE_UNSIGNED_INT
+    ///
+    GLType get_index_type() const noexcept;
+
+    ///
+    /// \brief change type of vertex index
+    ///
+    /// Indices in host-side cache are converted to new type. When changing
+    /// to 16-bit, all existing indices must be in its range.
+    ///
+    void set_index_type( GLType index_type );
+
+    ///
+    /// \brief switch to 32-bit index if current index type can't address
+    ///        the specified number of vertices
+    ///
+    /// Geometry never switches back to 16-bit index by itself, so small
+    /// geometries keep using compact 16-bit index.
+    ///
+    void fit_index_type( int32 num_vertex );
+
     const VertexTemplate& get_vertex_template() const noexcept;
 
     GLBuffer* get_vertex_buffer() noexcept;
@@ -95,20 +146,61 @@ public:
 
     void add_vertex_by_ptr( const void* vtx_data );
 
-    void add_index( IndexType idx );
+    void add_index( treecore::uint32 idx );
 
     HostVertexCache& get_host_vertex_cache() noexcept;
 
+    ///
+    /// \brief get host-side cache of 16-bit indices
+    ///
+    /// Only valid if index type is TFGL_TYPE_UNSIGNED_SHORT.
+    ///
     treecore::Array<IndexType>& get_host_index_cache() noexcept;
 
+    ///
+    /// \brief get host-side cache of 32-bit indices
+    ///
+    /// Only valid if index type is TFGL_TYPE_UNSIGNED_INT.
+    ///
+    treecore::Array<treecore::uint32>& get_host_index_cache_32() noexcept;
+
     void host_draw_end();
     void host_draw_end_no_change();
 
+    ///
+    /// \brief finish host-side drawing that only modified tail of data
+    ///
+    /// Vertices before vtx_begin and indices before idx_begin must be
+    /// unchanged since last upload. For dynamic geometry, upload_data() then
+    /// only sends the tail by glBufferSubData, and device buffers grow
+    /// geometrically so that appending small pieces is cheap.
+    ///
+    /// Bounding box is only extended by the tail, so it may be larger than
+    /// actual content if some vertices are removed from tail.
+    ///
+    void host_draw_end_tail( treecore::int32 vtx_begin, treecore::int32 idx_begin );
+
     ///
     /// \brief upload data to device side if data is dirty
     ///
+    /// Bounding box is also updated from host data, and scene nodes using
+    /// this geometry are notified if it is changed.
+    ///
     void upload_data();
 
+    ///
+    /// \brief get bounding box in model space
+    ///
+    /// The box is calculated from vertex attribute named "position" on data
+    /// upload. Only float attributes are recognized, and missing Z component
+    /// is treated as zero.
+    ///
+    /// \param result  bounding box is written here
+    /// \return false if bounding box is unknown, either because data is not
+    ///         uploaded yet, or there's no suitable position attribute
+    ///
+    bool get_bounding_box( BBox3f& result ) const noexcept;
+
 protected:
 
     struct Guts;
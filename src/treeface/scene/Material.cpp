@@ -3,6 +3,7 @@
 #include "treeface/graphics/Image.h"
 #include "treeface/graphics/ImageManager.h"
 
+#include "treeface/gl/GLStateCache.h"
 #include "treeface/gl/ImageRef.h"
 #include "treeface/gl/Program.h"
 #include "treeface/Config.h"
@@ -109,40 +110,44 @@ bool Material::remove_texture( const treecore::Identifier& uniform_name )
 }
 
 void Material::bind() noexcept
+{
+    bind_with_program( m_program );
+}
+
+void Material::bind_with_program( Program* program ) noexcept
 {
     // use textures
+    // textures that are already bound on their units are skipped by state
+    // cache
+    GLStateCache& state = GLStateCache::current();
     for (int i_layer = 0; i_layer < m_impl->layers.size(); i_layer++)
     {
         TextureLayer& curr_layer = m_impl->layers[i_layer];
 
-        glActiveTexture( GL_TEXTURE0 + i_layer );
+        state.active_texture( i_layer );
         curr_layer.gl_texture->bind();
     }
 
     // use program
-    glActiveTexture( GL_TEXTURE0 );
-    m_program->bind();
+    state.active_texture( 0 );
+    program->bind();
 
     // set samplers to program
+    // sampler locations are cached for our own program, and are queried for
+    // program variants
     for (int i_layer = 0; i_layer < m_impl->layers.size(); i_layer++)
     {
         TextureLayer& curr_layer = m_impl->layers[i_layer];
-        m_program->set_uniform( curr_layer.program_uniform_loc, i_layer );
+        GLint uni_loc = program == m_program.get() ? curr_layer.program_uniform_loc : program->get_uniform_location( curr_layer.uniform_name );
+        program->set_uniform( uni_loc, i_layer );
     }
 }
 
 void Material::unbind() noexcept
 {
-    for (int i_layer = 0; i_layer < m_impl->layers.size(); i_layer++)
-    {
-        TextureLayer& curr_layer = m_impl->layers[i_layer];
-
-        glActiveTexture( GL_TEXTURE0 + i_layer );
-        glBindSampler( i_layer, 0 );
-        curr_layer.gl_texture->unbind();
-    }
-
-    glActiveTexture( GL_TEXTURE0 );
+    // textures are left on their units, so that next material using the same
+    // textures doesn't bind them again. State cache knows what is bound, and
+    // forgets deleted textures
     m_program->unbind();
 }
 
@@ -48,6 +48,13 @@ public:
     bool            remove_texture( const treecore::Identifier& uniform_sname );
 
     void bind() noexcept;
+
+    ///
+    /// \brief stop using program of this material
+    ///
+    /// Textures are kept bound, so that they are not bound again by the next
+    /// draw that uses them.
+    ///
     void unbind() noexcept;
 
     TREECORE_DECLARE_NON_COPYABLE( Material )
@@ -56,6 +63,12 @@ public:
 protected:
     virtual treecore::String get_shader_source_addition() const noexcept;
 
+    ///
+    /// \brief bind textures of this material with a program other than the
+    ///        material's own, e.g. a variant of the material's program
+    ///
+    void bind_with_program( Program* program ) noexcept;
+
     treecore::RefCountHolder<Program> m_program;
 
 private:
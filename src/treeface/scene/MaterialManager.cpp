@@ -35,11 +35,14 @@ struct ProgramKey
     Identifier   name_vert;
     Identifier   name_frag;
     MaterialType type;
+    bool         instanced;
+    bool         uniform_block;
+    bool         anti_alias;
 };
 
 bool operator ==( const ProgramKey& a, const ProgramKey& b )
 {
-    return a.name_vert == b.name_vert && a.name_frag == b.name_frag && a.type == b.type;
+    return a.name_vert == b.name_vert && a.name_frag == b.name_frag && a.type == b.type && a.instanced == b.instanced && a.uniform_block == b.uniform_block && a.anti_alias == b.anti_alias;
 }
 
 struct ProgramKeyHasher
@@ -48,7 +51,10 @@ struct ProgramKeyHasher
     {
         pointer_sized_uint result = pointer_sized_uint( key.name_vert.getPtr() ) +
                                     pointer_sized_uint( key.name_frag.getPtr() ) +
-                                    pointer_sized_uint( key.type );
+                                    pointer_sized_uint( key.type ) +
+                                    pointer_sized_uint( key.instanced ) +
+                                    pointer_sized_uint( key.uniform_block ) * 2 +
+                                    pointer_sized_uint( key.anti_alias ) * 4;
         return int(result) % limit;
     }
 };
@@ -80,6 +86,9 @@ MaterialManager::~MaterialManager()
 #define KEY_RECV_SHADOW  "receive_shadow"
 #define KEY_TRANSLUSCENT "transluscent"
 #define KEY_TEXTURE      "textures"
+#define KEY_INSTANCING   "instancing"
+#define KEY_UNIFORM_BLOCK "uniform_block"
+#define KEY_ANTI_ALIAS    "anti_alias"
 
 #define KEY_OUTPUT_COLORS  "colors"
 #define KEY_OUTPUT_DEPTH   "depth"
@@ -97,6 +106,9 @@ public:
         add_item( KEY_RECV_SHADOW,  PropertyValidator::ITEM_SCALAR, false );
         add_item( KEY_TRANSLUSCENT, PropertyValidator::ITEM_SCALAR, false );
         add_item( KEY_TEXTURE,      PropertyValidator::ITEM_HASH,   false );
+        add_item( KEY_INSTANCING,   PropertyValidator::ITEM_SCALAR, false );
+        add_item( KEY_UNIFORM_BLOCK, PropertyValidator::ITEM_SCALAR, false );
+        add_item( KEY_ANTI_ALIAS,    PropertyValidator::ITEM_SCALAR, false );
     }
 
     virtual ~MaterialPropertyValidator() {}
@@ -150,6 +162,33 @@ Material* MaterialManager::build_material( const treecore::Identifier& name, con
         die( "unsupported material type enum: %d", mat_type );
     }
 
+    // uniform block changes shader source, so it must be set before program
+    // is built
+    bool use_uniform_block = data_kv.contains( KEY_UNIFORM_BLOCK ) && bool(data_kv[KEY_UNIFORM_BLOCK]);
+    if (use_uniform_block)
+    {
+        if (SceneGraphMaterial* sgmat = dynamic_cast<SceneGraphMaterial*>(mat))
+            sgmat->m_uniform_block = true;
+        else
+        {
+            warn( "material %s is not a scene graph material, uniform block is ignored", name.toString().toRawUTF8() );
+            use_uniform_block = false;
+        }
+    }
+
+    // anti-alias helpers are also in shader source
+    bool use_anti_alias = data_kv.contains( KEY_ANTI_ALIAS ) && bool(data_kv[KEY_ANTI_ALIAS]);
+    if (use_anti_alias)
+    {
+        if (VectorGraphicsMaterial* vgmat = dynamic_cast<VectorGraphicsMaterial*>(mat))
+            vgmat->m_anti_alias = true;
+        else
+        {
+            warn( "material %s is not a vector graphics material, anti-alias is ignored", name.toString().toRawUTF8() );
+            use_anti_alias = false;
+        }
+    }
+
     //
     // build program
     //
@@ -162,7 +201,10 @@ Material* MaterialManager::build_material( const treecore::Identifier& name, con
 
     ProgramKey prog_key{ Identifier( (*program_names)[0].toString() ),
                          Identifier( (*program_names)[1].toString() ),
-                         mat_type };
+                         mat_type,
+                         false,
+                         use_uniform_block,
+                         use_anti_alias };
 
     Program* prog = m_impl->programs.getOrDefault( prog_key, nullptr );
 
@@ -203,6 +245,35 @@ Material* MaterialManager::build_material( const treecore::Identifier& name, con
             sgmat->m_receive_shadow = bool(data_kv[KEY_RECV_SHADOW]);
         if ( data_kv.contains( KEY_TRANSLUSCENT ) )
             sgmat->m_translucent = bool(data_kv[KEY_TRANSLUSCENT]);
+
+        // build instancing variant of program
+        if ( data_kv.contains( KEY_INSTANCING ) && bool(data_kv[KEY_INSTANCING]) )
+        {
+            ProgramKey inst_prog_key = prog_key;
+            inst_prog_key.instanced = true;
+
+            Program* inst_prog = m_impl->programs.getOrDefault( inst_prog_key, nullptr );
+
+            if (inst_prog == nullptr)
+            {
+                MemoryBlock src_vert_raw;
+                MemoryBlock src_frag_raw;
+                PackageManager::getInstance()->get_item_data( inst_prog_key.name_vert, src_vert_raw, true );
+                PackageManager::getInstance()->get_item_data( inst_prog_key.name_frag, src_frag_raw, true );
+
+                String src_vert = sgmat->get_instanced_vertex_source_addition() + (const char*) src_vert_raw.getData();
+                String src_frag = sgmat->get_shader_source_addition() + (const char*) src_frag_raw.getData();
+
+                inst_prog = new Program( src_vert.toRawUTF8(), src_frag.toRawUTF8() );
+                m_impl->programs.set( inst_prog_key, inst_prog );
+            }
+
+            sgmat->init_instancing( inst_prog );
+        }
+    }
+    else if ( data_kv.contains( KEY_INSTANCING ) )
+    {
+        warn( "material %s is not a scene graph material, instancing is ignored", name.toString().toRawUTF8() );
     }
 
     //
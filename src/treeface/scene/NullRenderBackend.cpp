@@ -0,0 +1,36 @@
+#include "treeface/scene/NullRenderBackend.h"
+#include "treeface/scene/RenderCommand.h"
+
+namespace treeface {
+
+NullRenderBackend::~NullRenderBackend() {}
+
+void NullRenderBackend::execute( const RenderCommandList& commands )
+{
+    m_num_frames++;
+    m_num_commands += commands.commands.size();
+
+    for (const RenderCommand& cmd : commands.commands)
+    {
+        if (cmd.type == RENDER_COMMAND_DRAW)
+        {
+            m_num_draws++;
+            m_num_instances++;
+        }
+        else if (cmd.type == RENDER_COMMAND_DRAW_INSTANCED)
+        {
+            m_num_draws++;
+            m_num_instances += cmd.arg1;
+        }
+    }
+}
+
+void NullRenderBackend::reset_counters() noexcept
+{
+    m_num_frames    = 0;
+    m_num_commands  = 0;
+    m_num_draws     = 0;
+    m_num_instances = 0;
+}
+
+} // namespace treeface
@@ -0,0 +1,36 @@
+#ifndef TREEFACE_NULL_RENDER_BACKEND_H
+#define TREEFACE_NULL_RENDER_BACKEND_H
+
+#include "treeface/scene/RenderBackend.h"
+
+namespace treeface {
+
+/**
+ * @brief backend that only counts commands, for measuring CPU cost of
+ *        renderer without GL
+ */
+class NullRenderBackend: public RenderBackend
+{
+public:
+    NullRenderBackend() = default;
+    virtual ~NullRenderBackend();
+
+    void execute( const RenderCommandList& commands ) override;
+
+    treecore::int64 get_num_frames() const noexcept    { return m_num_frames; }
+    treecore::int64 get_num_commands() const noexcept  { return m_num_commands; }
+    treecore::int64 get_num_draws() const noexcept     { return m_num_draws; }
+    treecore::int64 get_num_instances() const noexcept { return m_num_instances; }
+
+    void reset_counters() noexcept;
+
+protected:
+    treecore::int64 m_num_frames    = 0;
+    treecore::int64 m_num_commands  = 0;
+    treecore::int64 m_num_draws     = 0; ///< number of draw calls, an instanced draw is counted once
+    treecore::int64 m_num_instances = 0; ///< number of drawn items
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_NULL_RENDER_BACKEND_H
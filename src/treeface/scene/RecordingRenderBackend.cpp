@@ -0,0 +1,97 @@
+#include "treeface/scene/RecordingRenderBackend.h"
+#include "treeface/scene/RenderCommand.h"
+
+#include <treecore/HashMap.h>
+#include <treecore/OutputStream.h>
+#include <treecore/ScopedPointer.h>
+
+using namespace treecore;
+
+namespace treeface {
+
+struct RecordingRenderBackend::Impl
+{
+    uint32 get_id( HashMap<const void*, uint32>& store, const void* obj );
+
+    void write_u32( uint32 value )
+    {
+        stream->write( &value, sizeof(value) );
+    }
+
+    ScopedPointer<OutputStream> stream;
+    HashMap<const void*, uint32> material_ids;
+    HashMap<const void*, uint32> object_ids;
+    int64 num_frames = 0;
+};
+
+uint32 RecordingRenderBackend::Impl::get_id( HashMap<const void*, uint32>& store, const void* obj )
+{
+    if (obj == nullptr)
+        return 0;
+
+    HashMap<const void*, uint32>::Iterator it( store );
+    if ( store.select( obj, it ) )
+        return it.value();
+
+    uint32 id = uint32( store.size() ) + 1;
+    store.set( obj, id );
+    return id;
+}
+
+RecordingRenderBackend::RecordingRenderBackend( OutputStream* stream )
+    : m_impl( new Impl() )
+{
+    m_impl->stream = stream;
+}
+
+RecordingRenderBackend::~RecordingRenderBackend()
+{
+    if (m_impl)
+    {
+        m_impl->stream->flush();
+        delete m_impl;
+    }
+}
+
+void RecordingRenderBackend::execute( const RenderCommandList& commands )
+{
+    OutputStream* stream = m_impl->stream;
+
+    m_impl->write_u32( RENDER_RECORD_FRAME_MAGIC );
+    m_impl->write_u32( uint32( commands.commands.size() ) );
+    m_impl->write_u32( uint32( commands.matrices.size() ) );
+    m_impl->write_u32( uint32( commands.object_blocks.size() ) );
+
+    stream->write( &commands.matrix_proj,   sizeof(Mat4f) );
+    stream->write( &commands.matrix_view,   sizeof(Mat4f) );
+    stream->write( &commands.light_direct,  sizeof(Vec4f) );
+    stream->write( &commands.light_color,   sizeof(Vec4f) );
+    stream->write( &commands.light_ambient, sizeof(Vec4f) );
+
+    if (commands.matrices.size() > 0)
+        stream->write( &commands.matrices[0], sizeof(ItemMatrices) * size_t( commands.matrices.size() ) );
+
+    if (commands.object_blocks.size() > 0)
+        stream->write( &commands.object_blocks[0], sizeof(int32) * size_t( commands.object_blocks.size() ) );
+
+    for (const RenderCommand& cmd : commands.commands)
+    {
+        uint32 data[5] = {
+            uint32( cmd.type ),
+            uint32( cmd.arg0 ),
+            uint32( cmd.arg1 ),
+            m_impl->get_id( m_impl->material_ids, cmd.material ),
+            m_impl->get_id( m_impl->object_ids,   cmd.vis_obj ),
+        };
+        stream->write( data, sizeof(data) );
+    }
+
+    m_impl->num_frames++;
+}
+
+int64 RecordingRenderBackend::get_num_frames() const noexcept
+{
+    return m_impl->num_frames;
+}
+
+} // namespace treeface
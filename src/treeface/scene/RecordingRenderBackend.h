@@ -0,0 +1,53 @@
+#ifndef TREEFACE_RECORDING_RENDER_BACKEND_H
+#define TREEFACE_RECORDING_RENDER_BACKEND_H
+
+#include "treeface/scene/RenderBackend.h"
+
+#define RENDER_RECORD_FRAME_MAGIC 0x46524654 // "TFRF" in little endian
+
+namespace treecore {
+class OutputStream;
+} // namespace treecore
+
+namespace treeface {
+
+/**
+ * @brief backend that serialises command lists to a stream
+ *
+ * Each frame is written in native byte order as:
+ *
+ * - uint32 RENDER_RECORD_FRAME_MAGIC
+ * - uint32 number of commands, number of items and number of object blocks
+ * - projection and view matrices, 16 floats each in column major
+ * - light direction, color and ambient, 4 floats each
+ * - matrices of each item: model-view, model-view-projection and normal
+ * - int32 item index of each object block
+ * - each command as five 32-bit values: type, arg0, arg1, material ID and
+ *   visual object ID
+ *
+ * Materials and visual objects are written as IDs that are assigned on first
+ * appearance and start from 1, while 0 is for none. The IDs are kept across
+ * frames of one backend, so that recorded frames can be compared.
+ */
+class RecordingRenderBackend: public RenderBackend
+{
+public:
+    /**
+     * @param stream  where data is written to, which is deleted together
+     *                with backend
+     */
+    RecordingRenderBackend( treecore::OutputStream* stream );
+    virtual ~RecordingRenderBackend();
+
+    void execute( const RenderCommandList& commands ) override;
+
+    treecore::int64 get_num_frames() const noexcept;
+
+protected:
+    struct Impl;
+    Impl* m_impl = nullptr;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_RECORDING_RENDER_BACKEND_H
@@ -0,0 +1,9 @@
+#include "treeface/scene/RenderBackend.h"
+
+namespace treeface {
+
+RenderBackend::~RenderBackend() {}
+
+void RenderBackend::upload_geometry( Geometry* geom ) {}
+
+} // namespace treeface
@@ -0,0 +1,44 @@
+#ifndef TREEFACE_RENDER_BACKEND_H
+#define TREEFACE_RENDER_BACKEND_H
+
+#include "treeface/base/Common.h"
+
+#include <treecore/ClassUtils.h>
+#include <treecore/RefCountObject.h>
+
+namespace treeface {
+
+class Geometry;
+struct RenderCommandList;
+
+/**
+ * @brief executes render commands built by SceneRenderer
+ */
+class RenderBackend: public treecore::RefCountObject
+{
+public:
+    RenderBackend() = default;
+
+    TREECORE_DECLARE_NON_COPYABLE( RenderBackend )
+    TREECORE_DECLARE_NON_MOVABLE( RenderBackend )
+
+    virtual ~RenderBackend();
+
+    /**
+     * @brief upload modified vertex and index data of a geometry
+     *
+     * This is called before commands of a frame are built, as bounding boxes
+     * of geometries are updated on upload. Backends without GL do nothing,
+     * which is the default.
+     */
+    virtual void upload_geometry( Geometry* geom );
+
+    /**
+     * @brief execute commands of one frame
+     */
+    virtual void execute( const RenderCommandList& commands ) = 0;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_RENDER_BACKEND_H
@@ -0,0 +1,102 @@
+#ifndef TREEFACE_RENDER_COMMAND_H
+#define TREEFACE_RENDER_COMMAND_H
+
+#include "treeface/base/Common.h"
+
+#include "treeface/math/Mat4.h"
+#include "treeface/math/Vec4.h"
+
+#include <treecore/Array.h>
+
+namespace treeface {
+
+class SceneGraphMaterial;
+class VisualObject;
+
+typedef enum
+{
+    RENDER_COMMAND_FRAME_BLOCK,     ///< upload frame uniform block from frame states of the list
+    RENDER_COMMAND_OBJECT_BLOCKS,   ///< upload per-object uniform blocks listed by RenderCommandList::object_blocks
+    RENDER_COMMAND_BIND_MATERIAL,   ///< bind material, arg0 is non-zero for instancing program; frame uniforms are set if material don't use uniform block
+    RENDER_COMMAND_BIND_OBJECT,     ///< bind vertex array of visual object, and set its uniforms
+    RENDER_COMMAND_OBJECT_BLOCK,    ///< bind per-object uniform block, arg0 is block index
+    RENDER_COMMAND_OBJECT_MATRICES, ///< set per-object matrices as plain uniforms, arg0 is item index
+    RENDER_COMMAND_DRAW,            ///< draw visual object
+    RENDER_COMMAND_DRAW_INSTANCED,  ///< draw geometry of visual object with instancing, arg0 is first item index, arg1 is number of items
+    RENDER_COMMAND_FINISH,          ///< unbind everything at frame end
+} RenderCommandType;
+
+///
+/// \brief one step of drawing a frame
+///
+/// Commands are plain data. Items are referred by their index in frame order,
+/// whose matrices are stored in RenderCommandList::matrices.
+///
+struct RenderCommand
+{
+    RenderCommandType   type;
+    treecore::int32     arg0;
+    treecore::int32     arg1;
+    SceneGraphMaterial* material;
+    VisualObject*       vis_obj;
+};
+
+inline bool operator ==( const RenderCommand& a, const RenderCommand& b ) noexcept
+{
+    return a.type == b.type && a.arg0 == b.arg0 && a.arg1 == b.arg1 && a.material == b.material && a.vis_obj == b.vis_obj;
+}
+
+inline bool operator !=( const RenderCommand& a, const RenderCommand& b ) noexcept
+{
+    return !(a == b);
+}
+
+///
+/// \brief per-item matrices of one frame, in the same layout as the object
+///        uniform block of SceneGraphMaterial
+///
+struct ItemMatrices
+{
+    Mat4f model_view;
+    Mat4f model_view_proj;
+    Mat4f normal;
+};
+
+///
+/// \brief all commands and data for drawing one frame
+///
+/// Built by SceneRenderer without any GL call, and executed by a
+/// RenderBackend.
+///
+TREECORE_ALN_BEGIN( 16 )
+struct RenderCommandList
+{
+    TREECORE_ALIGNED_ALLOCATOR( RenderCommandList );
+
+    Mat4f matrix_proj;
+    Mat4f matrix_view;
+    Vec4f light_direct; ///< in view space
+    Vec4f light_color;
+    Vec4f light_ambient;
+
+    treecore::Array<ItemMatrices, 16> matrices;      ///< matrices of all drawn items in frame order
+    treecore::Array<treecore::int32>  object_blocks; ///< item index of each per-object uniform block
+    treecore::Array<RenderCommand>    commands;
+
+    void clear() noexcept
+    {
+        matrices.clearQuick();
+        object_blocks.clearQuick();
+        commands.clearQuick();
+    }
+
+    void add( RenderCommandType type, treecore::int32 arg0 = 0, treecore::int32 arg1 = 0,
+              SceneGraphMaterial* material = nullptr, VisualObject* vis_obj = nullptr )
+    {
+        commands.add( { type, arg0, arg1, material, vis_obj } );
+    }
+} TREECORE_ALN_END( 16 );
+
+} // namespace treeface
+
+#endif // TREEFACE_RENDER_COMMAND_H
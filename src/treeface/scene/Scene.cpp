@@ -5,9 +5,11 @@
 #include "treeface/scene/GeometryManager.h"
 #include "treeface/scene/SceneNode.h"
 #include "treeface/scene/SceneNodeManager.h"
+#include "treeface/scene/TransformStore.h"
 
 #include "treeface/misc/Errors.h"
 #include "treeface/misc/PropertyValidator.h"
+#include "treeface/misc/StringCast.h"
 
 #include "treeface/base/PackageManager.h"
 
@@ -133,9 +135,53 @@ void Scene::set_global_light_ambient( const Vec4f& value ) noexcept
     m_guts->global_light_ambient = value;
 }
 
+DepthSortPolicy Scene::get_depth_sort_policy() const noexcept
+{
+    return m_guts->depth_sort;
+}
+
+void Scene::set_depth_sort_policy( DepthSortPolicy value ) noexcept
+{
+    m_guts->depth_sort = value;
+}
+
+bool Scene::get_frustum_culling() const noexcept
+{
+    return m_guts->frustum_culling;
+}
+
+void Scene::set_frustum_culling( bool value ) noexcept
+{
+    m_guts->frustum_culling = value;
+}
+
+bool Scene::get_contiguous_transforms() const noexcept
+{
+    return m_guts->transform_store.get() != nullptr;
+}
+
+void Scene::set_contiguous_transforms( bool value )
+{
+    if ( value == get_contiguous_transforms() )
+        return;
+
+    if (value)
+        m_guts->transform_store = new TransformStore( m_guts->root_node );
+    else
+        m_guts->transform_store = nullptr;
+}
+
+TransformStore* Scene::get_transform_store() noexcept
+{
+    return m_guts->transform_store.get();
+}
+
 #define KEY_GLOBAL_LIGHT_DIRECTION "global_light_direction"
 #define KEY_GLOBAL_LIGHT_COLOR     "global_light_color"
 #define KEY_GLOBAL_LIGHT_AMB       "global_light_ambient"
+#define KEY_DEPTH_SORT             "depth_sort"
+#define KEY_FRUSTUM_CULLING        "frustum_culling"
+#define KEY_CONTIGUOUS_TRANS       "contiguous_transforms"
 #define KEY_NODES                  "nodes"
 
 struct ScenePropertyValidator: public PropertyValidator, public RefCountSingleton<ScenePropertyValidator>
@@ -146,6 +192,9 @@ public:
         add_item( KEY_GLOBAL_LIGHT_DIRECTION, PropertyValidator::ITEM_ARRAY, false );
         add_item( KEY_GLOBAL_LIGHT_COLOR,     PropertyValidator::ITEM_ARRAY, false );
         add_item( KEY_GLOBAL_LIGHT_AMB,       PropertyValidator::ITEM_ARRAY, false );
+        add_item( KEY_DEPTH_SORT,             PropertyValidator::ITEM_SCALAR, false );
+        add_item( KEY_FRUSTUM_CULLING,        PropertyValidator::ITEM_SCALAR, false );
+        add_item( KEY_CONTIGUOUS_TRANS,       PropertyValidator::ITEM_SCALAR, false );
         add_item( KEY_NODES,                  PropertyValidator::ITEM_ARRAY, true );
     }
 
@@ -210,6 +259,16 @@ void Scene::build( const treecore::var& root )
         );
     }
 
+    // policy of depth sorting
+    if ( root_kv.contains( KEY_DEPTH_SORT ) )
+    {
+        if ( !fromString( root_kv[KEY_DEPTH_SORT], m_guts->depth_sort ) )
+            throw ConfigParseError( "Scene: invalid depth sort policy: " + root_kv[KEY_DEPTH_SORT].toString() );
+    }
+
+    if ( root_kv.contains( KEY_FRUSTUM_CULLING ) )
+        m_guts->frustum_culling = bool(root_kv[KEY_FRUSTUM_CULLING]);
+
     // scene graph
     Array<var>* scenenode_nodes = root_kv[KEY_NODES].getArray();
     for (int i = 0; i < scenenode_nodes->size(); i++)
@@ -218,6 +277,10 @@ void Scene::build( const treecore::var& root )
         SceneNode* node = m_guts->node_mgr->add_nodes( scenenode_data );;
         m_guts->root_node->add_child( node );
     }
+
+    // store is built after the hierarchy is loaded
+    if ( root_kv.contains( KEY_CONTIGUOUS_TRANS ) )
+        set_contiguous_transforms( bool(root_kv[KEY_CONTIGUOUS_TRANS]) );
 }
 
 } // namespace treeface
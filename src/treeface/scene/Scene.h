@@ -2,6 +2,7 @@
 #define TREEFACE_SCENE_H
 
 #include "treeface/base/Common.h"
+#include "treeface/base/Enums.h"
 #include "treeface/math/Vec4.h"
 
 #include <treecore/RefCountObject.h>
@@ -19,6 +20,7 @@ class MaterialManager;
 class SceneNode;
 class SceneNodeManager;
 class SceneRenderer;
+class TransformStore;
 
 class Scene: public treecore::RefCountObject
 {
@@ -66,6 +68,43 @@ public:
     void         set_global_light_ambient( float r, float g, float b, float a ) noexcept;
     void         set_global_light_ambient( const Vec4f& value ) noexcept;
 
+    /**
+     * @brief how render items are ordered by their view-space depth
+     *
+     * Sorting by depth requires re-sorting part of the render queue on each
+     * frame. Default is DEPTH_SORT_NONE.
+     */
+    DepthSortPolicy get_depth_sort_policy() const noexcept;
+    void            set_depth_sort_policy( DepthSortPolicy value ) noexcept;
+
+    /**
+     * @brief whether nodes outside of view frustum are skipped by renderer
+     *
+     * Culling relies on bounding boxes calculated from the "position" vertex
+     * attribute, so it should be disabled if vertex shaders move vertices far
+     * away from their original position. Default is false, and scenes can
+     * enable it by this method or by "frustum_culling" config key.
+     */
+    bool get_frustum_culling() const noexcept;
+    void set_frustum_culling( bool value ) noexcept;
+
+    /**
+     * @brief whether node transforms are kept in contiguous arrays
+     *
+     * When enabled, the scene owns a TransformStore for its hierarchy, and
+     * global transforms are updated by a linear pass over it on each frame.
+     * This is faster for large hierarchies with frequent transform changes.
+     * Default is false.
+     */
+    bool get_contiguous_transforms() const noexcept;
+    void set_contiguous_transforms( bool value );
+
+    /**
+     * @return transform store of this scene, or nullptr if contiguous
+     *         transforms are disabled
+     */
+    TransformStore* get_transform_store() noexcept;
+
 private:
     void build( const treecore::var& root );
 
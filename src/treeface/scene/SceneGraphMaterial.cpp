@@ -1,9 +1,12 @@
 #include "treeface/scene/SceneGraphMaterial.h"
 
 #include "treeface/gl/Program.h"
+#include "treeface/gl/VertexTemplate.h"
 
 #include "treeface/scene/guts/Material_guts.h"
 
+#include <treecore/RefCountSingleton.h>
+
 #define NAME_MAT_MV       "matrix_model_view"
 #define NAME_MAT_PROJ     "matrix_project"
 #define NAME_MAT_MVP      "matrix_model_view_project"
@@ -11,11 +14,42 @@
 #define NAME_GLB_L_DIRECT "global_light_direction"
 #define NAME_GLB_L_COLOR  "global_light_color"
 #define NAME_GLB_L_AMB    "global_light_ambient"
+#define NAME_MAT_VIEW     "matrix_view"
+#define NAME_BLOCK_FRAME  "TreefaceSceneFrame"
+#define NAME_BLOCK_OBJECT "TreefaceSceneObject"
+
+#define NAME_INST_MV   "instance_model_view_"
+#define NAME_INST_NORM "instance_normal_"
 
 using namespace treecore;
 
 namespace treeface {
 
+struct InstanceTemplateHelper: public treecore::RefCountObject, public treecore::RefCountSingleton<InstanceTemplateHelper>
+{
+    InstanceTemplateHelper()
+    {
+        value.add_attrib( TypedTemplate( NAME_INST_MV "0",   4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_MV "1",   4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_MV "2",   4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_MV "3",   4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_NORM "0", 4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_NORM "1", 4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_NORM "2", 4, TFGL_TYPE_FLOAT ), false, 16 );
+        value.add_attrib( TypedTemplate( NAME_INST_NORM "3", 4, TFGL_TYPE_FLOAT ), false, 16 );
+        treecore_assert( sizeof(Mat4f) * 2 == value.vertex_size() );
+    }
+
+    virtual ~InstanceTemplateHelper() = default;
+
+    VertexTemplate value;
+};
+
+const VertexTemplate& SceneGraphMaterial::VERTEX_TEMPLATE_INSTANCE()
+{
+    return InstanceTemplateHelper::getInstance()->value;
+}
+
 const treecore::Identifier SceneGraphMaterial::UNIFORM_MATRIX_MODEL_VIEW( NAME_MAT_MV );
 const treecore::Identifier SceneGraphMaterial::UNIFORM_MATRIX_PROJECT( NAME_MAT_PROJ );
 const treecore::Identifier SceneGraphMaterial::UNIFORM_MATRIX_MODEL_VIEW_PROJECT( NAME_MAT_MVP );
@@ -23,6 +57,20 @@ const treecore::Identifier SceneGraphMaterial::UNIFORM_MATRIX_NORMAL( NAME_MAT_N
 const treecore::Identifier SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_DIRECTION( NAME_GLB_L_DIRECT );
 const treecore::Identifier SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_COLOR( NAME_GLB_L_COLOR );
 const treecore::Identifier SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_AMBIENT( NAME_GLB_L_AMB );
+const treecore::Identifier SceneGraphMaterial::UNIFORM_MATRIX_VIEW( NAME_MAT_VIEW );
+const treecore::Identifier SceneGraphMaterial::UNIFORM_BLOCK_FRAME( NAME_BLOCK_FRAME );
+const treecore::Identifier SceneGraphMaterial::UNIFORM_BLOCK_OBJECT( NAME_BLOCK_OBJECT );
+
+void _bind_scene_uniform_blocks_( Program* program )
+{
+    int i_frame = program->get_uniform_block_index( SceneGraphMaterial::UNIFORM_BLOCK_FRAME );
+    if (i_frame >= 0)
+        program->set_uniform_block_binding( i_frame, TREEFACE_UNIFORM_BINDING_SCENE_FRAME );
+
+    int i_object = program->get_uniform_block_index( SceneGraphMaterial::UNIFORM_BLOCK_OBJECT );
+    if (i_object >= 0)
+        program->set_uniform_block_binding( i_object, TREEFACE_UNIFORM_BINDING_SCENE_OBJECT );
+}
 
 SceneGraphMaterial::~SceneGraphMaterial()
 {}
@@ -38,6 +86,34 @@ void SceneGraphMaterial::init( Program* program )
     m_uni_light_direct    = program->get_uniform_location( SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_DIRECTION );
     m_uni_light_color     = program->get_uniform_location( SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_COLOR );
     m_uni_light_ambient   = program->get_uniform_location( SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_AMBIENT );
+
+    if (m_uniform_block)
+        _bind_scene_uniform_blocks_( program );
+}
+
+void SceneGraphMaterial::init_instancing( Program* program )
+{
+    if (m_program_instanced.get() != nullptr)
+    {
+        warn( "attempt to init instancing on material %p twice", this );
+        return;
+    }
+
+    m_program_instanced = program;
+
+    m_inst_uni_proj          = program->get_uniform_location( SceneGraphMaterial::UNIFORM_MATRIX_PROJECT );
+    m_inst_uni_light_direct  = program->get_uniform_location( SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_DIRECTION );
+    m_inst_uni_light_color   = program->get_uniform_location( SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_COLOR );
+    m_inst_uni_light_ambient = program->get_uniform_location( SceneGraphMaterial::UNIFORM_GLOBAL_LIGHT_AMBIENT );
+
+    if (m_uniform_block)
+        _bind_scene_uniform_blocks_( program );
+}
+
+void SceneGraphMaterial::bind_instanced() noexcept
+{
+    treecore_assert( m_program_instanced.get() != nullptr );
+    bind_with_program( m_program_instanced );
 }
 
 void SceneGraphMaterial::set_matrix_model_view( const Mat4f& mat ) const noexcept
@@ -67,8 +143,32 @@ void SceneGraphMaterial::set_light( const Vec4f& direction, const Vec4f& color,
     m_program->set_uniform( m_uni_light_ambient, ambient );
 }
 
+// std140 layout, must be kept same with the buffer filled by SceneRenderer
+#define SOURCE_BLOCK_FRAME \
+    "layout(std140) uniform " NAME_BLOCK_FRAME "\n" \
+    "{\n" \
+    "    highp mat4 " NAME_MAT_PROJ ";\n" \
+    "    highp mat4 " NAME_MAT_VIEW ";\n" \
+    "    mediump vec4 " NAME_GLB_L_DIRECT ";\n" \
+    "    mediump vec4 " NAME_GLB_L_COLOR ";\n" \
+    "    mediump vec4 " NAME_GLB_L_AMB ";\n" \
+    "};\n"
+
+#define SOURCE_BLOCK_OBJECT \
+    "layout(std140) uniform " NAME_BLOCK_OBJECT "\n" \
+    "{\n" \
+    "    highp mat4 " NAME_MAT_MV ";\n" \
+    "    highp mat4 " NAME_MAT_MVP ";\n" \
+    "    highp mat4 " NAME_MAT_NORM ";\n" \
+    "};\n"
+
 treecore::String SceneGraphMaterial::get_shader_source_addition() const noexcept
 {
+    // blocks are declared without instance name, so that shader source can
+    // access uniforms in same way
+    if (m_uniform_block)
+        return Material::get_shader_source_addition() + String( SOURCE_BLOCK_FRAME SOURCE_BLOCK_OBJECT "\n" );
+
     return Material::get_shader_source_addition() + String(
         "uniform highp mat4 " NAME_MAT_MV ";\n"
         "uniform highp mat4 " NAME_MAT_PROJ ";\n"
@@ -80,4 +180,34 @@ treecore::String SceneGraphMaterial::get_shader_source_addition() const noexcept
         "\n" );
 }
 
+treecore::String SceneGraphMaterial::get_instanced_vertex_source_addition() const noexcept
+{
+    // per-node matrices are replaced by per-instance attributes, so that
+    // vertex shader source can be shared with non-instanced program
+    String frame_uniforms;
+    if (m_uniform_block)
+        frame_uniforms = SOURCE_BLOCK_FRAME;
+    else
+        frame_uniforms =
+            "uniform highp mat4 " NAME_MAT_PROJ ";\n"
+            "uniform mediump vec4 " NAME_GLB_L_DIRECT ";\n"
+            "uniform mediump vec4 " NAME_GLB_L_COLOR ";\n"
+            "uniform mediump vec4 " NAME_GLB_L_AMB ";\n";
+
+    return Material::get_shader_source_addition() + String(
+        "in highp vec4 " NAME_INST_MV "0;\n"
+        "in highp vec4 " NAME_INST_MV "1;\n"
+        "in highp vec4 " NAME_INST_MV "2;\n"
+        "in highp vec4 " NAME_INST_MV "3;\n"
+        "in highp vec4 " NAME_INST_NORM "0;\n"
+        "in highp vec4 " NAME_INST_NORM "1;\n"
+        "in highp vec4 " NAME_INST_NORM "2;\n"
+        "in highp vec4 " NAME_INST_NORM "3;\n" ) +
+           frame_uniforms + String(
+        "#define " NAME_MAT_MV " mat4(" NAME_INST_MV "0, " NAME_INST_MV "1, " NAME_INST_MV "2, " NAME_INST_MV "3)\n"
+        "#define " NAME_MAT_NORM " mat4(" NAME_INST_NORM "0, " NAME_INST_NORM "1, " NAME_INST_NORM "2, " NAME_INST_NORM "3)\n"
+        "#define " NAME_MAT_MVP " (" NAME_MAT_PROJ " * " NAME_MAT_MV ")\n"
+        "\n" );
+}
+
 } // namespace treeface
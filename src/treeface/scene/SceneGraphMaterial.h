@@ -9,12 +9,19 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 
+// uniform buffer binding points used by scene graph materials
+#define TREEFACE_UNIFORM_BINDING_SCENE_FRAME  0
+#define TREEFACE_UNIFORM_BINDING_SCENE_OBJECT 1
+
 namespace treeface {
 
+class VertexTemplate;
+
 class SceneGraphMaterial: public Material
 {
     friend class MaterialManager;
     friend class SceneRenderer;
+    friend class GLRenderBackend;
 
 public:
     static const treecore::Identifier UNIFORM_MATRIX_MODEL_VIEW;
@@ -24,18 +31,68 @@ public:
     static const treecore::Identifier UNIFORM_GLOBAL_LIGHT_DIRECTION;
     static const treecore::Identifier UNIFORM_GLOBAL_LIGHT_COLOR;
     static const treecore::Identifier UNIFORM_GLOBAL_LIGHT_AMBIENT;
+    static const treecore::Identifier UNIFORM_MATRIX_VIEW;
+    static const treecore::Identifier UNIFORM_BLOCK_FRAME;
+    static const treecore::Identifier UNIFORM_BLOCK_OBJECT;
+
+    ///
+    /// \brief layout of per-instance data used by instancing program variant
+    ///
+    /// Each instance has model-view matrix and normal matrix, both stored as
+    /// four column vectors.
+    ///
+    static const VertexTemplate& VERTEX_TEMPLATE_INSTANCE();
 
     SceneGraphMaterial() = default;
     virtual ~SceneGraphMaterial();
 
     void init( Program* program ) override;
 
+    ///
+    /// \brief set the instancing variant of program
+    ///
+    /// The variant is built from same shader source, but vertex shader gets
+    /// model-view and normal matrices from per-instance attributes, and
+    /// model-view-projection matrix is calculated in shader. Fragment shader
+    /// should not use per-node matrices.
+    ///
+    void init_instancing( Program* program );
+
+    bool supports_instancing() const noexcept
+    {
+        return m_program_instanced.get() != nullptr;
+    }
+
+    Program* get_instanced_program() const noexcept
+    {
+        return m_program_instanced.get();
+    }
+
+    ///
+    /// \brief bind textures of this material together with instancing program
+    ///
+    void bind_instanced() noexcept;
+
     void set_matrix_model_view( const Mat4f& mat ) const noexcept;
     void set_matrix_proj( const Mat4f& mat ) const noexcept;
     void set_matrix_model_view_proj( const Mat4f& mat ) const noexcept;
     void set_matrix_norm( const Mat4f& mat ) const noexcept;
     void set_light( const Vec4f& direction, const Vec4f& color, const Vec4f& ambient ) const noexcept;
 
+    ///
+    /// \brief whether scene uniforms are declared in uniform blocks
+    ///
+    /// If true, projection, view and light uniforms are in a std140 block
+    /// shared by all materials and updated once per frame, and per-node
+    /// matrices are in another block that is fed by buffer ranges. The
+    /// set_matrix_XXX() and set_light() methods have no effect on such
+    /// materials.
+    ///
+    bool uses_uniform_block() const noexcept
+    {
+        return m_uniform_block;
+    }
+
     bool is_translucent() const noexcept
     {
         return m_translucent;
@@ -56,8 +113,10 @@ public:
 
 protected:
     treecore::String get_shader_source_addition() const noexcept override;
+    treecore::String get_instanced_vertex_source_addition() const noexcept;
 
     bool  m_translucent = false;
+    bool  m_uniform_block       = false;
     bool  m_project_shadow      = true;
     bool  m_receive_shadow      = true;
     GLint m_uni_model_view      = -1;
@@ -67,6 +126,12 @@ protected:
     GLint m_uni_light_direct    = -1;
     GLint m_uni_light_color     = -1;
     GLint m_uni_light_ambient   = -1;
+
+    treecore::RefCountHolder<Program> m_program_instanced;
+    GLint m_inst_uni_proj          = -1;
+    GLint m_inst_uni_light_direct  = -1;
+    GLint m_inst_uni_light_color   = -1;
+    GLint m_inst_uni_light_ambient = -1;
 };
 
 } // namespace treeface
@@ -1,4 +1,7 @@
+#include "treeface/scene/Geometry.h"
 #include "treeface/scene/SceneNode.h"
+#include "treeface/scene/SceneRenderer.h"
+#include "treeface/scene/TransformStore.h"
 #include "treeface/scene/VisualObject.h"
 
 #include "treeface/scene/guts/SceneNode_guts.h"
@@ -7,6 +10,21 @@ using namespace treecore;
 
 namespace treeface {
 
+inline void _inverse_transform_( Mat4f& mat ) noexcept
+{
+    if ( mat.is_affine() )
+        mat.inverse_affine();
+    else
+        mat.inverse();
+}
+
+inline SceneNode* _get_root_( SceneNode* node ) noexcept
+{
+    while ( SceneNode* parent = node->get_parent() )
+        node = parent;
+    return node;
+}
+
 SceneNode::SceneNode(): m_impl( new Guts() )
 {}
 
@@ -23,35 +41,99 @@ const Mat4f& SceneNode::get_transform() noexcept
 
 const Mat4f& SceneNode::get_global_transform() noexcept
 {
-    if (m_impl->trans_dirty)
-        m_impl->update_trans_descendent();
-    else if (m_impl->global_dirty)
-        m_impl->update_global_descendent();
+    // store is updated once per frame, not on each query
+    if (TransformStore* store = m_impl->transform_store)
+        return store->get_global( m_impl->transform_index );
+
+    if (m_impl->global_dirty)
+        m_impl->update_global();
 
     return m_impl->trans_global;
 }
 
 const Mat4f& SceneNode::get_transform_inv() noexcept
 {
-    if (m_impl->trans_dirty)
-        m_impl->update_trans_descendent();
+    if (m_impl->trans_inv_dirty)
+    {
+        m_impl->trans_inv = m_impl->trans;
+        _inverse_transform_( m_impl->trans_inv );
+        m_impl->trans_inv_dirty = false;
+    }
+
     return m_impl->trans_inv;
 }
 
 const Mat4f& SceneNode::get_global_transform_inv() noexcept
 {
-    if (m_impl->trans_dirty)
-        m_impl->update_trans_descendent();
-    else if (m_impl->global_dirty)
-        m_impl->update_global_descendent();
+    const Mat4f& global = get_global_transform();
+
+    bool inv_dirty = m_impl->global_inv_dirty;
+    if (TransformStore* store = m_impl->transform_store)
+        inv_dirty = store->take_global_inv_dirty( m_impl->transform_index ) || inv_dirty;
+
+    if (inv_dirty)
+    {
+        m_impl->trans_global_inv = global;
+        _inverse_transform_( m_impl->trans_global_inv );
+        m_impl->global_inv_dirty = false;
+    }
 
     return m_impl->trans_global_inv;
 }
 
 void SceneNode::set_transform( const Mat4f& value ) noexcept
 {
-    m_impl->trans_dirty = true;
-    m_impl->trans       = value;
+    m_impl->trans_inv_dirty = true;
+    m_impl->trans           = value;
+
+    // global transform and bounds of whole subtree are affected
+    m_impl->invalidate_global_descendent();
+    m_impl->invalidate_bound_ancestor();
+    m_impl->mark_global_dirty_ancestor();
+
+    if (m_impl->transform_store)
+        m_impl->transform_store->local_changed( m_impl->transform_index, value );
+}
+
+void SceneNode::update_global_transforms() noexcept
+{
+    if (m_impl->transform_store)
+    {
+        m_impl->transform_store->update();
+        return;
+    }
+
+    bool self_dirty = m_impl->global_dirty;
+    if (!self_dirty && !m_impl->global_dirty_below)
+        return;
+
+    if (self_dirty)
+        m_impl->update_global();
+    m_impl->global_dirty_below = false;
+
+    Array<SceneNode*> stack;
+    for (int i = 0; i < m_impl->child_nodes.size(); i++)
+        stack.add( m_impl->child_nodes[i] );
+
+    while (stack.size() > 0)
+    {
+        SceneNode* node = stack.getLast();
+        stack.removeLast();
+
+        Guts* guts = node->m_impl;
+
+        // parent is always updated before children
+        bool node_dirty = guts->global_dirty;
+        if (node_dirty)
+            guts->update_global_from_parent();
+
+        if (node_dirty || guts->global_dirty_below)
+        {
+            guts->global_dirty_below = false;
+            for (int i = 0; i < guts->child_nodes.size(); i++)
+                stack.add( guts->child_nodes[i] );
+        }
+    }
 }
 
 bool SceneNode::add_item( SceneObject* obj )
@@ -59,6 +141,11 @@ bool SceneNode::add_item( SceneObject* obj )
     if ( m_impl->objects.add( obj ) )
     {
         obj->m_node = this;
+        invalidate_bounding_box();
+
+        for (SceneRenderer* renderer : _get_root_( this )->m_impl->renderers)
+            renderer->item_attached( this, obj );
+
         return true;
     }
     else
@@ -76,8 +163,13 @@ bool SceneNode::remove_item( SceneObject* obj )
 {
     if ( m_impl->objects.contains( obj ) )
     {
+        // notify before removal, as object may be destroyed by removal
+        for (SceneRenderer* renderer : _get_root_( this )->m_impl->renderers)
+            renderer->item_detached( this, obj );
+
         m_impl->objects.removeValue( obj );
         obj->m_node = nullptr;
+        invalidate_bounding_box();
         return true;
     }
     else
@@ -105,11 +197,21 @@ bool SceneNode::add_child( SceneNode* child )
     if (!add_re)
         return false;
 
-    child->m_impl->parent       = this;
-    child->m_impl->global_dirty = true;
+    child->m_impl->parent = this;
+    child->m_impl->invalidate_global_descendent();
+    child->m_impl->mark_global_dirty_ancestor();
+    invalidate_bounding_box();
+    m_impl->hierarchy_changed();
 
     child->m_impl->uniform_cache_dirty = true;
 
+    // child is no longer a root
+    for (SceneRenderer* renderer : child->m_impl->renderers)
+        renderer->root_lost();
+
+    for (SceneRenderer* renderer : _get_root_( this )->m_impl->renderers)
+        renderer->subtree_attached( child );
+
     return true;
 }
 
@@ -122,9 +224,17 @@ bool SceneNode::remove_child( SceneNode* child ) noexcept
 {
     if ( m_impl->child_nodes.contains( child ) )
     {
+        for (SceneRenderer* renderer : _get_root_( this )->m_impl->renderers)
+            renderer->subtree_detached( child );
+
         m_impl->child_nodes.removeValue( child );
-        child->m_impl->parent       = nullptr;
-        child->m_impl->global_dirty = true;
+        child->m_impl->parent = nullptr;
+
+        if (child->m_impl->transform_store)
+            child->m_impl->detach_transform_store();
+        child->m_impl->invalidate_global_descendent();
+        invalidate_bounding_box();
+        m_impl->hierarchy_changed();
 
         child->m_impl->uniform_cache_dirty = true;
         return true;
@@ -150,4 +260,54 @@ SceneNode* SceneNode::get_parent() noexcept
     return m_impl->parent;
 }
 
+uint32 SceneNode::get_hierarchy_version() const noexcept
+{
+    return m_impl->hierarchy_version;
+}
+
+bool SceneNode::get_global_bounding_box( BBox3f& result ) noexcept
+{
+    if (m_impl->bound_dirty)
+    {
+        const Mat4f& trans = get_global_transform();
+
+        BBox3f bound;
+        bool   known = true;
+
+        for (int i = 0; i < m_impl->objects.size(); i++)
+        {
+            VisualObject* vis_obj = dynamic_cast<VisualObject*>( m_impl->objects[i].get() );
+            if (!vis_obj)
+                continue;
+
+            BBox3f geom_bound;
+            if ( vis_obj->get_geometry()->get_bounding_box( geom_bound ) )
+                bound.add_box( geom_bound.transformed( trans ) );
+            else
+                known = false;
+        }
+
+        for (int i = 0; i < m_impl->child_nodes.size(); i++)
+        {
+            BBox3f child_bound;
+            if ( m_impl->child_nodes[i]->get_global_bounding_box( child_bound ) )
+                bound.add_box( child_bound );
+            else
+                known = false;
+        }
+
+        m_impl->bound_global = bound;
+        m_impl->bound_known  = known;
+        m_impl->bound_dirty  = false;
+    }
+
+    result = m_impl->bound_global;
+    return m_impl->bound_known;
+}
+
+void SceneNode::invalidate_bounding_box() noexcept
+{
+    m_impl->invalidate_bound_ancestor();
+}
+
 } // namespace treeface
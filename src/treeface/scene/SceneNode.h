@@ -3,12 +3,15 @@
 
 #include "treeface/base/Common.h"
 
+#include "treeface/math/BBox3.h"
 #include "treeface/math/Mat4.h"
 
 #include <treecore/ArrayRef.h>
 #include <treecore/HashMap.h>
 #include <treecore/RefCountObject.h>
 
+class TestFramework;
+
 namespace treecore {
 class Identifier;
 class Result;
@@ -17,14 +20,18 @@ class var;
 
 namespace treeface {
 
+class Geometry;
 class SceneObject;
 class SceneNodeManager;
 class UniversalValue;
 
 class SceneNode: public treecore::RefCountObject
 {
+    friend class ::TestFramework;
+    friend class Geometry;
     friend class SceneNodeManager;
     friend class SceneRenderer;
+    friend class TransformStore;
 
 public:
     SceneNode();
@@ -41,6 +48,19 @@ public:
 
     void set_transform( const Mat4f& value ) noexcept;
 
+    ///
+    /// \brief update global transforms of this node and all descendants
+    ///
+    /// Global transforms are also updated lazily when they are queried, but
+    /// updating them in one top-down pass avoids walking up ancestors for
+    /// each node. Subtrees without modification are skipped.
+    ///
+    /// If this node is managed by a TransformStore, the whole store is
+    /// updated instead. Global transforms of nodes in a store are not updated
+    /// by queries, so they are only up to date after this call.
+    ///
+    void update_global_transforms() noexcept;
+
     bool         add_item( SceneObject* obj );
     bool         has_item( SceneObject* obj ) const noexcept;
     bool         remove_item( SceneObject* obj );
@@ -54,7 +74,36 @@ public:
     SceneNode* get_child_at( int idx ) noexcept;
     SceneNode* get_parent() noexcept;
 
+    ///
+    /// \brief get a counter that is increased when child nodes are added or
+    ///        removed on this node or any of its descendants
+    ///
+    /// It can be used to check whether cached data of this subtree's
+    /// hierarchy is outdated.
+    ///
+    treecore::uint32 get_hierarchy_version() const noexcept;
+
+    ///
+    /// \brief get world-space bounding box of all visual objects on this node
+    ///        and its descendants
+    ///
+    /// The box is cached, and is recalculated when transform, hierarchy or
+    /// geometry data in this subtree is modified.
+    ///
+    /// \param result  bounding box is written here, which is invalid if the
+    ///                subtree has no visual object
+    /// \return false if any visual object in the subtree has unknown bounds
+    ///
+    /// \see Geometry::get_bounding_box
+    ///
+    bool get_global_bounding_box( BBox3f& result ) noexcept;
+
 private:
+    ///
+    /// \brief mark bounding box of this node and its ancestors as dirty
+    ///
+    void invalidate_bounding_box() noexcept;
+
     struct Guts;
     Guts* m_impl = nullptr;
 };
@@ -159,8 +159,7 @@ void SceneNodeManager::build_node( const treecore::var& data, SceneNode* node )
                    static_cast<float>( (*trans_array)[4] ),  float( (*trans_array)[5] ),  float( (*trans_array)[6] ),  float( (*trans_array)[7] ),
                    static_cast<float>( (*trans_array)[8] ),  float( (*trans_array)[9] ),  float( (*trans_array)[10] ), float( (*trans_array)[11] ),
                    static_cast<float>( (*trans_array)[12] ), float( (*trans_array)[13] ), float( (*trans_array)[14] ), float( (*trans_array)[15] ) );
-        node->m_impl->trans       = mat;
-        node->m_impl->trans_dirty = true;
+        node->set_transform( mat );
     }
 
     //
@@ -188,9 +187,7 @@ void SceneNodeManager::build_node( const treecore::var& data, SceneNode* node )
             SceneNode* child = new SceneNode();
             build_node( (*child_array)[i], child );
 
-            child->m_impl->parent       = node;
-            child->m_impl->global_dirty = true;
-            node->m_impl->child_nodes.add( child );
+            node->add_child( child );
         }
     }
 
@@ -2,18 +2,102 @@
 
 #include "treeface/scene/SceneNode.h"
 
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
 #include <treecore/Result.h>
 
 using namespace treecore;
 
 namespace treeface {
 
-SceneQuery::SceneQuery()
+struct FlatNode
+{
+    SceneNode* node;
+    int32 parent;      // index of parent in flattened array, -1 for root
+    int32 subtree_end; // index past the last descendant
+};
+
+struct SceneQuery::Impl
+{
+    // pending nodes of stack-based traverse, reused across traverses
+    Array<SceneNode*> stack;
+
+    bool flatten = false;
+
+    // pre-order sequence of the tree rooted at flat_root
+    Array<FlatNode> flat_nodes;
+    Array<int32>    flat_parent_stack;
+    RefCountHolder<SceneNode> flat_root;
+    uint32 flat_version = 0;
+
+    void build_flat( SceneNode* root );
+};
+
+void SceneQuery::Impl::build_flat( SceneNode* root )
+{
+    flat_nodes.clearQuick();
+    stack.clearQuick();
+    flat_parent_stack.clearQuick();
+
+    stack.add( root );
+    flat_parent_stack.add( -1 );
+
+    while (stack.size() > 0)
+    {
+        SceneNode* node   = stack.getLast();
+        int32      parent = flat_parent_stack.getLast();
+        stack.removeLast();
+        flat_parent_stack.removeLast();
+
+        int32 index = flat_nodes.size();
+        flat_nodes.add( { node, parent, index + 1 } );
+
+        // push in reverse so that the first child is popped first
+        for (int i = node->get_num_children() - 1; i >= 0; i--)
+        {
+            stack.add( node->get_child_at( i ) );
+            flat_parent_stack.add( index );
+        }
+    }
+
+    // every node is placed before its descendants, so walk backward to
+    // accumulate subtree ranges to parents
+    for (int i = flat_nodes.size() - 1; i > 0; i--)
+    {
+        FlatNode& curr        = flat_nodes[i];
+        FlatNode& parent_node = flat_nodes[curr.parent];
+        if (parent_node.subtree_end < curr.subtree_end)
+            parent_node.subtree_end = curr.subtree_end;
+    }
+
+    flat_root    = root;
+    flat_version = root->get_hierarchy_version();
+}
+
+SceneQuery::SceneQuery(): m_impl( new Impl() )
 {
 }
 
 SceneQuery::~SceneQuery()
 {
+    if (m_impl)
+        delete m_impl;
+}
+
+void SceneQuery::set_flatten( bool value ) noexcept
+{
+    m_impl->flatten = value;
+
+    if (!value)
+    {
+        m_impl->flat_nodes.clear();
+        m_impl->flat_root = nullptr;
+    }
+}
+
+bool SceneQuery::get_flatten() const noexcept
+{
+    return m_impl->flatten;
 }
 
 treecore::Result SceneQuery::traverse(SceneNode* root) noexcept
@@ -22,7 +106,7 @@ treecore::Result SceneQuery::traverse(SceneNode* root) noexcept
     if (!begin_re)
         return begin_re;
 
-    Result node_re = recur_part(root);
+    Result node_re = m_impl->flatten ? traverse_flat( root ) : traverse_stack( root );
     if (!node_re)
         return node_re;
 
@@ -33,18 +117,49 @@ treecore::Result SceneQuery::traverse(SceneNode* root) noexcept
     return Result::ok();
 }
 
-treecore::Result SceneQuery::recur_part(SceneNode* node) noexcept
+treecore::Result SceneQuery::traverse_stack(SceneNode* root) noexcept
 {
-    Result one_node_re = traverse_one_node(node);
-    if (!one_node_re)
-        return one_node_re;
+    Array<SceneNode*>& stack = m_impl->stack;
+    stack.clearQuick();
+    stack.add( root );
 
-    for (int i = 0; i < node->get_num_children(); i++)
+    while (stack.size() > 0)
     {
-        SceneNode* child = node->get_child_at(i);
-        Result child_re = recur_part(child);
-        if (!child_re)
-            return child_re;
+        SceneNode* node = stack.getLast();
+        stack.removeLast();
+
+        bool   skip_children = false;
+        Result one_node_re   = traverse_one_node( node, skip_children );
+        if (!one_node_re)
+            return one_node_re;
+
+        if (skip_children)
+            continue;
+
+        // push in reverse so that the first child is visited first
+        for (int i = node->get_num_children() - 1; i >= 0; i--)
+            stack.add( node->get_child_at( i ) );
+    }
+
+    return Result::ok();
+}
+
+treecore::Result SceneQuery::traverse_flat(SceneNode* root) noexcept
+{
+    if (m_impl->flat_root.get() != root || m_impl->flat_version != root->get_hierarchy_version())
+        m_impl->build_flat( root );
+
+    const FlatNode* nodes = &m_impl->flat_nodes[0];
+    const int32     num   = m_impl->flat_nodes.size();
+
+    for (int32 i = 0; i < num; )
+    {
+        bool   skip_children = false;
+        Result one_node_re   = traverse_one_node( nodes[i].node, skip_children );
+        if (!one_node_re)
+            return one_node_re;
+
+        i = skip_children ? nodes[i].subtree_end : i + 1;
     }
 
     return Result::ok();
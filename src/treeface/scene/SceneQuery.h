@@ -13,6 +13,19 @@ class Result;
 namespace treeface {
 class SceneNode;
 
+/**
+ * @brief visit nodes of a scene tree in pre-order
+ *
+ * Traverse is done with an explicit stack, so that the depth of hierarchy is
+ * not limited by call stack size. Children of one node are visited in the
+ * same order as SceneNode::get_child_at().
+ *
+ * If flatten is enabled, the pre-order sequence of nodes is cached in an
+ * array, and later traverses on the same root iterate that array linearly.
+ * The array is rebuilt only when hierarchy under the root is modified.
+ *
+ * Hierarchy must not be modified during traverse.
+ */
 class SceneQuery: public treecore::RefCountObject
 {
 public:
@@ -24,13 +37,34 @@ public:
 
     treecore::Result traverse(SceneNode* root) noexcept;
 
+    /**
+     * @brief cache pre-order node sequence across traverses
+     *
+     * Disabling flatten releases cached sequence.
+     */
+    void set_flatten(bool value) noexcept;
+    bool get_flatten() const noexcept;
+
 protected:
     virtual treecore::Result traverse_begin() noexcept = 0;
-    virtual treecore::Result traverse_one_node(SceneNode* node) noexcept = 0;
+
+    /**
+     * @brief process one node
+     *
+     * @param node           the node being visited
+     * @param skip_children  false on entry. Set it to true to avoid visiting
+     *                       descendants of this node.
+     * @return failure result aborts the traverse
+     */
+    virtual treecore::Result traverse_one_node(SceneNode* node, bool& skip_children) noexcept = 0;
     virtual treecore::Result traverse_end() noexcept = 0;
 
 private:
-    treecore::Result recur_part(SceneNode* node) noexcept;
+    treecore::Result traverse_stack(SceneNode* root) noexcept;
+    treecore::Result traverse_flat(SceneNode* root) noexcept;
+
+    struct Impl;
+    Impl* m_impl = nullptr;
 };
 
 } // namespace treeface
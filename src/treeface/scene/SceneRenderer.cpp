@@ -1,100 +1,735 @@
 #include "treeface/scene/SceneRenderer.h"
 
-#include "treeface/gl/Program.h"
-#include "treeface/gl/VertexArray.h"
+#include "treeface/gl/GLStateCache.h"
+#include "treeface/math/Frustum.h"
 
+#include "treeface/misc/RadixSort.h"
 #include "treeface/misc/UniversalValue.h"
+#include "treeface/misc/WorkerPool.h"
 
 #include "treeface/scene/Geometry.h"
+#include "treeface/scene/GLRenderBackend.h"
+#include "treeface/scene/RenderCommand.h"
 #include "treeface/scene/SceneGraphMaterial.h"
 #include "treeface/scene/SceneNode.h"
 #include "treeface/scene/VisualObject.h"
 
-#include "treeface/scene/guts/Geometry_guts.h"
 #include "treeface/scene/guts/VisualObject_guts.h"
+#include "treeface/scene/guts/FrameBuilder.h"
 #include "treeface/scene/guts/Material_guts.h"
+#include "treeface/scene/guts/RenderItem.h"
 #include "treeface/scene/guts/SceneNode_guts.h"
 #include "treeface/scene/guts/Scene_guts.h"
-#include "treeface/scene/guts/Utils.h"
 
 #include <treecore/HashSet.h>
+#include <treecore/RefCountHolder.h>
 #include <treecore/HashMap.h>
-#include <treecore/HashMultiMap.h>
+#include <treecore/Logger.h>
 #include <treecore/Result.h>
 #include <treecore/ScopedPointer.h>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// runs shorter than this are drawn one by one
+#define INSTANCING_MIN_RUN 4
+
+// number of subtrees per worker thread on parallel rebuild
+#define SUBTREES_PER_WORKER 4
+
 using namespace treecore;
 
 namespace treeface {
 
-typedef HashMultiMap<VisualObject*, SceneNode*>         TransformedItems;
-typedef HashMap<SceneGraphMaterial*, TransformedItems*> SceneCollection;
+// shared by all renderers, so that stamps written by one renderer are never
+// mistaken by another
+static uint32 _last_cull_stamp_ = 0;
 
-struct RenderItem
+///
+/// \brief continuous items in frame order that share material, and are drawn
+///        in one instanced call or one by one
+///
+struct DrawRun
 {
-    SceneGraphMaterial* mat;
-    VisualObject*       vis_obj;
-    SceneNode* node;
+    int32 i_begin;
+    int32 num;
+    bool  instanced;
 };
 
-struct ItemCombinationSorter
+struct SceneRenderer::Impl
 {
-    int compareElements( RenderItem a, RenderItem b ) const noexcept
+    ///
+    /// \brief drop all items and IDs before full rebuild
+    ///
+    void reset_queue();
+
+    ///
+    /// \brief traverse and sort the whole scene with worker threads
+    ///
+    /// The tree is split into subtrees that are collected in parallel. Sort
+    /// keys are made in calling thread, as dense IDs are shared by all items.
+    /// Then items of each subtree are sorted and merged in parallel.
+    ///
+    void rebuild_parallel();
+
+    ///
+    /// \brief create render item with sort key
+    ///
+    RenderItem make_item( VisualObject* vis_obj, SceneNode* node );
+
+    ///
+    /// \brief find position of item in sorted queue
+    /// \return index of the item, or -1 if not found
+    ///
+    int find_sorted( const RenderItem& item ) const noexcept;
+
+    ///
+    /// \brief merge pending items into the sorted queue
+    ///
+    /// Pending items are radix sorted, then merged from queue tail, so the
+    /// cost is O(num_queue + num_pending).
+    ///
+    void merge_pending();
+
+    ///
+    /// \brief order items by view-space depth for current frame
+    ///
+    /// The retained queue is kept in depth-less order. Items that need depth
+    /// sorting are copied to frame_queue with depth-aware keys and sorted.
+    ///
+    /// \return number of items at the head of retained queue that are drawn
+    ///         before frame_queue
+    ///
+    int sort_by_depth( const Mat4f& matrix_view, DepthSortPolicy policy );
+
+    ///
+    /// \brief stamp nodes that intersect with view frustum
+    ///
+    /// Subtrees whose bounding box is outside of frustum are skipped as a
+    /// whole, and subtrees totally inside are stamped without further tests.
+    /// Nodes are visited with an explicit stack, so hierarchy depth is not
+    /// limited by call stack.
+    ///
+    void mark_visible( SceneNode* root, const Frustumf& frustum, bool inside );
+
+    bool is_visible( const RenderItem& item ) const noexcept
     {
-        // opaque items should go front
-        if ( a.mat->is_translucent() )
+        return !culling || item.node->m_impl->visible_stamp == cull_stamp;
+    }
+
+    ///
+    /// \brief get item by its position in current frame
+    ///
+    /// Items at retained queue head are drawn in their order, and the rest
+    /// are drawn in depth order.
+    ///
+    const RenderItem& get_frame_item( int i ) const noexcept
+    {
+        return i < num_static ? static_items[i] : frame_queue[i - num_static];
+    }
+
+    ///
+    /// \brief split items of current frame into runs
+    ///
+    /// \return number of items drawn one by one with uniform block material,
+    ///         which need per-object uniform block
+    ///
+    int plan_runs( int num_total );
+
+    ///
+    /// \brief translate runs into commands
+    ///
+    /// Per-object uniform blocks of all items that are not instanced are
+    /// listed in frame order, so that they can be uploaded at once.
+    ///
+    void build_commands( bool use_uniform_block, int num_object_block );
+
+    RenderBackend* get_backend();
+
+    void collect_node_items( SceneNode* node, Array<RenderItem>& result );
+    static void collect_visual_objects( SceneNode* subtree, Array<RenderItem>& result );
+    void collect_subtree_items( SceneNode* subtree, Array<RenderItem>& result );
+    static void collect_subtree_nodes( SceneNode* subtree, HashSet<SceneNode*>& result );
+
+    Array<RenderItem> combs;
+    Array<RenderItem> pending;
+    Array<RenderItem> frame_queue;
+    Array<RenderItem> static_visible;
+    Array<RenderItem> sort_buffer;
+    Array<DrawRun>    runs;
+    int num_static = 0;
+    const RenderItem* static_items = nullptr;
+
+    // frustum culling state of current frame
+    bool   culling    = false;
+    uint32 cull_stamp = 0;
+
+    // commands of current frame, and where they are executed
+    ScopedPointer<RenderCommandList> commands;
+    RefCountHolder<RenderBackend>    backend;
+
+    RefCountHolder<SceneNode> root;
+    bool need_rebuild = true;
+
+    // dense IDs used in sort keys, they are reset on full rebuild
+    HashMap<SceneGraphMaterial*, uint32> material_ids;
+    HashMap<Geometry*, uint32> geometry_ids;
+
+    // worker threads, and their state of parallel rebuild
+    ScopedPointer<WorkerPool> pool;
+    Array<SceneNode*> split_expanded;
+    Array<SceneNode*> split_roots;
+    Array<Array<RenderItem> > subtree_items;
+    Array<int32> segment_bounds;
+};
+
+template<typename T>
+uint32 _get_dense_id_( HashMap<T*, uint32>& store, T* obj )
+{
+    typename HashMap<T*, uint32>::Iterator it( store );
+    if ( store.select( obj, it ) )
+        return it.value();
+
+    uint32 id = uint32( store.size() );
+    store.set( obj, id );
+    return id;
+}
+
+void SceneRenderer::Impl::reset_queue()
+{
+    combs.clear();
+    pending.clear();
+    material_ids.clear();
+    geometry_ids.clear();
+}
+
+void SceneRenderer::Impl::rebuild_parallel()
+{
+    reset_queue();
+
+    split_subtrees( root, pool->get_num_threads() * SUBTREES_PER_WORKER, split_expanded, split_roots );
+
+    subtree_items.resize( split_roots.size() );
+    parallel_for( pool.get(), split_roots.size(), [this]( int i ) {
+        subtree_items[i].clearQuick();
+        collect_visual_objects( split_roots[i], subtree_items[i] );
+    } );
+
+    // items of each subtree become one segment
+    segment_bounds.clearQuick();
+    segment_bounds.add( 0 );
+
+    for (SceneNode* node : split_expanded)
+        collect_node_items( node, combs );
+
+    for (int i = 0; i < subtree_items.size(); i++)
+    {
+        if ( combs.size() > segment_bounds.getLast() )
+            segment_bounds.add( combs.size() );
+
+        for (const RenderItem& item : subtree_items[i])
+            combs.add( make_item( item.vis_obj, item.node ) );
+    }
+
+    if ( combs.size() > segment_bounds.getLast() || segment_bounds.size() == 1 )
+        segment_bounds.add( combs.size() );
+
+    sort_segments( pool.get(), combs, sort_buffer, segment_bounds );
+    need_rebuild = false;
+}
+
+RenderItem SceneRenderer::Impl::make_item( VisualObject* vis_obj, SceneNode* node )
+{
+    SceneGraphMaterial* mat = vis_obj->get_material();
+    treecore_assert( mat != nullptr );
+
+    uint32 mat_id  = _get_dense_id_( material_ids, mat );
+    uint32 geom_id = _get_dense_id_( geometry_ids, vis_obj->get_geometry() );
+    uint64 key     = make_render_key( mat->is_translucent(), mat_id, geom_id, 0 );
+
+    return { key, mat, vis_obj, node, mat_id, geom_id, 0.0f };
+}
+
+int SceneRenderer::Impl::find_sorted( const RenderItem& item ) const noexcept
+{
+    // find the first item whose key is not less than the target
+    int i_begin = 0;
+    int i_end   = combs.size();
+
+    while (i_begin < i_end)
+    {
+        int i_mid = (i_begin + i_end) / 2;
+
+        if (combs[i_mid].key < item.key)
+            i_begin = i_mid + 1;
+        else
+            i_end = i_mid;
+    }
+
+    // items with same key are not ordered
+    for (int i = i_begin; i < combs.size() && combs[i].key == item.key; i++)
+    {
+        if (combs[i].vis_obj == item.vis_obj && combs[i].node == item.node)
+            return i;
+    }
+
+    return -1;
+}
+
+void SceneRenderer::Impl::merge_pending()
+{
+    if (pending.size() == 0)
+        return;
+
+    radix_sort( pending, sort_buffer, RenderItemKeyGetter() );
+
+    int i_old = combs.size() - 1;
+    int i_new = pending.size() - 1;
+    int i_dst = combs.size() + pending.size() - 1;
+
+    combs.resize( combs.size() + pending.size() );
+
+    while (i_new >= 0)
+    {
+        if (i_old >= 0 && combs[i_old].key > pending[i_new].key)
+            combs[i_dst--] = combs[i_old--];
+        else
+            combs[i_dst--] = pending[i_new--];
+    }
+
+    pending.clear();
+}
+
+int SceneRenderer::Impl::sort_by_depth( const Mat4f& matrix_view, DepthSortPolicy policy )
+{
+    frame_queue.clearQuick();
+
+    if (policy == DEPTH_SORT_NONE)
+        return combs.size();
+
+    int i_begin = 0;
+
+    // translucent items are at queue tail, find the first one
+    if (policy == DEPTH_SORT_TRANSLUCENT)
+    {
+        int i_end = combs.size();
+        while (i_begin < i_end)
         {
-            if ( !b.mat->is_translucent() )
-                return 1;
+            int i_mid = (i_begin + i_end) / 2;
+            if ( render_key_is_translucent( combs[i_mid].key ) )
+                i_end = i_mid;
+            else
+                i_begin = i_mid + 1;
         }
-        else
+    }
+
+    if ( i_begin == combs.size() )
+        return i_begin;
+
+    // calculate depth of node origin, camera looks at negative Z
+    float depth_min = std::numeric_limits<float>::max();
+    float depth_max = std::numeric_limits<float>::lowest();
+
+    for (int i = i_begin; i < combs.size(); i++)
+    {
+        if ( !is_visible( combs[i] ) )
+            continue;
+
+        RenderItem item = combs[i];
+        Vec4f      pos  = matrix_view * Vec4f( item.node->get_global_transform().data[3] );
+        item.depth = -pos.get_z();
+
+        if (item.depth < depth_min) depth_min = item.depth;
+        if (item.depth > depth_max) depth_max = item.depth;
+
+        frame_queue.add( item );
+    }
+
+    // quantize depth into buckets over the range of current frame
+    float scale = depth_max > depth_min ? float(RENDER_KEY_DEPTH_MAX) / (depth_max - depth_min) : 0.0f;
+
+    for (int i = 0; i < frame_queue.size(); i++)
+    {
+        RenderItem& item   = frame_queue[i];
+        uint32      bucket = std::min( uint32( (item.depth - depth_min) * scale ), uint32( RENDER_KEY_DEPTH_MAX ) );
+        item.key = make_render_key( render_key_is_translucent( item.key ), item.mat_id, item.geom_id, bucket );
+    }
+
+    radix_sort( frame_queue, sort_buffer, RenderItemKeyGetter() );
+
+    return i_begin;
+}
+
+void SceneRenderer::Impl::mark_visible( SceneNode* root, const Frustumf& frustum, bool inside )
+{
+    // node and whether it is known to be totally inside
+    struct CullEntry
+    {
+        SceneNode* node;
+        bool       inside;
+    };
+
+    Array<CullEntry> stack;
+    stack.add( { root, inside } );
+
+    while (stack.size() > 0)
+    {
+        CullEntry entry = stack.getLast();
+        stack.removeLast();
+
+        if (!entry.inside)
         {
-            if ( b.mat->is_translucent() )
-                return -1;
+            BBox3f bound;
+            if ( entry.node->get_global_bounding_box( bound ) )
+            {
+                FrustumTestResult re = frustum.test( bound );
+                if (re == FRUSTUM_OUTSIDE)
+                    continue;
+                entry.inside = re == FRUSTUM_INSIDE;
+            }
         }
 
-        if (a.mat < b.mat)
-            return -1;
-        else if (a.mat > b.mat)
-            return 1;
+        entry.node->m_impl->visible_stamp = cull_stamp;
+
+        for (int i = entry.node->get_num_children() - 1; i >= 0; i--)
+            stack.add( { entry.node->get_child_at( i ), entry.inside } );
+    }
+}
+
+int SceneRenderer::Impl::plan_runs( int num_total )
+{
+    runs.clearQuick();
+    int num_object_block = 0;
+
+    for (int i = 0; i < num_total; )
+    {
+        const RenderItem&   run_head = get_frame_item( i );
+        SceneGraphMaterial* mat      = run_head.mat;
+        Geometry*           geom     = run_head.vis_obj->get_geometry();
+
+        // find following items that could be drawn together with instancing
+        // visual objects having their own uniforms can only be batched with
+        // themselves
+        int num_run = 1;
+        if ( mat->supports_instancing() )
+        {
+            bool head_has_uniform = run_head.vis_obj->m_impl->uniforms.size() > 0;
+
+            for (; i + num_run < num_total; num_run++)
+            {
+                const RenderItem& next = get_frame_item( i + num_run );
+
+                if (next.mat != mat || next.vis_obj->get_geometry() != geom)
+                    break;
 
-        if (a.vis_obj < b.vis_obj)
-            return -1;
-        else if (a.vis_obj > b.vis_obj)
-            return 1;
+                if ( next.vis_obj != run_head.vis_obj && ( head_has_uniform || next.vis_obj->m_impl->uniforms.size() > 0 ) )
+                    break;
+            }
+        }
 
-        if (a.node < b.node)
-            return -1;
-        else if (a.node > b.node)
-            return 1;
+        bool instanced = num_run >= INSTANCING_MIN_RUN;
+        if ( !instanced && mat->uses_uniform_block() )
+            num_object_block += num_run;
 
-        return 0;
+        runs.add( { i, num_run, instanced } );
+        i += num_run;
     }
-};
 
-struct SceneRenderer::Impl
+    return num_object_block;
+}
+
+void SceneRenderer::Impl::build_commands( bool use_uniform_block, int num_object_block )
 {
-    Array<RenderItem> combs;
-};
+    if (use_uniform_block)
+        commands->add( RENDER_COMMAND_FRAME_BLOCK );
+
+    // per-object blocks in same order as they are drawn
+    if (num_object_block > 0)
+    {
+        for (const DrawRun& run : runs)
+        {
+            if ( run.instanced || !get_frame_item( run.i_begin ).mat->uses_uniform_block() )
+                continue;
+
+            for (int i = run.i_begin; i < run.i_begin + run.num; i++)
+                commands->object_blocks.add( i );
+        }
+
+        treecore_assert( commands->object_blocks.size() == num_object_block );
+        commands->add( RENDER_COMMAND_OBJECT_BLOCKS );
+    }
+
+    SceneGraphMaterial* prev_mat       = nullptr;
+    bool                prev_instanced = false;
+    VisualObject*       prev_vis_obj   = nullptr;
+    int                 i_object_block = 0;
+
+    for (const DrawRun& run : runs)
+    {
+        const RenderItem&   run_head = get_frame_item( run.i_begin );
+        SceneGraphMaterial* mat      = run_head.mat;
+
+        if (mat != prev_mat || run.instanced != prev_instanced)
+        {
+            prev_mat       = mat;
+            prev_instanced = run.instanced;
+            prev_vis_obj   = nullptr;
+            commands->add( RENDER_COMMAND_BIND_MATERIAL, run.instanced ? 1 : 0, 0, mat );
+        }
+
+        if (run.instanced)
+        {
+            // instancing binds its own vertex array
+            commands->add( RENDER_COMMAND_DRAW_INSTANCED, run.i_begin, run.num, mat, run_head.vis_obj );
+            prev_vis_obj = nullptr;
+            continue;
+        }
+
+        for (int i = run.i_begin; i < run.i_begin + run.num; i++)
+        {
+            VisualObject* vis_obj = get_frame_item( i ).vis_obj;
+
+            if (vis_obj != prev_vis_obj)
+            {
+                prev_vis_obj = vis_obj;
+                commands->add( RENDER_COMMAND_BIND_OBJECT, 0, 0, mat, vis_obj );
+            }
+
+            if ( mat->uses_uniform_block() )
+                commands->add( RENDER_COMMAND_OBJECT_BLOCK, i_object_block++, 0, mat );
+            else
+                commands->add( RENDER_COMMAND_OBJECT_MATRICES, i, 0, mat );
+
+            commands->add( RENDER_COMMAND_DRAW, 0, 0, mat, vis_obj );
+        }
+    }
+
+    commands->add( RENDER_COMMAND_FINISH );
+}
+
+RenderBackend* SceneRenderer::Impl::get_backend()
+{
+    if (backend.get() == nullptr)
+        backend = new GLRenderBackend();
+    return backend.get();
+}
+
+void SceneRenderer::Impl::collect_node_items( SceneNode* node, Array<RenderItem>& result )
+{
+    treecore_assert( node != nullptr );
+    for (int i = 0; i < node->get_num_items(); i++)
+    {
+        VisualObject* vis_obj = dynamic_cast<VisualObject*>( node->get_item_at( i ) );
+        treecore_assert( vis_obj != nullptr );
+
+        if (!vis_obj)
+            continue;
+
+        result.add( make_item( vis_obj, node ) );
+    }
+}
+
+void SceneRenderer::Impl::collect_visual_objects( SceneNode* subtree, Array<RenderItem>& result )
+{
+    // only visual object and node are filled, as sort keys need dense IDs
+    Array<SceneNode*> stack;
+    stack.add( subtree );
+
+    while (stack.size() > 0)
+    {
+        SceneNode* node = stack.getLast();
+        stack.removeLast();
+
+        for (int i = 0; i < node->get_num_items(); i++)
+        {
+            VisualObject* vis_obj = dynamic_cast<VisualObject*>( node->get_item_at( i ) );
+            treecore_assert( vis_obj != nullptr );
+
+            if (vis_obj)
+                result.add( { 0, nullptr, vis_obj, node, 0, 0, 0.0f } );
+        }
+
+        for (int i = node->get_num_children() - 1; i >= 0; i--)
+            stack.add( node->get_child_at( i ) );
+    }
+}
+
+void SceneRenderer::Impl::collect_subtree_items( SceneNode* subtree, Array<RenderItem>& result )
+{
+    collect_node_items( subtree, result );
+    for (int i = 0; i < subtree->get_num_children(); i++)
+        collect_subtree_items( subtree->get_child_at( i ), result );
+}
+
+void SceneRenderer::Impl::collect_subtree_nodes( SceneNode* subtree, HashSet<SceneNode*>& result )
+{
+    result.insert( subtree );
+    for (int i = 0; i < subtree->get_num_children(); i++)
+        collect_subtree_nodes( subtree->get_child_at( i ), result );
+}
 
 SceneRenderer::SceneRenderer()
     : m_impl( new Impl() )
-{}
+{
+    m_impl->commands = new RenderCommandList();
+}
 
 SceneRenderer::~SceneRenderer()
 {
     if (m_impl)
+    {
+        set_root( nullptr );
         delete m_impl;
+    }
+}
+
+void SceneRenderer::set_num_workers( int num )
+{
+    if (num < 2)
+        m_impl->pool = nullptr;
+    else if ( m_impl->pool == nullptr || m_impl->pool->get_num_threads() != num )
+        m_impl->pool = new WorkerPool( num );
+}
+
+int SceneRenderer::get_num_workers() const noexcept
+{
+    return m_impl->pool != nullptr ? m_impl->pool->get_num_threads() : 1;
+}
+
+void SceneRenderer::set_root( SceneNode* root )
+{
+    SceneNode* old_root = m_impl->root;
+    if (old_root == root)
+        return;
+
+    if (old_root != nullptr)
+        old_root->m_impl->renderers.removeFirstMatchingValue( this );
+
+    m_impl->root = root;
+    m_impl->need_rebuild = true;
+    m_impl->combs.clear();
+    m_impl->pending.clear();
+
+    if (root != nullptr)
+        root->m_impl->renderers.add( this );
+}
+
+void SceneRenderer::item_attached( SceneNode* node, SceneObject* obj )
+{
+    if (m_impl->need_rebuild)
+        return;
+
+    VisualObject* vis_obj = dynamic_cast<VisualObject*>( obj );
+    if (!vis_obj)
+        return;
+
+    m_impl->pending.add( m_impl->make_item( vis_obj, node ) );
+}
+
+void SceneRenderer::item_detached( SceneNode* node, SceneObject* obj )
+{
+    if (m_impl->need_rebuild)
+        return;
+
+    VisualObject* vis_obj = dynamic_cast<VisualObject*>( obj );
+    if (!vis_obj)
+        return;
+
+    RenderItem item = m_impl->make_item( vis_obj, node );
+
+    int i_item = m_impl->find_sorted( item );
+    if (i_item >= 0)
+    {
+        m_impl->combs.remove( i_item );
+        return;
+    }
+
+    // item is added after last render
+    for (int i = 0; i < m_impl->pending.size(); i++)
+    {
+        if (m_impl->pending[i].vis_obj == vis_obj && m_impl->pending[i].node == node)
+        {
+            m_impl->pending.remove( i );
+            return;
+        }
+    }
+
+    // sort key is outdated if geometry or material is changed without
+    // notification, so search retained queue by content
+    for (int i = 0; i < m_impl->combs.size(); i++)
+    {
+        if (m_impl->combs[i].vis_obj == vis_obj && m_impl->combs[i].node == node)
+        {
+            m_impl->combs.remove( i );
+            return;
+        }
+    }
+
+    // unknown item, never keep a queue that may have stale pointers
+    TREECORE_DBG( "detached item is not in render queue, rebuild queue" );
+    m_impl->need_rebuild = true;
+}
+
+void SceneRenderer::subtree_attached( SceneNode* subtree )
+{
+    if (m_impl->need_rebuild)
+        return;
+
+    m_impl->collect_subtree_items( subtree, m_impl->pending );
+}
+
+void SceneRenderer::subtree_detached( SceneNode* subtree )
+{
+    if (m_impl->need_rebuild)
+        return;
+
+    HashSet<SceneNode*> removed_nodes;
+    Impl::collect_subtree_nodes( subtree, removed_nodes );
+
+    // remove all items belong to removed nodes with one linear pass, which
+    // keeps the order of remaining items
+    Array<RenderItem>* queues[2] = { &m_impl->combs, &m_impl->pending };
+    for (Array<RenderItem>* queue : queues)
+    {
+        int i_dst = 0;
+        for (int i_src = 0; i_src < queue->size(); i_src++)
+        {
+            if ( removed_nodes.contains( (*queue)[i_src].node ) )
+                continue;
+            if (i_dst != i_src)
+                (*queue)[i_dst] = (*queue)[i_src];
+            i_dst++;
+        }
+        queue->resize( i_dst );
+    }
+}
+
+void SceneRenderer::root_lost() noexcept
+{
+    // the node we are rendering is now a part of another tree, and we won't
+    // get notified on its modification
+    m_impl->need_rebuild = true;
 }
 
 void SceneRenderer::render( const Mat4f& matrix_proj,
                             const Mat4f& matrix_view,
                             Scene* scene )
 {
-    traverse( scene->m_guts->root_node );
+    // binding stats are counted per frame
+    GLStateCache::current().reset_stats();
 
-    ItemCombinationSorter sorter;
-    m_impl->combs.sort( sorter );
+    set_root( scene->m_guts->root_node );
+
+    if (m_impl->need_rebuild)
+    {
+        if (m_impl->pool != nullptr)
+            m_impl->rebuild_parallel();
+        else
+            traverse( m_impl->root );
+    }
+    else
+        m_impl->merge_pending();
 
     // upload geometry data
     {
@@ -105,106 +740,115 @@ void SceneRenderer::render( const Mat4f& matrix_proj,
             if ( geom->is_dirty() ) dirty_geoms.insert( geom );
         }
 
+        RenderBackend* backend = m_impl->get_backend();
         HashSet<Geometry*>::Iterator i_dirty( dirty_geoms );
         while ( i_dirty.next() )
-        {
-            i_dirty.content()->get_vertex_buffer()->bind();
-            i_dirty.content()->get_index_buffer()->bind();
-            i_dirty.content()->upload_data();
-            i_dirty.content()->get_vertex_buffer()->unbind();
-            i_dirty.content()->get_index_buffer()->unbind();
-        }
+            backend->upload_geometry( i_dirty.content() );
     }
 
+    // update all modified global transforms in one pass, before they are
+    // used by culling, sorting and uniforms
+    m_impl->root->update_global_transforms();
+
     // light direction in model-view coordinate
     Vec4f light_direct_in_view = matrix_view * scene->get_global_light_direction();
 
-    // traverse scene items
-    SceneGraphMaterial* prev_mat     = nullptr;
-    VisualObject*       prev_vis_obj = nullptr;
-
-    for (int i = 0; i < m_impl->combs.size(); i++)
+    // find visible nodes, bounding boxes are ready as geometries are uploaded
+    m_impl->culling = scene->m_guts->frustum_culling;
+    if (m_impl->culling)
     {
-        RenderItem curr_render        = m_impl->combs[i];
-        Program*   prog               = curr_render.mat->get_program();
-        bool       upload_obj_uniform = false;
+        m_impl->cull_stamp = ++_last_cull_stamp_;
+        if (m_impl->cull_stamp == 0)
+            m_impl->cull_stamp = ++_last_cull_stamp_;
 
-        if (curr_render.mat != prev_mat)
-        {
-            upload_obj_uniform = true;
-            prev_mat = curr_render.mat;
-            curr_render.mat->bind();
-
-            prog->set_uniform( curr_render.mat->m_uni_proj,          matrix_proj );
-            prog->set_uniform( curr_render.mat->m_uni_light_direct,  light_direct_in_view );
-            prog->set_uniform( curr_render.mat->m_uni_light_color,   scene->get_global_light_color() );
-            prog->set_uniform( curr_render.mat->m_uni_light_ambient, scene->get_global_light_ambient() );
-        }
+        m_impl->mark_visible( m_impl->root, Frustumf( matrix_proj * matrix_view ), false );
+    }
+
+    // items at retained queue head are drawn in their order, and the rest are
+    // drawn in depth order
+    int num_static = m_impl->sort_by_depth( matrix_view, scene->m_guts->depth_sort );
 
-        if (curr_render.vis_obj != prev_vis_obj)
+    if (m_impl->culling)
+    {
+        m_impl->static_visible.clearQuick();
+        for (int i = 0; i < num_static; i++)
         {
-            upload_obj_uniform = true;
-            prev_vis_obj       = curr_render.vis_obj;
-            curr_render.vis_obj->get_vertex_array()->bind();
+            if ( m_impl->is_visible( m_impl->combs[i] ) )
+                m_impl->static_visible.add( m_impl->combs[i] );
         }
 
-        // update geometry and visual obj's uniforms to current program
-        if (upload_obj_uniform)
-        {
-            if (curr_render.vis_obj->m_impl->uniform_cache_dirty)
-                curr_render.vis_obj->m_impl->update_uniform_cache();
+        m_impl->num_static   = m_impl->static_visible.size();
+        m_impl->static_items = m_impl->num_static > 0 ? &m_impl->static_visible[0] : nullptr;
+    }
+    else
+    {
+        m_impl->num_static   = num_static;
+        m_impl->static_items = num_static > 0 ? &m_impl->combs[0] : nullptr;
+    }
 
-            for (int i_uni = 0; i_uni < curr_render.vis_obj->m_impl->cached_uniforms.size(); i_uni++)
-            {
-                const UniformKV& kv = curr_render.vis_obj->m_impl->cached_uniforms[i_uni];
-                prog->set_uniform( kv.first, kv.second );
-            }
-        }
+    const int num_total = m_impl->num_static + m_impl->frame_queue.size();
 
-        // set current node's transformation and uniforms
-        const Mat4f& mat_model = curr_render.node->get_global_transform();
-        const Mat4f  mat_model_view      = matrix_view * mat_model;
-        const Mat4f  mat_model_view_proj = matrix_proj * mat_model_view;
+    const int num_object_block = m_impl->plan_runs( num_total );
 
-        prog->set_uniform( curr_render.mat->m_uni_model_view,      mat_model_view );
-        prog->set_uniform( curr_render.mat->m_uni_model_view_proj, mat_model_view_proj );
-        prog->set_uniform( curr_render.mat->m_uni_norm,            mat_model_view.get_normal_matrix() );
+    RenderCommandList& commands = *m_impl->commands;
+    commands.clear();
+    commands.matrix_proj   = matrix_proj;
+    commands.matrix_view   = matrix_view;
+    commands.light_direct  = light_direct_in_view;
+    commands.light_color   = scene->get_global_light_color();
+    commands.light_ambient = scene->get_global_light_ambient();
 
-        // do draw
-        curr_render.vis_obj->render();
+    // matrices of all drawn items, so that commands only refer to them
+    commands.matrices.resize( num_total );
+    if (num_total > 0)
+    {
+        const int num_frame_queue = m_impl->frame_queue.size();
+        compute_item_matrices( m_impl->pool.get(),
+                               m_impl->static_items, m_impl->num_static,
+                               num_frame_queue > 0 ? &m_impl->frame_queue[0] : nullptr, num_frame_queue,
+                               matrix_proj, matrix_view, &commands.matrices[0] );
     }
 
-    VertexArray::unbind();
-    prev_mat->unbind();
+    // scene uniform blocks are only created when they are used
+    bool use_uniform_block = num_object_block > 0;
+    for (int i = 0; !use_uniform_block && i < m_impl->runs.size(); i++)
+        use_uniform_block = m_impl->get_frame_item( m_impl->runs[i].i_begin ).mat->uses_uniform_block();
+
+    m_impl->build_commands( use_uniform_block, num_object_block );
+    m_impl->get_backend()->execute( commands );
 }
 
-treecore::Result SceneRenderer::traverse_begin() noexcept
+void SceneRenderer::set_backend( RenderBackend* backend )
 {
-    m_impl->combs.clear();
-    return Result::ok();
+    m_impl->backend = backend;
 }
 
-treecore::Result SceneRenderer::traverse_one_node( SceneNode* node ) noexcept
+RenderBackend* SceneRenderer::get_backend() noexcept
 {
-    treecore_assert( node != nullptr );
-    for (int i = 0; i < node->get_num_items(); i++)
-    {
-        VisualObject* vis_obj = dynamic_cast<VisualObject*>( node->get_item_at( i ) );
-        treecore_assert( vis_obj != nullptr );
+    return m_impl->get_backend();
+}
 
-        if (!vis_obj)
-            continue;
+const RenderCommandList& SceneRenderer::get_commands() const noexcept
+{
+    return *m_impl->commands;
+}
 
-        SceneGraphMaterial* mat = vis_obj->get_material();
-        treecore_assert( mat != nullptr );
+treecore::Result SceneRenderer::traverse_begin() noexcept
+{
+    m_impl->reset_queue();
+    return Result::ok();
+}
 
-        m_impl->combs.add( { mat, vis_obj, node } );
-    }
+treecore::Result SceneRenderer::traverse_one_node( SceneNode* node, bool& skip_children ) noexcept
+{
+    m_impl->collect_node_items( node, m_impl->combs );
     return Result::ok();
 }
 
 treecore::Result SceneRenderer::traverse_end() noexcept
 {
+    radix_sort( m_impl->combs, m_impl->sort_buffer, RenderItemKeyGetter() );
+    m_impl->need_rebuild = false;
     return Result::ok();
 }
 
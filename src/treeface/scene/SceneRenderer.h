@@ -7,10 +7,28 @@
 
 namespace treeface {
 
+class RenderBackend;
 class Scene;
+class SceneObject;
+struct RenderCommandList;
 
+/**
+ * @brief draw all visual objects in a scene
+ *
+ * The renderer retains a sorted queue of render items across frames. It
+ * registers itself to the root node of the scene being rendered, and
+ * hierarchy modifications (SceneNode::add_child, remove_child, add_item,
+ * remove_item) under that root are reported to it, so that the queue is
+ * patched in place. A full traverse and sort only happens when the renderer
+ * is switched to another scene.
+ *
+ * The renderer itself makes no GL call. Each frame is built into a list of
+ * plain commands, which is executed by a RenderBackend.
+ */
 class SceneRenderer: public SceneQuery
 {
+    friend class SceneNode;
+
 public:
     SceneRenderer();
     virtual ~SceneRenderer();
@@ -22,12 +40,49 @@ public:
                 const Mat4f& matrix_view,
                 Scene* scene);
 
+    /**
+     * @brief set number of threads that prepare frames
+     *
+     * Full traverse and sort of the scene, and matrices of all drawn items
+     * are computed by worker threads, so that the calling thread is left
+     * with GL calls only. Thread count includes the calling thread, and
+     * values less than 2 do all work in the calling thread, which is the
+     * default.
+     */
+    void set_num_workers( int num );
+
+    int get_num_workers() const noexcept;
+
+    /**
+     * @brief set backend that executes commands of each frame
+     *
+     * The backend is held by renderer. A GLRenderBackend is created on first
+     * use if no backend is set.
+     */
+    void set_backend( RenderBackend* backend );
+
+    RenderBackend* get_backend() noexcept;
+
+    /**
+     * @brief commands of the last rendered frame
+     */
+    const RenderCommandList& get_commands() const noexcept;
+
 protected:
     virtual treecore::Result traverse_begin() noexcept;
-    virtual treecore::Result traverse_one_node(SceneNode* node) noexcept;
+    virtual treecore::Result traverse_one_node(SceneNode* node, bool& skip_children) noexcept;
     virtual treecore::Result traverse_end() noexcept;
 
 private:
+    void set_root( SceneNode* root );
+
+    // called by SceneNode on hierarchy modification
+    void item_attached( SceneNode* node, SceneObject* obj );
+    void item_detached( SceneNode* node, SceneObject* obj );
+    void subtree_attached( SceneNode* subtree );
+    void subtree_detached( SceneNode* subtree );
+    void root_lost() noexcept;
+
     struct Impl;
     Impl* m_impl = nullptr;
 };
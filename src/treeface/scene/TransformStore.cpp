@@ -0,0 +1,203 @@
+#include "treeface/scene/TransformStore.h"
+
+#include "treeface/scene/SceneNode.h"
+#include "treeface/scene/guts/SceneNode_guts.h"
+
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
+
+#include <cstring>
+
+using namespace treecore;
+
+namespace treeface {
+
+struct TransformStore::Impl
+{
+    TransformStore* host = nullptr;
+    RefCountHolder<SceneNode> root;
+
+    // per-node data in pre-order
+    Array<Mat4f, 16>  local;
+    Array<Mat4f, 16>  global;
+    Array<int32>      parent;
+    Array<uint8>      dirty;
+    Array<SceneNode*> nodes;
+
+    // global matrix is changed since node calculated its inverse
+    Array<uint8> inv_dirty;
+
+    // index of the first dirty node, or number of nodes if nothing is dirty
+    int32  first_dirty   = 0;
+    uint32 built_version = 0;
+
+    // temporary stacks for pre-order walk
+    Array<SceneNode*> stack;
+    Array<int32>      parent_stack;
+
+    void rebuild() noexcept;
+    void unbind_all() noexcept;
+};
+
+void TransformStore::Impl::unbind_all() noexcept
+{
+    stack.clearQuick();
+    stack.add( root.get() );
+
+    while (stack.size() > 0)
+    {
+        SceneNode* node = stack.getLast();
+        stack.removeLast();
+
+        node->m_impl->transform_store = nullptr;
+        node->m_impl->transform_index = -1;
+
+        for (int i = 0; i < node->m_impl->child_nodes.size(); i++)
+            stack.add( node->m_impl->child_nodes[i] );
+    }
+}
+
+void TransformStore::Impl::rebuild() noexcept
+{
+    local.clearQuick();
+    global.clearQuick();
+    parent.clearQuick();
+    dirty.clearQuick();
+    inv_dirty.clearQuick();
+    nodes.clearQuick();
+
+    stack.clearQuick();
+    parent_stack.clearQuick();
+    stack.add( root.get() );
+    parent_stack.add( -1 );
+
+    while (stack.size() > 0)
+    {
+        SceneNode* node     = stack.getLast();
+        int32      i_parent = parent_stack.getLast();
+        stack.removeLast();
+        parent_stack.removeLast();
+
+        SceneNode::Guts* guts  = node->m_impl;
+        int32            index = nodes.size();
+        guts->transform_store = host;
+        guts->transform_index = index;
+
+        nodes.add( node );
+        parent.add( i_parent );
+        local.add( guts->trans );
+        global.add( guts->trans );
+        dirty.add( 1 );
+        inv_dirty.add( 1 );
+
+        for (int i = guts->child_nodes.size() - 1; i >= 0; i--)
+        {
+            stack.add( guts->child_nodes[i] );
+            parent_stack.add( index );
+        }
+    }
+
+    first_dirty   = 0;
+    built_version = root->get_hierarchy_version();
+}
+
+TransformStore::TransformStore( SceneNode* root ): m_impl( new Impl() )
+{
+    m_impl->host = this;
+    m_impl->root = root;
+    m_impl->rebuild();
+    update();
+}
+
+TransformStore::~TransformStore()
+{
+    if (m_impl)
+    {
+        m_impl->unbind_all();
+
+        // nodes need to calculate global transforms by themselves
+        m_impl->root->m_impl->invalidate_global_descendent();
+        m_impl->root->m_impl->mark_global_dirty_ancestor();
+        delete m_impl;
+    }
+}
+
+SceneNode* TransformStore::get_root() noexcept
+{
+    return m_impl->root.get();
+}
+
+int32 TransformStore::get_num_nodes() const noexcept
+{
+    return m_impl->nodes.size();
+}
+
+void TransformStore::update() noexcept
+{
+    if (m_impl->built_version != m_impl->root->get_hierarchy_version())
+        m_impl->rebuild();
+
+    const int32 num = m_impl->nodes.size();
+    if (m_impl->first_dirty >= num)
+        return;
+
+    const int32* parent    = &m_impl->parent[0];
+    const Mat4f* local     = &m_impl->local[0];
+    Mat4f*       global    = &m_impl->global[0];
+    uint8*       dirty     = &m_impl->dirty[0];
+    uint8*       inv_dirty = &m_impl->inv_dirty[0];
+
+    // parent is always placed before children, so dirtiness is propagated
+    // and global matrices are calculated in one forward pass. Nodes are not
+    // touched, they pick up changes from the arrays when read
+    for (int32 i = m_impl->first_dirty; i < num; i++)
+    {
+        const int32 i_parent = parent[i];
+
+        if (i_parent >= 0)
+        {
+            dirty[i] |= dirty[i_parent];
+            if (!dirty[i])
+                continue;
+            global[i] = global[i_parent] * local[i];
+        }
+        else
+        {
+            if (!dirty[i])
+                continue;
+            global[i] = local[i];
+        }
+
+        inv_dirty[i] = 1;
+    }
+
+    std::memset( dirty + m_impl->first_dirty, 0, num - m_impl->first_dirty );
+    m_impl->first_dirty = num;
+}
+
+void TransformStore::local_changed( int32 index, const Mat4f& value ) noexcept
+{
+    // index is outdated if hierarchy is modified, and the whole store will
+    // be rebuilt anyway
+    if ( index < 0 || index >= m_impl->nodes.size() )
+        return;
+
+    m_impl->local[index] = value;
+    m_impl->dirty[index] = 1;
+    if (index < m_impl->first_dirty)
+        m_impl->first_dirty = index;
+}
+
+const Mat4f& TransformStore::get_global( int32 index ) const noexcept
+{
+    return m_impl->global[index];
+}
+
+bool TransformStore::take_global_inv_dirty( int32 index ) noexcept
+{
+    bool re = m_impl->inv_dirty[index] != 0;
+    m_impl->inv_dirty[index] = 0;
+    return re;
+}
+
+} // namespace treeface
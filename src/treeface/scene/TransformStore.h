@@ -0,0 +1,77 @@
+#ifndef TREEFACE_TRANSFORM_STORE_H
+#define TREEFACE_TRANSFORM_STORE_H
+
+#include "treeface/base/Common.h"
+
+#include "treeface/math/Mat4.h"
+
+#include <treecore/ClassUtils.h>
+#include <treecore/RefCountObject.h>
+
+namespace treeface {
+
+class SceneNode;
+
+/**
+ * @brief contiguous storage of node transforms in a scene hierarchy
+ *
+ * Local matrices, global matrices and parent indices of all nodes under a
+ * root are stored in arrays in pre-order, so that a parent is always placed
+ * before its children. Nodes in the hierarchy become handles into these
+ * arrays: SceneNode::set_transform() writes to the store, and
+ * SceneNode::get_global_transform() reads from it. Updating global matrices
+ * is a linear pass over the arrays starting from the first modified node,
+ * and dirty flags are also kept in the arrays, so the pass doesn't touch
+ * nodes.
+ *
+ * Global matrices are only updated by update(), which is called once per
+ * frame by SceneRenderer through SceneNode::update_global_transforms(). Node
+ * getters only read the store, so they return values as of last update.
+ *
+ * The arrays are rebuilt when hierarchy under the root is modified. Nodes
+ * removed from the hierarchy are detached from the store immediately and
+ * fall back to the per-node transform update.
+ *
+ * The root node is treated as having no parent.
+ */
+class TransformStore: public treecore::RefCountObject
+{
+    friend class SceneNode;
+
+public:
+    TransformStore( SceneNode* root );
+
+    TREECORE_DECLARE_NON_COPYABLE( TransformStore )
+    TREECORE_DECLARE_NON_MOVABLE( TransformStore )
+
+    virtual ~TransformStore();
+
+    SceneNode* get_root() noexcept;
+
+    /**
+     * @brief number of nodes in store, which may be outdated until update()
+     *        is called
+     */
+    treecore::int32 get_num_nodes() const noexcept;
+
+    /**
+     * @brief rebuild arrays if hierarchy is modified, and update global
+     *        matrices of all modified nodes
+     */
+    void update() noexcept;
+
+private:
+    void local_changed( treecore::int32 index, const Mat4f& value ) noexcept;
+
+    const Mat4f& get_global( treecore::int32 index ) const noexcept;
+
+    // whether global matrix is changed since last call for this node
+    bool take_global_inv_dirty( treecore::int32 index ) noexcept;
+
+    struct Impl;
+    Impl* m_impl = nullptr;
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_TRANSFORM_STORE_H
@@ -18,7 +18,9 @@ using namespace treecore;
 namespace treeface {
 
 VisualObject::VisualObject( Geometry* geom, SceneGraphMaterial* mat ): m_impl( new Impl( geom, mat ) )
-{}
+{
+    m_impl->host = this;
+}
 
 VisualObject::~VisualObject()
 {
@@ -69,7 +71,7 @@ VertexArray* VisualObject::get_vertex_array() const noexcept
 void VisualObject::render() noexcept
 {
     treecore_assert( !m_impl->geometry->is_dirty() );
-    m_impl->vertex_array->draw( m_impl->geometry->get_primitive(), m_impl->geometry->get_num_index() );
+    m_impl->vertex_array->draw( m_impl->geometry->get_primitive(), m_impl->geometry->get_num_index(), m_impl->geometry->get_index_type() );
 }
 
 } // namespace treeface
@@ -25,6 +25,7 @@ class VisualObject: public SceneObject
 {
     friend class ::TestFramework;
     friend class SceneRenderer;
+    friend class GLRenderBackend;
     friend class Geometry;
 
 public:
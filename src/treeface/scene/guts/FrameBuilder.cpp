@@ -0,0 +1,140 @@
+#include "treeface/scene/guts/FrameBuilder.h"
+
+#include "treeface/misc/RadixSort.h"
+#include "treeface/misc/WorkerPool.h"
+#include "treeface/scene/SceneNode.h"
+
+#include <algorithm>
+
+// matrix calculation of fewer items is not worth a task
+#define MATRIX_CHUNK_MIN 64
+
+// subtree split stops at this depth even if there are not enough subtrees
+#define SPLIT_DEPTH_MAX 8
+
+using namespace treecore;
+
+namespace treeface
+{
+
+void compute_item_matrices( WorkerPool* pool,
+                            const RenderItem* items_a, int num_a,
+                            const RenderItem* items_b, int num_b,
+                            const Mat4f& matrix_proj, const Mat4f& matrix_view,
+                            ItemMatrices* result )
+{
+    parallel_for_range( pool, num_a + num_b, MATRIX_CHUNK_MIN, [&]( int i_begin, int i_end ) {
+        for (int i = i_begin; i < i_end; i++)
+        {
+            const RenderItem& item = i < num_a ? items_a[i] : items_b[i - num_a];
+            ItemMatrices&     dst  = result[i];
+
+            dst.model_view      = matrix_view * item.node->get_global_transform();
+            dst.model_view_proj = matrix_proj * dst.model_view;
+            dst.normal          = dst.model_view.get_normal_matrix();
+        }
+    } );
+}
+
+void split_subtrees( SceneNode* root, int num_wanted, Array<SceneNode*>& expanded, Array<SceneNode*>& subtrees )
+{
+    expanded.clearQuick();
+    subtrees.clearQuick();
+    subtrees.add( root );
+
+    Array<SceneNode*> next;
+
+    for (int depth = 0; depth < SPLIT_DEPTH_MAX && subtrees.size() < num_wanted; depth++)
+    {
+        next.clearQuick();
+        bool any_expanded = false;
+
+        for (SceneNode* node : subtrees)
+        {
+            int num_child = node->get_num_children();
+            if (num_child == 0)
+            {
+                next.add( node );
+                continue;
+            }
+
+            any_expanded = true;
+            expanded.add( node );
+            for (int i = 0; i < num_child; i++)
+                next.add( node->get_child_at( i ) );
+        }
+
+        if (!any_expanded)
+            break;
+
+        subtrees.swapWith( next );
+    }
+}
+
+struct _KeyLess_
+{
+    bool operator ()( const RenderItem& a, const RenderItem& b ) const noexcept
+    {
+        return a.key < b.key;
+    }
+};
+
+void sort_segments( WorkerPool* pool, Array<RenderItem>& data, Array<RenderItem>& buffer, const Array<int32>& bounds )
+{
+    const int num = data.size();
+    buffer.resize( num );
+    if (num < 2)
+        return;
+
+    RenderItem* src = &data[0];
+    RenderItem* dst = &buffer[0];
+
+    // sort each segment
+    const int num_seg = bounds.size() - 1;
+    parallel_for( pool, num_seg, [&]( int i_seg ) {
+        int i_begin = bounds[i_seg];
+        int i_end   = bounds[i_seg + 1];
+        radix_sort( src + i_begin, dst + i_begin, size_t( i_end - i_begin ), RenderItemKeyGetter() );
+    } );
+
+    // merge adjacent segments until there is only one
+    Array<int32> curr_bounds( bounds );
+    Array<int32> next_bounds;
+
+    while (curr_bounds.size() > 2)
+    {
+        const int num_curr = curr_bounds.size() - 1;
+        const int num_pair = (num_curr + 1) / 2;
+
+        parallel_for( pool, num_pair, [&]( int i_pair ) {
+            int i_left  = i_pair * 2;
+            int i_begin = curr_bounds[i_left];
+
+            if (i_left + 1 == num_curr)
+            {
+                // the odd one is copied
+                int i_end = curr_bounds[i_left + 1];
+                std::copy( src + i_begin, src + i_end, dst + i_begin );
+            }
+            else
+            {
+                int i_mid = curr_bounds[i_left + 1];
+                int i_end = curr_bounds[i_left + 2];
+                std::merge( src + i_begin, src + i_mid, src + i_mid, src + i_end, dst + i_begin, _KeyLess_() );
+            }
+        } );
+
+        next_bounds.clearQuick();
+        for (int i = 0; i < num_curr; i += 2)
+            next_bounds.add( curr_bounds[i] );
+        next_bounds.add( num );
+
+        curr_bounds.swapWith( next_bounds );
+        std::swap( src, dst );
+    }
+
+    if ( src != &data[0] )
+        std::copy( src, src + num, &data[0] );
+}
+
+} // namespace treeface
@@ -0,0 +1,68 @@
+#ifndef TREEFACE_SCENE_FRAME_BUILDER_H
+#define TREEFACE_SCENE_FRAME_BUILDER_H
+
+#include "treeface/math/Mat4.h"
+#include "treeface/scene/RenderCommand.h"
+#include "treeface/scene/guts/RenderItem.h"
+
+#include <treecore/Array.h>
+
+//
+// CPU side work of building one frame, which can be split among worker
+// threads. None of these touches GL.
+//
+
+namespace treeface
+{
+
+class SceneNode;
+class WorkerPool;
+
+///
+/// \brief calculate matrices for items of current frame
+///
+/// Items are given in two parts, which are treated as one sequence. Global
+/// transforms of all nodes must be up to date, so that they are only read.
+///
+/// \param pool    worker pool, or nullptr to run in calling thread
+/// \param result  at least num_a + num_b elements
+///
+void compute_item_matrices( WorkerPool* pool,
+                            const RenderItem* items_a, int num_a,
+                            const RenderItem* items_b, int num_b,
+                            const Mat4f& matrix_proj, const Mat4f& matrix_view,
+                            ItemMatrices* result );
+
+///
+/// \brief split a tree into disjoint subtrees that can be visited in parallel
+///
+/// Starting from root, nodes are expanded level by level until there are
+/// enough subtrees. Expanded nodes are not included by any subtree, and
+/// should be visited separately.
+///
+/// \param num_wanted  expected number of subtrees
+/// \param expanded    nodes whose children are split
+/// \param subtrees    roots of subtrees
+///
+void split_subtrees( SceneNode* root, int num_wanted,
+                     treecore::Array<SceneNode*>& expanded,
+                     treecore::Array<SceneNode*>& subtrees );
+
+///
+/// \brief sort segments of items in parallel, then merge them
+///
+/// Segments are sorted with radix sort, and adjacent segments are merged in
+/// pairs in parallel. Items with equal key keep the order of their segments.
+///
+/// \param data    items to be sorted
+/// \param buffer  scratch array, resized to the size of data
+/// \param bounds  begin of each segment followed by size of data
+///
+void sort_segments( WorkerPool* pool,
+                    treecore::Array<RenderItem>& data,
+                    treecore::Array<RenderItem>& buffer,
+                    const treecore::Array<treecore::int32>& bounds );
+
+} // namespace treeface
+
+#endif // TREEFACE_SCENE_FRAME_BUILDER_H
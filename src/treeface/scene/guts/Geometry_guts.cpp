@@ -1,20 +1,23 @@
 #include "treeface/scene/guts/Geometry_guts.h"
 
-#include <treecore/ArrayRef.h>
+#include <algorithm>
 
 using namespace treecore;
 
 namespace treeface
 {
 
-Geometry::Guts::Guts( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic )
+Geometry::Guts::Guts( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic, GLType index_type )
     : vtx_temp( vtx_temp )
     , primitive( primitive )
+    , index_type( index_type )
     , dynamic( is_dynamic )
     , buf_vtx( new GLBuffer( TFGL_BUFFER_VERTEX, is_dynamic ? TFGL_BUFFER_DYNAMIC_DRAW : TFGL_BUFFER_STATIC_DRAW ) )
     , buf_idx( new GLBuffer( TFGL_BUFFER_INDEX,  is_dynamic ? TFGL_BUFFER_DYNAMIC_DRAW : TFGL_BUFFER_STATIC_DRAW ) )
     , host_data_vtx( vtx_temp.vertex_size() )
-{}
+{
+    treecore_assert( index_type == TFGL_TYPE_UNSIGNED_SHORT || index_type == TFGL_TYPE_UNSIGNED_INT );
+}
 
 Geometry::Guts::~Guts()
 {
@@ -22,6 +25,29 @@ Geometry::Guts::~Guts()
     treecore_assert( user_tail == nullptr );
 }
 
+// upload data from byte_begin to end, previous part is already on device
+void _upload_tail_( GLBuffer* buffer, int32& device_num_byte, const void* data, int32 num_byte, int32 byte_begin )
+{
+    if (byte_begin == 0)
+    {
+        buffer->upload_data( data, num_byte );
+        device_num_byte = num_byte;
+    }
+    else if (num_byte <= device_num_byte)
+    {
+        if (num_byte > byte_begin)
+            buffer->upload_sub_data( byte_begin, static_cast<const int8*>( data ) + byte_begin, num_byte - byte_begin );
+    }
+    else
+    {
+        // geometry is growing by appending, reserve more to avoid
+        // reallocating storage on each upload
+        device_num_byte = std::max( num_byte, device_num_byte * 2 );
+        buffer->upload_data( nullptr, device_num_byte );
+        buffer->upload_sub_data( 0, data, num_byte );
+    }
+}
+
 void Geometry::Guts::upload_data()
 {
     treecore_assert( !drawing );
@@ -30,20 +56,76 @@ void Geometry::Guts::upload_data()
 
     if (dirty)
     {
-        num_idx = host_data_idx.size();
-        buf_vtx->upload_data( host_data_vtx.get_raw_data_ptr(), host_data_vtx.num_byte() );
-        buf_idx->upload_data( ArrayRef<IndexType>( host_data_idx ) );
+        int32 vtx_begin = std::min( dirty_vtx_begin, host_data_vtx.size() );
+        update_bound( vtx_begin );
+
+        _upload_tail_( buf_vtx, device_num_byte_vtx, host_data_vtx.get_raw_data_ptr(), host_data_vtx.num_byte(),
+                       vtx_begin * host_data_vtx.block_size() );
+
+        if (index_type == TFGL_TYPE_UNSIGNED_INT)
+        {
+            num_idx = host_data_idx_32.size();
+            _upload_tail_( buf_idx, device_num_byte_idx, host_data_idx_32.getRawDataPointer(), num_idx * int32( sizeof(uint32) ),
+                           std::min( dirty_idx_begin, num_idx ) * int32( sizeof(uint32) ) );
+        }
+        else
+        {
+            num_idx = host_data_idx.size();
+            _upload_tail_( buf_idx, device_num_byte_idx, host_data_idx.getRawDataPointer(), num_idx * int32( sizeof(IndexType) ),
+                           std::min( dirty_idx_begin, num_idx ) * int32( sizeof(IndexType) ) );
+        }
 
         if (!dynamic)
         {
             host_data_vtx.clear();
             host_data_idx.clear();
+            host_data_idx_32.clear();
         }
 
+        // later modifications start from current end of host data
+        dirty_vtx_begin = host_data_vtx.size();
+        dirty_idx_begin = index_type == TFGL_TYPE_UNSIGNED_INT ? host_data_idx_32.size() : host_data_idx.size();
         dirty = false;
     }
 }
 
+void Geometry::Guts::update_bound( int32 i_vtx_begin )
+{
+    static const Identifier name_position( "position" );
+
+    // extend current bound by new vertices
+    BBox3f new_bound;
+    bool   new_known = false;
+    if (i_vtx_begin > 0 && bound_known)
+        new_bound = bound;
+    else
+        i_vtx_begin = 0;
+
+    for (int i_attr = 0; i_attr < vtx_temp.n_attribs(); i_attr++)
+    {
+        const TypedTemplateWithOffset& attr = vtx_temp.get_attrib( i_attr );
+        if (attr.name != name_position || attr.type != TFGL_TYPE_FLOAT || attr.n_elem < 2)
+            continue;
+
+        for (int i_vtx = i_vtx_begin; i_vtx < host_data_vtx.size(); i_vtx++)
+        {
+            const float* pos = reinterpret_cast<const float*>( static_cast<const char*>( host_data_vtx.get_by_ptr( i_vtx ) ) + attr.offset );
+            new_bound.add_point( pos[0], pos[1], attr.n_elem > 2 ? pos[2] : 0.0f );
+        }
+
+        new_known = true;
+        break;
+    }
+
+    bound_changed = new_known != bound_known ||
+                    (new_known && ( new_bound.is_valid() != bound.is_valid() ||
+                                    new_bound.x_min != bound.x_min || new_bound.x_max != bound.x_max ||
+                                    new_bound.y_min != bound.y_min || new_bound.y_max != bound.y_max ||
+                                    new_bound.z_min != bound.z_min || new_bound.z_max != bound.z_max ) );
+    bound       = new_bound;
+    bound_known = new_known;
+}
+
 void Geometry::Guts::invalidate_user_uniform_cache()
 {
     for (VisualObject::Impl* curr = user_head; curr != nullptr; curr = curr->same_geom_next)
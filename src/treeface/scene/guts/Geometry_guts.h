@@ -13,10 +13,11 @@ namespace treeface
 
 struct Geometry::Guts
 {
-    Guts( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic );
+    Guts( const VertexTemplate& vtx_temp, GLPrimitive primitive, bool is_dynamic, GLType index_type );
     ~Guts();
 
     void upload_data();
+    void update_bound( int32 i_vtx_begin );
 
     void invalidate_user_uniform_cache();
 
@@ -27,7 +28,16 @@ struct Geometry::Guts
     bool       drawing = false;
     bool       dirty   = false;
     int32      num_idx = 0;
+
+    // first vertex and index that are modified since last upload
+    int32 dirty_vtx_begin = 0;
+    int32 dirty_idx_begin = 0;
+
+    // size of device buffer storage, which could be larger than uploaded data
+    int32 device_num_byte_vtx = 0;
+    int32 device_num_byte_idx = 0;
     const GLPrimitive primitive;
+    GLType     index_type;
 
     const VertexTemplate vtx_temp;
 
@@ -36,8 +46,14 @@ struct Geometry::Guts
 
     UniformMap uniforms;
 
-    Geometry::HostVertexCache  host_data_vtx;
-    treecore::Array<IndexType> host_data_idx;
+    // bounding box in model space, updated on data upload
+    BBox3f bound;
+    bool   bound_known   = false;
+    bool   bound_changed = false;
+
+    Geometry::HostVertexCache         host_data_vtx;
+    treecore::Array<IndexType>        host_data_idx;    // used by 16-bit index
+    treecore::Array<treecore::uint32> host_data_idx_32; // used by 32-bit index
 };
 
 } // namespace treeface
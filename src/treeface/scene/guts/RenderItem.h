@@ -0,0 +1,94 @@
+#ifndef TREEFACE_SCENE_RENDER_ITEM_H
+#define TREEFACE_SCENE_RENDER_ITEM_H
+
+#include "treeface/base/Common.h"
+
+//
+// layout of 64-bit render item sort key, from high bit to low bit
+//
+// opaque items:      1 bit zero, 16 bit material ID, 8 bit coarse depth,
+//                    24 bit geometry ID, 15 bit padding
+// translucent items: 1 bit one, 23 bit reversed depth, 16 bit material ID,
+//                    24 bit geometry ID
+//
+// Depth is quantized into 23 bits, where zero is the nearest.
+//
+#define RENDER_KEY_DEPTH_BITS        23
+#define RENDER_KEY_COARSE_DEPTH_BITS 8
+#define RENDER_KEY_GEOMETRY_BITS     24
+#define RENDER_KEY_MATERIAL_BITS     16
+
+#define RENDER_KEY_DEPTH_MAX    ( (1u << RENDER_KEY_DEPTH_BITS) - 1 )
+#define RENDER_KEY_GEOMETRY_MAX ( (1u << RENDER_KEY_GEOMETRY_BITS) - 1 )
+#define RENDER_KEY_MATERIAL_MAX ( (1u << RENDER_KEY_MATERIAL_BITS) - 1 )
+
+#define RENDER_KEY_TRANSLUCENT_SHIFT 63
+
+namespace treeface
+{
+
+class SceneGraphMaterial;
+class SceneNode;
+class VisualObject;
+
+struct RenderItem
+{
+    uint64              key;
+    SceneGraphMaterial* mat;
+    VisualObject*       vis_obj;
+    SceneNode*          node;
+    uint32              mat_id;
+    uint32              geom_id;
+    float               depth; ///< view-space depth of node origin, only valid when sorting by depth
+};
+
+///
+/// \brief pack render states into one sort key
+///
+/// Opaque items go before translucent items. Opaque items are grouped by
+/// material, then roughly ordered from near to far, then grouped by geometry.
+/// Translucent items are strictly ordered from far to near. IDs wider than
+/// their fields are wrapped, which only makes grouping less perfect.
+///
+/// \param depth_bucket  quantized depth, zero for the nearest
+///
+inline uint64 make_render_key( bool translucent, uint32 mat_id, uint32 geom_id, uint32 depth_bucket ) noexcept
+{
+    mat_id       &= RENDER_KEY_MATERIAL_MAX;
+    geom_id      &= RENDER_KEY_GEOMETRY_MAX;
+    depth_bucket &= RENDER_KEY_DEPTH_MAX;
+
+    if (translucent)
+    {
+        return (uint64( 1 ) << RENDER_KEY_TRANSLUCENT_SHIFT)
+               | (uint64( RENDER_KEY_DEPTH_MAX - depth_bucket ) << (RENDER_KEY_MATERIAL_BITS + RENDER_KEY_GEOMETRY_BITS) )
+               | (uint64( mat_id ) << RENDER_KEY_GEOMETRY_BITS)
+               | uint64( geom_id );
+    }
+    else
+    {
+        uint32 coarse_depth = depth_bucket >> (RENDER_KEY_DEPTH_BITS - RENDER_KEY_COARSE_DEPTH_BITS);
+        const int pad_bits  = 63 - RENDER_KEY_MATERIAL_BITS - RENDER_KEY_COARSE_DEPTH_BITS - RENDER_KEY_GEOMETRY_BITS;
+
+        return (uint64( mat_id ) << (RENDER_KEY_COARSE_DEPTH_BITS + RENDER_KEY_GEOMETRY_BITS + pad_bits) )
+               | (uint64( coarse_depth ) << (RENDER_KEY_GEOMETRY_BITS + pad_bits) )
+               | (uint64( geom_id ) << pad_bits);
+    }
+}
+
+inline bool render_key_is_translucent( uint64 key ) noexcept
+{
+    return (key >> RENDER_KEY_TRANSLUCENT_SHIFT) != 0;
+}
+
+struct RenderItemKeyGetter
+{
+    uint64 operator ()( const RenderItem& item ) const noexcept
+    {
+        return item.key;
+    }
+};
+
+} // namespace treeface
+
+#endif // TREEFACE_SCENE_RENDER_ITEM_H
@@ -4,31 +4,92 @@ using namespace treecore;
 
 namespace treeface {
 
-void SceneNode::Guts::update_trans_descendent()
+void SceneNode::Guts::update_global_from_parent() noexcept
 {
-    trans_inv = trans;
-    trans_inv.inverse();
+    if (parent)
+        trans_global = parent->get_global_transform() * trans;
+    else
+        trans_global = trans;
 
-    trans_dirty = false;
+    global_dirty     = false;
+    global_inv_dirty = true;
 
-    update_global_descendent();
+    // children are still dirty if this node is updated lazily, so top-down
+    // update must keep going through this node
+    if (child_nodes.size() > 0)
+        global_dirty_below = true;
 }
 
-void SceneNode::Guts::update_global_descendent()
+void SceneNode::Guts::update_global() noexcept
 {
-    if (parent)
+    // fast path: parent is already clean, or its global transform is
+    // provided by transform store
+    if (parent == nullptr || !parent->m_impl->global_dirty || parent->m_impl->transform_store)
     {
-        trans_global = parent->get_global_transform() * trans;
+        update_global_from_parent();
+        return;
     }
-    else
+
+    // a clean node never has dirty ancestors, so collect the dirty chain
+    // and update it from top
+    Array<Guts*> chain;
+    for (Guts* curr = this; curr != nullptr && curr->global_dirty && !curr->transform_store; curr = curr->parent ? curr->parent->m_impl : nullptr)
+        chain.add( curr );
+
+    for (int i = chain.size() - 1; i >= 0; i--)
+        chain[i]->update_global_from_parent();
+}
+
+void SceneNode::Guts::invalidate_global_descendent()
+{
+    if (global_dirty && bound_dirty)
+        return;
+
+    global_dirty = true;
+    bound_dirty  = true;
+
+    for (int i = 0; i < child_nodes.size(); i++)
+        child_nodes[i]->m_impl->invalidate_global_descendent();
+}
+
+void SceneNode::Guts::invalidate_bound_ancestor()
+{
+    // a node with dirty bound always has dirty ancestors. Walk begins from
+    // parent, as this node may be already marked by
+    // invalidate_global_descendent() while its ancestors are not
+    bound_dirty = true;
+    for (Guts* curr = parent ? parent->m_impl : nullptr; curr != nullptr && !curr->bound_dirty; curr = curr->parent ? curr->parent->m_impl : nullptr)
+        curr->bound_dirty = true;
+}
+
+void SceneNode::Guts::mark_global_dirty_ancestor() noexcept
+{
+    for (SceneNode* curr = parent; curr != nullptr && !curr->m_impl->global_dirty_below; curr = curr->m_impl->parent)
+        curr->m_impl->global_dirty_below = true;
+}
+
+void SceneNode::Guts::detach_transform_store() noexcept
+{
+    Array<Guts*> stack;
+    stack.add( this );
+
+    while (stack.size() > 0)
     {
-        trans_global = trans;
-    }
+        Guts* curr = stack.getLast();
+        stack.removeLast();
 
-    trans_global_inv = trans_global;
-    trans_global_inv.inverse();
+        curr->transform_store = nullptr;
+        curr->transform_index = -1;
 
-    global_dirty = false;
+        for (int i = 0; i < curr->child_nodes.size(); i++)
+            stack.add( curr->child_nodes[i]->m_impl );
+    }
+}
+
+void SceneNode::Guts::hierarchy_changed() noexcept
+{
+    for (Guts* curr = this; curr != nullptr; curr = curr->parent ? curr->parent->m_impl : nullptr)
+        curr->hierarchy_version++;
 }
 
 } // namespace treeface
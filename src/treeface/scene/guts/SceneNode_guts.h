@@ -8,12 +8,16 @@
 #include "treeface/math/Mat4.h"
 
 #include <treecore/AlignedMalloc.h>
+#include <treecore/Array.h>
 #include <treecore/HashSet.h>
 #include <treecore/RefCountHolder.h>
 #include <treecore/SortedSet.h>
 
 namespace treeface {
 
+class SceneRenderer;
+class TransformStore;
+
 TREECORE_ALN_BEGIN( 16 )
 struct SceneNode::Guts
 {
@@ -24,17 +28,82 @@ struct SceneNode::Guts
     Mat4f trans_global;
     Mat4f trans_global_inv;
 
-    bool trans_dirty = true;
+    BBox3f bound_global;
+
+    // inverse matrices are only calculated on request
+    bool trans_inv_dirty     = true;
     bool global_dirty        = true;
+    bool global_inv_dirty    = true;
+    // some descendants may have dirty global transform
+    bool global_dirty_below  = false;
     bool uniform_cache_dirty = true;
+    bool bound_dirty         = true;
+    bool bound_known         = false;
+
+    // written by renderer on frustum culling, equals to renderer's current
+    // stamp if this node is visible
+    treecore::uint32 visible_stamp = 0;
+
+    treecore::uint32 hierarchy_version = 0;
+
+    // when this node is managed by a transform store, global transform is
+    // stored there, and trans_global is not used
+    TransformStore*  transform_store = nullptr;
+    treecore::int32  transform_index = -1;
 
     treecore::SortedSet<treecore::RefCountHolder<SceneNode> > child_nodes;
     SceneNode* parent = nullptr;
 
     treecore::SortedSet<treecore::RefCountHolder<SceneObject> > objects;
 
-    void update_trans_descendent();
-    void update_global_descendent();
+    // renderers that retain render queue of the tree rooted at this node
+    treecore::Array<SceneRenderer*> renderers;
+
+    ///
+    /// \brief calculate global transform from parent's global transform
+    ///
+    /// Parent's global transform must be up to date, or parent is managed by
+    /// a transform store. Children are not updated, so this node is marked as
+    /// having dirty descendants.
+    ///
+    void update_global_from_parent() noexcept;
+
+    ///
+    /// \brief make global transform of this node up to date
+    ///
+    /// Dirty ancestors are updated from top to bottom without recursion.
+    ///
+    void update_global() noexcept;
+
+    ///
+    /// \brief mark ancestors as having dirty descendants, so that they are
+    ///        visited by SceneNode::update_global_transforms()
+    ///
+    void mark_global_dirty_ancestor() noexcept;
+
+    ///
+    /// \brief mark global transform and bounding box of this node and all
+    ///        descendants as dirty
+    ///
+    /// If a node has both flags dirty, all its descendants also have, so the
+    /// recursion stops there.
+    ///
+    void invalidate_global_descendent();
+
+    ///
+    /// \brief mark bounding box of this node and all ancestors as dirty
+    ///
+    void invalidate_bound_ancestor();
+
+    ///
+    /// \brief increase hierarchy version of this node and all ancestors
+    ///
+    void hierarchy_changed() noexcept;
+
+    ///
+    /// \brief detach this node and all descendants from transform store
+    ///
+    void detach_transform_store() noexcept;
 
 } TREECORE_ALN_END( 16 );
 
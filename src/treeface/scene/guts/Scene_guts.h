@@ -3,6 +3,7 @@
 
 #include "treeface/scene/Scene.h"
 #include "treeface/scene/SceneNode.h"
+#include "treeface/scene/TransformStore.h"
 
 namespace treeface {
 
@@ -18,6 +19,12 @@ struct Scene::Guts
     Vec4f global_light_direction{0.577350269, 0.577350269, 0.577350269, 0};
     Vec4f global_light_color{1, 1, 1, 1};
     Vec4f global_light_ambient{0, 0, 0, 1};
+
+    DepthSortPolicy depth_sort = DEPTH_SORT_NONE;
+    bool frustum_culling = false;
+
+    // destroyed before root node
+    treecore::RefCountHolder<TransformStore> transform_store;
 } TREECORE_ALN_END(16);
 
 } // namespace treeface
@@ -16,6 +16,7 @@ struct VisualObject::Impl
 
     void update_uniform_cache();
 
+    VisualObject*       host = nullptr;
     VisualObject::Impl* same_geom_prev = nullptr;
     VisualObject::Impl* same_geom_next = nullptr;
     treecore::RefCountHolder<SceneGraphMaterial> material     = nullptr;
@@ -0,0 +1,175 @@
+#include "TestFramework.h"
+
+#include "treeface/graphics/guts/ShapeGenerator_guts.h"
+#include "treeface/graphics/guts/Utils.h"
+
+#include <cmath>
+
+using namespace treeface;
+using namespace treecore;
+
+#define FRINGE_WIDTH 0.5f
+
+struct FillAAResult
+{
+    FillAAResult(): vertices( sizeof(FillAAVertex) ) {}
+
+    Geometry::HostVertexCache vertices;
+    Array<uint32> indices;
+};
+
+void add_polygon( ShapeGenerator& gen, const Vec2f* points, int num_point )
+{
+    gen.move_to( points[0] );
+    for (int i = 1; i < num_point; i++)
+        gen.line_to( points[i] );
+}
+
+// sum of area of triangles from i_begin'th index
+float total_area( const FillAAResult& result, int i_begin = 0 )
+{
+    float area = 0.0f;
+    for (int i = i_begin; i + 2 < result.indices.size(); i += 3)
+    {
+        const Vec2f& a = result.vertices.get<FillAAVertex>( result.indices[i] ).position;
+        const Vec2f& b = result.vertices.get<FillAAVertex>( result.indices[i + 1] ).position;
+        const Vec2f& c = result.vertices.get<FillAAVertex>( result.indices[i + 2] ).position;
+        area += std::abs( (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) ) / 2;
+    }
+    return area;
+}
+
+int count_coverage( const FillAAResult& result, float coverage )
+{
+    int num = 0;
+    for (int i = 0; i < result.vertices.size(); i++)
+        if (result.vertices.get<FillAAVertex>( i ).coverage == coverage)
+            num++;
+    return num;
+}
+
+bool indices_valid( const FillAAResult& result )
+{
+    if (result.indices.size() % 3 != 0)
+        return false;
+
+    for (uint32 index : result.indices)
+        if ( index >= uint32( result.vertices.size() ) )
+            return false;
+
+    for (int i = 0; i < result.vertices.size(); i++)
+    {
+        const Vec2f& p = result.vertices.get<FillAAVertex>( i ).position;
+        if ( !std::isfinite( p.x ) || !std::isfinite( p.y ) )
+            return false;
+    }
+    return true;
+}
+
+float max_fringe_distance( const FillAAResult& result, int i_inner, int i_outer, int num )
+{
+    float dist = 0.0f;
+    for (int i = 0; i < num; i++)
+    {
+        Vec2f v = result.vertices.get<FillAAVertex>( i_outer + i ).position - result.vertices.get<FillAAVertex>( i_inner + i ).position;
+        dist = std::fmax( dist, v.length() );
+    }
+    return dist;
+}
+
+bool near( float a, float b )
+{
+    return std::abs( a - b ) < 1.0e-4f;
+}
+
+void TestFramework::content()
+{
+    // guts are only reachable from here
+    auto do_fill_aa = []( const ShapeGenerator& gen, FillAAResult& result )
+    {
+        Vec2f skel_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+        Vec2f skel_max( -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() );
+        TessellateScratch scratch;
+        gen.m_guts->fill_aa( FRINGE_WIDTH, result.vertices, result.indices, skel_min, skel_max, scratch );
+    };
+
+    const Vec2f square_cclw[] = { Vec2f( 0.0f, 0.0f ), Vec2f( 8.0f, 0.0f ), Vec2f( 8.0f, 8.0f ), Vec2f( 0.0f, 8.0f ) };
+    const Vec2f square_clw[]  = { Vec2f( 0.0f, 0.0f ), Vec2f( 0.0f, 8.0f ), Vec2f( 8.0f, 8.0f ), Vec2f( 8.0f, 0.0f ) };
+    const Vec2f hole[]        = { Vec2f( 2.0f, 2.0f ), Vec2f( 2.0f, 6.0f ), Vec2f( 6.0f, 6.0f ), Vec2f( 6.0f, 2.0f ) };
+    const Vec2f spike[]       = { Vec2f( 0.0f, 0.0f ), Vec2f( 20.0f, 1.0f ), Vec2f( 0.0f, 2.0f ) };
+
+    const float outer_area = (8.0f + 2 * FRINGE_WIDTH) * (8.0f + 2 * FRINGE_WIDTH);
+
+    // fringe is out of shape regardless of orientation
+    {
+        ShapeGenerator gen;
+        add_polygon( gen, square_cclw, 4 );
+        FillAAResult result;
+        do_fill_aa( gen, result );
+
+        OK( indices_valid( result ) );
+        IS( result.vertices.size(), 8 );
+        IS( count_coverage( result, 1.0f ), 4 );
+        IS( count_coverage( result, 0.0f ), 4 );
+        OK( near( total_area( result ), outer_area ) );
+
+        const Vec2f& corner = result.vertices.get<FillAAVertex>( 4 ).position;
+        OK( near( corner.x, -FRINGE_WIDTH ) );
+        OK( near( corner.y, -FRINGE_WIDTH ) );
+    }
+
+    {
+        ShapeGenerator gen;
+        add_polygon( gen, square_clw, 4 );
+        FillAAResult result;
+        do_fill_aa( gen, result );
+
+        OK( indices_valid( result ) );
+        OK( near( total_area( result ), outer_area ) );
+
+        const Vec2f& corner = result.vertices.get<FillAAVertex>( 6 ).position;
+        OK( near( corner.x, 8.0f + FRINGE_WIDTH ) );
+        OK( near( corner.y, 8.0f + FRINGE_WIDTH ) );
+    }
+
+    // fringe of hole goes into hole
+    {
+        ShapeGenerator gen;
+        add_polygon( gen, square_cclw, 4 );
+        add_polygon( gen, hole, 4 );
+        FillAAResult result;
+        do_fill_aa( gen, result );
+
+        OK( indices_valid( result ) );
+        IS( result.vertices.size(), 16 );
+        float hole_size = 4.0f - 2 * FRINGE_WIDTH;
+        OK( near( total_area( result ), outer_area - hole_size * hole_size ) );
+    }
+
+    // fringe at sharp corner is limited
+    {
+        ShapeGenerator gen;
+        add_polygon( gen, spike, 3 );
+        FillAAResult result;
+        do_fill_aa( gen, result );
+
+        OK( indices_valid( result ) );
+        float dist = max_fringe_distance( result, 0, 3, 3 );
+        OK( dist > FRINGE_WIDTH * 2 );
+        OK( dist <= FRINGE_WIDTH * FILL_FRINGE_MITER_LIMIT + 1.0e-4f );
+    }
+
+    // indices continue after existing vertices
+    {
+        ShapeGenerator gen;
+        add_polygon( gen, square_cclw, 4 );
+        FillAAResult result;
+        do_fill_aa( gen, result );
+        int num_index = result.indices.size();
+        do_fill_aa( gen, result );
+
+        OK( indices_valid( result ) );
+        IS( result.vertices.size(), 16 );
+        OK( near( total_area( result, num_index ), outer_area ) );
+    }
+}
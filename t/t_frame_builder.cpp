@@ -0,0 +1,162 @@
+#include "TestFramework.h"
+
+#include "treeface/misc/RadixSort.h"
+#include "treeface/misc/WorkerPool.h"
+#include "treeface/scene/SceneNode.h"
+#include "treeface/scene/guts/FrameBuilder.h"
+
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
+
+#include <atomic>
+#include <cstring>
+
+using namespace treeface;
+using namespace treecore;
+
+#define NUM_ITEM 5000
+
+// same calculation in another thread should give identical bits
+bool same_matrix( const Mat4f& a, const Mat4f& b )
+{
+    return memcmp( &a, &b, sizeof(Mat4f) ) == 0;
+}
+
+void TestFramework::content()
+{
+    WorkerPool pool( 4 );
+    IS( pool.get_num_threads(), 4 );
+
+    // every task runs exactly once, in repeated batches
+    {
+        std::atomic<int> counts[1000];
+        bool all_once = true;
+
+        for (int i_batch = 0; i_batch < 10; i_batch++)
+        {
+            for (std::atomic<int>& count : counts)
+                count = 0;
+
+            pool.run( 1000, [&]( int i ) { counts[i]++; } );
+
+            for (std::atomic<int>& count : counts)
+                all_once = all_once && count == 1;
+        }
+        OK( all_once );
+
+        int num_covered = 0;
+        parallel_for_range( &pool, 1000, 16, [&]( int i_begin, int i_end ) {
+            for (int i = i_begin; i < i_end; i++)
+                counts[i]++;
+        } );
+        for (std::atomic<int>& count : counts)
+            num_covered += count == 2;
+        IS( num_covered, 1000 );
+    }
+
+    // sort of segments is same as one stable radix sort
+    {
+        Array<RenderItem> items;
+        uint32 seed = 12345;
+        for (int i = 0; i < NUM_ITEM; i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            items.add( { uint64( seed >> 20 ), nullptr, nullptr, nullptr, uint32( i ), 0, 0.0f } );
+        }
+
+        Array<int32> bounds;
+        for (int i = 0; i < NUM_ITEM; i += 700)
+            bounds.add( i );
+        bounds.add( NUM_ITEM );
+
+        Array<RenderItem> expect( items );
+        Array<RenderItem> buffer;
+        radix_sort( expect, buffer, RenderItemKeyGetter() );
+
+        sort_segments( &pool, items, buffer, bounds );
+
+        int num_same = 0;
+        for (int i = 0; i < NUM_ITEM; i++)
+            num_same += items[i].key == expect[i].key && items[i].mat_id == expect[i].mat_id;
+        IS( num_same, NUM_ITEM );
+    }
+
+    // subtrees and expanded nodes cover the whole tree once
+    RefCountHolder<SceneNode> root = new SceneNode();
+    Array<SceneNode*> all_nodes;
+    all_nodes.add( root );
+
+    for (int i = 1; i < 400; i++)
+    {
+        SceneNode* node = new SceneNode();
+        Mat4f trans;
+        trans.set_translate( float( i % 7 ), float( i % 3 ), 1.0f );
+        node->set_transform( trans );
+
+        all_nodes[(i - 1) / 3]->add_child( node );
+        all_nodes.add( node );
+    }
+
+    {
+        Array<SceneNode*> expanded;
+        Array<SceneNode*> subtrees;
+        split_subtrees( root, 16, expanded, subtrees );
+        OK( subtrees.size() >= 16 );
+
+        Array<SceneNode*> covered( expanded );
+        for (SceneNode* subtree : subtrees)
+        {
+            Array<SceneNode*> stack;
+            stack.add( subtree );
+            while (stack.size() > 0)
+            {
+                SceneNode* node = stack.getLast();
+                stack.removeLast();
+                covered.add( node );
+                for (int i = 0; i < node->get_num_children(); i++)
+                    stack.add( node->get_child_at( i ) );
+            }
+        }
+
+        IS( covered.size(), all_nodes.size() );
+
+        int num_found = 0;
+        for (SceneNode* node : all_nodes)
+            num_found += covered.contains( node );
+        IS( num_found, all_nodes.size() );
+    }
+
+    // matrices are same as calculated one by one
+    {
+        root->update_global_transforms();
+
+        Array<RenderItem> items;
+        for (SceneNode* node : all_nodes)
+            items.add( { 0, nullptr, nullptr, node, 0, 0, 0.0f } );
+
+        Mat4f proj;
+        proj.set_scale( 0.5f, 0.5f, -0.1f );
+        Mat4f view;
+        view.set_translate( 0.0f, 0.0f, -10.0f );
+
+        const int num_a = 150;
+        const int num_b = items.size() - num_a;
+
+        Array<ItemMatrices, 16> result;
+        result.resize( items.size() );
+        compute_item_matrices( &pool, &items[0], num_a, &items[num_a], num_b, proj, view, &result[0] );
+
+        int num_same = 0;
+        for (int i = 0; i < items.size(); i++)
+        {
+            Mat4f model_view      = view * items[i].node->get_global_transform();
+            Mat4f model_view_proj = proj * model_view;
+            Mat4f normal          = model_view.get_normal_matrix();
+
+            num_same += same_matrix( result[i].model_view, model_view ) &&
+                        same_matrix( result[i].model_view_proj, model_view_proj ) &&
+                        same_matrix( result[i].normal, normal );
+        }
+        IS( num_same, items.size() );
+    }
+}
@@ -0,0 +1,188 @@
+#include "TestFramework.h"
+
+#include "treecore/File.h"
+
+#include "treeface/base/PackageManager.h"
+#include "treeface/math/BBox3.h"
+#include "treeface/math/Frustum.h"
+#include "treeface/scene/Geometry.h"
+#include "treeface/scene/GeometryManager.h"
+#include "treeface/scene/MaterialManager.h"
+#include "treeface/scene/SceneGraphMaterial.h"
+#include "treeface/scene/SceneNode.h"
+#include "treeface/scene/VisualObject.h"
+
+#include "treeface/scene/guts/Geometry_guts.h"
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <SDL.h>
+
+using namespace treeface;
+using namespace treecore;
+
+void build_up_sdl( SDL_Window** window, SDL_GLContext* context )
+{
+    SDL_Init( SDL_INIT_VIDEO & SDL_INIT_TIMER & SDL_INIT_EVENTS );
+
+    *window = SDL_CreateWindow( "frustum test", 50, 50, 400, 400, SDL_WINDOW_OPENGL );
+    if (!*window)
+        die( "error: failed to create window: %s\n", SDL_GetError() );
+
+    *context = SDL_GL_CreateContext( *window );
+    if (!context)
+        die( "error: failed to create GL context: %s\n", SDL_GetError() );
+
+    SDL_GL_MakeCurrent( *window, *context );
+
+    GLenum glew_err = glewInit();
+    if (glew_err != GLEW_OK)
+        die( "error: failed to init glew: %s\n", glewGetErrorString( glew_err ) );
+}
+
+// same traversal as culling in SceneRenderer
+void collect_visible( SceneNode* node, const Frustumf& frustum, Array<SceneNode*>& result )
+{
+    BBox3f bound;
+    if ( node->get_global_bounding_box( bound ) && frustum.test( bound ) == FRUSTUM_OUTSIDE )
+        return;
+
+    result.add( node );
+    for (int i = 0; i < node->get_num_children(); i++)
+        collect_visible( node->get_child_at( i ), frustum, result );
+}
+
+void TestFramework::content()
+{
+    OK( "bounding box" );
+    {
+        BBox3f box;
+        OK( !box.is_valid() );
+
+        box.add_point( 1, 2, 3 );
+        OK( box.is_valid() );
+        box.add_point( -1, 5, 0 );
+        IS( box.x_min, -1 );
+        IS( box.x_max, 1 );
+        IS( box.y_min, 2 );
+        IS( box.y_max, 5 );
+        IS( box.z_min, 0 );
+        IS( box.z_max, 3 );
+
+        BBox3f other;
+        box.add_box( other );
+        IS( box.x_min, -1 );
+        IS( box.x_max, 1 );
+    }
+
+    OK( "transform bounding box" );
+    {
+        BBox3f box( -1, -2, -3, 1, 2, 3 );
+
+        Mat4f trans;
+        trans.set_translate( 10, 20, 30 );
+        BBox3f moved = box.transformed( trans );
+        IS_EPSILON( moved.x_min, 9.0f );
+        IS_EPSILON( moved.x_max, 11.0f );
+        IS_EPSILON( moved.y_min, 18.0f );
+        IS_EPSILON( moved.y_max, 22.0f );
+        IS_EPSILON( moved.z_min, 27.0f );
+        IS_EPSILON( moved.z_max, 33.0f );
+
+        // rotate 90 degrees around Z: x => y, y => -x
+        Mat4f rot( 0, 1, 0, 0,
+                   -1, 0, 0, 0,
+                   0, 0, 1, 0,
+                   0, 0, 0, 1 );
+        BBox3f rotated = box.transformed( rot );
+        IS_EPSILON( rotated.x_min, -2.0f );
+        IS_EPSILON( rotated.x_max, 2.0f );
+        IS_EPSILON( rotated.y_min, -1.0f );
+        IS_EPSILON( rotated.y_max, 1.0f );
+        IS_EPSILON( rotated.z_min, -3.0f );
+        IS_EPSILON( rotated.z_max, 3.0f );
+
+        OK( !BBox3f().transformed( rot ).is_valid() );
+    }
+
+    OK( "frustum of identity matrix is clip cube" );
+    {
+        Mat4f    identity;
+        Frustumf frustum( identity );
+        IS( frustum.test( BBox3f( -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f ) ), FRUSTUM_INSIDE );
+        IS( frustum.test( BBox3f( 0.5f, -0.5f, -0.5f, 1.5f, 0.5f, 0.5f ) ),  FRUSTUM_INTERSECT );
+        IS( frustum.test( BBox3f( -5, -5, -5, 5, 5, 5 ) ),                   FRUSTUM_INTERSECT );
+        IS( frustum.test( BBox3f( 2, -0.5f, -0.5f, 3, 0.5f, 0.5f ) ),        FRUSTUM_OUTSIDE );
+        IS( frustum.test( BBox3f( -0.5f, -3, -0.5f, 0.5f, -2, 0.5f ) ),      FRUSTUM_OUTSIDE );
+        IS( frustum.test( BBox3f( -0.5f, -0.5f, 1.5f, 0.5f, 0.5f, 2 ) ),     FRUSTUM_OUTSIDE );
+        IS( frustum.test( BBox3f() ),                                        FRUSTUM_INTERSECT );
+    }
+
+    OK( "frustum of scaled and translated view" );
+    {
+        // visible range is x in [8, 12], y in [-2, 2], z in [-2, 2]
+        Mat4f scale;
+        scale.set_scale( 0.5f, 0.5f, 0.5f );
+        Mat4f trans;
+        trans.set_translate( -10, 0, 0 );
+
+        Frustumf frustum( scale * trans );
+        IS( frustum.test( BBox3f( 9, -1, -1, 11, 1, 1 ) ),   FRUSTUM_INSIDE );
+        IS( frustum.test( BBox3f( -1, -1, -1, 1, 1, 1 ) ),   FRUSTUM_OUTSIDE );
+        IS( frustum.test( BBox3f( 11, -1, -1, 13, 1, 1 ) ),  FRUSTUM_INTERSECT );
+        IS( frustum.test( BBox3f( 13, -1, -1, 14, 1, 1 ) ),  FRUSTUM_OUTSIDE );
+    }
+
+    OK( "moved node is not culled by stale bound of ancestors" );
+    {
+        SDL_Window*   window  = nullptr;
+        SDL_GLContext context = nullptr;
+        build_up_sdl( &window, &context );
+
+        PackageManager::getInstance()->add_package( File::getCurrentWorkingDirectory().getChildFile( "../examples/resource.zip" ), PackageManager::KEEP_EXISTING );
+
+        RefCountHolder<GeometryManager>    geom_mgr = new GeometryManager();
+        RefCountHolder<MaterialManager>    mat_mgr  = new MaterialManager();
+        RefCountHolder<Geometry>           geom     = geom_mgr->get_geometry( "geom_sphere1.json" );
+        RefCountHolder<SceneGraphMaterial> mat      = dynamic_cast<SceneGraphMaterial*>( mat_mgr->get_material( "material_uni_color.json" ) );
+
+        geom->m_impl->bound       = BBox3f( -1, -1, -1, 1, 1, 1 );
+        geom->m_impl->bound_known = true;
+
+        RefCountHolder<SceneNode> root       = new SceneNode();
+        RefCountHolder<SceneNode> parent     = new SceneNode();
+        RefCountHolder<SceneNode> grandchild = new SceneNode();
+        root->add_child( parent );
+        parent->add_child( grandchild );
+        grandchild->add_item( new VisualObject( geom, mat ) );
+
+        // visible range is x in [8, 12]
+        Mat4f scale;
+        scale.set_scale( 0.5f, 0.5f, 0.5f );
+        Mat4f trans;
+        trans.set_translate( -10, 0, 0 );
+        Frustumf frustum( scale * trans );
+
+        // bounds are cached while grandchild is out of view
+        Array<SceneNode*> visible;
+        collect_visible( root, frustum, visible );
+        OK( !visible.contains( grandchild ) );
+
+        Mat4f move;
+        move.set_translate( 10, 0, 0 );
+        grandchild->set_transform( move );
+
+        BBox3f bound;
+        OK( root->get_global_bounding_box( bound ) );
+        IS_EPSILON( bound.x_min, 9.0f );
+        IS_EPSILON( bound.x_max, 11.0f );
+
+        visible.clear();
+        collect_visible( root, frustum, visible );
+        OK( visible.contains( grandchild ) );
+
+        root->remove_child( parent );
+        SDL_GL_DeleteContext( context );
+        SDL_Quit();
+    }
+}
@@ -134,6 +134,37 @@ void TestFramework::content()
         IS( data_idx[11],              3 );
     }
 
+    // switch to 32-bit index
+    IS( geom->get_index_type(), TFGL_TYPE_UNSIGNED_SHORT );
+    geom->fit_index_type( 65536 );
+    IS( geom->get_index_type(), TFGL_TYPE_UNSIGNED_SHORT );
+    geom->fit_index_type( 65537 );
+    IS( geom->get_index_type(), TFGL_TYPE_UNSIGNED_INT );
+
+    {
+        Geometry::HostDrawScope scope( *geom );
+        Array<uint32>& data_idx = geom->get_host_index_cache_32();
+        IS( data_idx.size(), 12 );
+        IS( data_idx[1],     2 );
+        IS( data_idx[11],    3 );
+
+        geom->add_index( 70000 );
+        IS( data_idx.size(), 13 );
+        IS( data_idx[12],    70000 );
+        data_idx.removeLast();
+    }
+
+    geom->set_index_type( TFGL_TYPE_UNSIGNED_SHORT );
+    IS( geom->get_index_type(), TFGL_TYPE_UNSIGNED_SHORT );
+
+    {
+        Geometry::HostDrawScope scope( *geom );
+        Array<IndexType>& data_idx = geom->get_host_index_cache();
+        IS( data_idx.size(), 12 );
+        IS( data_idx[2],     1 );
+        IS( data_idx[5],     3 );
+    }
+
     SDL_GL_DeleteContext( context );
     SDL_Quit();
 }
@@ -0,0 +1,98 @@
+#include "TestFramework.h"
+
+#include "treeface/gl/GLStateCache.h"
+
+#include <SDL.h>
+
+using namespace treeface;
+using namespace treecore;
+
+void build_up_sdl( SDL_Window** window, SDL_GLContext* context )
+{
+    SDL_Init( SDL_INIT_VIDEO & SDL_INIT_TIMER & SDL_INIT_EVENTS );
+
+    *window = SDL_CreateWindow( "GL state cache test", 50, 50, 400, 400, SDL_WINDOW_OPENGL );
+    if (!*window)
+        die( "error: failed to create window: %s\n", SDL_GetError() );
+
+    *context = SDL_GL_CreateContext( *window );
+    if (!context)
+        die( "error: failed to create GL context: %s\n", SDL_GetError() );
+
+    SDL_GL_MakeCurrent( *window, *context );
+
+    GLenum glew_err = glewInit();
+    if (glew_err != GLEW_OK)
+        die( "error: failed to init glew: %s\n", glewGetErrorString( glew_err ) );
+}
+
+void TestFramework::content()
+{
+    SDL_Window*   window  = nullptr;
+    SDL_GLContext context = nullptr;
+    build_up_sdl( &window, &context );
+
+    GLStateCache cache;
+    GLStateCache::set_current( &cache );
+
+    GLuint buffers[2];
+    glGenBuffers( 2, buffers );
+    GLuint arrays[2];
+    glGenVertexArrays( 2, arrays );
+
+    OK( "redundant binds are elided" );
+    {
+        cache.reset_stats();
+        cache.bind_buffer( TFGL_BUFFER_VERTEX, buffers[0] );
+        cache.bind_buffer( TFGL_BUFFER_VERTEX, buffers[0] );
+        cache.bind_buffer( TFGL_BUFFER_VERTEX, buffers[1] );
+        IS( cache.get_stats().num_issued, 2 );
+        IS( cache.get_stats().num_elided, 1 );
+        IS( cache.get_buffer( TFGL_BUFFER_VERTEX ), buffers[1] );
+
+        GLint bound = 0;
+        glGetIntegerv( GL_ARRAY_BUFFER_BINDING, &bound );
+        IS( GLuint( bound ), buffers[1] );
+
+        cache.reset_stats();
+        IS( cache.get_stats().num_issued, 0 );
+        IS( cache.get_stats().num_elided, 0 );
+    }
+
+    OK( "binding vertex array drops cached index buffer" );
+    {
+        cache.bind_vertex_array( arrays[0] );
+        cache.bind_buffer( TFGL_BUFFER_INDEX, buffers[0] );
+
+        cache.reset_stats();
+        cache.bind_vertex_array( arrays[1] );
+        cache.bind_buffer( TFGL_BUFFER_INDEX, buffers[0] );
+        IS( cache.get_stats().num_issued, 2 );
+        IS( cache.get_stats().num_elided, 0 );
+
+        // binding of the other vertex array is queried from driver
+        cache.bind_vertex_array( arrays[0] );
+        IS( cache.get_buffer( TFGL_BUFFER_INDEX ), buffers[0] );
+        cache.bind_vertex_array( 0 );
+    }
+
+    OK( "invalidated bindings are sent again" );
+    {
+        cache.use_program( 0 );
+        cache.invalidate();
+        cache.reset_stats();
+        cache.use_program( 0 );
+        cache.use_program( 0 );
+        IS( cache.get_stats().num_issued, 1 );
+        IS( cache.get_stats().num_elided, 1 );
+    }
+
+    cache.bind_buffer( TFGL_BUFFER_VERTEX, 0 );
+    cache.bind_buffer( TFGL_BUFFER_INDEX, 0 );
+    glDeleteVertexArrays( 2, arrays );
+    glDeleteBuffers( 2, buffers );
+    GLStateCache::set_current( nullptr );
+
+    SDL_GL_DeleteContext( context );
+    SDL_Quit();
+}
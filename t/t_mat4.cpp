@@ -225,6 +225,38 @@ void TestFramework::content()
         is_epsilon(mat.get<3,3>(), 1.0f, "3 3 is 1");
     }
 
+    OK("affine inverse");
+    {
+        Mat4f mat(0.0f, 2.0f, 0.0f, 0.0f,
+                  -3.0f, 0.0f, 0.0f, 0.0f,
+                  0.0f, 0.0f, 4.0f, 0.0f,
+                  5.0f, 6.0f, 7.0f, 1.0f);
+        OK(mat.is_affine());
+
+        Mat4f full(mat);
+        full.inverse();
+
+        Mat4f affine(mat);
+        float det = affine.inverse_affine();
+        is_epsilon(det, 24.0f, "determinant is 24");
+
+        is_epsilon(affine.get<0,1>(), full.get<0,1>(), "0 1 same as full inverse");
+        is_epsilon(affine.get<1,0>(), full.get<1,0>(), "1 0 same as full inverse");
+        is_epsilon(affine.get<2,2>(), full.get<2,2>(), "2 2 same as full inverse");
+        is_epsilon(affine.get<0,3>(), full.get<0,3>(), "0 3 same as full inverse");
+        is_epsilon(affine.get<1,3>(), full.get<1,3>(), "1 3 same as full inverse");
+        is_epsilon(affine.get<2,3>(), full.get<2,3>(), "2 3 same as full inverse");
+        is_epsilon(affine.get<3,3>(), 1.0f, "3 3 is 1");
+
+        Mat4f mul = mat * affine;
+        is_epsilon(mul.get<0,0>(), 1.0f, "0 0 is 1");
+        is_epsilon(mul.get<1,1>(), 1.0f, "1 1 is 1");
+        is_epsilon(mul.get<2,2>(), 1.0f, "2 2 is 1");
+        lt(std::abs(mul.get<0,3>()), 1.0f/10000, "0 3 is 0");
+        lt(std::abs(mul.get<1,3>()), 1.0f/10000, "1 3 is 0");
+        lt(std::abs(mul.get<2,3>()), 1.0f/10000, "2 3 is 0");
+    }
+
     {
         Mat4f fwd(data_rand);
         Mat4f inv(data_rand);
@@ -0,0 +1,164 @@
+#include "TestFramework.h"
+
+#include "treeface/graphics/guts/HalfOutline.h"
+#include "treeface/graphics/guts/OutlineSegments.h"
+#include "treeface/graphics/BBox2.h"
+
+#include <random>
+
+using namespace treeface;
+using namespace treecore;
+
+#define NUM_VERTEX 203
+#define NUM_QUERY  2000
+
+// points on a small grid, so that zero-length, parallel and collinear
+// segments are common
+Vec2f get_grid_point( std::mt19937& rng )
+{
+    std::uniform_int_distribution<int> coord( 0, 6 );
+    return Vec2f( float( coord( rng ) ), float( coord( rng ) ) );
+}
+
+// brute force search used before SIMD kernel
+int find_cross_from_tail_ref( const HalfOutline& outline, const Vec2f& p1, const Vec2f& p2, Vec2f& p_cross, int step_limit )
+{
+    const BBox2f bound_input( p1, p2 );
+    const int    i_min = outline.num_final > 0 ? outline.num_final - 1 : 0;
+
+    for (int i = outline.size() - 2; i >= i_min; i--)
+    {
+        if (outline.size() - i > step_limit) break;
+
+        const Vec2f& p3 = outline.outline[i];
+        const Vec2f& p4 = outline.outline[i + 1];
+        if ( (bound_input ^ BBox2f( p3, p4 )) && cross_test_inc( p1, p2, p3, p4, p_cross ) )
+            return i;
+    }
+    return -1;
+}
+
+int find_cross_from_head_ref( const HalfOutline& outline, const Vec2f& p1, const Vec2f& p2, Vec2f& p_cross, int step_limit )
+{
+    const BBox2f bound_input( p1, p2 );
+
+    for (int i = 0; i < outline.size() - 1 && i < step_limit; i++)
+    {
+        const Vec2f& p3 = outline.outline[i];
+        const Vec2f& p4 = outline.outline[i + 1];
+        if ( (bound_input ^ BBox2f( p3, p4 )) && cross_test_inc( p1, p2, p3, p4, p_cross ) )
+            return i;
+    }
+    return -1;
+}
+
+bool segments_match_outline( const HalfOutline& outline )
+{
+    if (outline.segments.size() != outline.size() - 1)
+        return false;
+
+    // a query that only touches each segment at one end must hit it
+    for (int i = 0; i < outline.segments.size(); i++)
+    {
+        OutlineSegments::Query query_begin( outline.outline[i], outline.outline[i] );
+        OutlineSegments::Query query_end( outline.outline[i + 1], outline.outline[i + 1] );
+        if ( !( outline.segments.test_pack( i / 4, query_begin ) & (1 << (i % 4)) ) ||
+             !( outline.segments.test_pack( i / 4, query_end ) & (1 << (i % 4)) ) )
+            return false;
+    }
+    return true;
+}
+
+void TestFramework::content()
+{
+    std::mt19937 rng( 42 );
+
+    HalfOutline outline( 1.0f );
+    for (int i = 0; i < NUM_VERTEX; i++)
+        outline.add( get_grid_point( rng ), i );
+
+    OK( segments_match_outline( outline ) );
+
+    // kernel never rejects a segment that is crossed
+    {
+        bool superset = true;
+        for (int i_query = 0; i_query < NUM_QUERY; i_query++)
+        {
+            Vec2f p1 = get_grid_point( rng );
+            Vec2f p2 = get_grid_point( rng );
+            OutlineSegments::Query query( p1, p2 );
+
+            for (int i = 0; i < outline.segments.size(); i++)
+            {
+                Vec2f p_cross;
+                bool  crossed = (BBox2f( p1, p2 ) ^ BBox2f( outline.outline[i], outline.outline[i + 1] )) &&
+                                cross_test_inc( p1, p2, outline.outline[i], outline.outline[i + 1], p_cross );
+                bool  lane_set = ( outline.segments.test_pack( i / 4, query ) & (1 << (i % 4)) ) != 0;
+                if (crossed && !lane_set)
+                    superset = false;
+            }
+        }
+        OK( superset );
+    }
+
+    // same result with searching segment by segment
+    {
+        int num_match = 0;
+        for (int i_query = 0; i_query < NUM_QUERY; i_query++)
+        {
+            Vec2f p1 = get_grid_point( rng );
+            Vec2f p2 = get_grid_point( rng );
+            int   step_limit = 1 + i_query % 64;
+
+            Vec2f cross_ref;
+            Vec2f cross_got;
+            int   i_ref = find_cross_from_tail_ref( outline, p1, p2, cross_ref, step_limit );
+            int   i_got = outline.find_cross_from_tail( p1, p2, cross_got, step_limit );
+            if ( i_ref == i_got && (i_ref < 0 || cross_ref == cross_got) )
+                num_match++;
+
+            i_ref = find_cross_from_head_ref( outline, p1, p2, cross_ref, step_limit );
+            i_got = outline.find_cross_from_head( p1, p2, cross_got, step_limit );
+            if ( i_ref == i_got && (i_ref < 0 || cross_ref == cross_got) )
+                num_match++;
+        }
+        IS( num_match, NUM_QUERY * 2 );
+    }
+
+    // segments follow modification of outline
+    outline.resize( 150 );
+    OK( segments_match_outline( outline ) );
+
+    outline.remove_range( 0, 5 );
+    OK( segments_match_outline( outline ) );
+
+    outline.remove_range( 37, 3 );
+    OK( segments_match_outline( outline ) );
+
+    outline.set_vertex( 0, Vec2f( 10.0f, 10.0f ) );
+    outline.set_vertex( 21, Vec2f( -3.0f, 2.0f ) );
+    outline.set_vertex( outline.size() - 1, Vec2f( 7.0f, -1.0f ) );
+    OK( segments_match_outline( outline ) );
+
+    // searching from tail doesn't go into final vertices
+    outline.num_final = outline.size() - 10;
+    {
+        int num_match = 0;
+        for (int i_query = 0; i_query < NUM_QUERY; i_query++)
+        {
+            Vec2f p1 = get_grid_point( rng );
+            Vec2f p2 = get_grid_point( rng );
+
+            Vec2f cross_ref;
+            Vec2f cross_got;
+            int   i_ref = find_cross_from_tail_ref( outline, p1, p2, cross_ref, 64 );
+            int   i_got = outline.find_cross_from_tail( p1, p2, cross_got, 64 );
+            if ( i_ref == i_got && (i_ref < 0 || cross_ref == cross_got) )
+                num_match++;
+        }
+        IS( num_match, NUM_QUERY );
+    }
+
+    outline.clear();
+    IS( outline.segments.size(), 0 );
+}
@@ -0,0 +1,108 @@
+#include "TestFramework.h"
+#include "treeface/graphics/guts/PathGlyph.h"
+#include "treeface/math/Constants.h"
+
+using namespace treeface;
+
+// distance from point to line segment
+float seg_dist( const Vec2f& p, const Vec2f& a, const Vec2f& b )
+{
+    Vec2f ab   = b - a;
+    float frac = ( (p - a) * ab ) / ab.length2();
+    if (frac < 0.0f) frac = 0.0f;
+    if (frac > 1.0f) frac = 1.0f;
+    return (a + ab * frac - p).length();
+}
+
+// maximum distance from densely sampled curve to segmented result
+float max_error( const Vec2f& p0, const Vec2f& p1, const Vec2f& p2, const Vec2f& p3,
+                 const Geometry::HostVertexCache& segments )
+{
+    float result = 0.0f;
+
+    for (int i_sample = 0; i_sample <= 500; i_sample++)
+    {
+        float t = i_sample / 500.0f;
+        float u = 1.0f - t;
+        Vec2f p = p0 * (u * u * u) + p1 * (3.0f * u * u * t) + p2 * (3.0f * u * t * t) + p3 * (t * t * t);
+
+        float dist = std::numeric_limits<float>::max();
+        for (int i = 1; i < segments.size(); i++)
+            dist = std::min( dist, seg_dist( p, segments.get<Vec2f>( i - 1 ), segments.get<Vec2f>( i ) ) );
+
+        result = std::max( result, dist );
+    }
+
+    return result;
+}
+
+void TestFramework::content()
+{
+    Vec2f p0( 0.0f, 0.0f );
+    Vec2f p1( 10.0f, 80.0f );
+    Vec2f p2( 90.0f, -40.0f );
+    Vec2f p3( 100.0f, 20.0f );
+    PathGlyph glyph( p1, p2, p3 );
+
+    {
+        OK( "cubic bessel within tolerance" );
+        Geometry::HostVertexCache segments( sizeof(Vec2f) );
+        segments.add( p0 );
+        glyph.segment( p0, 0.25f, segments );
+
+        IS( segments.size(), glyph.get_num_bessel_segment( p0, 0.25f ) + 1 );
+        OK( segments.get_last<Vec2f>() == p3 );
+        OK( max_error( p0, p1, p2, p3, segments ) <= 0.25f );
+    }
+
+    {
+        OK( "larger tolerance gives fewer segments" );
+        int num_fine   = glyph.get_num_bessel_segment( p0, 0.1f );
+        int num_coarse = glyph.get_num_bessel_segment( p0, 1.0f );
+        OK( num_coarse < num_fine );
+
+        Geometry::HostVertexCache segments( sizeof(Vec2f) );
+        segments.add( p0 );
+        glyph.segment( p0, 1.0f, segments );
+        OK( max_error( p0, p1, p2, p3, segments ) <= 1.0f );
+    }
+
+    {
+        OK( "straight curve is one segment" );
+        PathGlyph straight( Vec2f( 1.0f, 1.0f ), Vec2f( 2.0f, 2.0f ), Vec2f( 3.0f, 3.0f ) );
+        IS( straight.get_num_bessel_segment( Vec2f( 0.0f, 0.0f ), 0.25f ), 1 );
+    }
+
+    {
+        OK( "quadratic bessel" );
+        PathGlyph quad( Vec2f( 50.0f, 100.0f ), Vec2f( 100.0f, 0.0f ) );
+        Geometry::HostVertexCache segments( sizeof(Vec2f) );
+        quad.segment( p0, 0.25f, segments );
+
+        IS( segments.size(),                  quad.get_num_bessel_segment( p0, 0.25f ) );
+        IS( segments.get_last<Vec2f>().x,     100.0f );
+        IS( segments.get_last<Vec2f>().y,     0.0f );
+
+        // curve is symmetric
+        int num = segments.size();
+        for (int i = 1; i < num; i++)
+        {
+            const Vec2f& a = segments.get<Vec2f>( i - 1 );
+            const Vec2f& b = segments.get<Vec2f>( num - i - 1 );
+            OK( std::abs( a.x + b.x - 100.0f ) < 0.001f );
+            OK( std::abs( a.y - b.y ) < 0.001f );
+        }
+    }
+
+    {
+        OK( "half circle arc" );
+        PathGlyph arc( Vec2f( 0.0f, 0.0f ), Vec2f( -10.0f, 0.0f ), PI, true );
+        Geometry::HostVertexCache segments( sizeof(Vec2f) );
+        arc.segment( Vec2f( 10.0f, 0.0f ), 0.25f, segments );
+
+        // each step is at most 2 * acos(1 - 0.25 / 10)
+        IS( segments.size(), 8 );
+        OK( segments.get<Vec2f>( 0 ).y > 0.0f );
+        IS( segments.get_last<Vec2f>().x, -10.0f );
+    }
+}
@@ -0,0 +1,104 @@
+#include "TestFramework.h"
+
+#include "treeface/misc/RadixSort.h"
+
+#include <treecore/Array.h>
+
+using namespace treecore;
+using namespace treeface;
+
+struct KeyValue
+{
+    uint64 key;
+    int    value;
+};
+
+struct KeyValueKeyGetter
+{
+    uint64 operator ()( const KeyValue& item ) const noexcept
+    {
+        return item.key;
+    }
+};
+
+void TestFramework::content()
+{
+    {
+        OK( "sort keys spread on all bytes" );
+        Array<KeyValue> data;
+        Array<KeyValue> buffer;
+
+        uint64 seed = 12345;
+        for (int i = 0; i < 1000; i++)
+        {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            data.add( { seed, i } );
+        }
+
+        radix_sort( data, buffer, KeyValueKeyGetter() );
+
+        IS( data.size(), 1000 );
+        bool sorted = true;
+        for (int i = 1; i < data.size(); i++)
+        {
+            if (data[i - 1].key > data[i].key)
+                sorted = false;
+        }
+        OK( sorted );
+    }
+
+    {
+        OK( "sort is stable" );
+        Array<KeyValue> data;
+        Array<KeyValue> buffer;
+
+        for (int i = 0; i < 100; i++)
+            data.add( { uint64( (99 - i) % 4 ) << 40, i } );
+
+        radix_sort( data, buffer, KeyValueKeyGetter() );
+
+        bool stable = true;
+        for (int i = 1; i < data.size(); i++)
+        {
+            if (data[i - 1].key > data[i].key)
+                stable = false;
+            else if (data[i - 1].key == data[i].key && data[i - 1].value > data[i].value)
+                stable = false;
+        }
+        OK( stable );
+        IS( data[0].key, uint64( 0 ) );
+        IS( data[0].value, 3 );
+        IS( data[99].key, uint64( 3 ) << 40 );
+        IS( data[99].value, 96 );
+    }
+
+    {
+        OK( "sort with identical keys" );
+        Array<KeyValue> data;
+        Array<KeyValue> buffer;
+
+        for (int i = 0; i < 10; i++)
+            data.add( { 0xdeadbeefull, i } );
+
+        radix_sort( data, buffer, KeyValueKeyGetter() );
+
+        for (int i = 0; i < 10; i++)
+            IS( data[i].value, i );
+    }
+
+    {
+        OK( "float keys keep order" );
+        const float values[] = { -1.0e30f, -2.5f, -1.0f, -1.0e-30f, 0.0f, 1.0e-30f, 1.0f, 2.5f, 1.0e30f };
+        const int   num      = sizeof(values) / sizeof(values[0]);
+
+        bool ordered = true;
+        for (int i = 1; i < num; i++)
+        {
+            if ( float_to_radix_key( values[i - 1] ) >= float_to_radix_key( values[i] ) )
+                ordered = false;
+        }
+        OK( ordered );
+
+        IS( float_to_radix_key( -0.0f ), float_to_radix_key( 0.0f ) );
+    }
+}
@@ -0,0 +1,112 @@
+#include "TestFramework.h"
+
+#include "treeface/scene/NullRenderBackend.h"
+#include "treeface/scene/RecordingRenderBackend.h"
+#include "treeface/scene/RenderCommand.h"
+
+#include <treecore/MemoryOutputStream.h>
+#include <treecore/RefCountHolder.h>
+
+#include <cstring>
+
+using namespace treeface;
+using namespace treecore;
+
+// backends under test never dereference materials and objects
+static int dummy_mat[2];
+static int dummy_obj[3];
+
+#define FAKE_MAT( i ) reinterpret_cast<SceneGraphMaterial*>( &dummy_mat[i] )
+#define FAKE_OBJ( i ) reinterpret_cast<VisualObject*>( &dummy_obj[i] )
+
+void build_frame( RenderCommandList& list )
+{
+    list.clear();
+    list.matrices.resize( 7 );
+
+    list.object_blocks.add( 0 );
+    list.object_blocks.add( 1 );
+
+    list.add( RENDER_COMMAND_FRAME_BLOCK );
+    list.add( RENDER_COMMAND_OBJECT_BLOCKS );
+    list.add( RENDER_COMMAND_BIND_MATERIAL, 0, 0, FAKE_MAT( 0 ) );
+    list.add( RENDER_COMMAND_BIND_OBJECT,   0, 0, FAKE_MAT( 0 ), FAKE_OBJ( 0 ) );
+    list.add( RENDER_COMMAND_OBJECT_BLOCK,  0, 0, FAKE_MAT( 0 ) );
+    list.add( RENDER_COMMAND_DRAW,          0, 0, FAKE_MAT( 0 ), FAKE_OBJ( 0 ) );
+    list.add( RENDER_COMMAND_BIND_OBJECT,   0, 0, FAKE_MAT( 0 ), FAKE_OBJ( 1 ) );
+    list.add( RENDER_COMMAND_OBJECT_BLOCK,  1, 0, FAKE_MAT( 0 ) );
+    list.add( RENDER_COMMAND_DRAW,          0, 0, FAKE_MAT( 0 ), FAKE_OBJ( 1 ) );
+    list.add( RENDER_COMMAND_BIND_MATERIAL, 1, 0, FAKE_MAT( 1 ) );
+    list.add( RENDER_COMMAND_DRAW_INSTANCED, 2, 5, FAKE_MAT( 1 ), FAKE_OBJ( 2 ) );
+    list.add( RENDER_COMMAND_FINISH );
+}
+
+void TestFramework::content()
+{
+    RenderCommandList list;
+    build_frame( list );
+    IS( list.commands.size(), 12 );
+
+    // commands are compared as plain data
+    {
+        RenderCommandList other;
+        build_frame( other );
+        OK( list.commands[10] == other.commands[10] );
+        other.commands[10].arg1 = 4;
+        OK( list.commands[10] != other.commands[10] );
+    }
+
+    // null backend
+    {
+        RefCountHolder<NullRenderBackend> backend = new NullRenderBackend();
+        backend->execute( list );
+        backend->execute( list );
+
+        IS( backend->get_num_frames(),    2 );
+        IS( backend->get_num_commands(),  24 );
+        IS( backend->get_num_draws(),     6 );
+        IS( backend->get_num_instances(), 14 );
+
+        backend->reset_counters();
+        IS( backend->get_num_frames(), 0 );
+    }
+
+    // recording backend
+    {
+        MemoryOutputStream* stream = new MemoryOutputStream();
+        RefCountHolder<RecordingRenderBackend> backend = new RecordingRenderBackend( stream );
+        backend->execute( list );
+        backend->execute( list );
+        IS( backend->get_num_frames(), 2 );
+
+        const size_t frame_size = sizeof(uint32) * 4 + sizeof(Mat4f) * 2 + sizeof(Vec4f) * 3 +
+                                  sizeof(ItemMatrices) * 7 + sizeof(int32) * 2 + sizeof(uint32) * 5 * 12;
+        IS( stream->getDataSize(), frame_size * 2 );
+
+        const uint8* data = static_cast<const uint8*>( stream->getData() );
+
+        uint32 header[4];
+        memcpy( header, data + frame_size, sizeof(header) );
+        IS( header[0], uint32( RENDER_RECORD_FRAME_MAGIC ) );
+        IS( header[1], 12 );
+        IS( header[2], 7 );
+        IS( header[3], 2 );
+
+        // material and object IDs are kept across frames
+        const size_t cmd_offset = frame_size - sizeof(uint32) * 5 * 12;
+
+        uint32 draw_inst[5];
+        memcpy( draw_inst, data + frame_size + cmd_offset + sizeof(uint32) * 5 * 10, sizeof(draw_inst) );
+        IS( draw_inst[0], uint32( RENDER_COMMAND_DRAW_INSTANCED ) );
+        IS( draw_inst[1], 2 );
+        IS( draw_inst[2], 5 );
+        IS( draw_inst[3], 2 );
+        IS( draw_inst[4], 3 );
+
+        uint32 finish[5];
+        memcpy( finish, data + frame_size + cmd_offset + sizeof(uint32) * 5 * 11, sizeof(finish) );
+        IS( finish[0], uint32( RENDER_COMMAND_FINISH ) );
+        IS( finish[3], 0 );
+        IS( finish[4], 0 );
+    }
+}
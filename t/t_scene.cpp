@@ -108,6 +108,9 @@ void TestFramework::content()
     IS_EPSILON( l_ambient.get_z(),   0.2 );
     IS_EPSILON( l_ambient.get_w(),   1 );
 
+    // depth sort policy is not specified
+    IS( scene->get_depth_sort_policy(), DEPTH_SORT_NONE );
+
     // node hierarchy
     SceneNode* root_node = scene->get_root_node();
     SceneNode* node_a    = scene->get_node( "a" );
@@ -0,0 +1,165 @@
+#include "TestFramework.h"
+
+#include "treeface/scene/SceneNode.h"
+#include "treeface/scene/TransformStore.h"
+
+#include "treeface/scene/guts/SceneNode_guts.h"
+
+#include <treecore/RefCountHolder.h>
+
+using namespace treeface;
+using namespace treecore;
+
+void TestFramework::content()
+{
+    RefCountHolder<SceneNode> root = new SceneNode();
+    SceneNode* child      = new SceneNode();
+    SceneNode* grandchild = new SceneNode();
+    root->add_child( child );
+    child->add_child( grandchild );
+
+    Mat4f trans_root;
+    trans_root.set_translate( 1, 2, 3 );
+    Mat4f trans_child;
+    trans_child.set_scale( 2, 2, 2 );
+    Mat4f trans_grandchild;
+    trans_grandchild.set_translate( 10, 0, 0 );
+
+    root->set_transform( trans_root );
+    child->set_transform( trans_child );
+    grandchild->set_transform( trans_grandchild );
+
+    OK( "lazy global transform" );
+    {
+        const Mat4f& global = grandchild->get_global_transform();
+        IS_EPSILON( global.get<0, 0>(), 2.0f );
+        IS_EPSILON( global.get<0, 3>(), 21.0f );
+        IS_EPSILON( global.get<1, 3>(), 2.0f );
+        IS_EPSILON( global.get<2, 3>(), 3.0f );
+    }
+
+    OK( "ancestor modification reaches descendants" );
+    {
+        trans_root.set_translate( 5, 0, 0 );
+        root->set_transform( trans_root );
+
+        const Mat4f& global = grandchild->get_global_transform();
+        IS_EPSILON( global.get<0, 3>(), 25.0f );
+    }
+
+    OK( "top-down update" );
+    {
+        trans_child.set_scale( 3, 3, 3 );
+        child->set_transform( trans_child );
+        root->update_global_transforms();
+
+        IS_EPSILON( child->get_global_transform().get<0, 0>(), 3.0f );
+        IS_EPSILON( grandchild->get_global_transform().get<0, 3>(), 35.0f );
+    }
+
+    OK( "top-down update after lazy read" );
+    {
+        trans_child.set_scale( 4, 4, 4 );
+        child->set_transform( trans_child );
+
+        // child becomes clean, while grandchild is still dirty
+        IS_EPSILON( child->get_global_transform().get<0, 0>(), 4.0f );
+        OK( grandchild->m_impl->global_dirty );
+
+        root->update_global_transforms();
+        OK( !grandchild->m_impl->global_dirty );
+        OK( !child->m_impl->global_dirty_below );
+        IS_EPSILON( grandchild->m_impl->trans_global.get<0, 3>(), 45.0f );
+
+        trans_child.set_scale( 3, 3, 3 );
+        child->set_transform( trans_child );
+        root->update_global_transforms();
+    }
+
+    OK( "global inverse" );
+    {
+        const Mat4f& inv = grandchild->get_global_transform_inv();
+        IS_EPSILON( inv.get<0, 0>(), 1.0f / 3 );
+        IS_EPSILON( inv.get<0, 3>(), -35.0f / 3 );
+
+        Mat4f mul = grandchild->get_global_transform() * inv;
+        IS_EPSILON( mul.get<0, 0>(), 1.0f );
+        IS_EPSILON( mul.get<1, 1>(), 1.0f );
+        IS_EPSILON( mul.get<3, 3>(), 1.0f );
+
+        const Mat4f& local_inv = child->get_transform_inv();
+        IS_EPSILON( local_inv.get<0, 0>(), 1.0f / 3 );
+    }
+
+    OK( "moved subtree" );
+    {
+        RefCountHolder<SceneNode> other_root = new SceneNode();
+        Mat4f trans_other;
+        trans_other.set_translate( 0, 100, 0 );
+        other_root->set_transform( trans_other );
+
+        RefCountHolder<SceneNode> child_holder = child;
+        root->remove_child( child );
+        other_root->add_child( child );
+        other_root->update_global_transforms();
+
+        IS_EPSILON( grandchild->get_global_transform().get<0, 3>(), 30.0f );
+        IS_EPSILON( grandchild->get_global_transform().get<1, 3>(), 100.0f );
+    }
+
+    OK( "contiguous transform store" );
+    {
+        RefCountHolder<SceneNode> store_root = new SceneNode();
+        SceneNode* a  = new SceneNode();
+        SceneNode* b  = new SceneNode();
+        SceneNode* a1 = new SceneNode();
+        store_root->add_child( a );
+        store_root->add_child( b );
+        a->add_child( a1 );
+
+        Mat4f trans;
+        trans.set_translate( 1, 0, 0 );
+        a->set_transform( trans );
+        a1->set_transform( trans );
+        trans.set_translate( 0, 1, 0 );
+        b->set_transform( trans );
+
+        RefCountHolder<TransformStore> store = new TransformStore( store_root );
+        store->update();
+        IS( store->get_num_nodes(), 4 );
+        IS_EPSILON( a1->get_global_transform().get<0, 3>(), 2.0f );
+        IS_EPSILON( b->get_global_transform().get<1, 3>(), 1.0f );
+
+        // modification goes to store, and queries only see it after update
+        trans.set_translate( 5, 0, 0 );
+        a->set_transform( trans );
+        IS_EPSILON( a1->get_global_transform().get<0, 3>(), 2.0f );
+        store->update();
+        IS_EPSILON( a1->get_global_transform().get<0, 3>(), 6.0f );
+        IS_EPSILON( a1->get_global_transform_inv().get<0, 3>(), -6.0f );
+
+        // new nodes are picked up on update
+        SceneNode* a2 = new SceneNode();
+        trans.set_translate( 0, 0, 1 );
+        a2->set_transform( trans );
+        a->add_child( a2 );
+        IS_EPSILON( a2->get_global_transform().get<0, 3>(), 5.0f );
+        IS_EPSILON( a2->get_global_transform().get<2, 3>(), 1.0f );
+        store_root->update_global_transforms();
+        IS( store->get_num_nodes(), 5 );
+
+        // detached nodes calculate by themselves
+        RefCountHolder<SceneNode> a_holder = a;
+        store_root->remove_child( a );
+        IS_EPSILON( a1->get_global_transform().get<0, 3>(), 6.0f );
+        trans.set_translate( 3, 0, 0 );
+        a->set_transform( trans );
+        IS_EPSILON( a1->get_global_transform().get<0, 3>(), 4.0f );
+
+        // nodes keep working after store is released
+        store = nullptr;
+        trans.set_translate( 0, 7, 0 );
+        store_root->set_transform( trans );
+        IS_EPSILON( b->get_global_transform().get<1, 3>(), 8.0f );
+    }
+}
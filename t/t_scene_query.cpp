@@ -0,0 +1,191 @@
+#include "TestFramework.h"
+
+#include "treeface/scene/SceneNode.h"
+#include "treeface/scene/SceneQuery.h"
+
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
+#include <treecore/Result.h>
+
+using namespace treeface;
+using namespace treecore;
+
+class RecordQuery: public SceneQuery
+{
+public:
+    Array<SceneNode*> visited;
+    SceneNode* skip = nullptr;
+
+protected:
+    Result traverse_begin() noexcept override
+    {
+        visited.clear();
+        return Result::ok();
+    }
+
+    Result traverse_one_node( SceneNode* node, bool& skip_children ) noexcept override
+    {
+        visited.add( node );
+        if (node == skip)
+            skip_children = true;
+        return Result::ok();
+    }
+
+    Result traverse_end() noexcept override
+    {
+        return Result::ok();
+    }
+};
+
+void collect_recursive( SceneNode* node, SceneNode* skip, Array<SceneNode*>& result )
+{
+    result.add( node );
+    if (node == skip)
+        return;
+
+    for (int i = 0; i < node->get_num_children(); i++)
+        collect_recursive( node->get_child_at( i ), skip, result );
+}
+
+bool same_sequence( const Array<SceneNode*>& a, const Array<SceneNode*>& b )
+{
+    if ( a.size() != b.size() )
+        return false;
+
+    for (int i = 0; i < a.size(); i++)
+    {
+        if (a[i] != b[i])
+            return false;
+    }
+
+    return true;
+}
+
+void TestFramework::content()
+{
+    // root
+    //  +- n1
+    //  |   +- n11
+    //  |   +- n12
+    //  |       +- n121
+    //  +- n2
+    //      +- n21
+    RefCountHolder<SceneNode> root = new SceneNode();
+    SceneNode* n1   = new SceneNode();
+    SceneNode* n2   = new SceneNode();
+    SceneNode* n11  = new SceneNode();
+    SceneNode* n12  = new SceneNode();
+    SceneNode* n121 = new SceneNode();
+    SceneNode* n21  = new SceneNode();
+    root->add_child( n1 );
+    root->add_child( n2 );
+    n1->add_child( n11 );
+    n1->add_child( n12 );
+    n12->add_child( n121 );
+    n2->add_child( n21 );
+
+    RefCountHolder<RecordQuery> query = new RecordQuery();
+
+    OK( "stack traverse in pre-order" );
+    {
+        Array<SceneNode*> expect;
+        collect_recursive( root, nullptr, expect );
+
+        OK( query->traverse( root ) );
+        IS( query->visited.size(), 7 );
+        OK( same_sequence( query->visited, expect ) );
+    }
+
+    OK( "stack traverse skipping subtree" );
+    {
+        Array<SceneNode*> expect;
+        collect_recursive( root, n1, expect );
+
+        query->skip = n1;
+        OK( query->traverse( root ) );
+        IS( query->visited.size(), 4 );
+        OK( same_sequence( query->visited, expect ) );
+        query->skip = nullptr;
+    }
+
+    OK( "flattened traverse" );
+    {
+        query->set_flatten( true );
+
+        Array<SceneNode*> expect;
+        collect_recursive( root, nullptr, expect );
+        OK( query->traverse( root ) );
+        OK( same_sequence( query->visited, expect ) );
+
+        // second run uses cached sequence
+        OK( query->traverse( root ) );
+        OK( same_sequence( query->visited, expect ) );
+
+        Array<SceneNode*> expect_skip;
+        collect_recursive( root, n12, expect_skip );
+        query->skip = n12;
+        OK( query->traverse( root ) );
+        IS( query->visited.size(), 6 );
+        OK( same_sequence( query->visited, expect_skip ) );
+        query->skip = nullptr;
+    }
+
+    OK( "flattened traverse after hierarchy change" );
+    {
+        uint32 version = root->get_hierarchy_version();
+        SceneNode* n122 = new SceneNode();
+        n12->add_child( n122 );
+        OK( root->get_hierarchy_version() != version );
+
+        Array<SceneNode*> expect;
+        collect_recursive( root, nullptr, expect );
+        OK( query->traverse( root ) );
+        IS( query->visited.size(), 8 );
+        OK( same_sequence( query->visited, expect ) );
+
+        version = root->get_hierarchy_version();
+        root->remove_child( n1 );
+        OK( root->get_hierarchy_version() != version );
+
+        expect.clear();
+        collect_recursive( root, nullptr, expect );
+        OK( query->traverse( root ) );
+        IS( query->visited.size(), 3 );
+        OK( same_sequence( query->visited, expect ) );
+
+        query->set_flatten( false );
+        OK( query->traverse( root ) );
+        OK( same_sequence( query->visited, expect ) );
+    }
+
+    OK( "deep hierarchy" );
+    {
+        RefCountHolder<SceneNode> deep_root = new SceneNode();
+        SceneNode* curr = deep_root;
+        for (int i = 0; i < 10000; i++)
+        {
+            SceneNode* child = new SceneNode();
+            curr->add_child( child );
+            curr = child;
+        }
+
+        OK( query->traverse( deep_root ) );
+        IS( query->visited.size(), 10001 );
+        IS( query->visited.getLast(), curr );
+
+        query->set_flatten( true );
+        OK( query->traverse( deep_root ) );
+        IS( query->visited.size(), 10001 );
+        IS( query->visited.getLast(), curr );
+        query->set_flatten( false );
+
+        // release chain from bottom, so that destruction does not recurse
+        // through the whole hierarchy
+        while (curr != deep_root)
+        {
+            SceneNode* parent = curr->get_parent();
+            parent->remove_child( curr );
+            curr = parent;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#include "TestFramework.h"
+
+#include "treeface/misc/ScratchArena.h"
+
+#include <thread>
+
+using namespace treeface;
+using namespace treecore;
+
+void TestFramework::content()
+{
+    ScratchArena arena( 1024 );
+    IS( arena.get_num_used(), 0 );
+    IS( arena.get_peak(),     0 );
+    IS( arena.get_capacity(), 0 );
+
+    // allocations are aligned and do not overlap
+    uint8*  bytes = arena.allocate<uint8>( 3 );
+    uint32* words = arena.allocate<uint32>( 10 );
+    OK( bytes );
+    OK( words );
+    IS( size_t( bytes ) % SCRATCH_ARENA_ALIGN, 0 );
+    IS( size_t( words ) % SCRATCH_ARENA_ALIGN, 0 );
+    OK( (uint8*) words >= bytes + 3 );
+    IS( arena.get_num_used(), 56 );
+    IS( arena.get_capacity(), 1024 );
+
+    for (int i = 0; i < 10; i++)
+        words[i] = uint32( i );
+
+    // nested scope is rewound
+    {
+        ScratchScope scope( arena );
+        float* floats = arena.allocate<float>( 100 );
+        floats[99] = 1.0f;
+        IS( arena.get_num_used(), 64 + 400 );
+    }
+    IS( arena.get_num_used(), 56 );
+    IS( arena.get_peak(),     64 + 400 );
+
+    // big allocation goes to new chunk, and old content is kept
+    {
+        ScratchScope scope( arena );
+        uint8* big = arena.allocate<uint8>( 4000 );
+        OK( big );
+        big[3999] = 1;
+        IS( arena.get_capacity(), 1024 + 4000 );
+        IS( words[9],             9 );
+    }
+    IS( arena.get_num_used(), 56 );
+    IS( arena.get_peak(),     56 + 4000 );
+
+    // after full reset, chunks are merged so next time one chunk is enough
+    arena.reset();
+    IS( arena.get_num_used(), 0 );
+    IS( arena.get_capacity(), 1024 + 4000 );
+
+    uint8* merged1 = arena.allocate<uint8>( 1000 );
+    uint8* merged2 = arena.allocate<uint8>( 4000 );
+    IS( merged2 - merged1, 1008 );
+    IS( arena.get_capacity(), 1024 + 4000 );
+
+    arena.reset();
+    arena.reset_peak();
+    IS( arena.get_peak(), 0 );
+
+    // each thread has its own arena
+    ScratchArena* arena_main  = &ScratchArena::get_thread_arena();
+    ScratchArena* arena_other = nullptr;
+    std::thread   thread( [&arena_other]() { arena_other = &ScratchArena::get_thread_arena(); } );
+    thread.join();
+    OK( arena_other );
+    OK( arena_main != arena_other );
+    IS( arena_main, &ScratchArena::get_thread_arena() );
+}
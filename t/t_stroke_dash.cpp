@@ -0,0 +1,201 @@
+#include "TestFramework.h"
+
+#include "treeface/graphics/guts/SubPath.h"
+#include "treeface/graphics/ShapeGenerator.h"
+#include "treeface/math/Constants.h"
+
+#include <cmath>
+#include <initializer_list>
+
+using namespace treeface;
+using namespace treecore;
+
+struct StrokeResult
+{
+    StrokeResult(): vertices( sizeof(StrokeVertex) ) {}
+
+    Geometry::HostVertexCache vertices;
+    Array<uint32> indices;
+};
+
+SubPath make_path( const Vec2f* points, int num_point, bool closed )
+{
+    SubPath path;
+    for (int i = 0; i < num_point; i++)
+        path.glyphs.add( PathGlyph( points[i] ) );
+    path.closed = closed;
+    return path;
+}
+
+SubPath make_path( const Array<Vec2f>& points )
+{
+    SubPath path;
+    for (const Vec2f& p : points)
+        path.glyphs.add( PathGlyph( p ) );
+    return path;
+}
+
+void do_stroke( const SubPath& path, const StrokeStyle& style, StrokeResult& result )
+{
+    Vec2f skel_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skel_max( -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() );
+    path.stroke_complex( result.vertices, result.indices, skel_min, skel_max, style, SHAPE_GENERATOR_DEFAULT_TOLERANCE );
+}
+
+// stroke each expected dash as a separate solid subpath
+void do_stroke_pieces( const Array<Array<Vec2f> >& pieces, const StrokeStyle& style, StrokeResult& result )
+{
+    StrokeStyle style_solid{ style.cap, style.join, style.miter_cutoff, style.width };
+    for (const Array<Vec2f>& piece : pieces)
+        do_stroke( make_path( piece ), style_solid, result );
+}
+
+bool same_result( const StrokeResult& expect, const StrokeResult& result )
+{
+    if ( expect.vertices.size() != result.vertices.size() || expect.vertices.size() == 0 )
+        return false;
+
+    for (int i = 0; i < expect.vertices.size(); i++)
+    {
+        const StrokeVertex& a = expect.vertices.get<StrokeVertex>( i );
+        const StrokeVertex& b = result.vertices.get<StrokeVertex>( i );
+        if (a.position != b.position || a.tangent_unorm != b.tangent_unorm || a.trip != b.trip || a.side != b.side)
+            return false;
+    }
+
+    return expect.indices == result.indices;
+}
+
+float total_area( const StrokeResult& result )
+{
+    float area = 0.0f;
+    for (int i = 0; i + 2 < result.indices.size(); i += 3)
+    {
+        const Vec2f& a = result.vertices.get<StrokeVertex>( result.indices[i] ).position;
+        const Vec2f& b = result.vertices.get<StrokeVertex>( result.indices[i + 1] ).position;
+        const Vec2f& c = result.vertices.get<StrokeVertex>( result.indices[i + 2] ).position;
+        area += std::abs( (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) ) / 2;
+    }
+    return area;
+}
+
+Array<Vec2f> make_piece( std::initializer_list<Vec2f> points )
+{
+    Array<Vec2f> result;
+    for (const Vec2f& p : points)
+        result.add( p );
+    return result;
+}
+
+void TestFramework::content()
+{
+    const Vec2f corner[] = { Vec2f( 0.0f, 0.0f ), Vec2f( 16.0f, 0.0f ), Vec2f( 16.0f, 16.0f ) };
+    const Vec2f square[] = { Vec2f( 0.0f, 0.0f ), Vec2f( 8.0f, 0.0f ), Vec2f( 8.0f, 8.0f ), Vec2f( 0.0f, 8.0f ) };
+    const Vec2f line[]   = { Vec2f( 0.0f, 0.0f ), Vec2f( 16.0f, 0.0f ) };
+
+    const float dash_10_2[] = { 10.0f, 2.0f };
+    const float dash_5[]    = { 5.0f };
+    const float dash_6_2[]  = { 6.0f, 2.0f };
+    const float dash_0_4[]  = { 0.0f, 4.0f };
+    const float dash_zero[] = { 0.0f, 0.0f };
+
+    // no dash is same as solid stroke
+    {
+        SubPath path = make_path( corner, 3, false );
+
+        StrokeResult expect;
+        do_stroke( path, StrokeStyle{ LINE_CAP_ROUND, LINE_JOIN_MITER, float( M_PI ) / 6, 2.0f }, expect );
+
+        StrokeResult result;
+        do_stroke( path, StrokeStyle{ LINE_CAP_ROUND, LINE_JOIN_MITER, float( M_PI ) / 6, 2.0f, dash_zero, 2, 3.0f }, result );
+        OK( same_result( expect, result ) );
+    }
+
+    // dash across corner has line join
+    {
+        StrokeStyle style{ LINE_CAP_BUTT, LINE_JOIN_MITER, float( M_PI ) / 6, 2.0f, dash_10_2, 2, 0.0f };
+
+        StrokeResult result;
+        do_stroke( make_path( corner, 3, false ), style, result );
+
+        Array<Array<Vec2f> > pieces;
+        pieces.add( make_piece( { Vec2f( 0.0f, 0.0f ), Vec2f( 10.0f, 0.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 12.0f, 0.0f ), Vec2f( 16.0f, 0.0f ), Vec2f( 16.0f, 6.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 16.0f, 8.0f ), Vec2f( 16.0f, 16.0f ) } ) );
+
+        StrokeResult expect;
+        do_stroke_pieces( pieces, style, expect );
+        OK( same_result( expect, result ) );
+    }
+
+    // dash offset, negative offset is wrapped into pattern
+    {
+        Array<Array<Vec2f> > pieces;
+        pieces.add( make_piece( { Vec2f( 0.0f, 0.0f ), Vec2f( 7.0f, 0.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 9.0f, 0.0f ), Vec2f( 16.0f, 0.0f ), Vec2f( 16.0f, 3.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 16.0f, 5.0f ), Vec2f( 16.0f, 15.0f ) } ) );
+
+        StrokeStyle style{ LINE_CAP_SQUARE, LINE_JOIN_ROUND, float( M_PI ) / 6, 1.0f, dash_10_2, 2, 3.0f };
+
+        StrokeResult expect;
+        do_stroke_pieces( pieces, style, expect );
+
+        StrokeResult result;
+        do_stroke( make_path( corner, 3, false ), style, result );
+        OK( same_result( expect, result ) );
+
+        StrokeResult result_neg;
+        style.dash_offset = -9.0f;
+        do_stroke( make_path( corner, 3, false ), style, result_neg );
+        OK( same_result( expect, result_neg ) );
+    }
+
+    // odd number of lengths are repeated
+    {
+        StrokeStyle style{ LINE_CAP_BUTT, LINE_JOIN_BEVEL, float( M_PI ) / 6, 1.0f, dash_5, 1, 0.0f };
+
+        StrokeResult result;
+        do_stroke( make_path( line, 2, false ), style, result );
+
+        Array<Array<Vec2f> > pieces;
+        pieces.add( make_piece( { Vec2f( 0.0f, 0.0f ), Vec2f( 5.0f, 0.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 10.0f, 0.0f ), Vec2f( 15.0f, 0.0f ) } ) );
+
+        StrokeResult expect;
+        do_stroke_pieces( pieces, style, expect );
+        OK( same_result( expect, result ) );
+    }
+
+    // dash that reaches end of closed path continues at its beginning
+    {
+        StrokeStyle style{ LINE_CAP_BUTT, LINE_JOIN_MITER, float( M_PI ) / 6, 1.0f, dash_6_2, 2, 4.0f };
+
+        StrokeResult result;
+        do_stroke( make_path( square, 4, true ), style, result );
+
+        Array<Array<Vec2f> > pieces;
+        pieces.add( make_piece( { Vec2f( 4.0f, 0.0f ), Vec2f( 8.0f, 0.0f ), Vec2f( 8.0f, 2.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 8.0f, 4.0f ), Vec2f( 8.0f, 8.0f ), Vec2f( 6.0f, 8.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 4.0f, 8.0f ), Vec2f( 0.0f, 8.0f ), Vec2f( 0.0f, 6.0f ) } ) );
+        pieces.add( make_piece( { Vec2f( 0.0f, 4.0f ), Vec2f( 0.0f, 0.0f ), Vec2f( 2.0f, 0.0f ) } ) );
+
+        StrokeResult expect;
+        do_stroke_pieces( pieces, style, expect );
+        OK( same_result( expect, result ) );
+    }
+
+    // zero-length dashes are dots drawn by caps
+    {
+        StrokeStyle style{ LINE_CAP_ROUND, LINE_JOIN_MITER, float( M_PI ) / 6, 2.0f, dash_0_4, 2, 0.0f };
+
+        StrokeResult result;
+        do_stroke( make_path( line, 2, false ), style, result );
+        float area = total_area( result );
+        OK( std::abs( area - 5 * PI ) < 0.2f );
+
+        StrokeResult result_butt;
+        style.cap = LINE_CAP_BUTT;
+        do_stroke( make_path( line, 2, false ), style, result_butt );
+        IS( result_butt.vertices.size(), 0 );
+    }
+}
@@ -0,0 +1,198 @@
+#include "TestFramework.h"
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "treeface/gl/GLBuffer.h"
+#include "treeface/graphics/ShapeGenerator.h"
+#include "treeface/graphics/StrokeStream.h"
+#include "treeface/scene/Geometry.h"
+
+#include <treecore/RefCountHolder.h>
+
+#include <SDL.h>
+
+#include <cmath>
+
+using namespace treeface;
+using namespace treecore;
+
+#define NUM_POINT 20000
+#define NUM_FRAME 500
+#define NUM_POINT_PER_FRAME 7
+
+void build_up_sdl( SDL_Window** window, SDL_GLContext* context )
+{
+    SDL_Init( SDL_INIT_VIDEO & SDL_INIT_TIMER & SDL_INIT_EVENTS );
+
+    *window = SDL_CreateWindow( "stroke stream test", 50, 50, 400, 400, SDL_WINDOW_OPENGL );
+    if (!*window)
+        die( "error: failed to create window: %s\n", SDL_GetError() );
+
+    *context = SDL_GL_CreateContext( *window );
+    if (!context)
+        die( "error: failed to create GL context: %s\n", SDL_GetError() );
+
+    SDL_GL_MakeCurrent( *window, *context );
+
+    GLenum glew_err = glewInit();
+    if (glew_err != GLEW_OK)
+        die( "error: failed to init glew: %s\n", glewGetErrorString( glew_err ) );
+}
+
+// wandering polyline that turns to both sides
+Vec2f get_point( int i )
+{
+    float t = float( i ) * 0.05f;
+    return Vec2f( t * 3.0f + 5.0f * std::sin( t * 1.3f ), 20.0f * std::sin( t * 0.37f ) + 3.0f * std::cos( t * 2.9f ) );
+}
+
+// streamed result only differs in trip, which is not normalized
+bool same_except_trip( Geometry* expect, Geometry* result )
+{
+    Geometry::HostDrawScope scope_expect( *expect );
+    Geometry::HostDrawScope scope_result( *result );
+
+    Geometry::HostVertexCache& vtx_expect = expect->get_host_vertex_cache();
+    Geometry::HostVertexCache& vtx_result = result->get_host_vertex_cache();
+    if ( vtx_expect.size() != vtx_result.size() || vtx_expect.size() == 0 )
+        return false;
+
+    for (int i = 0; i < vtx_expect.size(); i++)
+    {
+        const StrokeVertex& a = vtx_expect.get<StrokeVertex>( i );
+        const StrokeVertex& b = vtx_result.get<StrokeVertex>( i );
+        if (a.position != b.position || a.tangent_unorm != b.tangent_unorm || a.side != b.side)
+            return false;
+    }
+
+    if ( expect->get_index_type() != result->get_index_type() )
+        return false;
+
+    if (expect->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+        return expect->get_host_index_cache_32() == result->get_host_index_cache_32();
+    else
+        return expect->get_host_index_cache() == result->get_host_index_cache();
+}
+
+void TestFramework::content()
+{
+    SDL_Window*   window  = nullptr;
+    SDL_GLContext context = nullptr;
+    build_up_sdl( &window, &context );
+
+    LineJoin joins[] = { LINE_JOIN_MITER, LINE_JOIN_ROUND, LINE_JOIN_BEVEL };
+
+    for (LineJoin join : joins)
+    {
+        StrokeStyle style{ LINE_CAP_ROUND, join, float( M_PI ) / 6, 2.0f };
+
+        ShapeGenerator gen;
+        gen.move_to( get_point( 0 ) );
+        for (int i = 1; i < NUM_POINT; i++)
+            gen.line_to( get_point( i ) );
+
+        RefCountHolder<Geometry> expect = ShapeGenerator::create_complicated_stroke_geometry();
+        {
+            Geometry::HostDrawScope scope( *expect.get() );
+            gen.stroke_complicated_preserve( style, expect.get() );
+        }
+
+        RefCountHolder<Geometry> result = ShapeGenerator::create_complicated_stroke_geometry();
+        int max_pending = 0;
+        {
+            Geometry::HostDrawScope scope( *result.get() );
+            StrokeStream stream( result.get(), style );
+            stream.begin_path( get_point( 0 ) );
+            for (int i = 1; i < NUM_POINT; i++)
+            {
+                stream.line_to( get_point( i ) );
+                if (stream.get_num_pending_vertex() > max_pending)
+                    max_pending = stream.get_num_pending_vertex();
+            }
+
+            // triangles are appended before path ends
+            OK( result->get_host_vertex_cache().size() > 0 );
+
+            stream.end_path();
+            IS( stream.get_num_pending_vertex(), 0 );
+        }
+
+        OK( same_except_trip( expect.get(), result.get() ) );
+
+        // memory doesn't grow with path length
+        OK( max_pending < 1024 );
+
+        // trip is distance from path begin
+        Geometry::HostDrawScope scope( *result.get() );
+        const StrokeVertex& vtx_last = result->get_host_vertex_cache().get<StrokeVertex>( result->get_host_vertex_cache().size() - 1 );
+        OK( vtx_last.trip > 1000.0f );
+    }
+
+    // growing path that is drawn at each frame
+    {
+        StrokeStyle style{ LINE_CAP_SQUARE, LINE_JOIN_MITER, float( M_PI ) / 6, 2.0f };
+
+        RefCountHolder<Geometry> result = ShapeGenerator::create_complicated_stroke_geometry();
+        StrokeStream stream( result.get(), style );
+        ShapeGenerator gen;
+
+        stream.begin_path( get_point( 0 ) );
+        gen.move_to( get_point( 0 ) );
+
+        int i_point = 1;
+        int max_tail_byte = 0;
+        bool prefix_kept  = true;
+        for (int i_frame = 0; i_frame < NUM_FRAME; i_frame++)
+        {
+            // points may flush triangles into host cache
+            result->host_draw_begin();
+            for (int i = 0; i < NUM_POINT_PER_FRAME; i++, i_point++)
+            {
+                stream.line_to( get_point( i_point ) );
+                gen.line_to( get_point( i_point ) );
+            }
+
+            stream.update_preview();
+            int32 vtx_begin = 0;
+            int32 idx_begin = 0;
+            stream.take_modified_begin( vtx_begin, idx_begin );
+            result->host_draw_end_tail( vtx_begin, idx_begin );
+
+            Geometry::DirtyRange range{ 0, 0, 0, 0 };
+            if ( !result->get_dirty_range( range ) )
+                prefix_kept = false;
+            if (range.vertex_byte_end - range.vertex_byte_begin > max_tail_byte)
+                max_tail_byte = range.vertex_byte_end - range.vertex_byte_begin;
+            if (i_frame > 0 && range.vertex_byte_begin == 0)
+                prefix_kept = false;
+
+            result->get_vertex_buffer()->bind();
+            result->get_index_buffer()->bind();
+            result->upload_data();
+            result->get_vertex_buffer()->unbind();
+            result->get_index_buffer()->unbind();
+        }
+
+        OK( prefix_kept );
+        OK( !result->is_dirty() );
+        {
+            Geometry::HostDrawScope scope( *result.get() );
+            IS( result->get_num_index(), result->get_host_index_cache().size() );
+        }
+
+        // only the last joints and end cap are uploaded on each frame
+        OK( max_tail_byte < int( sizeof(StrokeVertex) ) * 1024 );
+
+        // preview is same with stroking the whole path
+        RefCountHolder<Geometry> expect = ShapeGenerator::create_complicated_stroke_geometry();
+        {
+            Geometry::HostDrawScope scope( *expect.get() );
+            gen.stroke_complicated_preserve( style, expect.get() );
+        }
+        OK( same_except_trip( expect.get(), result.get() ) );
+    }
+
+    SDL_GL_DeleteContext( context );
+    SDL_Quit();
+}
@@ -0,0 +1,272 @@
+#include "TestFramework.h"
+
+#include "treeface/graphics/guts/SweepFiller.h"
+
+#include <cmath>
+
+using namespace treeface;
+using namespace treecore;
+
+struct Polygons
+{
+    Polygons(): vertices( sizeof(Vec2f) ) {}
+
+    void begin_polygon()
+    {
+        subpath_begin.add( vertices.size() );
+    }
+
+    void add( float x, float y )
+    {
+        vertices.add( Vec2f( x, y ) );
+    }
+
+    Geometry::HostVertexCache vertices;
+    Array<int32> subpath_begin;
+};
+
+struct FillResult
+{
+    Array<Vec2f>  vertices;
+    Array<uint32> indices;
+    int num_crossing = 0;
+};
+
+FillResult do_fill( SweepFiller& filler, const Polygons& input, FillRule rule )
+{
+    Geometry::HostVertexCache vertices = input.vertices;
+    FillResult result;
+
+    Vec2f skel_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+    Vec2f skel_max( -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() );
+    filler.fill( rule, vertices, input.subpath_begin, result.indices, skel_min, skel_max );
+
+    for (int i = 0; i < vertices.size(); i++)
+        result.vertices.add( vertices.get<Vec2f>( i ) );
+    result.num_crossing = filler.num_crossing;
+    return result;
+}
+
+float triangle_area( const FillResult& result, int i_tri )
+{
+    const Vec2f& a = result.vertices[result.indices[i_tri * 3]];
+    const Vec2f& b = result.vertices[result.indices[i_tri * 3 + 1]];
+    const Vec2f& c = result.vertices[result.indices[i_tri * 3 + 2]];
+    return ( (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) ) / 2;
+}
+
+float total_area( const FillResult& result )
+{
+    float area = 0.0f;
+    for (int i = 0; i < result.indices.size() / 3; i++)
+        area += triangle_area( result, i );
+    return area;
+}
+
+bool all_counter_clockwise( const FillResult& result )
+{
+    for (int i = 0; i < result.indices.size() / 3; i++)
+        if (triangle_area( result, i ) <= 0.0f)
+            return false;
+    return true;
+}
+
+int32 winding_number( const Polygons& input, const Vec2f& p )
+{
+    int32 winding = 0;
+    for (int i_subpath = 0; i_subpath < input.subpath_begin.size(); i_subpath++)
+    {
+        int i_begin = input.subpath_begin[i_subpath];
+        int i_end   = i_subpath == input.subpath_begin.size() - 1 ? input.vertices.size() : input.subpath_begin[i_subpath + 1];
+
+        for (int i = i_begin; i < i_end; i++)
+        {
+            const Vec2f& a = input.vertices.get<Vec2f>( i );
+            const Vec2f& b = input.vertices.get<Vec2f>( i == i_end - 1 ? i_begin : i + 1 );
+
+            if ( (a.y <= p.y) != (b.y <= p.y) )
+            {
+                double x = a.x + (double( p.y ) - a.y) / (double( b.y ) - a.y) * (double( b.x ) - a.x);
+                if (x > p.x)
+                    winding += b.y > a.y ? 1 : -1;
+            }
+        }
+    }
+    return winding;
+}
+
+int num_covering_triangles( const FillResult& result, const Vec2f& p )
+{
+    int num = 0;
+    for (int i = 0; i < result.indices.size() / 3; i++)
+    {
+        const Vec2f& a = result.vertices[result.indices[i * 3]];
+        const Vec2f& b = result.vertices[result.indices[i * 3 + 1]];
+        const Vec2f& c = result.vertices[result.indices[i * 3 + 2]];
+
+        double ab = (double( b.x ) - a.x) * (double( p.y ) - a.y) - (double( b.y ) - a.y) * (double( p.x ) - a.x);
+        double bc = (double( c.x ) - b.x) * (double( p.y ) - b.y) - (double( c.y ) - b.y) * (double( p.x ) - b.x);
+        double ca = (double( a.x ) - c.x) * (double( p.y ) - c.y) - (double( a.y ) - c.y) * (double( p.x ) - c.x);
+        if (ab > 0.0 && bc > 0.0 && ca > 0.0)
+            num++;
+    }
+    return num;
+}
+
+// sample points are put off grid lines, so that they won't fall on edges
+int num_wrong_samples( const Polygons& input, const FillResult& result, FillRule rule, float size )
+{
+    int num_wrong = 0;
+    for (int i = 0; i < 40; i++)
+    {
+        for (int j = 0; j < 40; j++)
+        {
+            Vec2f p( (i + 0.371f) * size / 40, (j + 0.619f) * size / 40 );
+            int32 winding = winding_number( input, p );
+            bool  inside  = rule == FILL_NON_ZERO ? winding != 0 : (winding & 1) != 0;
+
+            if ( num_covering_triangles( result, p ) != (inside ? 1 : 0) )
+                num_wrong++;
+        }
+    }
+    return num_wrong;
+}
+
+void TestFramework::content()
+{
+    SweepFiller filler;
+
+    // bow-tie crosses itself once, both lobes are filled by both rules
+    {
+        Polygons bowtie;
+        bowtie.begin_polygon();
+        bowtie.add( 0, 0 );
+        bowtie.add( 2, 2 );
+        bowtie.add( 2, 0 );
+        bowtie.add( 0, 2 );
+
+        FillResult result = do_fill( filler, bowtie, FILL_NON_ZERO );
+        IS( result.num_crossing,     1 );
+        IS( result.vertices.size(),  5 );
+        IS( result.vertices[4].x,    1.0f );
+        IS( result.vertices[4].y,    1.0f );
+        IS( result.indices.size(),   6 );
+        IS( total_area( result ),    2.0f );
+        OK( all_counter_clockwise( result ) );
+
+        result = do_fill( filler, bowtie, FILL_EVEN_ODD );
+        IS( result.num_crossing,     1 );
+        IS( total_area( result ),    2.0f );
+    }
+
+    // overlapped part of two squares has winding number 2
+    {
+        Polygons squares;
+        squares.begin_polygon();
+        squares.add( 0, 0 );
+        squares.add( 2, 0 );
+        squares.add( 2, 2 );
+        squares.add( 0, 2 );
+        squares.begin_polygon();
+        squares.add( 1, 1 );
+        squares.add( 3, 1 );
+        squares.add( 3, 3 );
+        squares.add( 1, 3 );
+
+        FillResult result = do_fill( filler, squares, FILL_NON_ZERO );
+        IS( result.num_crossing,    2 );
+        IS( total_area( result ),   7.0f );
+        OK( all_counter_clockwise( result ) );
+        IS( num_wrong_samples( squares, result, FILL_NON_ZERO, 4 ), 0 );
+
+        result = do_fill( filler, squares, FILL_EVEN_ODD );
+        IS( result.num_crossing,    2 );
+        IS( total_area( result ),   6.0f );
+        OK( all_counter_clockwise( result ) );
+        IS( num_wrong_samples( squares, result, FILL_EVEN_ODD, 4 ), 0 );
+    }
+
+    // hole of reversed direction is empty by both rules, hole of same
+    // direction is only empty by even-odd rule
+    {
+        Polygons reversed;
+        reversed.begin_polygon();
+        reversed.add( 0, 0 );
+        reversed.add( 4, 0 );
+        reversed.add( 4, 4 );
+        reversed.add( 0, 4 );
+        reversed.begin_polygon();
+        reversed.add( 1, 1 );
+        reversed.add( 1, 3 );
+        reversed.add( 3, 3 );
+        reversed.add( 3, 1 );
+
+        IS( total_area( do_fill( filler, reversed, FILL_NON_ZERO ) ), 12.0f );
+        IS( total_area( do_fill( filler, reversed, FILL_EVEN_ODD ) ), 12.0f );
+
+        Polygons same;
+        same.begin_polygon();
+        same.add( 0, 0 );
+        same.add( 4, 0 );
+        same.add( 4, 4 );
+        same.add( 0, 4 );
+        same.begin_polygon();
+        same.add( 1, 1 );
+        same.add( 3, 1 );
+        same.add( 3, 3 );
+        same.add( 1, 3 );
+
+        FillResult result = do_fill( filler, same, FILL_NON_ZERO );
+        IS( result.num_crossing,  0 );
+        IS( total_area( result ), 16.0f );
+        IS( total_area( do_fill( filler, same, FILL_EVEN_ODD ) ), 12.0f );
+    }
+
+    // pentagram has center part of winding number 2
+    {
+        Polygons star;
+        star.begin_polygon();
+        for (int i = 0; i < 5; i++)
+        {
+            float angle = float( M_PI / 2 + i * 4 * M_PI / 5 );
+            star.add( 5 + 4 * std::cos( angle ), 5 + 4 * std::sin( angle ) );
+        }
+
+        FillResult result = do_fill( filler, star, FILL_NON_ZERO );
+        IS( result.num_crossing, 5 );
+        OK( all_counter_clockwise( result ) );
+        IS( num_wrong_samples( star, result, FILL_NON_ZERO, 10 ), 0 );
+
+        result = do_fill( filler, star, FILL_EVEN_ODD );
+        IS( result.num_crossing, 5 );
+        OK( all_counter_clockwise( result ) );
+        IS( num_wrong_samples( star, result, FILL_EVEN_ODD, 10 ), 0 );
+    }
+
+    // random polygons that cross themselves a lot
+    {
+        uint32 seed = 12345;
+        for (int i_round = 0; i_round < 20; i_round++)
+        {
+            Polygons random;
+            for (int i_subpath = 0; i_subpath < 1 + i_round % 3; i_subpath++)
+            {
+                random.begin_polygon();
+                for (int i = 0; i < 5 + i_round; i++)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    float x = float( (seed >> 8) % 1000 ) / 100;
+                    seed = seed * 1103515245 + 12345;
+                    float y = float( (seed >> 8) % 1000 ) / 100;
+                    random.add( x, y );
+                }
+            }
+
+            FillResult result = do_fill( filler, random, FILL_NON_ZERO );
+            IS( num_wrong_samples( random, result, FILL_NON_ZERO, 10 ), 0 );
+
+            result = do_fill( filler, random, FILL_EVEN_ODD );
+            IS( num_wrong_samples( random, result, FILL_EVEN_ODD, 10 ), 0 );
+        }
+    }
+}
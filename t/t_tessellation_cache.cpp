@@ -0,0 +1,203 @@
+#include "TestFramework.h"
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "treeface/graphics/ShapeGenerator.h"
+#include "treeface/graphics/TessellationCache.h"
+#include "treeface/graphics/VectorGraphicsMaterial.h"
+#include "treeface/misc/UniversalValue.h"
+#include "treeface/scene/Geometry.h"
+
+#include <treecore/RefCountHolder.h>
+
+#include <SDL.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace treeface;
+using namespace treecore;
+
+void build_up_sdl( SDL_Window** window, SDL_GLContext* context )
+{
+    SDL_Init( SDL_INIT_VIDEO & SDL_INIT_TIMER & SDL_INIT_EVENTS );
+
+    *window = SDL_CreateWindow( "tessellation cache test", 50, 50, 400, 400, SDL_WINDOW_OPENGL );
+    if (!*window)
+        die( "error: failed to create window: %s\n", SDL_GetError() );
+
+    *context = SDL_GL_CreateContext( *window );
+    if (!context)
+        die( "error: failed to create GL context: %s\n", SDL_GetError() );
+
+    SDL_GL_MakeCurrent( *window, *context );
+
+    GLenum glew_err = glewInit();
+    if (glew_err != GLEW_OK)
+        die( "error: failed to init glew: %s\n", glewGetErrorString( glew_err ) );
+}
+
+void build_path( ShapeGenerator& gen, int num_vtx )
+{
+    float radius = 10.0f;
+
+    gen.move_to( Vec2f( radius, 0.0f ) );
+    for (int i = 1; i < num_vtx; i++)
+    {
+        float angle     = 2.0f * float( M_PI ) * i / num_vtx;
+        float angle_mid = angle - float( M_PI ) / num_vtx;
+        Vec2f end( radius * std::cos( angle ), radius * std::sin( angle ) );
+
+        if (i % 3 == 0)
+            gen.curve_to( Vec2f( radius * 1.1f * std::cos( angle_mid ), radius * 1.1f * std::sin( angle_mid ) ), end );
+        else
+            gen.line_to( end );
+    }
+    gen.close_path();
+}
+
+bool same_host_data( Geometry* a, Geometry* b )
+{
+    Geometry::HostDrawScope scope_a( *a );
+    Geometry::HostDrawScope scope_b( *b );
+
+    Geometry::HostVertexCache& vtx_a = a->get_host_vertex_cache();
+    Geometry::HostVertexCache& vtx_b = b->get_host_vertex_cache();
+    if ( vtx_a.size() != vtx_b.size() || vtx_a.size() == 0 )
+        return false;
+    if ( memcmp( vtx_a.get_raw_data_ptr(), vtx_b.get_raw_data_ptr(), vtx_a.num_byte() ) != 0 )
+        return false;
+
+    return a->get_host_index_cache() == b->get_host_index_cache();
+}
+
+// cache writes host data, so target geometry is put into host draw
+void cached_fill( TessellationCache& cache, const ShapeGenerator& gen, Geometry* geom )
+{
+    Geometry::HostDrawScope scope( *geom );
+    cache.fill_simple( gen, geom );
+}
+
+void cached_stroke( TessellationCache& cache, const ShapeGenerator& gen, const StrokeStyle& style, Geometry* geom )
+{
+    Geometry::HostDrawScope scope( *geom );
+    cache.stroke_complicated( gen, style, geom );
+}
+
+void TestFramework::content()
+{
+    SDL_Window*   window  = nullptr;
+    SDL_GLContext context = nullptr;
+    build_up_sdl( &window, &context );
+
+    TessellationCache cache;
+    ShapeGenerator    gen;
+    build_path( gen, 12 );
+
+    {
+        OK( "fill" );
+        RefCountHolder<Geometry> expect = ShapeGenerator::create_fill_geometry();
+        RefCountHolder<Geometry> result1 = ShapeGenerator::create_fill_geometry();
+        RefCountHolder<Geometry> result2 = ShapeGenerator::create_fill_geometry();
+        {
+            Geometry::HostDrawScope scope( *expect.get() );
+            gen.fill_simple_preserve( expect.get() );
+        }
+
+        cached_fill( cache, gen, result1.get() );
+        IS( cache.get_num_miss(),  1 );
+        IS( cache.get_num_hit(),   0 );
+        IS( cache.get_num_entry(), 1 );
+        OK( same_host_data( expect.get(), result1.get() ) );
+
+        cached_fill( cache, gen, result2.get() );
+        IS( cache.get_num_miss(), 1 );
+        IS( cache.get_num_hit(),  1 );
+        OK( same_host_data( expect.get(), result2.get() ) );
+
+        UniversalValue skeleton_expect;
+        UniversalValue skeleton_result;
+        OK( expect->get_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, skeleton_expect ) );
+        OK( result2->get_uniform_value( VectorGraphicsMaterial::UNIFORM_SKELETON_MAX, skeleton_result ) );
+        OK( skeleton_expect == skeleton_result );
+    }
+
+    {
+        OK( "stroke is keyed by style" );
+        StrokeStyle style{ LINE_CAP_ROUND, LINE_JOIN_ROUND, float( M_PI ) / 6, 2.0f };
+
+        RefCountHolder<Geometry> expect = ShapeGenerator::create_complicated_stroke_geometry();
+        RefCountHolder<Geometry> result = ShapeGenerator::create_complicated_stroke_geometry();
+        {
+            Geometry::HostDrawScope scope( *expect.get() );
+            gen.stroke_complicated_preserve( style, expect.get() );
+        }
+
+        RefCountHolder<Geometry> first = ShapeGenerator::create_complicated_stroke_geometry();
+        cached_stroke( cache, gen, style, first.get() );
+        cached_stroke( cache, gen, style, result.get() );
+        IS( cache.get_num_miss(), 2 );
+        IS( cache.get_num_hit(),  2 );
+        OK( same_host_data( expect.get(), result.get() ) );
+
+        style.width = 3.0f;
+        RefCountHolder<Geometry> wider = ShapeGenerator::create_complicated_stroke_geometry();
+        cached_stroke( cache, gen, style, wider.get() );
+        IS( cache.get_num_miss(),  3 );
+        IS( cache.get_num_entry(), 3 );
+    }
+
+    {
+        OK( "path change is a miss" );
+        gen.set_tolerance( 0.05f );
+        RefCountHolder<Geometry> result = ShapeGenerator::create_fill_geometry();
+        cached_fill( cache, gen, result.get() );
+        IS( cache.get_num_miss(), 4 );
+
+        gen.line_to( Vec2f( 0.0f, 1.0f ) );
+        result = ShapeGenerator::create_fill_geometry();
+        cached_fill( cache, gen, result.get() );
+        IS( cache.get_num_miss(), 5 );
+    }
+
+    {
+        OK( "least recently used are dropped" );
+        cache.clear();
+        cache.reset_counters();
+        IS( cache.get_num_entry(), 0 );
+        IS( cache.get_num_byte(),  size_t( 0 ) );
+
+        ShapeGenerator paths[10];
+        for (int i = 0; i < 10; i++)
+        {
+            build_path( paths[i], 8 + i );
+            RefCountHolder<Geometry> geom = ShapeGenerator::create_fill_geometry();
+            cached_fill( cache, paths[i], geom.get() );
+        }
+        IS( cache.get_num_entry(), 10 );
+
+        // touch first one, so it is kept
+        {
+            RefCountHolder<Geometry> geom = ShapeGenerator::create_fill_geometry();
+            cached_fill( cache, paths[0], geom.get() );
+            IS( cache.get_num_hit(), 1 );
+        }
+
+        cache.set_byte_budget( cache.get_num_byte() / 2 );
+        OK( cache.get_num_byte() <= cache.get_byte_budget() );
+        OK( cache.get_num_entry() < 10 );
+
+        RefCountHolder<Geometry> geom = ShapeGenerator::create_fill_geometry();
+        cached_fill( cache, paths[0], geom.get() );
+        IS( cache.get_num_hit(), 2 );
+
+        geom = ShapeGenerator::create_fill_geometry();
+        cached_fill( cache, paths[1], geom.get() );
+        IS( cache.get_num_hit(),  2 );
+        IS( cache.get_num_miss(), 11 );
+    }
+
+    SDL_GL_DeleteContext( context );
+    SDL_Quit();
+}
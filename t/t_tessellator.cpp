@@ -0,0 +1,157 @@
+#include "TestFramework.h"
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#include "treeface/graphics/ShapeGenerator.h"
+#include "treeface/graphics/Tessellator.h"
+#include "treeface/misc/WorkerPool.h"
+#include "treeface/scene/Geometry.h"
+
+#include <treecore/RefCountHolder.h>
+
+#include <SDL.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace treeface;
+using namespace treecore;
+
+#define NUM_PATH 200
+
+void build_up_sdl( SDL_Window** window, SDL_GLContext* context )
+{
+    SDL_Init( SDL_INIT_VIDEO & SDL_INIT_TIMER & SDL_INIT_EVENTS );
+
+    *window = SDL_CreateWindow( "tessellator test", 50, 50, 400, 400, SDL_WINDOW_OPENGL );
+    if (!*window)
+        die( "error: failed to create window: %s\n", SDL_GetError() );
+
+    *context = SDL_GL_CreateContext( *window );
+    if (!context)
+        die( "error: failed to create GL context: %s\n", SDL_GetError() );
+
+    SDL_GL_MakeCurrent( *window, *context );
+
+    GLenum glew_err = glewInit();
+    if (glew_err != GLEW_OK)
+        die( "error: failed to init glew: %s\n", glewGetErrorString( glew_err ) );
+}
+
+// polygon with some curved edges
+void build_path( ShapeGenerator& gen, int i_path )
+{
+    int   num_vtx = 5 + i_path % 30;
+    float radius  = 10.0f + i_path % 7;
+
+    gen.move_to( Vec2f( radius, 0.0f ) );
+    for (int i = 1; i < num_vtx; i++)
+    {
+        float angle     = 2.0f * float( M_PI ) * i / num_vtx;
+        float angle_mid = angle - float( M_PI ) / num_vtx;
+        Vec2f end( radius * std::cos( angle ), radius * std::sin( angle ) );
+
+        if (i % 3 == 0)
+            gen.curve_to( Vec2f( radius * 1.1f * std::cos( angle_mid ), radius * 1.1f * std::sin( angle_mid ) ), end );
+        else
+            gen.line_to( end );
+    }
+    gen.close_path();
+}
+
+bool same_host_data( Geometry* a, Geometry* b )
+{
+    Geometry::HostDrawScope scope_a( *a );
+    Geometry::HostDrawScope scope_b( *b );
+
+    Geometry::HostVertexCache& vtx_a = a->get_host_vertex_cache();
+    Geometry::HostVertexCache& vtx_b = b->get_host_vertex_cache();
+    if ( vtx_a.size() != vtx_b.size() || vtx_a.size() == 0 )
+        return false;
+    if ( memcmp( vtx_a.get_raw_data_ptr(), vtx_b.get_raw_data_ptr(), vtx_a.num_byte() ) != 0 )
+        return false;
+
+    return a->get_host_index_cache() == b->get_host_index_cache();
+}
+
+// geometries are written by tessellator inside host draw
+void run_in_host_draw( Tessellator& tessellator, const Array<Tessellator::Job>& jobs )
+{
+    for (const Tessellator::Job& job : jobs)
+        job.geom->host_draw_begin();
+
+    tessellator.run( jobs.getRawDataPointer(), jobs.size() );
+
+    for (const Tessellator::Job& job : jobs)
+        job.geom->host_draw_end();
+}
+
+void TestFramework::content()
+{
+    SDL_Window*   window  = nullptr;
+    SDL_GLContext context = nullptr;
+    build_up_sdl( &window, &context );
+
+    StrokeStyle style{ LINE_CAP_ROUND, LINE_JOIN_ROUND, float( M_PI ) / 6, 2.0f };
+
+    Array<ShapeGenerator*>          paths;
+    Array<RefCountHolder<Geometry> > expect;
+    Array<RefCountHolder<Geometry> > result;
+    Array<Tessellator::Job>         jobs;
+
+    for (int i = 0; i < NUM_PATH; i++)
+    {
+        ShapeGenerator* gen = new ShapeGenerator();
+        build_path( *gen, i );
+        paths.add( gen );
+
+        bool is_stroke = i % 2 == 1;
+        if (is_stroke)
+        {
+            expect.add( ShapeGenerator::create_complicated_stroke_geometry() );
+            result.add( ShapeGenerator::create_complicated_stroke_geometry() );
+            Geometry::HostDrawScope scope( *expect[i].get() );
+            gen->stroke_complicated_preserve( style, expect[i].get() );
+        }
+        else
+        {
+            expect.add( ShapeGenerator::create_fill_geometry() );
+            result.add( ShapeGenerator::create_fill_geometry() );
+            Geometry::HostDrawScope scope( *expect[i].get() );
+            gen->fill_simple_preserve( expect[i].get() );
+        }
+
+        jobs.add( Tessellator::Job{ gen, result[i].get(), is_stroke, style } );
+    }
+
+    // batch result is same as one by one
+    WorkerPool  pool( 4 );
+    Tessellator tessellator( &pool );
+    run_in_host_draw( tessellator, jobs );
+
+    int num_same = 0;
+    for (int i = 0; i < NUM_PATH; i++)
+        num_same += same_host_data( expect[i].get(), result[i].get() );
+    IS( num_same, NUM_PATH );
+
+    // reused scratch gives same result
+    for (int i = 0; i < NUM_PATH; i++)
+    {
+        RefCountHolder<Geometry>& geom = result.getReference( i );
+        geom = jobs[i].is_stroke ? ShapeGenerator::create_complicated_stroke_geometry() : ShapeGenerator::create_fill_geometry();
+        jobs.getReference( i ).geom = geom.get();
+    }
+    run_in_host_draw( tessellator, jobs );
+
+    num_same = 0;
+    for (int i = 0; i < NUM_PATH; i++)
+        num_same += same_host_data( expect[i].get(), result[i].get() );
+    IS( num_same, NUM_PATH );
+
+    for (ShapeGenerator* gen : paths)
+        delete gen;
+
+    SDL_GL_DeleteContext( context );
+    SDL_Quit();
+}
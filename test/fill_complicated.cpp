@@ -0,0 +1,157 @@
+#include "treeface/graphics/guts/ShapeGenerator_guts.h"
+#include "treeface/graphics/guts/SweepFiller.h"
+#include "treeface/scene/Geometry.h"
+#include "treeface/math/Vec2.h"
+
+#include <treecore/Array.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace treecore;
+using namespace treeface;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+#define NUM_REPEAT_SHAPE 1000
+
+// ShapeGenerator is friend to TestFramework, which gives access to simple fill
+class TestFramework
+{
+public:
+    static double run_simple( ShapeGenerator& generator, int num_repeat, int& result_num_triangle )
+    {
+        TessellateScratch scratch;
+        Geometry::HostVertexCache vertices( sizeof(Vec2f) );
+        Array<uint32> indices;
+
+        auto t_begin = Clock::now();
+        for (int i = 0; i < num_repeat; i++)
+        {
+            vertices.clear();
+            indices.clearQuick();
+            scratch.subpath_begin.clearQuick();
+
+            Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+            Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+            generator.m_guts->segment( vertices, scratch.subpath_begin );
+            generator.m_guts->fill( vertices, scratch.subpath_begin, indices, skeleton_min, skeleton_max, scratch );
+        }
+        auto t_end = Clock::now();
+
+        result_num_triangle = indices.size() / 3;
+        return std::chrono::duration<double, std::milli>( t_end - t_begin ).count() / num_repeat;
+    }
+
+    static double run_complicated( ShapeGenerator& generator, FillRule rule, int num_repeat,
+                                   int& result_num_triangle, int& result_num_crossing )
+    {
+        SweepFiller filler;
+        Geometry::HostVertexCache vertices( sizeof(Vec2f) );
+        Array<int32>  subpath_begin;
+        Array<uint32> indices;
+
+        auto t_begin = Clock::now();
+        for (int i = 0; i < num_repeat; i++)
+        {
+            vertices.clear();
+            indices.clearQuick();
+            subpath_begin.clearQuick();
+
+            Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
+            Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
+            generator.m_guts->segment( vertices, subpath_begin );
+            filler.fill( rule, vertices, subpath_begin, indices, skeleton_min, skeleton_max );
+        }
+        auto t_end = Clock::now();
+
+        result_num_triangle = indices.size() / 3;
+        result_num_crossing = filler.num_crossing;
+        return std::chrono::duration<double, std::milli>( t_end - t_begin ).count() / num_repeat;
+    }
+};
+
+void compare_shape( const char* name, ShapeGenerator& generator, int num_vertex )
+{
+    int num_tri = 0;
+    int num_crossing = 0;
+
+    double ms = TestFramework::run_simple( generator, NUM_REPEAT_SHAPE, num_tri );
+    printf( "%-32s %8d vertices %-10s %8d triangles %8s crossings %10.4f ms\n",
+            name, num_vertex, "simple", num_tri, "-", ms );
+
+    ms = TestFramework::run_complicated( generator, FILL_NON_ZERO, NUM_REPEAT_SHAPE, num_tri, num_crossing );
+    printf( "%-32s %8d vertices %-10s %8d triangles %8d crossings %10.4f ms\n",
+            name, num_vertex, "non-zero", num_tri, num_crossing, ms );
+
+    ms = TestFramework::run_complicated( generator, FILL_EVEN_ODD, NUM_REPEAT_SHAPE, num_tri, num_crossing );
+    printf( "%-32s %8d vertices %-10s %8d triangles %8d crossings %10.4f ms\n",
+            name, num_vertex, "even-odd", num_tri, num_crossing, ms );
+}
+
+// star-shaped polygon whose vertex angles are jittered, so that nearby edges
+// cross each other and number of crossings grows linearly
+void build_tangled_star( int num_vertex, std::mt19937& rng, ShapeGenerator& generator )
+{
+    std::uniform_real_distribution<float> radius( 0.5f, 1.5f );
+    std::uniform_real_distribution<float> jitter( -1.5f, 1.5f );
+
+    for (int i = 0; i < num_vertex; i++)
+    {
+        double angle = 2.0 * M_PI * (i + jitter( rng )) / num_vertex;
+        float  r     = radius( rng );
+        generator.line_to( Vec2f( r * float( std::cos( angle ) ), r * float( std::sin( angle ) ) ) );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    // shapes given in command line, such as test/shape_*.tab
+    // simple fill gives wrong result on self-intersecting shapes such as
+    // shape_zigzag.tab, and may hit assertion in debug build
+    for (int i_arg = 1; i_arg < argc; i_arg++)
+    {
+        FILE* fh_in = fopen( argv[i_arg], "rb" );
+        if (fh_in == nullptr)
+        {
+            fprintf( stderr, "failed to open input file %s: %s\n", argv[i_arg], strerror( errno ) );
+            continue;
+        }
+
+        ShapeGenerator generator;
+        int   num_vertex = 0;
+        float x = 0.0f;
+        float y = 0.0f;
+        while (fscanf( fh_in, "%f %f", &x, &y ) == 2)
+        {
+            generator.line_to( Vec2f( x, y ) );
+            num_vertex++;
+        }
+
+        fclose( fh_in );
+
+        compare_shape( argv[i_arg], generator, num_vertex );
+    }
+
+    // synthetic shapes, cost per vertex and crossing should stay near flat
+    // if sweep is O((n+k) log n)
+    std::mt19937 rng( 1234 );
+    for (int num_vertex = 1000; num_vertex <= 256000; num_vertex *= 2)
+    {
+        ShapeGenerator generator;
+        build_tangled_star( num_vertex, rng, generator );
+
+        int    num_tri      = 0;
+        int    num_crossing = 0;
+        double ms = TestFramework::run_complicated( generator, FILL_NON_ZERO, 1, num_tri, num_crossing );
+        printf( "tangled star %8d vertices %8d crossings %8d triangles %10.3f ms %8.1f ns/(vertex+crossing)\n",
+                num_vertex, num_crossing, num_tri, ms, ms * 1.0e6 / (num_vertex + num_crossing) );
+    }
+
+    return 0;
+}
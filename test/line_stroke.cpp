@@ -1,3 +1,4 @@
+#include "treeface/graphics/ShapeGenerator.h"
 #include "treeface/graphics/guts/SubPath.h"
 #include "treeface/math/Constants.h"
 
@@ -152,7 +153,7 @@ int main( int argc, const char* argv[] )
     Array<IndexType> indices;
     Vec2f skeleton_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max() );
     Vec2f skeleton_max( std::numeric_limits<float>::min(), std::numeric_limits<float>::min() );
-    path.stroke_complex( vertices, indices, skeleton_min, skeleton_max, StrokeStyle{ line_cap, line_join, miter_cutoff * treeface::PI / 180, line_width } );
+    path.stroke_complex( vertices, indices, skeleton_min, skeleton_max, StrokeStyle{ line_cap, line_join, miter_cutoff * treeface::PI / 180, line_width }, SHAPE_GENERATOR_DEFAULT_TOLERANCE );
 
     // write result
     file_out.deleteFile();
@@ -0,0 +1,109 @@
+#include "treeface/graphics/Utils.h"
+#include "treeface/graphics/guts/HalfEdgeNetwork.h"
+#include "treeface/graphics/guts/Utils.h"
+#include "treeface/misc/ScratchArena.h"
+
+#include <treecore/Array.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace treecore;
+using namespace treeface;
+
+// partition result has at most three times of edges as input, which must be
+// addressable by 32-bit index
+#define MAX_NUM_VERTEX (std::numeric_limits<int32>::max() / 3)
+
+typedef HalfEdgeNetworkT<uint32> Network;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+void run_partition( const char* name, const Geometry::HostVertexCache& vertices )
+{
+    Network network( vertices );
+
+    {
+        bool ccw = (clockwise_accum( vertices, 0, vertices.size() ) < 0.0);
+        Array<uint32> begin;
+        begin.add( 0 );
+        network.build_half_edges( begin, ccw );
+    }
+
+    Network network_result( vertices );
+
+    ScratchArena& arena = ScratchArena::get_thread_arena();
+    arena.reset_peak();
+
+    auto t_begin = Clock::now();
+    network.partition_polygon_monotone( network_result );
+    auto t_end = Clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>( t_end - t_begin ).count();
+    printf( "%-40s %8d vertices %8d result edges %10.3f ms %8.1f ns/vertex %10.1f KiB arena peak\n",
+            name, vertices.size(), network_result.edges.size(), ms, ms * 1.0e6 / vertices.size(),
+            arena.get_peak() / 1024.0 );
+}
+
+// star-shaped polygon with random radius, which has a lot of split and merge
+// vertices
+void build_star( int num_vertex, std::mt19937& rng, Geometry::HostVertexCache& result )
+{
+    std::uniform_real_distribution<float> radius( 0.5f, 1.5f );
+
+    for (int i = 0; i < num_vertex; i++)
+    {
+        double angle = 2.0 * M_PI * i / num_vertex;
+        float  r     = radius( rng );
+        result.add( Vec2f( r * float( std::cos( angle ) ), r * float( std::sin( angle ) ) ) );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    // shapes given in command line
+    for (int i_arg = 1; i_arg < argc; i_arg++)
+    {
+        FILE* fh_in = fopen( argv[i_arg], "rb" );
+        if (fh_in == nullptr)
+        {
+            fprintf( stderr, "failed to open input file %s: %s\n", argv[i_arg], strerror( errno ) );
+            continue;
+        }
+
+        Geometry::HostVertexCache vertices( sizeof(Vec2f) );
+        float x = 0.0f;
+        float y = 0.0f;
+        while (fscanf( fh_in, "%f %f", &x, &y ) == 2)
+            vertices.add( Vec2f( x, y ) );
+
+        fclose( fh_in );
+
+        run_partition( argv[i_arg], vertices );
+    }
+
+    // synthetic shapes, from 1000 up to 1024000 vertices
+    std::mt19937 rng( 1234 );
+    for (int num_vertex = 1000; num_vertex <= 1024000; num_vertex *= 2)
+    {
+        if (num_vertex > MAX_NUM_VERTEX)
+        {
+            printf( "skip synthetic shapes larger than %d vertices, which exceed range of index\n", int( MAX_NUM_VERTEX ) );
+            break;
+        }
+
+        Geometry::HostVertexCache vertices( sizeof(Vec2f) );
+        build_star( num_vertex, rng, vertices );
+
+        char name[64];
+        snprintf( name, sizeof(name), "star %d", num_vertex );
+        run_partition( name, vertices );
+    }
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "treeface/misc/RadixSort.h"
+
+#include "treeface/scene/SceneGraphMaterial.h"
+#include "treeface/scene/guts/RenderItem.h"
+
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace treecore;
+using namespace treeface;
+
+#define NUM_MATERIAL 64
+#define NUM_GEOMETRY 1024
+#define NUM_REPEAT   5
+
+// the comparator used by SceneRenderer before packed sort keys
+struct LegacyItemSorter
+{
+    int compareElements( const RenderItem& a, const RenderItem& b ) const noexcept
+    {
+        if ( a.mat->is_translucent() )
+        {
+            if ( !b.mat->is_translucent() )
+                return 1;
+        }
+        else
+        {
+            if ( b.mat->is_translucent() )
+                return -1;
+        }
+
+        if (a.mat < b.mat)
+            return -1;
+        else if (a.mat > b.mat)
+            return 1;
+
+        if (a.vis_obj < b.vis_obj)
+            return -1;
+        else if (a.vis_obj > b.vis_obj)
+            return 1;
+
+        if (a.node < b.node)
+            return -1;
+        else if (a.node > b.node)
+            return 1;
+
+        return 0;
+    }
+};
+
+double run_legacy( const Array<RenderItem>& input )
+{
+    double total = 0.0;
+    for (int i = 0; i < NUM_REPEAT; i++)
+    {
+        Array<RenderItem> data( input );
+        LegacyItemSorter sorter;
+
+        auto t_begin = std::chrono::high_resolution_clock::now();
+        data.sort( sorter );
+        auto t_end = std::chrono::high_resolution_clock::now();
+
+        total += std::chrono::duration<double, std::milli>( t_end - t_begin ).count();
+    }
+    return total / NUM_REPEAT;
+}
+
+double run_radix( const Array<RenderItem>& input )
+{
+    double total = 0.0;
+    Array<RenderItem> buffer;
+    for (int i = 0; i < NUM_REPEAT; i++)
+    {
+        Array<RenderItem> data( input );
+
+        auto t_begin = std::chrono::high_resolution_clock::now();
+        radix_sort( data, buffer, RenderItemKeyGetter() );
+        auto t_end = std::chrono::high_resolution_clock::now();
+
+        total += std::chrono::duration<double, std::milli>( t_end - t_begin ).count();
+    }
+    return total / NUM_REPEAT;
+}
+
+int main( int argc, char** argv )
+{
+    Array<RefCountHolder<SceneGraphMaterial> > materials;
+    for (int i = 0; i < NUM_MATERIAL; i++)
+        materials.add( new SceneGraphMaterial() );
+
+    std::mt19937 rng( 42 );
+    std::uniform_int_distribution<int> mat_dist( 0, NUM_MATERIAL - 1 );
+    std::uniform_int_distribution<int> geom_dist( 0, NUM_GEOMETRY - 1 );
+
+    const int sizes[] = { 10000, 100000, 1000000 };
+
+    printf( "%10s %14s %14s\n", "items", "comparator ms", "radix ms" );
+
+    for (int size : sizes)
+    {
+        Array<RenderItem> input;
+        for (int i = 0; i < size; i++)
+        {
+            int mat_id  = mat_dist( rng );
+            int geom_id = geom_dist( rng );
+
+            // visual objects and nodes are only compared by address, so fake
+            // unique pointers are enough
+            SceneGraphMaterial* mat = materials[mat_id];
+            VisualObject* vis_obj   = reinterpret_cast<VisualObject*>( pointer_sized_uint( geom_id + 1 ) * 64 );
+            SceneNode*    node      = reinterpret_cast<SceneNode*>( pointer_sized_uint( i + 1 ) * 64 );
+
+            uint64 key = make_render_key( mat->is_translucent(), uint32( mat_id ), uint32( geom_id ), 0 );
+            input.add( { key, mat, vis_obj, node } );
+        }
+
+        printf( "%10d %14.3f %14.3f\n", size, run_legacy( input ), run_radix( input ) );
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "treeface/graphics/guts/HalfOutline.h"
+#include "treeface/graphics/BBox2.h"
+#include "treeface/graphics/ShapeGenerator.h"
+#include "treeface/scene/Geometry.h"
+
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace treecore;
+using namespace treeface;
+
+typedef std::chrono::high_resolution_clock Clock;
+
+#define NUM_OUTLINE_VERTEX 4096
+#define NUM_QUERY 200000
+#define NUM_REPEAT_STROKE 20
+
+// search segment by segment on AoS bounds, which is how inner outline cross
+// was searched before SIMD kernel
+int find_cross_from_tail_scalar( const Array<Vec2f>& outline, const Array<BBox2f>& bounds,
+                                 const Vec2f& p1, const Vec2f& p2, Vec2f& p_cross, int step_limit )
+{
+    const BBox2f bound_input( p1, p2 );
+
+    for (int i = outline.size() - 2; i >= 0; i--)
+    {
+        if (outline.size() - i > step_limit) break;
+
+        if ( bound_input ^ bounds[i] )
+        {
+            if ( cross_test_inc( p1, p2, outline[i], outline[i + 1], p_cross ) )
+                return i;
+        }
+    }
+
+    return -1;
+}
+
+// offset of a curve that turns tighter than stroke width, which is where
+// inner outline of thick stroke folds back and is searched a lot
+Vec2f get_curl_point( int i, float radius )
+{
+    float t = float( i ) * 0.2f;
+    return Vec2f( t + radius * std::cos( t * 1.7f ), radius * std::sin( t * 1.7f ) );
+}
+
+void bench_kernel( int step_limit )
+{
+    HalfOutline   outline( 1.0f );
+    Array<Vec2f>  points;
+    Array<BBox2f> bounds;
+
+    for (int i = 0; i < NUM_OUTLINE_VERTEX; i++)
+    {
+        Vec2f p = get_curl_point( i, 3.0f );
+        if (points.size() > 0)
+            bounds.add( BBox2f( points.getLast(), p ) );
+        points.add( p );
+        outline.add( p, i );
+    }
+
+    // queries near tail of outline, half of them cross something
+    std::mt19937 rng( 1234 );
+    std::uniform_real_distribution<float> offset( -4.0f, 4.0f );
+    Array<Vec2f> queries;
+    for (int i = 0; i < NUM_QUERY; i++)
+    {
+        Vec2f base = get_curl_point( NUM_OUTLINE_VERTEX - 1 - (i % step_limit), 3.0f );
+        queries.add( base + Vec2f( offset( rng ), offset( rng ) ) );
+        queries.add( base + Vec2f( offset( rng ), offset( rng ) ) );
+    }
+
+    int   num_mismatch = 0;
+    int   num_got      = 0;
+    Vec2f cross_simd;
+    Vec2f cross_scalar;
+
+    auto t_begin = Clock::now();
+    for (int i = 0; i < NUM_QUERY; i++)
+    {
+        if (find_cross_from_tail_scalar( points, bounds, queries[i * 2], queries[i * 2 + 1], cross_scalar, step_limit ) >= 0)
+            num_got++;
+    }
+    auto   t_scalar  = Clock::now();
+    double ms_scalar = std::chrono::duration<double, std::milli>( t_scalar - t_begin ).count();
+
+    for (int i = 0; i < NUM_QUERY; i++)
+        outline.find_cross_from_tail( queries[i * 2], queries[i * 2 + 1], cross_simd, step_limit );
+    double ms_simd = std::chrono::duration<double, std::milli>( Clock::now() - t_scalar ).count();
+
+    for (int i = 0; i < NUM_QUERY; i++)
+    {
+        int i_scalar = find_cross_from_tail_scalar( points, bounds, queries[i * 2], queries[i * 2 + 1], cross_scalar, step_limit );
+        int i_simd   = outline.find_cross_from_tail( queries[i * 2], queries[i * 2 + 1], cross_simd, step_limit );
+        if ( i_scalar != i_simd || (i_scalar >= 0 && cross_scalar != cross_simd) )
+            num_mismatch++;
+    }
+
+    printf( "find cross from tail, limit %4d: %8d queries %8d got, scalar %9.3f ms, simd %9.3f ms, speedup %5.2fx, %d mismatch\n",
+            step_limit, NUM_QUERY, num_got, ms_scalar, ms_simd, ms_scalar / ms_simd, num_mismatch );
+}
+
+void bench_stroke( float width )
+{
+    ShapeGenerator generator;
+    generator.move_to( get_curl_point( 0, 1.0f ) );
+    for (int i = 1; i < 20000; i++)
+        generator.line_to( get_curl_point( i, 1.0f ) );
+
+    StrokeStyle style{ LINE_CAP_ROUND, LINE_JOIN_ROUND, float( M_PI ) / 6, width };
+
+    RefCountHolder<Geometry> geom = ShapeGenerator::create_complicated_stroke_geometry();
+
+    auto t_begin = Clock::now();
+    for (int i = 0; i < NUM_REPEAT_STROKE; i++)
+    {
+        geom->get_host_vertex_cache().clear_quick();
+        if (geom->get_index_type() == TFGL_TYPE_UNSIGNED_INT)
+            geom->get_host_index_cache_32().clearQuick();
+        else
+            geom->get_host_index_cache().clearQuick();
+        generator.stroke_complicated_preserve( style, geom.get() );
+    }
+    double ms = std::chrono::duration<double, std::milli>( Clock::now() - t_begin ).count() / NUM_REPEAT_STROKE;
+
+    printf( "stroke curl of 20000 points, width %5.1f: %8d vertices %10.3f ms\n",
+            width, geom->get_host_vertex_cache().size(), ms );
+}
+
+int main( int argc, char** argv )
+{
+    bench_kernel( 8 );
+    bench_kernel( TAIL_FIND_LIMIT );
+    bench_kernel( 256 );
+
+    // time of thick strokes is dominated by inner outline search
+    bench_stroke( 0.5f );
+    bench_stroke( 4.0f );
+    bench_stroke( 16.0f );
+
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <treecore/StringRef.h>
 
 #include "treeface/gl/GLBuffer.h"
+#include "treeface/gl/GLStateCache.h"
 #include "treeface/gl/ImageRef.h"
 #include "treeface/gl/Program.h"
 #include "treeface/gl/Texture.h"
@@ -153,7 +154,7 @@ void build_up_gl()
     buf_idx->upload_data( data_indices, sizeof(data_indices) );
     buf_idx->unbind();
 
-    glActiveTexture( GL_TEXTURE1 );
+    GLStateCache::current().active_texture( 1 );
     texture = new Texture( img_texture1, 0 );
     texture->bind();
     texture->set_min_filter( TFGL_TEXTURE_NEAREST );
@@ -175,7 +176,7 @@ void main_loop( SDL_Window* window )
     int uni_tex = program_tex->get_uniform_location( "tex_sampler" );
     Logger::outputDebugString( "set to texture uniform: " + String( uni_tex ) );
 
-    glActiveTexture( GL_TEXTURE0 );
+    GLStateCache::current().active_texture( 0 );
 
     while (1)
     {
@@ -208,7 +209,7 @@ void main_loop( SDL_Window* window )
         vertex_array_tex->bind();
         printf( "  use buffer\n" );
 
-        glActiveTexture( GL_TEXTURE0 );
+        GLStateCache::current().active_texture( 0 );
         printf( "  use texture\n" );
         texture->bind();
 
@@ -0,0 +1,126 @@
+#include "treeface/scene/SceneNode.h"
+#include "treeface/scene/TransformStore.h"
+
+#include <treecore/Array.h>
+#include <treecore/RefCountHolder.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace treecore;
+using namespace treeface;
+
+#define NUM_NODE     100000
+#define NUM_BRANCH   4
+#define NUM_REPEAT   20
+#define PARTIAL_RATE 100
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// build a tree in which nodes are allocated in shuffled order, so that
+// hierarchy order does not follow memory order
+SceneNode* build_tree( Array<SceneNode*>& nodes, std::mt19937& rng )
+{
+    for (int i = 0; i < NUM_NODE; i++)
+        nodes.add( new SceneNode() );
+
+    std::shuffle( &nodes[0], &nodes[0] + NUM_NODE, rng );
+
+    Mat4f trans;
+    trans.set_translate( 1, 0, 0 );
+
+    for (int i = 0; i < NUM_NODE; i++)
+    {
+        nodes[i]->set_transform( trans );
+        if (i > 0)
+            nodes[(i - 1) / NUM_BRANCH]->add_child( nodes[i] );
+    }
+
+    return nodes[0];
+}
+
+void modify( Array<SceneNode*>& nodes, std::mt19937& rng, bool partial )
+{
+    Mat4f trans;
+    trans.set_translate( float( rng() % 16 ), 0, 0 );
+
+    if (partial)
+    {
+        for (int i = 0; i < NUM_NODE / PARTIAL_RATE; i++)
+            nodes[rng() % NUM_NODE]->set_transform( trans );
+    }
+    else
+    {
+        nodes[0]->set_transform( trans );
+    }
+}
+
+double run_lazy( Array<SceneNode*>& nodes, std::mt19937& rng, bool partial )
+{
+    double total = 0.0;
+    float  sum   = 0.0f;
+
+    for (int i = 0; i < NUM_REPEAT; i++)
+    {
+        modify( nodes, rng, partial );
+
+        auto t_begin = Clock::now();
+        for (int i_node = 0; i_node < NUM_NODE; i_node++)
+            sum += nodes[i_node]->get_global_transform().get<0, 3>();
+        auto t_end = Clock::now();
+
+        total += std::chrono::duration<double, std::milli>( t_end - t_begin ).count();
+    }
+
+    printf( "  checksum %f\n", sum );
+    return total / NUM_REPEAT;
+}
+
+double run_update( Array<SceneNode*>& nodes, std::mt19937& rng, bool partial )
+{
+    double total = 0.0;
+
+    for (int i = 0; i < NUM_REPEAT; i++)
+    {
+        modify( nodes, rng, partial );
+
+        auto t_begin = Clock::now();
+        nodes[0]->update_global_transforms();
+        auto t_end = Clock::now();
+
+        total += std::chrono::duration<double, std::milli>( t_end - t_begin ).count();
+    }
+
+    return total / NUM_REPEAT;
+}
+
+int main()
+{
+    std::mt19937 rng( 1234 );
+
+    Array<SceneNode*> nodes;
+    RefCountHolder<SceneNode> root = build_tree( nodes, rng );
+
+    printf( "%d nodes, %d children per node, average of %d runs\n", NUM_NODE, NUM_BRANCH, NUM_REPEAT );
+
+    for (int i_case = 0; i_case < 2; i_case++)
+    {
+        bool partial = i_case == 1;
+        printf( partial ? "modify 1%% random nodes:\n" : "modify root node:\n" );
+
+        double lazy = run_lazy( nodes, rng, partial );
+        printf( "  lazy query on each node:    %8.3f ms\n", lazy );
+
+        double pass = run_update( nodes, rng, partial );
+        printf( "  per-node top-down pass:     %8.3f ms\n", pass );
+
+        RefCountHolder<TransformStore> store = new TransformStore( root );
+        store->update();
+        double contiguous = run_update( nodes, rng, partial );
+        printf( "  contiguous transform store: %8.3f ms\n", contiguous );
+    }
+
+    return 0;
+}